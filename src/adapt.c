@@ -0,0 +1,265 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "adapt.h"
+#include "utility.h"
+
+// 알고리듬별 Level 목록 (빠른 것부터)
+// LZ4: 음수는 가속 (Acceleration), 0 은 기본 (kPrefs), 3 이상은 HC. (1, 2 는 0 과 같고, 10 이상은 너무 느림)
+static const int kLz4Levels[] = { -16, -8, -4, -2, 0, 3, 4, 5, 6, 7, 8, 9 };
+#define LZ4_START_INDEX 4  // Level 0
+
+// ZSTD: 음수는 빠른 Level, 1 은 기본 (create_resources 의 ZSTD_fast)
+static const int kZstdLevels[] = { -16, -8, -4, -2, -1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 15, 19 };
+#define ZSTD_START_INDEX 5 // Level 1
+
+/**
+ * @brief Level 을 옮기고 통계에 반영합니다.
+ *
+ * @param adapt Level 조절 컨텍스트
+ * @param index 새 Level 의 위치
+ * @param now 지금 시각 (us)
+ * @param speed 바꾸기 직전 구간의 처리 속도 (bytes/s)
+ * @param waitRatio 직전 Level 을 쓰는 동안 쓰기를 기다린 시간의 비율
+ * @param pendingRatio 직전 Level 을 쓰는 동안 끝나지 않은 쓰기 수 평균 (최대값 대비)
+ */
+static void adapt_move(ADAPT_Context_t* adapt, int index, ULONGLONG now, double speed, double waitRatio, double pendingRatio) {
+    adapt->index = index;
+    if (adapt->stats.loggedChanges < ADAPT_MAX_LOGGED_CHANGES) {
+        ADAPT_Change_t* const change = &(adapt->stats.changes[adapt->stats.loggedChanges++]);
+        change->inputOffset = adapt->doneBytes;
+        change->elapsedMillis = (DWORD)((now - adapt->startMicros) / 1000);
+        change->level = adapt->levels[index];
+        change->speed = speed;
+        change->waitPercent = (DWORD)(waitRatio * 100.0 + 0.5);
+        change->pendingPercent = (DWORD)(pendingRatio * 100.0 + 0.5);
+    }
+    adapt->stats.levelChanges++;
+
+    int const level = adapt->levels[index];
+    if (level < adapt->stats.minLevel) {
+        adapt->stats.minLevel = level;
+    }
+    if (level > adapt->stats.maxLevel) {
+        adapt->stats.maxLevel = level;
+    }
+}
+
+/**
+ * @brief Level 조절을 시작합니다.
+ *
+ * 알고리듬의 기본 Level 에서 시작하며, 마감 시간은 지금부터 잽니다.
+ * ADAPT_MODE_OUTPUT 이면 기본 Level 아래로는 내리지 않습니다.
+ *
+ * @param algorithm 압축 알고리듬
+ * @param mode 조절 방식
+ * @param totalBytes 압축할 전체 원본 크기
+ * @param deadlineMillis 지금부터 마감까지의 시간 (ms, ADAPT_MODE_DEADLINE 에만 사용)
+ * @return Level 조절 컨텍스트, 실패 시 NULL
+ */
+ADAPT_Context_t* adapt_create(CompressionAlgorithm algorithm, AdaptMode mode, ULONGLONG totalBytes, DWORD deadlineMillis) {
+    ADAPT_Context_t* const adapt = (ADAPT_Context_t*)calloc(1, sizeof(ADAPT_Context_t));
+    if (adapt == NULL) {
+        log_message("error : Failed to allocate the level adaptation context.");
+        return NULL;
+    }
+
+    if (algorithm == LZ4) {
+        adapt->levels = kLz4Levels;
+        adapt->levelCount = sizeof(kLz4Levels) / sizeof(kLz4Levels[0]);
+        adapt->index = LZ4_START_INDEX;
+    } else {
+        adapt->levels = kZstdLevels;
+        adapt->levelCount = sizeof(kZstdLevels) / sizeof(kZstdLevels[0]);
+        adapt->index = ZSTD_START_INDEX;
+    }
+
+    adapt->mode = mode;
+    adapt->minIndex = (mode == ADAPT_MODE_OUTPUT) ? adapt->index : 0;
+    adapt->totalBytes = totalBytes;
+    adapt->deadlineMicros = (ULONGLONG)deadlineMillis * 1000;
+    adapt->startMicros = now_micros();
+    adapt->intervalStartMicros = adapt->startMicros;
+    adapt->windowStartMicros = adapt->startMicros;
+
+    adapt->stats.startLevel = adapt->levels[adapt->index];
+    adapt->stats.minLevel = adapt->stats.startLevel;
+    adapt->stats.maxLevel = adapt->stats.startLevel;
+    return adapt;
+}
+
+/**
+ * @brief Level 조절 컨텍스트를 해제합니다.
+ */
+void adapt_free(ADAPT_Context_t* adapt) {
+    free(adapt);
+}
+
+/**
+ * @brief 지금 사용할 Level 을 구합니다.
+ */
+int adapt_level(const ADAPT_Context_t* adapt) {
+    return adapt->levels[adapt->index];
+}
+
+/**
+ * @brief 쓰기를 기다린 시간과 지금 끝나지 않은 쓰기 수를 알립니다. (ADAPT_MODE_OUTPUT 의 판단 근거)
+ *
+ * @param adapt Level 조절 컨텍스트 (NULL 이면 아무것도 하지 않음)
+ * @param waitMicros 지난 알림 이후 압축 Thread 가 쓰기 때문에 기다린 시간 (us)
+ * @param pendingWrites 지금 끝나지 않은 쓰기 수
+ * @param maxPendingWrites 끝나지 않은 쓰기 수의 최대값 (0 이면 쓰기 수는 보지 않음)
+ */
+void adapt_add_wait(ADAPT_Context_t* adapt, ULONGLONG waitMicros, DWORD pendingWrites, DWORD maxPendingWrites) {
+    if (adapt == NULL) {
+        return;
+    }
+
+    adapt->windowWaitMicros += waitMicros;
+    adapt->stats.waitMicros += waitMicros;
+    if (maxPendingWrites > 0) {
+        adapt->windowPending += (double)pendingWrites / (double)maxPendingWrites;
+        adapt->windowSamples++;
+    }
+}
+
+/**
+ * @brief 마감 시간 안에 끝낼 수 있는 Level 을 정합니다.
+ *
+ * 마감 시간이 이미 지났으면 가장 빠른 Level 로 내립니다.
+ *
+ * @return 새 Level 의 위치
+ */
+static int adapt_pick_deadline(const ADAPT_Context_t* adapt, ULONGLONG now) {
+    ULONGLONG const elapsedMicros = now - adapt->startMicros;
+    if (elapsedMicros >= adapt->deadlineMicros) {
+        return adapt->minIndex;
+    }
+
+    // 남은 크기를 남은 시간 안에 끝내는 데 필요한 속도
+    ULONGLONG const remainingBytes = (adapt->totalBytes > adapt->doneBytes) ? adapt->totalBytes - adapt->doneBytes : 0;
+    double const required = (double)remainingBytes * 1000000.0 / (double)(adapt->deadlineMicros - elapsedMicros);
+    double const speed = adapt->speed[adapt->index];
+
+    if (speed < required && adapt->index > adapt->minIndex) {
+        return adapt->index - 1;
+    }
+
+    if (adapt->index + 1 < adapt->levelCount) {
+        double const next = (adapt->speed[adapt->index + 1] != 0.0) ?
+            adapt->speed[adapt->index + 1] : speed * ADAPT_UNKNOWN_SLOWDOWN;
+        if (next >= required * ADAPT_UP_MARGIN) {
+            return adapt->index + 1;
+        }
+    }
+    return adapt->index;
+}
+
+/**
+ * @brief 쓰기 상황에 맞는 Level 을 정합니다. I/O 병목이면 올리고, CPU 병목이면 내립니다.
+ *
+ * 올리는 것은 지금 Level 로 바꾼 뒤 실제로 쓰기를 기다렸을 때만 하고 (한 번에 여러 단계 오르지 않게),
+ * 내리는 것은 Staging 버퍼가 몇 번 비워질 만큼 (ADAPT_OUTPUT_SETTLE_INTERVALS) 기다리지 않았을 때만 합니다.
+ *
+ * @param waitRatio 지금 Level 로 바꾼 뒤 쓰기를 기다린 시간의 비율
+ * @param pendingRatio 지금 Level 로 바꾼 뒤 끝나지 않은 쓰기 수의 평균 (최대값 대비)
+ * @return 새 Level 의 위치
+ */
+static int adapt_pick_output(const ADAPT_Context_t* adapt, double waitRatio, double pendingRatio) {
+    BOOL const bIoBound = (waitRatio >= ADAPT_IO_BOUND_WAIT || pendingRatio >= ADAPT_IO_BOUND_PENDING);
+    BOOL const bCpuBound = (adapt->windowIntervals >= ADAPT_OUTPUT_SETTLE_INTERVALS &&
+                            waitRatio < ADAPT_CPU_BOUND_WAIT && pendingRatio < ADAPT_CPU_BOUND_PENDING);
+
+    if (bIoBound && adapt->index + 1 < adapt->levelCount) {
+        return adapt->index + 1;
+    }
+    if (bCpuBound && adapt->index > adapt->minIndex) {
+        return adapt->index - 1;
+    }
+    return adapt->index;
+}
+
+/**
+ * @brief 압축한 원본 크기를 알리고, ADAPT_INTERVAL_BYTES 마다 처리 상황을 재어 Level 을 다시 정합니다.
+ *
+ * @param adapt Level 조절 컨텍스트 (NULL 이면 아무것도 하지 않음)
+ * @param bytes 지금 Level 로 압축한 원본 크기
+ * @return Level 이 바뀌었으면 TRUE (adapt_level 로 새 Level 을 구해 적용해야 함)
+ */
+BOOL adapt_update(ADAPT_Context_t* adapt, size_t bytes) {
+    if (adapt == NULL) {
+        return FALSE;
+    }
+
+    adapt->doneBytes += bytes;
+    adapt->intervalBytes += bytes;
+    if (adapt->intervalBytes < ADAPT_INTERVAL_BYTES) {
+        return FALSE;
+    }
+
+    // 이번 구간의 속도를 지금 Level 의 이동 평균에 반영
+    ULONGLONG const now = now_micros();
+    ULONGLONG const intervalMicros = (now > adapt->intervalStartMicros) ? now - adapt->intervalStartMicros : 1;
+    double const rate = (double)adapt->intervalBytes * 1000000.0 / (double)intervalMicros;
+    double* const speed = &(adapt->speed[adapt->index]);
+    *speed = (*speed == 0.0) ? rate : (*speed + rate) / 2.0;
+
+    adapt->intervalBytes = 0;
+    adapt->intervalStartMicros = now;
+    adapt->windowIntervals++;
+
+    // 지금 Level 로 바꾼 뒤의 쓰기 상황
+    ULONGLONG const windowMicros = (now > adapt->windowStartMicros) ? now - adapt->windowStartMicros : 1;
+    double waitRatio = (double)adapt->windowWaitMicros / (double)windowMicros;
+    if (waitRatio > 1.0) {
+        waitRatio = 1.0;
+    }
+    double const pendingRatio = (adapt->windowSamples > 0) ? adapt->windowPending / adapt->windowSamples : 0.0;
+
+    int const index = (adapt->mode == ADAPT_MODE_OUTPUT) ?
+        adapt_pick_output(adapt, waitRatio, pendingRatio) : adapt_pick_deadline(adapt, now);
+    if (index == adapt->index) {
+        return FALSE;
+    }
+    adapt_move(adapt, index, now, rate, waitRatio, pendingRatio);
+
+    adapt->windowStartMicros = now;
+    adapt->windowWaitMicros = 0;
+    adapt->windowPending = 0.0;
+    adapt->windowSamples = 0;
+    adapt->windowIntervals = 0;
+    return TRUE;
+}
+
+/**
+ * @brief 걸린 시간과 마감 여부를 기록하고 통계를 복사합니다.
+ *
+ * @param adapt Level 조절 컨텍스트 (NULL 이면 아무것도 하지 않음)
+ * @param stats 통계를 저장할 곳 (NULL 이면 저장하지 않음)
+ */
+void adapt_finish(ADAPT_Context_t* adapt, ADAPT_Stats_t* stats) {
+    if (adapt == NULL) {
+        return;
+    }
+
+    ULONGLONG const elapsedMicros = now_micros() - adapt->startMicros;
+    adapt->stats.finalLevel = adapt_level(adapt);
+    adapt->stats.elapsedMillis = (DWORD)(elapsedMicros / 1000);
+    adapt->stats.bMetDeadline = (adapt->mode == ADAPT_MODE_DEADLINE && elapsedMicros <= adapt->deadlineMicros);
+    if (stats != NULL) {
+        *stats = adapt->stats;
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ADAPT_H
+#define ADAPT_H
+
+#include <windows.h>
+
+#include "compressor.h"
+
+/*
+ * 압축 Level 자동 조절
+ *
+ * 압축하면서 ADAPT_INTERVAL_BYTES 마다 처리 상황을 재어 Level 을 올리거나 내립니다. (zstd --adapt 와 비슷)
+ *
+ * 마감 시간에 맞춘 조절 (ADAPT_MODE_DEADLINE) 은 파일을 정해진 시간 안에 압축해야 할 때 사용하며,
+ * 남은 크기와 남은 시간으로 필요한 속도를 구하고,
+ * - 지금 Level 의 속도가 필요한 속도보다 느리면 한 단계 내리고,
+ * - 한 단계 위 Level 의 (잰 적이 없으면 추정한) 속도로도 여유 있게 끝낼 수 있으면 한 단계 올립니다.
+ * 속도는 I/O 를 기다린 시간을 포함한 실제 경과 시간으로 재며, Level 별로 이동 평균을 유지하여 오르내림을 반복하지 않게 합니다.
+ *
+ * 출력 속도에 맞춘 조절 (ADAPT_MODE_OUTPUT) 은 마감 시간 없이, 압축 Thread 가 쓰기를 기다린 시간과 끝나지 않은 쓰기 수
+ * (adapt_add_wait 로 알림) 를 봅니다.
+ * 쓰기는 Staging 버퍼 단위로 띄엄띄엄 기다리게 되므로, 구간 하나가 아니라 마지막으로 Level 을 바꾼 뒤의 누적 값으로 판단합니다.
+ * - 쓰기를 기다리는 시간이 길거나 쓰기가 밀려 있으면 I/O 가 병목이므로 (CPU 가 놀고 있음) Level 을 올리고,
+ * - ADAPT_OUTPUT_SETTLE_INTERVALS 구간 동안 쓰기를 거의 기다리지 않으면 CPU 가 병목이므로 Level 을 내립니다.
+ *   (처음 Level 아래로는 내리지 않음)
+ */
+
+#define ADAPT_INTERVAL_BYTES   (1024 * 1024) // 이만큼 압축할 때마다 Level 을 다시 정함
+#define ADAPT_MAX_LEVELS       32            // 조절하는 Level 단계 수 최대값
+#define ADAPT_UP_MARGIN        1.15          // 위 Level 의 속도가 필요한 속도의 이 배 이상이어야 올림
+#define ADAPT_UNKNOWN_SLOWDOWN 0.7           // 잰 적이 없는 위 Level 의 속도는 지금 Level 속도의 이 배로 추정
+#define ADAPT_IO_BOUND_WAIT    0.10          // 구간 시간 중 쓰기를 기다린 비율이 이 이상이면 I/O 병목
+#define ADAPT_IO_BOUND_PENDING 0.75          // 끝나지 않은 쓰기 수의 평균이 최대값의 이 비율 이상이면 I/O 병목
+#define ADAPT_CPU_BOUND_WAIT   0.02          // 구간 시간 중 쓰기를 기다린 비율이 이 미만이면 (밀린 쓰기도 적으면) CPU 병목
+#define ADAPT_CPU_BOUND_PENDING 0.25         // CPU 병목으로 보는 끝나지 않은 쓰기 수의 평균 비율 상한
+#define ADAPT_OUTPUT_SETTLE_INTERVALS 8      // Level 을 바꾼 뒤 쓰기를 기다리지 않은 채 이만큼 구간이 지나야 내림
+#define ADAPT_MAX_LOGGED_CHANGES 64          // 통계에 기록하는 Level 변경 수 최대값
+
+// enum 선언
+
+typedef enum {
+    ADAPT_MODE_DEADLINE,      // 마감 시간 안에 끝나는 가장 높은 Level
+    ADAPT_MODE_OUTPUT         // 쓰기 속도에 맞춘 Level (I/O 병목이면 올리고 CPU 병목이면 내림)
+} AdaptMode;
+
+// 구조체 선언
+
+typedef struct ADAPT_Change_s ADAPT_Change_t;
+typedef struct ADAPT_Context_s ADAPT_Context_t;
+
+/*
+ * Level 변경 기록 하나
+ */
+struct ADAPT_Change_s {
+    ULONGLONG inputOffset;    // 바꾼 시점까지 압축한 원본 크기
+    DWORD elapsedMillis;      // 바꾼 시각 (시작 기준, ms)
+    int level;                // 새 Level
+    double speed;             // 바꾸기 직전 구간의 처리 속도 (bytes/s)
+    DWORD waitPercent;        // 직전 Level 을 쓰는 동안 쓰기를 기다린 시간의 비율 (%)
+    DWORD pendingPercent;     // 직전 Level 을 쓰는 동안 끝나지 않은 쓰기 수 평균 (최대값 대비 %)
+};
+
+struct ADAPT_Stats_s { // ADAPT_Stats_t (compressor.h 에서 선언)
+    int startLevel;           // 처음 Level
+    int finalLevel;           // 마지막 Level
+    int minLevel;             // 사용한 가장 낮은 Level
+    int maxLevel;             // 사용한 가장 높은 Level
+    DWORD levelChanges;       // Level 을 바꾼 횟수
+    DWORD elapsedMillis;      // 압축에 걸린 시간 (ms)
+    BOOL bMetDeadline;        // 마감 시간 안에 끝났는지 여부 (ADAPT_MODE_DEADLINE)
+    ULONGLONG waitMicros;     // 쓰기를 기다린 총 시간 (us)
+    DWORD loggedChanges;      // changes 에 기록한 수 (levelChanges 와 ADAPT_MAX_LOGGED_CHANGES 중 작은 값)
+    ADAPT_Change_t changes[ADAPT_MAX_LOGGED_CHANGES]; // Level 변경 기록 (앞에서부터)
+};
+
+struct ADAPT_Context_s {
+    AdaptMode mode;           // 조절 방식
+    const int* levels;        // 낮은 (빠른) 것부터 높은 (느린) 순서의 Level 목록 (알고리듬별)
+    int levelCount;           // Level 목록 크기
+    int index;                // 지금 Level 의 위치
+    int minIndex;             // 내려갈 수 있는 가장 낮은 위치
+    double speed[ADAPT_MAX_LEVELS]; // Level 별로 잰 속도의 이동 평균 (bytes/s, 0 이면 잰 적 없음)
+
+    ULONGLONG totalBytes;     // 압축할 전체 원본 크기
+    ULONGLONG doneBytes;      // 지금까지 압축한 원본 크기
+    ULONGLONG deadlineMicros; // 시작부터 마감까지의 시간 (us)
+    ULONGLONG startMicros;    // 시작 시각 (us)
+    ULONGLONG intervalBytes;  // 이번 구간에 압축한 원본 크기
+    ULONGLONG intervalStartMicros; // 이번 구간의 시작 시각 (us)
+    ULONGLONG windowStartMicros;   // 마지막으로 Level 을 바꾼 시각 (us)
+    ULONGLONG windowWaitMicros;    // 마지막으로 Level 을 바꾼 뒤 쓰기를 기다린 시간 (us)
+    double windowPending;     // 마지막으로 Level 을 바꾼 뒤 끝나지 않은 쓰기 수 비율의 합
+    DWORD windowSamples;      // windowPending 에 더한 수
+    DWORD windowIntervals;    // 마지막으로 Level 을 바꾼 뒤 지난 구간 수
+
+    ADAPT_Stats_t stats;      // 통계
+};
+
+// 함수 선언
+
+ADAPT_Context_t* adapt_create(CompressionAlgorithm algorithm, AdaptMode mode, ULONGLONG totalBytes, DWORD deadlineMillis);
+void adapt_free(ADAPT_Context_t* adapt);
+int adapt_level(const ADAPT_Context_t* adapt);
+void adapt_add_wait(ADAPT_Context_t* adapt, ULONGLONG waitMicros, DWORD pendingWrites, DWORD maxPendingWrites);
+BOOL adapt_update(ADAPT_Context_t* adapt, size_t bytes);
+void adapt_finish(ADAPT_Context_t* adapt, ADAPT_Stats_t* stats);
+
+#endif // ADAPT_H
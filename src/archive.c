@@ -0,0 +1,822 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits.h>
+
+#include "archive.h"
+#include "asyncio_win.h"
+#include "crc32c.h"
+#include "utility.h"
+
+// Archive Block 압축 옵션 설정 (각 Block 은 독립된 Frame)
+static const LZ4F_preferences_t kArchivePrefs = {
+    {
+        LZ4F_max64KB,
+        LZ4F_blockLinked,
+        LZ4F_noContentChecksum,
+        LZ4F_frame,
+        0, // Unknown size of uncompressed content
+        0, // No dictionary ID
+        LZ4F_noBlockChecksum
+    }, // Frame info
+    0, // Compression level. Default 는 0
+    0, // Auto flush
+    0, // Favor decompression speed
+    { 0, 0, 0 },  // reserved. 0 으로 설정해야함
+};
+
+/**
+ * @brief 이름 Hash 계산 (FNV-1a, 32 bit)
+ *
+ * @param name 이름
+ * @param length 이름 길이
+ * @return Hash 값
+ */
+static DWORD archive_hash_name(const TCHAR* name, size_t length) {
+    DWORD hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (BYTE)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* ---------- Writer ---------- */
+
+/**
+ * @brief 진행 중인 쓰기 작업의 완료를 기다립니다.
+ *
+ * @param writer Archive Writer
+ * @return 쓰기 작업 성공 여부
+ */
+static BOOL archive_wait_write(ARCHIVE_Writer_t* writer) {
+    DWORD dwBytesWritten;
+
+    if (!writer->bWritePending) {
+        return TRUE;
+    }
+
+    writer->bWritePending = FALSE;
+    if (!GetOverlappedResult(writer->hOutput, &(writer->writeOverlap), &dwBytesWritten, TRUE)) {
+        log_message("Archive - write completion failed.");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 압축 결과 버퍼를 필요한 크기 이상으로 확보합니다.
+ *
+ * 진행 중인 쓰기 작업이 버퍼를 참조하고 있을 수 있으므로, 재할당 전에 완료를 기다립니다.
+ */
+static BOOL archive_reserve_dst(ARCHIVE_Writer_t* writer, size_t rawSize) {
+    size_t const bound = (writer->algorithm == LZ4)
+        ? LZ4F_compressFrameBound(rawSize, &kArchivePrefs)
+        : ZSTD_compressBound(rawSize);
+
+    if (bound <= writer->dstBufMaxSize) {
+        return TRUE;
+    }
+
+    if (!archive_wait_write(writer)) {
+        return FALSE;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        LPVOID newBuf = realloc(writer->dstBuf[i], bound);
+        if (newBuf == NULL) {
+            return FALSE;
+        }
+        writer->dstBuf[i] = newBuf;
+    }
+    writer->dstBufMaxSize = bound;
+    return TRUE;
+}
+
+/**
+ * @brief 원본 데이터 하나를 Block (완결된 Frame) 으로 압축하여 Non-Blocking 방식으로 씁니다.
+ *
+ * 압축은 비어 있는 버퍼에 수행하고, 이전 Block 의 쓰기 작업은 그동안 진행됩니다.
+ *
+ * @param writer Archive Writer
+ * @param src 원본 데이터
+ * @param srcSize 원본 데이터 크기
+ * @param pCompressedSize 압축된 Block 크기
+ * @return 성공 여부
+ */
+static BOOL archive_emit_block(ARCHIVE_Writer_t* writer, const void* src, size_t srcSize, DWORD* pCompressedSize) {
+    DWORD dwBytesWritten;
+
+    if (!archive_reserve_dst(writer, srcSize)) {
+        log_message("Archive - failed to allocate block buffer.");
+        return FALSE;
+    }
+
+    LPVOID dst = writer->dstBuf[writer->dstIndex];
+    size_t compressedSize;
+    if (writer->algorithm == LZ4) {
+        compressedSize = LZ4F_compressFrame_usingCDict(
+            writer->lz4CctxPtr, dst, writer->dstBufMaxSize,
+            src, srcSize, NULL, &kArchivePrefs
+        );
+        if (LZ4F_isError(compressedSize)) {
+            log_message("Archive - LZ4 block compression failed.");
+            return FALSE;
+        }
+    } else {
+        compressedSize = ZSTD_compress2(writer->zstdCctxPtr, dst, writer->dstBufMaxSize, src, srcSize);
+        if (ZSTD_isError(compressedSize)) {
+            log_message("Archive - ZSTD block compression failed.");
+            return FALSE;
+        }
+    }
+
+    // 이전 Block 쓰기 완료 확인 후, 이번 Block 쓰기 요청
+    if (!archive_wait_write(writer)) {
+        return FALSE;
+    }
+
+    async_set_offset(&(writer->writeOverlap), writer->fileOffset);
+    if (!async_write(writer->hOutput, dst, (DWORD)compressedSize, &dwBytesWritten, &(writer->writeOverlap), FALSE)) {
+        return FALSE;
+    }
+
+    writer->bWritePending = TRUE;
+    writer->fileOffset += compressedSize;
+    writer->dstIndex ^= 1;
+
+    *pCompressedSize = (DWORD)compressedSize;
+    return TRUE;
+}
+
+/**
+ * @brief 채워진 Solid Block (또는 단일 멤버) 을 압축하여 쓰고, 대기 중인 멤버의 Block 정보를 확정합니다.
+ */
+static BOOL archive_flush_block(ARCHIVE_Writer_t* writer) {
+    DWORD compressedSize;
+    ULONGLONG const blockOffset = writer->fileOffset;
+
+    if (writer->firstPendingEntry == writer->entryCount) {
+        return TRUE; // 대기 중인 멤버 없음
+    }
+
+    if (!archive_emit_block(writer, writer->rawBuf, writer->rawBufUsed, &compressedSize)) {
+        return FALSE;
+    }
+
+    for (DWORD i = writer->firstPendingEntry; i < writer->entryCount; i++) {
+        writer->entries[i].blockOffset = blockOffset;
+        writer->entries[i].blockCompressedSize = compressedSize;
+        writer->entries[i].blockRawSize = (DWORD)writer->rawBufUsed;
+    }
+
+    writer->firstPendingEntry = writer->entryCount;
+    writer->rawBufUsed = 0;
+    return TRUE;
+}
+
+/**
+ * @brief 원본 버퍼를 필요한 크기 이상으로 확보합니다.
+ */
+static BOOL archive_reserve_raw(ARCHIVE_Writer_t* writer, size_t size) {
+    if (size <= writer->rawBufMaxSize) {
+        return TRUE;
+    }
+
+    LPVOID newBuf = realloc(writer->rawBuf, size);
+    if (newBuf == NULL) {
+        log_message("Archive - failed to allocate member buffer.");
+        return FALSE;
+    }
+
+    writer->rawBuf = newBuf;
+    writer->rawBufMaxSize = size;
+    return TRUE;
+}
+
+/**
+ * @brief 이미 추가된 멤버 중 같은 이름이 있는지 확인합니다. (Reader 와 같은 Hash Bucket 탐색)
+ */
+static BOOL archive_name_exists(const ARCHIVE_Writer_t* writer, const TCHAR* name, size_t nameLength, DWORD hash) {
+    if (writer->nameBucketCount == 0) {
+        return FALSE;
+    }
+
+    DWORD const mask = writer->nameBucketCount - 1;
+    for (DWORD slot = hash & mask; writer->nameBuckets[slot] != 0; slot = (slot + 1) & mask) {
+        const ARCHIVE_Entry_t* const entry = &(writer->entries[writer->nameBuckets[slot] - 1]);
+        if (entry->nameHash == hash && entry->nameLength == nameLength &&
+            memcmp(writer->namePool + entry->nameOffset, name, nameLength) == 0) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief 마지막으로 추가한 멤버를 중복 이름 검사용 Hash Bucket 에 등록합니다.
+ *
+ * 멤버 데이터를 모두 채운 뒤에만 등록하므로, 실패하여 취소한 멤버는 Bucket 에 남지 않습니다.
+ */
+static BOOL archive_commit_name(ARCHIVE_Writer_t* writer) {
+    // 사용률이 1/2 을 넘으면 두 배로 늘리고 모든 멤버를 다시 등록
+    if ((ULONGLONG)writer->entryCount * 2 > writer->nameBucketCount) {
+        DWORD newCount = writer->nameBucketCount ? writer->nameBucketCount * 2 : 256;
+        DWORD* newBuckets = (DWORD*)calloc(newCount, sizeof(DWORD));
+        if (newBuckets == NULL) {
+            return FALSE;
+        }
+        for (DWORD i = 0; i + 1 < writer->entryCount; i++) {
+            DWORD slot = writer->entries[i].nameHash & (newCount - 1);
+            while (newBuckets[slot] != 0) {
+                slot = (slot + 1) & (newCount - 1);
+            }
+            newBuckets[slot] = i + 1;
+        }
+        free(writer->nameBuckets);
+        writer->nameBuckets = newBuckets;
+        writer->nameBucketCount = newCount;
+    }
+
+    DWORD const mask = writer->nameBucketCount - 1;
+    DWORD slot = writer->entries[writer->entryCount - 1].nameHash & mask;
+    while (writer->nameBuckets[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    writer->nameBuckets[slot] = writer->entryCount;
+    return TRUE;
+}
+
+/**
+ * @brief 멤버 목록에 새 멤버를 추가합니다. (Block 정보는 Block 을 쓸 때 확정)
+ */
+static BOOL archive_push_entry(ARCHIVE_Writer_t* writer, const TCHAR* name, size_t size) {
+    size_t const nameLength = strlen(name);
+    if (nameLength == 0 || nameLength > 0xFFFF || size > 0xFFFFFFFFu) {
+        log_message("Archive - invalid member name or size.");
+        return FALSE;
+    }
+
+    DWORD const hash = archive_hash_name(name, nameLength);
+    if (archive_name_exists(writer, name, nameLength, hash)) {
+        log_message("Archive - duplicate member name.");
+        return FALSE;
+    }
+
+    if (writer->entryCount == writer->entryMaxCount) {
+        DWORD const newCount = writer->entryMaxCount ? writer->entryMaxCount * 2 : 256;
+        ARCHIVE_Entry_t* newEntries = (ARCHIVE_Entry_t*)realloc(writer->entries, newCount * sizeof(ARCHIVE_Entry_t));
+        if (newEntries == NULL) {
+            return FALSE;
+        }
+        writer->entries = newEntries;
+        writer->entryMaxCount = newCount;
+    }
+
+    while (writer->namePoolSize + nameLength > writer->namePoolMaxSize) {
+        DWORD const newSize = writer->namePoolMaxSize ? writer->namePoolMaxSize * 2 : 4096;
+        TCHAR* newPool = (TCHAR*)realloc(writer->namePool, newSize);
+        if (newPool == NULL) {
+            return FALSE;
+        }
+        writer->namePool = newPool;
+        writer->namePoolMaxSize = newSize;
+    }
+
+    ARCHIVE_Entry_t* entry = &(writer->entries[writer->entryCount]);
+    memset(entry, 0, sizeof(ARCHIVE_Entry_t));
+    entry->nameHash = hash;
+    entry->nameOffset = writer->namePoolSize;
+    entry->nameLength = (WORD)nameLength;
+    entry->memberOffset = (DWORD)writer->rawBufUsed;
+    entry->memberSize = (DWORD)size;
+
+    memcpy(writer->namePool + writer->namePoolSize, name, nameLength);
+    writer->namePoolSize += (DWORD)nameLength;
+    writer->entryCount++;
+    return TRUE;
+}
+
+/**
+ * @brief 멤버를 추가할 원본 버퍼 공간을 준비합니다.
+ *
+ * Solid 모드에서는 현재 Block 에 들어가지 않으면 Block 을 먼저 씁니다.
+ * Solid Block 보다 큰 멤버와 Independent 모드의 멤버는 단독 Block 이 됩니다.
+ *
+ * @return 멤버 데이터를 채울 위치 (실패 시 NULL)
+ */
+static BYTE* archive_begin_member(ARCHIVE_Writer_t* writer, const TCHAR* name, size_t size) {
+    BOOL const bSolid = (writer->mode == ARCHIVE_SOLID) && (size <= writer->solidBlockSize);
+
+    if (!bSolid || writer->rawBufUsed + size > writer->solidBlockSize) {
+        if (!archive_flush_block(writer)) {
+            return NULL;
+        }
+    }
+
+    if (!archive_reserve_raw(writer, writer->rawBufUsed + size) ||
+        !archive_push_entry(writer, name, size)) {
+        return NULL;
+    }
+
+    BYTE* const dst = (BYTE*)writer->rawBuf + writer->rawBufUsed;
+    writer->rawBufUsed += size;
+    return dst;
+}
+
+/**
+ * @brief archive_begin_member 로 시작한 마지막 멤버를 취소합니다. (멤버 목록, 이름, 원본 버퍼를 되돌림)
+ */
+static void archive_cancel_member(ARCHIVE_Writer_t* writer) {
+    const ARCHIVE_Entry_t* const entry = &(writer->entries[writer->entryCount - 1]);
+    writer->rawBufUsed -= entry->memberSize;
+    writer->namePoolSize -= entry->nameLength;
+    writer->entryCount--;
+}
+
+/**
+ * @brief 멤버 추가를 마무리합니다. (이름을 등록하고, 단독 Block 이면 바로 씁니다)
+ */
+static BOOL archive_end_member(ARCHIVE_Writer_t* writer) {
+    if (!archive_commit_name(writer)) {
+        archive_cancel_member(writer);
+        return FALSE;
+    }
+
+    if (writer->mode == ARCHIVE_SOLID && writer->rawBufUsed <= writer->solidBlockSize) {
+        return TRUE;
+    }
+    return archive_flush_block(writer);
+}
+
+/**
+ * @brief Archive Writer 의 자원을 정리합니다.
+ */
+static void archive_writer_free(ARCHIVE_Writer_t* writer) {
+    if (writer == NULL) {
+        return;
+    }
+
+    if (writer->hOutput != INVALID_HANDLE_VALUE) {
+        archive_wait_write(writer);
+        CloseHandle(writer->hOutput);
+    }
+
+    LZ4F_freeCompressionContext(writer->lz4CctxPtr);
+    ZSTD_freeCCtx(writer->zstdCctxPtr);
+    free(writer->rawBuf);
+    free(writer->dstBuf[0]);
+    free(writer->dstBuf[1]);
+    free(writer->entries);
+    free(writer->namePool);
+    free(writer->nameBuckets);
+    free(writer);
+}
+
+/**
+ * @brief Archive 파일을 생성하고 Writer 를 초기화합니다.
+ *
+ * @param archivePath 생성할 Archive 파일 경로
+ * @param algorithm 압축 알고리듬
+ * @param mode Block 구성 방식 (Independent / Solid)
+ * @param solidBlockSize Solid Block 크기 (0 이면 ARCHIVE_SOLID_BLOCK_DEFAULT)
+ * @return Archive Writer (실패 시 NULL)
+ */
+ARCHIVE_Writer_t* archive_writer_open(
+    const TCHAR* archivePath, CompressionAlgorithm algorithm,
+    ArchiveMode mode, size_t solidBlockSize
+) {
+    ARCHIVE_Writer_t* writer = (ARCHIVE_Writer_t*)calloc(1, sizeof(ARCHIVE_Writer_t));
+    if (writer == NULL) {
+        return NULL;
+    }
+
+    writer->algorithm = algorithm;
+    writer->mode = mode;
+    writer->solidBlockSize = solidBlockSize ? solidBlockSize : ARCHIVE_SOLID_BLOCK_DEFAULT;
+    writer->hOutput = init_file_write(archivePath);
+
+    BOOL bResult = (writer->hOutput != INVALID_HANDLE_VALUE);
+    if (bResult && algorithm == LZ4) {
+        bResult = !LZ4F_isError(LZ4F_createCompressionContext(&(writer->lz4CctxPtr), LZ4F_VERSION));
+    } else if (bResult && algorithm == ZSTD) {
+        writer->zstdCctxPtr = ZSTD_createCCtx();
+        bResult = (writer->zstdCctxPtr != NULL) &&
+            !ZSTD_isError(ZSTD_CCtx_setParameter(writer->zstdCctxPtr, ZSTD_c_compressionLevel, ZSTD_fast));
+    } else {
+        bResult = FALSE;
+    }
+
+    if (bResult && mode == ARCHIVE_SOLID) {
+        bResult = archive_reserve_raw(writer, writer->solidBlockSize) &&
+            archive_reserve_dst(writer, writer->solidBlockSize);
+    }
+
+    if (bResult) {
+        return writer;
+    }
+
+    log_message("Failed to open archive for writing.");
+    archive_writer_free(writer);
+    return NULL;
+}
+
+/**
+ * @brief 메모리에 있는 데이터를 멤버로 추가합니다.
+ *
+ * @param writer Archive Writer
+ * @param name 멤버 이름 (Archive 내에서 고유해야 하며, 이미 있는 이름이면 실패)
+ * @param data 멤버 데이터
+ * @param size 멤버 데이터 크기
+ * @return 성공 여부
+ */
+BOOL archive_writer_add_buffer(ARCHIVE_Writer_t* writer, const TCHAR* name, const void* data, size_t size) {
+    BYTE* const dst = archive_begin_member(writer, name, size);
+    if (dst == NULL) {
+        return FALSE;
+    }
+
+    memcpy(dst, data, size);
+    return archive_end_member(writer);
+}
+
+/**
+ * @brief 파일을 멤버로 추가합니다.
+ *
+ * 파일 내용은 별도 버퍼를 거치지 않고 Solid Block (또는 단독 Block) 원본 버퍼로 바로 읽습니다.
+ *
+ * @param writer Archive Writer
+ * @param name 멤버 이름 (Archive 내에서 고유해야 하며, 이미 있는 이름이면 실패)
+ * @param filePath 추가할 파일 경로
+ * @return 성공 여부
+ */
+BOOL archive_writer_add_file(ARCHIVE_Writer_t* writer, const TCHAR* name, const TCHAR* filePath) {
+    HANDLE hInput = init_file_read(filePath);
+    if (hInput == INVALID_HANDLE_VALUE) {
+        return FALSE;
+    }
+
+    DWORD const dwFileSize = get_file_size(hInput);
+    BYTE* const dst = archive_begin_member(writer, name, dwFileSize);
+    if (dst == NULL) {
+        CloseHandle(hInput);
+        return FALSE;
+    }
+    BOOL bResult = TRUE;
+
+    OVERLAPPED readOverlap = { 0, };
+    DWORD dwTotalRead = 0;
+    while (bResult && dwTotalRead < dwFileSize) {
+        DWORD dwBytesRead = 0;
+        bResult = async_read(
+            hInput, dst + dwTotalRead, dwFileSize - dwTotalRead,
+            &dwBytesRead, &readOverlap, TRUE
+        );
+        if (dwBytesRead == 0) {
+            bResult = FALSE; // 파일 크기보다 일찍 EOF 도달
+        }
+        dwTotalRead += dwBytesRead;
+        async_set_offset(&readOverlap, dwTotalRead);
+    }
+
+    CloseHandle(hInput);
+
+    if (!bResult) {
+        log_message("Archive - failed to read member file.");
+        archive_cancel_member(writer); // 일부만 채워진 멤버가 Index 에 남지 않도록 되돌림
+        return FALSE;
+    }
+
+    return archive_end_member(writer);
+}
+
+/**
+ * @brief 남은 Block 과 Index, Footer 를 쓰고 Archive 를 닫습니다.
+ *
+ * 성공 여부와 관계없이 Writer 의 자원은 해제됩니다.
+ *
+ * @param writer Archive Writer
+ * @return 성공 여부
+ */
+BOOL archive_writer_close(ARCHIVE_Writer_t* writer) {
+    DWORD dwBytesWritten;
+
+    BOOL bResult = archive_flush_block(writer) && archive_wait_write(writer);
+
+    // Hash Bucket 수는 멤버 수의 2 배 이상인 2 의 거듭제곱 (Load factor <= 0.5)
+    DWORD bucketCount = 16;
+    while (bucketCount < writer->entryCount * 2) {
+        bucketCount <<= 1;
+    }
+
+    size_t const entriesSize = (size_t)writer->entryCount * ARCHIVE_ENTRY_SIZE;
+    size_t const bucketsSize = (size_t)bucketCount * ARCHIVE_BUCKET_SIZE;
+    size_t const indexSize = entriesSize + bucketsSize + writer->namePoolSize;
+    BYTE* const index = (BYTE*)calloc(1, indexSize + ARCHIVE_FOOTER_SIZE);
+    bResult = bResult && (index != NULL);
+
+    if (bResult) {
+        BYTE* const buckets = index + entriesSize;
+
+        for (DWORD i = 0; i < writer->entryCount; i++) {
+            const ARCHIVE_Entry_t* entry = &(writer->entries[i]);
+            BYTE* const p = index + (size_t)i * ARCHIVE_ENTRY_SIZE;
+            write_le32(p + 0, entry->nameHash);
+            write_le32(p + 4, entry->nameOffset);
+            write_le16(p + 8, entry->nameLength);
+            write_le16(p + 10, 0); // reserved
+            write_le64(p + 12, entry->blockOffset);
+            write_le32(p + 20, entry->blockCompressedSize);
+            write_le32(p + 24, entry->blockRawSize);
+            write_le32(p + 28, entry->memberOffset);
+            write_le32(p + 32, entry->memberSize);
+
+            // Linear probing
+            DWORD slot = entry->nameHash & (bucketCount - 1);
+            while (read_le32(buckets + slot * ARCHIVE_BUCKET_SIZE) != 0) {
+                slot = (slot + 1) & (bucketCount - 1);
+            }
+            write_le32(buckets + slot * ARCHIVE_BUCKET_SIZE, i + 1);
+        }
+
+        memcpy(index + entriesSize + bucketsSize, writer->namePool, writer->namePoolSize);
+
+        BYTE* const footer = index + indexSize;
+        write_le32(footer + 0, ARCHIVE_MAGIC);
+        write_le16(footer + 4, ARCHIVE_VERSION);
+        footer[6] = (BYTE)writer->algorithm;
+        footer[7] = (BYTE)writer->mode;
+        write_le32(footer + 8, writer->entryCount);
+        write_le32(footer + 12, bucketCount);
+        write_le64(footer + 16, writer->fileOffset);
+        write_le32(footer + 24, (DWORD)indexSize);
+        write_le32(footer + 28, crc32c(0, index, indexSize)); // Index 의 CRC32C
+
+        async_set_offset(&(writer->writeOverlap), writer->fileOffset);
+        bResult = async_write(
+            writer->hOutput, index, (DWORD)(indexSize + ARCHIVE_FOOTER_SIZE),
+            &dwBytesWritten, &(writer->writeOverlap), TRUE
+        );
+    }
+
+    if (!bResult) {
+        log_message("Failed to finalize archive.");
+    }
+
+    free(index);
+    archive_writer_free(writer);
+    return bResult;
+}
+
+/* ---------- Reader ---------- */
+
+/**
+ * @brief 파일의 지정한 위치에서 정확히 지정한 크기만큼 읽습니다.
+ */
+static BOOL archive_read_at(HANDLE hFile, ULONGLONG offset, void* buffer, DWORD size) {
+    OVERLAPPED readOverlap = { 0, };
+    DWORD dwTotalRead = 0;
+
+    while (dwTotalRead < size) {
+        DWORD dwBytesRead = 0;
+        async_set_offset(&readOverlap, offset + dwTotalRead);
+        if (!async_read(hFile, (BYTE*)buffer + dwTotalRead, size - dwTotalRead, &dwBytesRead, &readOverlap, TRUE) ||
+            dwBytesRead == 0) {
+            return FALSE;
+        }
+        dwTotalRead += dwBytesRead;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Index 영역의 i 번째 Entry 를 읽습니다.
+ */
+static void archive_load_entry(const ARCHIVE_Reader_t* reader, DWORD i, ARCHIVE_Entry_t* entry) {
+    const BYTE* const p = reader->index + (size_t)i * ARCHIVE_ENTRY_SIZE;
+    entry->nameHash = read_le32(p + 0);
+    entry->nameOffset = read_le32(p + 4);
+    entry->nameLength = read_le16(p + 8);
+    entry->blockOffset = read_le64(p + 12);
+    entry->blockCompressedSize = read_le32(p + 20);
+    entry->blockRawSize = read_le32(p + 24);
+    entry->memberOffset = read_le32(p + 28);
+    entry->memberSize = read_le32(p + 32);
+}
+
+/**
+ * @brief Archive Reader 의 자원을 정리합니다.
+ *
+ * @param reader Archive Reader
+ */
+void archive_reader_close(ARCHIVE_Reader_t* reader) {
+    if (reader == NULL) {
+        return;
+    }
+
+    if (reader->hInput != INVALID_HANDLE_VALUE) {
+        CloseHandle(reader->hInput);
+    }
+
+    free_decompressor(reader->decomp);
+    free(reader->index);
+    free(reader->srcBuf);
+    free(reader->blockBuf);
+    free(reader);
+}
+
+/**
+ * @brief Archive 파일을 열고 Footer 와 Index 를 읽습니다.
+ *
+ * Block 영역은 읽지 않으므로, 여는 비용은 멤버 수에만 비례합니다.
+ *
+ * @param archivePath 읽을 Archive 파일 경로
+ * @return Archive Reader (실패 시 NULL)
+ */
+ARCHIVE_Reader_t* archive_reader_open(const TCHAR* archivePath) {
+    BYTE footer[ARCHIVE_FOOTER_SIZE];
+    LARGE_INTEGER fileSize;
+
+    ARCHIVE_Reader_t* reader = (ARCHIVE_Reader_t*)calloc(1, sizeof(ARCHIVE_Reader_t));
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    reader->cachedBlockOffset = ULLONG_MAX;
+    reader->hInput = init_file_read(archivePath);
+
+    BOOL bResult = (reader->hInput != INVALID_HANDLE_VALUE) &&
+        GetFileSizeEx(reader->hInput, &fileSize) &&
+        fileSize.QuadPart >= ARCHIVE_FOOTER_SIZE &&
+        archive_read_at(reader->hInput, (ULONGLONG)fileSize.QuadPart - ARCHIVE_FOOTER_SIZE, footer, ARCHIVE_FOOTER_SIZE) &&
+        read_le32(footer + 0) == ARCHIVE_MAGIC &&
+        read_le16(footer + 4) >= ARCHIVE_VERSION_MIN && read_le16(footer + 4) <= ARCHIVE_VERSION &&
+        footer[6] < ALGORITHM_COUNT;
+
+    if (bResult) {
+        reader->algorithm = (CompressionAlgorithm)footer[6];
+        reader->entryCount = read_le32(footer + 8);
+        reader->bucketCount = read_le32(footer + 12);
+
+        ULONGLONG const indexOffset = read_le64(footer + 16);
+        DWORD const indexSize = read_le32(footer + 24);
+        size_t const fixedSize = (size_t)reader->entryCount * ARCHIVE_ENTRY_SIZE + (size_t)reader->bucketCount * ARCHIVE_BUCKET_SIZE;
+
+        bResult = (indexOffset + indexSize + ARCHIVE_FOOTER_SIZE == (ULONGLONG)fileSize.QuadPart) &&
+            (reader->bucketCount != 0) && ((reader->bucketCount & (reader->bucketCount - 1)) == 0) &&
+            (fixedSize <= indexSize);
+
+        if (bResult) {
+            reader->index = (BYTE*)malloc(indexSize ? indexSize : 1);
+            bResult = (reader->index != NULL) &&
+                archive_read_at(reader->hInput, indexOffset, reader->index, indexSize);
+        }
+
+        // Version 1 은 Index Checksum 이 없음
+        if (bResult && read_le16(footer + 4) >= 2 && crc32c(0, reader->index, indexSize) != read_le32(footer + 28)) {
+            log_message("Archive index checksum mismatch.");
+            bResult = FALSE;
+        }
+
+        if (bResult) {
+            reader->buckets = reader->index + (size_t)reader->entryCount * ARCHIVE_ENTRY_SIZE;
+            reader->namePool = (const TCHAR*)(reader->index + fixedSize);
+            reader->namePoolSize = (DWORD)(indexSize - fixedSize);
+            bResult = create_decompressor(&(reader->decomp), reader->algorithm);
+        }
+    }
+
+    if (bResult) {
+        return reader;
+    }
+
+    log_message("Failed to open archive for reading.");
+    archive_reader_close(reader);
+    return NULL;
+}
+
+/**
+ * @brief Archive 의 멤버 수를 반환합니다.
+ */
+DWORD archive_reader_count(const ARCHIVE_Reader_t* reader) {
+    return reader->entryCount;
+}
+
+/**
+ * @brief 이름으로 멤버를 찾습니다. (Hash Bucket 을 통한 O(1) 탐색)
+ *
+ * @param reader Archive Reader
+ * @param name 찾을 멤버 이름
+ * @param entry 찾은 멤버 정보
+ * @return 찾으면 TRUE, 없으면 FALSE
+ */
+BOOL archive_reader_find(const ARCHIVE_Reader_t* reader, const TCHAR* name, ARCHIVE_Entry_t* entry) {
+    size_t const nameLength = strlen(name);
+    DWORD const hash = archive_hash_name(name, nameLength);
+    DWORD const mask = reader->bucketCount - 1;
+
+    for (DWORD probe = 0, slot = hash & mask; probe < reader->bucketCount; probe++, slot = (slot + 1) & mask) {
+        DWORD const value = read_le32(reader->buckets + slot * ARCHIVE_BUCKET_SIZE);
+        if (value == 0 || value > reader->entryCount) {
+            return FALSE; // 빈 칸에 도달하면 없는 이름
+        }
+
+        archive_load_entry(reader, value - 1, entry);
+        if (entry->nameHash == hash && entry->nameLength == nameLength &&
+            (ULONGLONG)entry->nameOffset + entry->nameLength <= reader->namePoolSize &&
+            memcmp(reader->namePool + entry->nameOffset, name, nameLength) == 0) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief 버퍼를 필요한 크기 이상으로 확보합니다.
+ */
+static BOOL archive_reserve_buffer(LPVOID* buffer, size_t* maxSize, size_t size) {
+    if (size <= *maxSize) {
+        return TRUE;
+    }
+
+    LPVOID newBuf = realloc(*buffer, size ? size : 1);
+    if (newBuf == NULL) {
+        return FALSE;
+    }
+
+    *buffer = newBuf;
+    *maxSize = size;
+    return TRUE;
+}
+
+/**
+ * @brief 멤버 하나를 추출합니다.
+ *
+ * 멤버가 속한 Block 하나만 읽어 압축 해제하며, 마지막으로 압축 해제한 Block 은 Cache 하여
+ * 같은 Solid Block 의 멤버를 연속으로 추출할 때 다시 압축 해제하지 않습니다.
+ *
+ * @param reader Archive Reader
+ * @param name 추출할 멤버 이름
+ * @param dst 멤버 데이터를 저장할 버퍼
+ * @param dstCapacity dst 버퍼 크기
+ * @param pSize 멤버 데이터 크기
+ * @return 성공 여부
+ */
+BOOL archive_reader_extract(
+    ARCHIVE_Reader_t* reader, const TCHAR* name,
+    void* dst, size_t dstCapacity, size_t* pSize
+) {
+    ARCHIVE_Entry_t entry;
+    size_t decodedSize;
+
+    *pSize = 0;
+
+    if (!archive_reader_find(reader, name, &entry)) {
+        return FALSE;
+    }
+
+    if ((ULONGLONG)entry.memberOffset + entry.memberSize > entry.blockRawSize || entry.memberSize > dstCapacity) {
+        log_message("Archive - invalid entry or destination too small.");
+        return FALSE;
+    }
+
+    if (reader->cachedBlockOffset != entry.blockOffset) {
+        reader->cachedBlockOffset = ULLONG_MAX;
+
+        if (!archive_reserve_buffer(&(reader->srcBuf), &(reader->srcBufMaxSize), entry.blockCompressedSize) ||
+            !archive_reserve_buffer(&(reader->blockBuf), &(reader->blockBufMaxSize), entry.blockRawSize)) {
+            log_message("Archive - failed to allocate block buffer.");
+            return FALSE;
+        }
+
+        if (!archive_read_at(reader->hInput, entry.blockOffset, reader->srcBuf, entry.blockCompressedSize) ||
+            !decompress_buffer(reader->decomp, reader->srcBuf, entry.blockCompressedSize,
+                               reader->blockBuf, entry.blockRawSize, &decodedSize) ||
+            decodedSize != entry.blockRawSize) {
+            log_message("Archive - failed to decode block.");
+            return FALSE;
+        }
+
+        reader->cachedBlockOffset = entry.blockOffset;
+    }
+
+    memcpy(dst, (const BYTE*)reader->blockBuf + entry.memberOffset, entry.memberSize);
+    *pSize = entry.memberSize;
+    return TRUE;
+}
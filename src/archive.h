@@ -0,0 +1,137 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <windows.h>
+
+#include "compressor.h"
+#include "decompressor.h"
+
+/*
+ * Archive 파일 구조 (모든 정수는 Little Endian)
+ *
+ *   [Block 0][Block 1]...[Block N-1]      각 Block 은 완결된 LZ4/ZSTD Frame 하나
+ *   [Entry 0]...[Entry M-1]               멤버별 위치 정보 (ARCHIVE_ENTRY_SIZE bytes)
+ *   [Bucket 0]...[Bucket B-1]             이름 Hash -> (Entry 번호 + 1), 0 은 빈 칸
+ *   [Name Pool]                           멤버 이름 (널 종단자 없음)
+ *   [Footer]                              ARCHIVE_FOOTER_SIZE bytes, 파일 끝에 고정
+ *
+ * Footer 와 Index 만 읽으면 Block 을 순회하지 않고 O(1) 로 멤버를 찾을 수 있습니다.
+ * Footer 마지막 4 bytes 는 Index 의 CRC32C 이며, Reader 는 Index 를 읽은 직후 검증합니다.
+ */
+
+#define ARCHIVE_MAGIC           0x52414E53  // "SNAR"
+#define ARCHIVE_VERSION         2   // 2: Footer 에 Index 의 CRC32C 추가
+#define ARCHIVE_VERSION_MIN     1   // 읽을 수 있는 가장 낮은 Version
+#define ARCHIVE_FOOTER_SIZE     32
+#define ARCHIVE_ENTRY_SIZE      36
+#define ARCHIVE_BUCKET_SIZE     4
+#define ARCHIVE_SOLID_BLOCK_DEFAULT (1024 * 1024) // Solid Block 기본 크기 (1 MB)
+
+// enum 선언
+
+typedef enum {
+    ARCHIVE_INDEPENDENT,  // 멤버마다 독립된 Frame (단일 멤버 추출이 가장 빠름)
+    ARCHIVE_SOLID         // 여러 멤버를 하나의 Block 으로 묶어 압축 (압축률이 가장 좋음)
+} ArchiveMode;
+
+// 구조체 선언
+
+typedef struct ARCHIVE_Entry_s ARCHIVE_Entry_t;
+typedef struct ARCHIVE_Writer_s ARCHIVE_Writer_t;
+typedef struct ARCHIVE_Reader_s ARCHIVE_Reader_t;
+
+struct ARCHIVE_Entry_s {
+    DWORD nameHash;             // 이름 Hash (FNV-1a)
+    DWORD nameOffset;           // Name Pool 내 이름 위치
+    WORD nameLength;            // 이름 길이
+    ULONGLONG blockOffset;      // 멤버가 속한 Block 의 파일 내 위치
+    DWORD blockCompressedSize;  // Block 의 압축된 크기
+    DWORD blockRawSize;         // Block 의 원본 크기
+    DWORD memberOffset;         // Block 원본 내 멤버 위치
+    DWORD memberSize;           // 멤버 원본 크기
+};
+
+struct ARCHIVE_Writer_s {
+    HANDLE hOutput;                 // 출력 핸들
+    CompressionAlgorithm algorithm; // 압축 알고리듬
+    ArchiveMode mode;               // Block 구성 방식
+    LZ4F_cctx* lz4CctxPtr;          // LZ4F 압축 컨텍스트 포인터 (멤버 간 재사용)
+    ZSTD_CCtx* zstdCctxPtr;         // ZSTD 압축 컨텍스트 포인터 (멤버 간 재사용)
+
+    LPVOID rawBuf;                  // Solid Block 또는 단일 멤버 원본 버퍼
+    size_t rawBufMaxSize;           // 원본 버퍼의 최대 크기
+    size_t rawBufUsed;              // 원본 버퍼에 채워진 크기
+    size_t solidBlockSize;          // Solid Block 크기
+
+    LPVOID dstBuf[2];               // 압축 결과 버퍼 (쓰기와 압축을 겹치기 위한 Double Buffer)
+    size_t dstBufMaxSize;           // 압축 결과 버퍼의 최대 크기
+    int dstIndex;                   // 다음에 사용할 압축 결과 버퍼 번호
+    BOOL bWritePending;             // 완료를 기다리는 쓰기 작업 존재 여부
+    OVERLAPPED writeOverlap;        // Non-Blocking 쓰기 작업을 위한 OVERLAPPED 구조체
+    ULONGLONG fileOffset;           // 다음 쓰기 위치
+
+    ARCHIVE_Entry_t* entries;       // 멤버 목록
+    DWORD entryCount;               // 멤버 수
+    DWORD entryMaxCount;            // 멤버 목록 할당 크기
+    DWORD firstPendingEntry;        // 아직 Block 위치가 정해지지 않은 첫 멤버
+    TCHAR* namePool;                // 이름 저장 공간
+    DWORD namePoolSize;             // 이름 저장 공간 사용량
+    DWORD namePoolMaxSize;          // 이름 저장 공간 할당 크기
+    DWORD* nameBuckets;             // 중복 이름 검사용 Hash Bucket (Entry 번호 + 1, 0 은 빈 칸)
+    DWORD nameBucketCount;          // 중복 이름 검사용 Hash Bucket 수 (2 의 거듭제곱)
+};
+
+struct ARCHIVE_Reader_s {
+    HANDLE hInput;                  // 입력 핸들
+    CompressionAlgorithm algorithm; // 압축 알고리듬
+    DECOMP_Context_t* decomp;       // 압축 해제 컨텍스트
+    BYTE* index;                    // Index 영역 (Entry, Bucket, Name Pool)
+    DWORD entryCount;               // 멤버 수
+    DWORD bucketCount;              // Hash Bucket 수 (2 의 거듭제곱)
+    const BYTE* buckets;            // Hash Bucket 시작 위치
+    const TCHAR* namePool;          // Name Pool 시작 위치
+    DWORD namePoolSize;             // Name Pool 크기
+
+    LPVOID srcBuf;                  // 압축된 Block 버퍼
+    size_t srcBufMaxSize;           // 압축된 Block 버퍼의 최대 크기
+    LPVOID blockBuf;                // 압축 해제된 Block 버퍼 (마지막 Block 을 Cache)
+    size_t blockBufMaxSize;         // 압축 해제된 Block 버퍼의 최대 크기
+    ULONGLONG cachedBlockOffset;    // Cache 된 Block 의 위치 (없으면 ULLONG_MAX)
+};
+
+// 함수 선언
+
+ARCHIVE_Writer_t* archive_writer_open(
+    const TCHAR* archivePath, CompressionAlgorithm algorithm,
+    ArchiveMode mode, size_t solidBlockSize
+);
+BOOL archive_writer_add_buffer(ARCHIVE_Writer_t* writer, const TCHAR* name, const void* data, size_t size);
+BOOL archive_writer_add_file(ARCHIVE_Writer_t* writer, const TCHAR* name, const TCHAR* filePath);
+BOOL archive_writer_close(ARCHIVE_Writer_t* writer);
+
+ARCHIVE_Reader_t* archive_reader_open(const TCHAR* archivePath);
+DWORD archive_reader_count(const ARCHIVE_Reader_t* reader);
+BOOL archive_reader_find(const ARCHIVE_Reader_t* reader, const TCHAR* name, ARCHIVE_Entry_t* entry);
+BOOL archive_reader_extract(
+    ARCHIVE_Reader_t* reader, const TCHAR* name,
+    void* dst, size_t dstCapacity, size_t* pSize
+);
+void archive_reader_close(ARCHIVE_Reader_t* reader);
+
+#endif // ARCHIVE_H
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <malloc.h> // _aligned_malloc
+
 #include "asyncio_win.h"
 #include "utility.h"
 
@@ -26,7 +28,50 @@
  * @return HANDLE 읽기 작업을 위한 파일 핸들
  */
 HANDLE init_file_read(const TCHAR* filePath) {
-    HANDLE hFile = CreateFile(filePath, GENERIC_READ, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+    return init_file_read_ex(filePath, IO_CACHE_DEFAULT);
+}
+
+/**
+ * @brief 파일 쓰기 초기화
+ * 
+ * 주어진 파일 경로에 대해 파일을 쓰기 위해 파일을 엽니다.
+ * 
+ * @param filePath 쓸 파일 경로
+ * @return HANDLE 쓰기 작업을 위한 파일 핸들
+ */
+HANDLE init_file_write(const TCHAR* filePath) {
+    return init_file_write_ex(filePath, IO_CACHE_DEFAULT);
+}
+
+/**
+ * @brief File Cache 사용 방식에 해당하는 CreateFile 플래그를 반환합니다.
+ */
+static DWORD cache_mode_flags(IoCacheMode cacheMode) {
+    switch (cacheMode) {
+    case IO_CACHE_SEQUENTIAL:
+        return FILE_FLAG_SEQUENTIAL_SCAN;
+    case IO_CACHE_DIRECT:
+        return FILE_FLAG_NO_BUFFERING;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief File Cache 사용 방식을 지정하여 파일 읽기 초기화
+ *
+ * IO_CACHE_DIRECT 로 연 파일은 async_alloc_aligned 로 할당한 버퍼로, Sector 크기의 배수만큼
+ * 정렬된 위치에서 읽어야 합니다. 파일 끝에서는 요청보다 적게 읽힙니다.
+ *
+ * @param filePath 읽을 파일 경로
+ * @param cacheMode File Cache 사용 방식
+ * @return HANDLE 읽기 작업을 위한 파일 핸들
+ */
+HANDLE init_file_read_ex(const TCHAR* filePath, IoCacheMode cacheMode) {
+    HANDLE hFile = CreateFile(
+        filePath, GENERIC_READ, 0, NULL, OPEN_EXISTING,
+        FILE_FLAG_OVERLAPPED | cache_mode_flags(cacheMode), NULL
+    );
     // 파일 열기 (읽기 전용 모드, 비동기식 I/O 작업을 위한 FILE_FLAG_OVERLAPPED 설정)
     if (hFile == INVALID_HANDLE_VALUE) {
         log_message("Failed to open file for reading.");
@@ -38,15 +83,20 @@ HANDLE init_file_read(const TCHAR* filePath) {
 }
 
 /**
- * @brief 파일 쓰기 초기화
- * 
- * 주어진 파일 경로에 대해 파일을 쓰기 위해 파일을 엽니다.
- * 
+ * @brief File Cache 사용 방식을 지정하여 파일 쓰기 초기화
+ *
+ * IO_CACHE_DIRECT 로 연 파일은 정렬된 버퍼로 Sector 크기의 배수만큼 써야 하므로, 마지막 Sector 는
+ * 채워서 쓴 뒤 async_set_file_size 로 실제 크기에 맞게 잘라야 합니다.
+ *
  * @param filePath 쓸 파일 경로
+ * @param cacheMode File Cache 사용 방식
  * @return HANDLE 쓰기 작업을 위한 파일 핸들
  */
-HANDLE init_file_write(const TCHAR* filePath) {
-    HANDLE hFile = CreateFile(filePath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_FLAG_OVERLAPPED, NULL);
+HANDLE init_file_write_ex(const TCHAR* filePath, IoCacheMode cacheMode) {
+    HANDLE hFile = CreateFile(
+        filePath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+        FILE_FLAG_OVERLAPPED | cache_mode_flags(cacheMode), NULL
+    );
     // 파일 열기 (쓰기 전용 모드, 파일이 없으면 새로 생성, 비동기식 I/O 작업을 위한 FILE_FLAG_OVERLAPPED 설정)
     if (hFile == INVALID_HANDLE_VALUE) {
         log_message("Failed to open file for writing.");
@@ -57,6 +107,246 @@ HANDLE init_file_write(const TCHAR* filePath) {
     return hFile;
 }
 
+/**
+ * @brief Direct I/O 에 필요한 정렬 단위 (Sector 크기) 를 구합니다.
+ *
+ * @param hFile 파일 핸들
+ * @return 정렬 단위 (byte). 알 수 없으면 IO_DEFAULT_ALIGNMENT
+ */
+DWORD async_sector_size(HANDLE hFile) {
+    FILE_STORAGE_INFO info;
+    if (!GetFileInformationByHandleEx(hFile, FileStorageInfo, &info, sizeof(info))) {
+        return IO_DEFAULT_ALIGNMENT;
+    }
+
+    DWORD sectorSize = info.LogicalBytesPerSector;
+    if (info.PhysicalBytesPerSectorForPerformance > sectorSize) {
+        sectorSize = info.PhysicalBytesPerSectorForPerformance;
+    }
+    return (sectorSize != 0) ? sectorSize : IO_DEFAULT_ALIGNMENT;
+}
+
+/**
+ * @brief IO_DEFAULT_ALIGNMENT 로 정렬된 I/O 버퍼를 할당합니다. (async_free_aligned 로 해제)
+ *
+ * @param size 버퍼 크기
+ * @return 버퍼, 실패 시 NULL
+ */
+LPVOID async_alloc_aligned(size_t size) {
+    return _aligned_malloc(size, IO_DEFAULT_ALIGNMENT);
+}
+
+/**
+ * @brief async_alloc_aligned 로 할당한 버퍼를 해제합니다.
+ *
+ * @param lpBuffer 버퍼 (NULL 가능)
+ */
+void async_free_aligned(LPVOID lpBuffer) {
+    _aligned_free(lpBuffer);
+}
+
+/**
+ * @brief 파일 크기를 지정한 크기로 바꿉니다. (Direct I/O 로 채워 쓴 마지막 Sector 를 잘라내는 데 사용)
+ *
+ * @param hFile GENERIC_WRITE 로 연 파일 핸들
+ * @param size 새 파일 크기
+ * @return 성공 여부
+ */
+BOOL async_set_file_size(HANDLE hFile, ULONGLONG size) {
+    FILE_END_OF_FILE_INFO info;
+    info.EndOfFile.QuadPart = (LONGLONG)size;
+    if (!SetFileInformationByHandle(hFile, FileEndOfFileInfo, &info, sizeof(info))) {
+        log_message("Failed to set file size.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 파일의 Disk 공간을 미리 할당합니다. 파일 크기는 바뀌지 않습니다. (fallocate 의 KEEP_SIZE 와 같음)
+ *
+ * 할당 크기를 파일 크기보다 작게 하면 파일이 잘립니다.
+ *
+ * @param hFile GENERIC_WRITE 로 연 파일 핸들
+ * @param size 할당할 크기
+ * @return 성공 여부
+ */
+BOOL async_set_allocation(HANDLE hFile, ULONGLONG size) {
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = (LONGLONG)size;
+    if (!SetFileInformationByHandle(hFile, FileAllocationInfo, &info, sizeof(info))) {
+        log_message("Failed to set file allocation.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static volatile LONG64 g_readRequests = 0;  // async_read_ex 로 요청한 읽기 수 (통계용)
+static volatile LONG64 g_writeRequests = 0; // async_write_ex 로 요청한 쓰기 수 (통계용)
+
+/**
+ * @brief 지금까지 요청한 읽기/쓰기 수를 구합니다. (모든 Thread 합계, Benchmark 에서 System Call 수 비교용)
+ *
+ * @param pReads 읽기 요청 수
+ * @param pWrites 쓰기 요청 수
+ */
+void async_get_request_counts(ULONGLONG* pReads, ULONGLONG* pWrites) {
+    *pReads = (ULONGLONG)g_readRequests;
+    *pWrites = (ULONGLONG)g_writeRequests;
+}
+
+#define IO_THROTTLE_BURST_MS 100 // Token Bucket 최대 충전량 (해당 시간 동안의 대역폭)
+
+/**
+ * @brief I/O 제한 구조체를 초기화합니다.
+ *
+ * @param throttle 초기화할 I/O 제한 구조체
+ * @param readBytesPerSec 읽기 대역폭 (bytes/s, 0 이면 무제한)
+ * @param writeBytesPerSec 쓰기 대역폭 (bytes/s, 0 이면 무제한)
+ * @param maxInFlight 동시 진행 I/O 최대 수 (0 이면 무제한, 최대 IO_THROTTLE_MAX_IN_FLIGHT)
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL io_throttle_init(IO_Throttle_t* throttle, DWORD readBytesPerSec, DWORD writeBytesPerSec, LONG maxInFlight) {
+    LARGE_INTEGER frequency, now;
+
+    if (maxInFlight < 0 || maxInFlight > IO_THROTTLE_MAX_IN_FLIGHT) {
+        log_message("Invalid I/O in-flight limit.");
+        return FALSE;
+    }
+
+    memset(throttle, 0, sizeof(IO_Throttle_t));
+    InitializeSRWLock(&(throttle->lock));
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    throttle->tickFrequency = frequency.QuadPart;
+    throttle->lastTick = now.QuadPart;
+
+    throttle->readRate = (double)readBytesPerSec;
+    throttle->writeRate = (double)writeBytesPerSec;
+    throttle->readTokens = throttle->readRate * IO_THROTTLE_BURST_MS / 1000.0;
+    throttle->writeTokens = throttle->writeRate * IO_THROTTLE_BURST_MS / 1000.0;
+    throttle->maxInFlight = maxInFlight;
+    return TRUE;
+}
+
+/**
+ * @brief 지난 시간만큼 Token 을 충전합니다. (lock 을 잡은 상태에서 호출)
+ */
+static void io_throttle_refill(IO_Throttle_t* throttle) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    double const elapsed = (double)(now.QuadPart - throttle->lastTick) / (double)throttle->tickFrequency;
+    throttle->lastTick = now.QuadPart;
+
+    double const readBurst = throttle->readRate * IO_THROTTLE_BURST_MS / 1000.0;
+    double const writeBurst = throttle->writeRate * IO_THROTTLE_BURST_MS / 1000.0;
+
+    throttle->readTokens += elapsed * throttle->readRate;
+    if (throttle->readTokens > readBurst) {
+        throttle->readTokens = readBurst;
+    }
+
+    throttle->writeTokens += elapsed * throttle->writeRate;
+    if (throttle->writeTokens > writeBurst) {
+        throttle->writeTokens = writeBurst;
+    }
+}
+
+/**
+ * @brief I/O 요청 전, 대역폭과 동시 진행 I/O 수 제한을 만족할 때까지 대기합니다.
+ *
+ * 대역폭은 요청 크기만큼 Token 을 먼저 사용하고, 부족한 만큼 대기합니다. (여러 Thread 가 공유해도 순서대로 지불)
+ * 동시 진행 I/O 는 OVERLAPPED 구조체로 추적하며, 자리는 소유자가 async_wait/async_poll 로 완료를 확인할 때 반환합니다.
+ * 빈 자리가 없을 때 이 Thread 가 요청한 I/O 가 이미 완료되었으면 그 자리를 넘겨받습니다. 대기 없이 요청한 쓰기를
+ * 남겨 둔 채 대기하는 읽기를 요청하는 경우처럼, 자리를 반환할 쪽이 바로 대기 중인 자신이면 영원히 기다리게 되기 때문입니다.
+ * 자신의 I/O 는 Kernel 이 완료하므로 대기는 항상 끝납니다.
+ * (다른 Thread 의 OVERLAPPED 구조체는 이미 해제되었을 수 있으므로 절대 참조하지 않음)
+ *
+ * @param throttle I/O 제한 구조체 (NULL 이면 제한 없음)
+ * @param bWrite 쓰기 요청 여부
+ * @param dwBytes 요청 크기
+ * @param lpOverlap 요청에 사용할 OVERLAPPED 구조체
+ */
+static void io_throttle_acquire(IO_Throttle_t* throttle, BOOL bWrite, DWORD dwBytes, LPOVERLAPPED lpOverlap) {
+    if (throttle == NULL) {
+        return;
+    }
+
+    // 1. 대역폭 제한 (Token Bucket)
+    double const rate = bWrite ? throttle->writeRate : throttle->readRate;
+    if (rate > 0) {
+        AcquireSRWLockExclusive(&(throttle->lock));
+        io_throttle_refill(throttle);
+        double* const tokens = bWrite ? &(throttle->writeTokens) : &(throttle->readTokens);
+        *tokens -= (double)dwBytes;
+        double const deficit = -(*tokens);
+        ReleaseSRWLockExclusive(&(throttle->lock));
+
+        if (deficit > 0) {
+            DWORD const dwDelayMs = (DWORD)(deficit * 1000.0 / rate) + 1;
+            Sleep(dwDelayMs);
+            InterlockedExchangeAdd64(&(throttle->delayedMicros), (LONG64)dwDelayMs * 1000);
+        }
+    }
+
+    // 2. 동시 진행 I/O 수 제한
+    if (throttle->maxInFlight > 0) {
+        DWORD const dwThreadId = GetCurrentThreadId();
+
+        for (;;) {
+            int freeSlot = -1;
+
+            AcquireSRWLockExclusive(&(throttle->lock));
+            for (LONG i = 0; i < throttle->maxInFlight && freeSlot < 0; i++) {
+                if (throttle->inFlight[i] == NULL) {
+                    freeSlot = (int)i;
+                }
+            }
+            for (LONG i = 0; i < throttle->maxInFlight && freeSlot < 0; i++) {
+                // 이 Thread 가 요청하여 아직 async_wait/async_poll 하지 않은 I/O 만 참조 (완료 전에는 해제되지 않음)
+                if (throttle->inFlightThread[i] == dwThreadId && HasOverlappedIoCompleted(throttle->inFlight[i])) {
+                    freeSlot = (int)i;
+                }
+            }
+            if (freeSlot >= 0) {
+                throttle->inFlight[freeSlot] = lpOverlap;
+                throttle->inFlightThread[freeSlot] = dwThreadId;
+            }
+            ReleaseSRWLockExclusive(&(throttle->lock));
+
+            if (freeSlot >= 0) {
+                break;
+            }
+
+            Sleep(1);
+            InterlockedExchangeAdd64(&(throttle->delayedMicros), 1000);
+        }
+    }
+}
+
+/**
+ * @brief 완료가 확인된 I/O 의 동시 진행 자리를 반환합니다.
+ *
+ * @param throttle I/O 제한 구조체 (NULL 이면 제한 없음)
+ * @param lpOverlap 완료된 I/O 의 OVERLAPPED 구조체
+ */
+static void io_throttle_release(IO_Throttle_t* throttle, LPOVERLAPPED lpOverlap) {
+    if (throttle == NULL || throttle->maxInFlight == 0) {
+        return;
+    }
+
+    AcquireSRWLockExclusive(&(throttle->lock));
+    for (LONG i = 0; i < throttle->maxInFlight; i++) {
+        if (throttle->inFlight[i] == lpOverlap) {
+            throttle->inFlight[i] = NULL;
+            throttle->inFlightThread[i] = 0;
+        }
+    }
+    ReleaseSRWLockExclusive(&(throttle->lock));
+}
+
 /**
 * @brief 비동기적으로 파일에서 데이터를 읽음
 * @param hFile 읽을 파일의 핸들
@@ -71,51 +361,120 @@ BOOL async_read(
     HANDLE hFile, LPVOID lpBuffer, DWORD dwBytesToRead,
     LPDWORD lpBytesRead, LPOVERLAPPED lpOverlap, BOOL bWait
 ) {
+    return async_read_ex(hFile, lpBuffer, dwBytesToRead, lpBytesRead, lpOverlap, bWait, NULL);
+}
+
+/**
+* @brief 비동기적으로 파일에 데이터를 씀
+* @param hFile 쓸 파일의 핸들
+* @param lpBuffer 쓸 데이터를 담고 있는 버퍼
+* @param dwBytesToWrite 쓸 데이터의 크기
+* @param lpBytesWritten 실제로 쓴 데이터의 크기
+* @param lpOverlap OVERLAPPED 구조체 포인터 (비동기 작업을 위한 상태 정보)
+* @param bWait 작업 완료 대기 여부 (TRUE: 대기, FALSE: 바로 리턴)
+* @return 쓰기 작업 성공 여부
+*/
+BOOL async_write(
+    HANDLE hFile, LPCVOID lpBuffer, DWORD dwBytesToWrite,
+    LPDWORD lpBytesWritten, LPOVERLAPPED lpOverlap, BOOL bWait
+) {
+    return async_write_ex(hFile, lpBuffer, dwBytesToWrite, lpBytesWritten, lpOverlap, bWait, NULL);
+}
+
+/**
+* @brief I/O 제한을 적용하여 비동기적으로 파일에서 데이터를 읽음
+*
+* bWait 가 FALSE 인 요청은 반드시 async_wait 또는 async_poll 로 완료를 확인해야 하며, 그 전까지 동시 진행 I/O 자리를 차지합니다.
+*
+* @param hFile 읽을 파일의 핸들
+* @param lpBuffer 데이터를 읽어들일 버퍼
+* @param dwBytesToRead 읽을 데이터의 크기
+* @param lpBytesRead 실제로 읽은 데이터의 크기
+* @param lpOverlap OVERLAPPED 구조체 포인터 (비동기 작업을 위한 상태 정보)
+* @param bWait 작업 완료 대기 여부 (TRUE: 대기, FALSE: 바로 리턴)
+* @param throttle I/O 제한 구조체 (NULL 이면 제한 없음)
+* @return 읽기 작업 성공 여부
+*/
+BOOL async_read_ex(
+    HANDLE hFile, LPVOID lpBuffer, DWORD dwBytesToRead,
+    LPDWORD lpBytesRead, LPOVERLAPPED lpOverlap, BOOL bWait,
+    IO_Throttle_t* throttle
+) {
+    io_throttle_acquire(throttle, FALSE, dwBytesToRead, lpOverlap);
+    InterlockedIncrement64(&g_readRequests);
+
     BOOL bResult = ReadFile(hFile, lpBuffer, dwBytesToRead, lpBytesRead, lpOverlap);  // 파일 읽기 시도
     
-    // I/O 작업이 대기 상태가 아니면 실패로 간주
-    if (!bResult && GetLastError() != ERROR_IO_PENDING) {
-        log_message("Read operation failed.");
-        return FALSE;
+    if (!bResult) {
+        DWORD const dwError = GetLastError();
+
+        // 파일 끝 이후를 읽으려 하면 ERROR_HANDLE_EOF 로 즉시 실패 -> EOF 로 처리
+        if (dwError == ERROR_HANDLE_EOF) {
+            *lpBytesRead = 0;
+            io_throttle_release(throttle, lpOverlap);
+            return TRUE;
+        }
+
+        // I/O 작업이 대기 상태가 아니면 실패로 간주
+        if (dwError != ERROR_IO_PENDING) {
+            log_message("Read operation failed.");
+            io_throttle_release(throttle, lpOverlap);
+            return FALSE;
+        }
     }
 
     // 작업 결과 얻기 (대기 플래그가 TRUE이면 작업 완료를 기다림)
     bResult = GetOverlappedResult(hFile, lpOverlap, lpBytesRead, bWait);  // 비동기 작업 결과 확인
-    if (bWait && !bResult) {
+    if (!bResult) {
         DWORD dwError = GetLastError();
-        if (dwError == ERROR_IO_INCOMPLETE) {
+        if (dwError == ERROR_HANDLE_EOF) {
+            *lpBytesRead = 0;
+        } else if (bWait && dwError == ERROR_IO_INCOMPLETE) {
             log_message("Read - GetOverlappedResult IO pending.");
             Sleep(100);
         }
     }
 
-    // EOF (End of File) 처리: 읽은 바이트가 0이면 파일 끝에 도달한 것
-    if (*lpBytesRead == 0) {
-        log_message("EOF reached.");
+    if (bWait) {
+        io_throttle_release(throttle, lpOverlap);
+
+        // EOF (End of File) 처리: 읽은 바이트가 0이면 파일 끝에 도달한 것
+        if (*lpBytesRead == 0) {
+            log_message("EOF reached.");
+        }
     }
 
     return TRUE;
 }
 
 /**
-* @brief 비동기적으로 파일에 데이터를 씀
+* @brief I/O 제한을 적용하여 비동기적으로 파일에 데이터를 씀
+*
+* bWait 가 FALSE 인 요청은 반드시 async_wait 또는 async_poll 로 완료를 확인해야 하며, 그 전까지 동시 진행 I/O 자리를 차지합니다.
+*
 * @param hFile 쓸 파일의 핸들
 * @param lpBuffer 쓸 데이터를 담고 있는 버퍼
 * @param dwBytesToWrite 쓸 데이터의 크기
 * @param lpBytesWritten 실제로 쓴 데이터의 크기
 * @param lpOverlap OVERLAPPED 구조체 포인터 (비동기 작업을 위한 상태 정보)
 * @param bWait 작업 완료 대기 여부 (TRUE: 대기, FALSE: 바로 리턴)
+* @param throttle I/O 제한 구조체 (NULL 이면 제한 없음)
 * @return 쓰기 작업 성공 여부
 */
-BOOL async_write(
+BOOL async_write_ex(
     HANDLE hFile, LPCVOID lpBuffer, DWORD dwBytesToWrite,
-    LPDWORD lpBytesWritten, LPOVERLAPPED lpOverlap, BOOL bWait
+    LPDWORD lpBytesWritten, LPOVERLAPPED lpOverlap, BOOL bWait,
+    IO_Throttle_t* throttle
 ) {
+    io_throttle_acquire(throttle, TRUE, dwBytesToWrite, lpOverlap);
+    InterlockedIncrement64(&g_writeRequests);
+
     BOOL bResult = WriteFile(hFile, lpBuffer, dwBytesToWrite, lpBytesWritten, lpOverlap);  // 파일 쓰기 시도
 
     // I/O 작업이 대기 상태가 아니면 실패로 간주
     if (!bResult && GetLastError() != ERROR_IO_PENDING) {
         log_message("Write operation failed.");
+        io_throttle_release(throttle, lpOverlap);
         return FALSE;
     }
 
@@ -129,5 +488,169 @@ BOOL async_write(
         }
     }
 
+    if (bWait) {
+        io_throttle_release(throttle, lpOverlap);
+    }
+
+    return TRUE;
+}
+
+/**
+* @brief bWait 없이 요청한 I/O 작업의 완료를 기다림
+* @param hFile 파일의 핸들
+* @param lpOverlap 요청에 사용한 OVERLAPPED 구조체 포인터
+* @param lpBytesTransferred 실제로 읽거나 쓴 데이터의 크기
+* @param throttle 요청에 사용한 I/O 제한 구조체 (NULL 이면 제한 없음)
+* @return I/O 작업 성공 여부
+*/
+BOOL async_wait(HANDLE hFile, LPOVERLAPPED lpOverlap, LPDWORD lpBytesTransferred, IO_Throttle_t* throttle) {
+    BOOL bResult = GetOverlappedResult(hFile, lpOverlap, lpBytesTransferred, TRUE);
+    if (!bResult && GetLastError() == ERROR_HANDLE_EOF) {
+        *lpBytesTransferred = 0;
+        bResult = TRUE;
+    }
+
+    io_throttle_release(throttle, lpOverlap);
+
+    if (!bResult) {
+        log_message("I/O completion failed.");
+    }
+
+    return bResult;
+}
+
+/**
+* @brief bWait 없이 요청한 I/O 작업의 완료 여부를 대기 없이 확인함
+* @param hFile 파일의 핸들
+* @param lpOverlap 요청에 사용한 OVERLAPPED 구조체 포인터
+* @param lpBytesTransferred 완료된 경우, 실제로 읽거나 쓴 데이터의 크기
+* @param pbCompleted 완료 여부 (FALSE 이면 아직 진행 중)
+* @param throttle 요청에 사용한 I/O 제한 구조체 (NULL 이면 제한 없음)
+* @return I/O 작업 성공 여부 (진행 중이면 TRUE)
+*/
+BOOL async_poll(
+    HANDLE hFile, LPOVERLAPPED lpOverlap, LPDWORD lpBytesTransferred,
+    BOOL* pbCompleted, IO_Throttle_t* throttle
+) {
+    *pbCompleted = FALSE;
+
+    if (!GetOverlappedResult(hFile, lpOverlap, lpBytesTransferred, FALSE)) {
+        DWORD const dwError = GetLastError();
+        if (dwError == ERROR_IO_INCOMPLETE) {
+            return TRUE; // 아직 진행 중
+        }
+        if (dwError != ERROR_HANDLE_EOF) {
+            log_message("I/O completion failed.");
+            io_throttle_release(throttle, lpOverlap);
+            return FALSE;
+        }
+        *lpBytesTransferred = 0;
+    }
+
+    *pbCompleted = TRUE;
+    io_throttle_release(throttle, lpOverlap);
     return TRUE;
 }
+
+/**
+* @brief OVERLAPPED 구조체에 64 bit 파일 위치를 설정함
+* @param lpOverlap OVERLAPPED 구조체 포인터
+* @param offset 파일 위치
+*/
+void async_set_offset(LPOVERLAPPED lpOverlap, ULONGLONG offset) {
+    lpOverlap->Offset = (DWORD)offset;
+    lpOverlap->OffsetHigh = (DWORD)(offset >> 32);
+}
+
+/**
+* @brief I/O 완료 통지를 받을 I/O Completion Port 를 생성함
+*
+* 여러 파일의 I/O 완료를 하나의 Thread 에서 GetQueuedCompletionStatusEx 로 기다릴 수 있습니다.
+*
+* @return I/O Completion Port 핸들, 실패 시 NULL
+*/
+HANDLE async_create_port(void) {
+    HANDLE hPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (hPort == NULL) {
+        log_message("Failed to create I/O completion port.");
+    }
+    return hPort;
+}
+
+/**
+* @brief 파일 핸들을 I/O Completion Port 에 연결함
+*
+* 연결 후 해당 파일의 Overlapped I/O 가 완료될 때마다 key 와 함께 완료 통지가 Port 에 쌓입니다.
+* GetOverlappedResult 를 이용한 기존의 완료 확인도 그대로 동작합니다.
+*
+* @param hPort I/O Completion Port 핸들
+* @param hFile FILE_FLAG_OVERLAPPED 로 연 파일 핸들
+* @param key 완료 통지에 함께 전달할 값
+* @return 연결 성공 여부
+*/
+BOOL async_attach_port(HANDLE hPort, HANDLE hFile, ULONG_PTR key) {
+    if (CreateIoCompletionPort(hFile, hPort, key, 0) == NULL) {
+        log_message("Failed to attach file to I/O completion port.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+* @brief 파일 전체를 읽기 전용으로 Memory 에 Map 함
+*
+* 읽기를 공유하여 열므로 같은 파일을 여러 곳 (압축과 쓰기 후 검증 등) 에서 동시에 Map 할 수 있습니다.
+* 내용은 접근할 때 Page 단위로 읽히며, 다른 Process 와 File Cache 를 공유합니다.
+*
+* @param filePath Map 할 파일 경로
+* @param mapping 결과 (실패해도 io_unmap_file 로 정리 가능)
+* @return Map 성공 여부 (빈 파일이면 data 가 NULL 이고 성공)
+*/
+BOOL io_map_file(const TCHAR* filePath, IO_Mapping_t* mapping) {
+    LARGE_INTEGER fileSize;
+
+    mapping->hMapping = NULL;
+    mapping->data = NULL;
+    mapping->size = 0;
+    mapping->hFile = CreateFile(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (mapping->hFile == INVALID_HANDLE_VALUE || !GetFileSizeEx(mapping->hFile, &fileSize) ||
+        (ULONGLONG)fileSize.QuadPart > (SIZE_T)-1) {
+        log_message("Failed to open file for mapping.");
+        return FALSE;
+    }
+    if (fileSize.QuadPart == 0) {
+        return TRUE; // 빈 파일은 Map 할 수 없음
+    }
+
+    mapping->hMapping = CreateFileMapping(mapping->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping->hMapping != NULL) {
+        mapping->data = (const BYTE*)MapViewOfFile(mapping->hMapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (mapping->data == NULL) {
+        log_message("Failed to map file.");
+        return FALSE;
+    }
+    mapping->size = (size_t)fileSize.QuadPart;
+    return TRUE;
+}
+
+/**
+* @brief io_map_file 로 Map 한 파일을 해제함 (Map 하지 않았거나 실패한 경우에도 호출 가능)
+*
+* @param mapping 해제할 Mapping
+*/
+void io_unmap_file(IO_Mapping_t* mapping) {
+    if (mapping->data != NULL) {
+        UnmapViewOfFile(mapping->data);
+    }
+    if (mapping->hMapping != NULL) {
+        CloseHandle(mapping->hMapping);
+    }
+    if (mapping->hFile != INVALID_HANDLE_VALUE && mapping->hFile != NULL) {
+        CloseHandle(mapping->hFile);
+    }
+    mapping->hFile = INVALID_HANDLE_VALUE;
+    mapping->hMapping = NULL;
+    mapping->data = NULL;
+    mapping->size = 0;
+}
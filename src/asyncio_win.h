@@ -20,10 +20,68 @@
 #include <windows.h>
 #include <stdio.h>
 
+#define IO_THROTTLE_MAX_IN_FLIGHT 64 // 동시 진행 I/O 제한의 최대값
+#define IO_DEFAULT_ALIGNMENT 4096    // I/O 버퍼 정렬 단위 (Page 크기, Direct I/O 의 Sector 크기 이상)
+
+// enum 선언
+
+typedef enum {
+    IO_CACHE_DEFAULT,    // 시스템 File Cache 를 사용 (기본)
+    IO_CACHE_SEQUENTIAL, // File Cache 를 사용하되 순차 접근임을 알려, 지나간 Page 를 먼저 내보내도록 함 (FILE_FLAG_SEQUENTIAL_SCAN)
+    IO_CACHE_DIRECT      // File Cache 를 거치지 않음 (FILE_FLAG_NO_BUFFERING). 버퍼 주소, 요청 크기, 파일 위치가 Sector 단위로 정렬되어야 함
+} IoCacheMode;
+
+// 구조체 선언
+
+typedef struct IO_Throttle_s IO_Throttle_t;
+typedef struct IO_Mapping_s IO_Mapping_t;
+
+/*
+ * I/O 대역폭 (Token Bucket) 및 동시 진행 I/O 수 제한
+ *
+ * 하나의 작업에만 사용하거나, 여러 작업 (Thread) 이 공유하여 전체 I/O 를 제한할 수 있습니다.
+ * 제한에 걸리면 I/O 를 요청하는 Thread 가 대기하므로, Background 작업이 Kernel I/O Queue 를
+ * 포화시켜 우선순위가 높은 작업의 I/O 가 지연되는 것을 막습니다.
+ */
+struct IO_Throttle_s {
+    SRWLOCK lock;                                   // Token 및 진행 중인 I/O 목록 보호
+    double readRate;                                // 읽기 대역폭 (bytes/s, 0 이면 무제한)
+    double writeRate;                               // 쓰기 대역폭 (bytes/s, 0 이면 무제한)
+    double readTokens;                              // 사용 가능한 읽기 Token (음수이면 대기 필요)
+    double writeTokens;                             // 사용 가능한 쓰기 Token (음수이면 대기 필요)
+    LONGLONG lastTick;                              // 마지막 Token 충전 시각 (QueryPerformanceCounter)
+    LONGLONG tickFrequency;                         // QueryPerformanceFrequency
+    LONG maxInFlight;                               // 동시 진행 I/O 최대 수 (0 이면 무제한)
+    LPOVERLAPPED inFlight[IO_THROTTLE_MAX_IN_FLIGHT]; // 진행 중인 I/O 의 OVERLAPPED 구조체 (요청한 Thread 만 참조)
+    DWORD inFlightThread[IO_THROTTLE_MAX_IN_FLIGHT];  // 자리를 차지한 I/O 를 요청한 Thread ID
+    volatile LONG64 delayedMicros;                  // 제한으로 인해 대기한 총 시간 (us, 통계용)
+};
+
+/*
+ * 읽기 전용으로 Memory 에 Map 한 파일 (io_map_file)
+ */
+struct IO_Mapping_s {
+    HANDLE hFile;             // 파일 핸들 (INVALID_HANDLE_VALUE 이면 Map 하지 않음)
+    HANDLE hMapping;          // File Mapping 핸들 (빈 파일이면 NULL)
+    const BYTE* data;         // 파일 내용 (빈 파일이면 NULL)
+    size_t size;              // 파일 크기
+};
+
 // 함수 선언
 
+BOOL io_throttle_init(IO_Throttle_t* throttle, DWORD readBytesPerSec, DWORD writeBytesPerSec, LONG maxInFlight);
+
 HANDLE init_file_read(const TCHAR* filePath);
 HANDLE init_file_write(const TCHAR* filePath);
+HANDLE init_file_read_ex(const TCHAR* filePath, IoCacheMode cacheMode);
+HANDLE init_file_write_ex(const TCHAR* filePath, IoCacheMode cacheMode);
+
+DWORD async_sector_size(HANDLE hFile);
+LPVOID async_alloc_aligned(size_t size);
+void async_free_aligned(LPVOID lpBuffer);
+BOOL async_set_file_size(HANDLE hFile, ULONGLONG size);
+BOOL async_set_allocation(HANDLE hFile, ULONGLONG size);
+void async_get_request_counts(ULONGLONG* pReads, ULONGLONG* pWrites);
 
 BOOL async_read(
     HANDLE hFile, LPVOID lpBuffer, DWORD dwBytesToRead,
@@ -34,4 +92,27 @@ BOOL async_write(
     LPDWORD lpBytesWritten, LPOVERLAPPED lpOverlap, BOOL bWait
 );
 
+BOOL async_read_ex(
+    HANDLE hFile, LPVOID lpBuffer, DWORD dwBytesToRead,
+    LPDWORD lpBytesRead, LPOVERLAPPED lpOverlap, BOOL bWait,
+    IO_Throttle_t* throttle
+);
+BOOL async_write_ex(
+    HANDLE hFile, LPCVOID lpBuffer, DWORD dwBytesToWrite,
+    LPDWORD lpBytesWritten, LPOVERLAPPED lpOverlap, BOOL bWait,
+    IO_Throttle_t* throttle
+);
+BOOL async_wait(HANDLE hFile, LPOVERLAPPED lpOverlap, LPDWORD lpBytesTransferred, IO_Throttle_t* throttle);
+BOOL async_poll(
+    HANDLE hFile, LPOVERLAPPED lpOverlap, LPDWORD lpBytesTransferred,
+    BOOL* pbCompleted, IO_Throttle_t* throttle
+);
+void async_set_offset(LPOVERLAPPED lpOverlap, ULONGLONG offset);
+
+HANDLE async_create_port(void);
+BOOL async_attach_port(HANDLE hPort, HANDLE hFile, ULONG_PTR key);
+
+BOOL io_map_file(const TCHAR* filePath, IO_Mapping_t* mapping);
+void io_unmap_file(IO_Mapping_t* mapping);
+
 #endif // ASYNCIO_WIN_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <windows.h>
+#include <stdio.h>
+
+#include "../compressor.h"
+
+// 함수 선언 (공통)
+
+double bench_now(void);
+void bench_fill_log(char* buffer, size_t size, unsigned int seed);
+BOOL bench_write_file(const TCHAR* filePath, const void* data, size_t size);
+ULONGLONG bench_file_size(const TCHAR* filePath);
+void bench_temp_path(TCHAR* path, size_t pathSize, const TCHAR* name);
+BOOL bench_verify_file(const TCHAR* compressedPath, CompressionAlgorithm algorithm, const void* original, size_t size);
+
+// 함수 선언 (Benchmark)
+
+void bench_archive(void);
+void bench_throttle(void);
+void bench_step(void);
+void bench_loop(void);
+void bench_appender(void);
+void bench_recover(void);
+void bench_checksum(void);
+void bench_verify(void);
+void bench_cache(void);
+void bench_stage(void);
+void bench_prealloc(void);
+void bench_durability(void);
+void bench_pipeline(void);
+void bench_pool(void);
+void bench_deadline(void);
+void bench_backpressure(void);
+void bench_estimate(void);
+void bench_tune(void);
+void bench_lz4prefs(void);
+void bench_longrange(void);
+void bench_streaming(void);
+void bench_delta(void);
+void bench_firmware(void);
+void bench_seekable(void);
+void bench_message(void);
+
+#endif // BENCH_H
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../log_appender.h"
+#include "../utility.h"
+
+#define APPENDER_BENCH_INPUT_SIZE (32 * 1024 * 1024) // 전체 Log 크기
+
+/**
+ * @brief Log 를 줄 단위 Record 로 나누었을 때의 시작 위치 목록을 만듭니다.
+ */
+static size_t split_records(const char* data, size_t size, size_t** pOffsets) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == '\n') {
+            count++;
+        }
+    }
+
+    size_t* const offsets = (size_t*)malloc((count + 2) * sizeof(size_t));
+    if (offsets == NULL) {
+        return 0;
+    }
+
+    size_t n = 0;
+    offsets[n++] = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == '\n') {
+            offsets[n++] = i + 1;
+        }
+    }
+    if (offsets[n - 1] != size) {
+        offsets[n++] = size; // 마지막 줄에 개행이 없는 경우
+    }
+
+    *pOffsets = offsets;
+    return n - 1;
+}
+
+/**
+ * @brief 하나의 Flush 설정으로 모든 Record 를 Appender 에 쓰고, 처리량과 압축률을 측정합니다.
+ */
+static void bench_one_appender(
+    const TCHAR* outputPath, const char* data, const size_t* offsets, size_t recordCount,
+    CompressionAlgorithm algorithm, size_t flushBytes
+) {
+    TCHAR msg[256];
+    LogAppenderOptions options = { 0, };
+    options.flushBytes = flushBytes;
+
+    double const start = bench_now();
+    LOG_Appender_t* appender = log_appender_open(outputPath, algorithm, &options);
+    if (appender == NULL) {
+        return;
+    }
+
+    BOOL bResult = TRUE;
+    for (size_t i = 0; i < recordCount && bResult; i++) {
+        bResult = log_appender_write(appender, data + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    ULONGLONG const flushCount = appender->flushCount;
+    bResult = log_appender_close(appender) && bResult;
+    double const elapsed = bench_now() - start;
+
+    ULONGLONG const outputSize = bench_file_size(outputPath);
+    BOOL const bVerified = bResult && bench_verify_file(outputPath, algorithm, data, APPENDER_BENCH_INPUT_SIZE);
+
+    sprintf(msg, "%s appender, flush every %7zu B | %s %6.3f s | %8.2f M records/s (%6.1f ns/record, %7.1f MB/s) | "
+                 "ratio %5.2f | %6llu flushes",
+            (algorithm == LZ4) ? "LZ4 " : "ZSTD", flushBytes, bVerified ? "ok  " : "FAIL", elapsed,
+            recordCount / elapsed / 1e6, elapsed / recordCount * 1e9,
+            APPENDER_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0),
+            outputSize ? (double)APPENDER_BENCH_INPUT_SIZE / (double)outputSize : 0.0, flushCount);
+    log_message(msg);
+
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief Log Record 를 하나씩 압축하며 쓰는 Appender 의 Record 당 비용과, Flush 간격에 따른 압축률을 측정합니다.
+ *
+ * 기준으로 압축하지 않고 stdio 로 쓰는 경우를 함께 측정합니다.
+ */
+void bench_appender(void) {
+    TCHAR msg[200];
+    TCHAR outputPath[MAX_PATH];
+    size_t* offsets = NULL;
+
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_appender_output.bin");
+
+    char* const data = (char*)malloc(APPENDER_BENCH_INPUT_SIZE);
+    if (data == NULL) {
+        return;
+    }
+    bench_fill_log(data, APPENDER_BENCH_INPUT_SIZE, 11);
+
+    size_t const recordCount = split_records(data, APPENDER_BENCH_INPUT_SIZE, &offsets);
+    if (recordCount == 0) {
+        free(data);
+        return;
+    }
+
+    sprintf(msg, "%zu records, average %.1f bytes", recordCount, (double)APPENDER_BENCH_INPUT_SIZE / recordCount);
+    log_message(msg);
+
+    // 기준: 압축 없이 stdio 로 쓰기
+    double const start = bench_now();
+    FILE* const file = fopen(outputPath, "wb");
+    if (file != NULL) {
+        for (size_t i = 0; i < recordCount; i++) {
+            fwrite(data + offsets[i], 1, offsets[i + 1] - offsets[i], file);
+        }
+        fclose(file);
+        double const elapsed = bench_now() - start;
+        sprintf(msg, "raw  fwrite (uncompressed)              | ok   %6.3f s | %8.2f M records/s (%6.1f ns/record, %7.1f MB/s)",
+                elapsed, recordCount / elapsed / 1e6, elapsed / recordCount * 1e9,
+                APPENDER_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0));
+        log_message(msg);
+        DeleteFile(outputPath);
+    }
+
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        bench_one_appender(outputPath, data, offsets, recordCount, algorithm, 4 * 1024);
+        bench_one_appender(outputPath, data, offsets, recordCount, algorithm, 64 * 1024);
+        bench_one_appender(outputPath, data, offsets, recordCount, algorithm, 1024 * 1024);
+    }
+
+    free(offsets);
+    free(data);
+}
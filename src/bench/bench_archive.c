@@ -0,0 +1,189 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../archive.h"
+#include "../utility.h"
+
+#define ARCHIVE_BENCH_FILES     10000
+#define ARCHIVE_BENCH_MIN_SIZE  256
+#define ARCHIVE_BENCH_MAX_SIZE  (8 * 1024)
+
+/**
+ * @brief i 번째 Corpus 파일의 크기 (Seed 로 결정)
+ */
+static size_t corpus_file_size(unsigned int i) {
+    unsigned int const r = (i + 1) * 2654435761u;
+    return ARCHIVE_BENCH_MIN_SIZE + (r >> 8) % (ARCHIVE_BENCH_MAX_SIZE - ARCHIVE_BENCH_MIN_SIZE);
+}
+
+/**
+ * @brief 10k 개의 작은 Log 파일 Corpus 를 임시 폴더에 생성합니다.
+ */
+static BOOL create_corpus(const TCHAR* corpusDir, char* scratch, ULONGLONG* pTotalSize) {
+    TCHAR path[MAX_PATH];
+
+    CreateDirectory(corpusDir, NULL);
+    *pTotalSize = 0;
+
+    for (unsigned int i = 0; i < ARCHIVE_BENCH_FILES; i++) {
+        size_t const size = corpus_file_size(i);
+        bench_fill_log(scratch, size, i + 1);
+
+        snprintf(path, sizeof(path), "%s\\f%05u.log", corpusDir, i);
+        if (!bench_write_file(path, scratch, size)) {
+            log_message("Archive bench - failed to create corpus.");
+            return FALSE;
+        }
+        *pTotalSize += size;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 파일마다 따로 압축하는 기존 방식 (compress_file) 의 시간과 크기를 측정합니다.
+ */
+static void bench_separate(const TCHAR* corpusDir, CompressionAlgorithm algorithm, const TCHAR* label, ULONGLONG totalSize) {
+    TCHAR path[MAX_PATH];
+    TCHAR msg[200];
+    ULONGLONG compressedSize = 0;
+
+    double const start = bench_now();
+    for (unsigned int i = 0; i < ARCHIVE_BENCH_FILES; i++) {
+        snprintf(path, sizeof(path), "%s\\f%05u.log", corpusDir, i);
+        TCHAR* const output = get_output_file_name(path, algorithm);
+        compress_file(path, output, algorithm);
+        compressedSize += bench_file_size(output);
+        DeleteFile(output);
+        free(output);
+    }
+    double const elapsed = bench_now() - start;
+
+    sprintf(msg, "%-22s separate    : %8.3f s  %10llu -> %10llu bytes (ratio %.3f)",
+            label, elapsed, totalSize, compressedSize, (double)totalSize / (double)compressedSize);
+    log_message(msg);
+}
+
+/**
+ * @brief Archive 생성 및 임의 순서 단일 멤버 추출 시간을 측정합니다.
+ */
+static void bench_one_archive(
+    const TCHAR* corpusDir, const TCHAR* archivePath,
+    CompressionAlgorithm algorithm, ArchiveMode mode, const TCHAR* label,
+    ULONGLONG totalSize, char* expected, char* extracted
+) {
+    TCHAR path[MAX_PATH];
+    TCHAR name[32];
+    TCHAR msg[200];
+
+    // 1. Writer
+    double start = bench_now();
+    ARCHIVE_Writer_t* writer = archive_writer_open(archivePath, algorithm, mode, 0);
+    if (writer == NULL) {
+        return;
+    }
+    for (unsigned int i = 0; i < ARCHIVE_BENCH_FILES; i++) {
+        snprintf(path, sizeof(path), "%s\\f%05u.log", corpusDir, i);
+        snprintf(name, sizeof(name), "f%05u.log", i);
+        if (!archive_writer_add_file(writer, name, path)) {
+            log_message("Archive bench - add failed.");
+            break;
+        }
+    }
+    BOOL const bClosed = archive_writer_close(writer);
+    double const writeTime = bench_now() - start;
+    if (!bClosed) {
+        return;
+    }
+
+    // 2. Reader (임의 순서로 모든 멤버를 한 번씩 추출)
+    start = bench_now();
+    ARCHIVE_Reader_t* reader = archive_reader_open(archivePath);
+    double const openTime = bench_now() - start;
+    if (reader == NULL) {
+        return;
+    }
+
+    unsigned int failures = 0;
+    double worst = 0.0;
+    start = bench_now();
+    for (unsigned int k = 0; k < ARCHIVE_BENCH_FILES; k++) {
+        unsigned int const i = (unsigned int)(((ULONGLONG)k * 7919u) % ARCHIVE_BENCH_FILES); // 7919 는 소수 -> 순열
+        size_t size;
+
+        snprintf(name, sizeof(name), "f%05u.log", i);
+        double const t0 = bench_now();
+        BOOL const bResult = archive_reader_extract(reader, name, extracted, ARCHIVE_BENCH_MAX_SIZE, &size);
+        double const t1 = bench_now() - t0;
+        if (t1 > worst) {
+            worst = t1;
+        }
+
+        bench_fill_log(expected, corpus_file_size(i), i + 1);
+        if (!bResult || size != corpus_file_size(i) || memcmp(expected, extracted, size) != 0) {
+            failures++;
+        }
+    }
+    double const readTime = bench_now() - start;
+    archive_reader_close(reader);
+
+    ULONGLONG const archiveSize = bench_file_size(archivePath);
+    sprintf(msg, "%-22s write       : %8.3f s  %10llu -> %10llu bytes (ratio %.3f)",
+            label, writeTime, totalSize, archiveSize, (double)totalSize / (double)archiveSize);
+    log_message(msg);
+    sprintf(msg, "%-22s open+index  : %8.3f ms", label, openTime * 1000.0);
+    log_message(msg);
+    sprintf(msg, "%-22s extract     : %8.2f us avg, %8.2f us worst, %u failures",
+            label, readTime * 1e6 / ARCHIVE_BENCH_FILES, worst * 1e6, failures);
+    log_message(msg);
+
+    DeleteFile(archivePath);
+}
+
+/**
+ * @brief 10k 개의 작은 파일 Corpus 에 대해 파일별 압축과 Archive (Independent / Solid) 를 비교합니다.
+ */
+void bench_archive(void) {
+    TCHAR corpusDir[MAX_PATH];
+    TCHAR archivePath[MAX_PATH];
+    TCHAR path[MAX_PATH];
+    ULONGLONG totalSize;
+
+    char* const scratch = (char*)malloc(ARCHIVE_BENCH_MAX_SIZE);
+    char* const extracted = (char*)malloc(ARCHIVE_BENCH_MAX_SIZE);
+    bench_temp_path(corpusDir, sizeof(corpusDir), "cesb_archive_corpus");
+    bench_temp_path(archivePath, sizeof(archivePath), "cesb_bench.snar");
+
+    if (scratch && extracted && create_corpus(corpusDir, scratch, &totalSize)) {
+        bench_separate(corpusDir, LZ4, "LZ4", totalSize);
+        bench_separate(corpusDir, ZSTD, "ZSTD", totalSize);
+        log_message("");
+        bench_one_archive(corpusDir, archivePath, LZ4, ARCHIVE_INDEPENDENT, "LZ4 independent", totalSize, scratch, extracted);
+        bench_one_archive(corpusDir, archivePath, LZ4, ARCHIVE_SOLID, "LZ4 solid (1MB)", totalSize, scratch, extracted);
+        bench_one_archive(corpusDir, archivePath, ZSTD, ARCHIVE_INDEPENDENT, "ZSTD independent", totalSize, scratch, extracted);
+        bench_one_archive(corpusDir, archivePath, ZSTD, ARCHIVE_SOLID, "ZSTD solid (1MB)", totalSize, scratch, extracted);
+    }
+
+    for (unsigned int i = 0; i < ARCHIVE_BENCH_FILES; i++) {
+        snprintf(path, sizeof(path), "%s\\f%05u.log", corpusDir, i);
+        DeleteFile(path);
+    }
+    RemoveDirectory(corpusDir);
+
+    free(scratch);
+    free(extracted);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../adapt.h"
+#include "../compressor.h"
+#include "../utility.h"
+
+#define BACKPRESSURE_BENCH_INPUT_SIZE (64 * 1024 * 1024) // 압축 대상 크기
+#define BACKPRESSURE_BENCH_LOG_LINES  8                  // 출력하는 Level 변경 기록 수
+
+/**
+ * @brief 한 가지 쓰기 대역폭과 설정으로 ZSTD 압축하여 처리량, 압축률, 사용한 Level 을 출력합니다.
+ *
+ * @param writeRate 쓰기 대역폭 (bytes/s, 0 이면 제한 없음)
+ * @param bAdapt 출력 속도에 맞춘 Level 조절 여부
+ * @param bPipeline 읽기 / 압축 / 쓰기 Pipeline 사용 여부
+ * @param bPrintLog Level 변경 기록 출력 여부
+ */
+static void bench_one_backpressure(
+    const TCHAR* inputPath, const TCHAR* outputPath, DWORD writeRate,
+    BOOL bAdapt, BOOL bPipeline, BOOL bPrintLog, const char* original
+) {
+    TCHAR msg[320];
+    IO_Throttle_t throttle;
+    static ADAPT_Stats_t stats; // 변경 기록 때문에 큼
+    CompressionOptions options = { 0, };
+
+    if (writeRate != 0 && !io_throttle_init(&throttle, 0, writeRate, 0)) {
+        return;
+    }
+    memset(&stats, 0, sizeof(stats));
+    options.throttle = (writeRate != 0) ? &throttle : NULL;
+    options.bAdaptToOutput = bAdapt;
+    options.adaptStats = &stats;
+    options.bPipeline = bPipeline;
+
+    double const start = bench_now();
+    BOOL const bResult = compress_file_ex(inputPath, outputPath, ZSTD, &options);
+    double const elapsed = bench_now() - start;
+
+    ULONGLONG const compressedSize = bench_file_size(outputPath);
+    BOOL const bVerified = bResult && bench_verify_file(outputPath, ZSTD, original, BACKPRESSURE_BENCH_INPUT_SIZE);
+    sprintf(msg, "  %-8s %-17s %s %6.2f s (%7.1f MB/s) | ratio %5.2f | verified %s",
+            bPipeline ? "pipeline" : "loop", bAdapt ? "adaptive" : "fixed level 1", bResult ? "ok  " : "FAIL", elapsed,
+            BACKPRESSURE_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0),
+            compressedSize ? (double)BACKPRESSURE_BENCH_INPUT_SIZE / compressedSize : 0.0, bVerified ? "yes" : "NO ");
+    if (bAdapt) {
+        sprintf(msg + strlen(msg), " | level %2d..%2d, final %2d, %3lu changes, write wait %5.0f ms",
+                stats.minLevel, stats.maxLevel, stats.finalLevel, (unsigned long)stats.levelChanges,
+                stats.waitMicros / 1000.0);
+    }
+    log_message(msg);
+
+    if (bPrintLog) {
+        for (DWORD i = 0; i < stats.loggedChanges && i < BACKPRESSURE_BENCH_LOG_LINES; i++) {
+            const ADAPT_Change_t* const change = &(stats.changes[i]);
+            sprintf(msg, "      %6lu ms at %6.1f MB -> level %2d (interval %6.1f MB/s, write wait %3lu%%, pending %3lu%%)",
+                    (unsigned long)change->elapsedMillis, change->inputOffset / (1024.0 * 1024.0), change->level,
+                    change->speed / (1024.0 * 1024.0), (unsigned long)change->waitPercent,
+                    (unsigned long)change->pendingPercent);
+            log_message(msg);
+        }
+    }
+
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief 쓰기 대역폭을 제한하여 느린 Storage (SD Card, NFS 등) 를 흉내내고, 고정 Level 과 출력 속도에 맞춘 Level 을 비교합니다.
+ *
+ * 쓰기가 느리면 Level 을 올려 쓰는 양을 줄이고, 빠르면 기본 Level 로 돌아와야 합니다.
+ */
+void bench_backpressure(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR msg[128];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_backpressure_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_backpressure_output.bin");
+
+    char* const original = (char*)malloc(BACKPRESSURE_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, BACKPRESSURE_BENCH_INPUT_SIZE, 71);
+    if (!bench_write_file(inputPath, original, BACKPRESSURE_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    static const DWORD kWriteRates[] = { 0, 64 * 1024 * 1024, 16 * 1024 * 1024, 4 * 1024 * 1024 };
+    for (size_t i = 0; i < sizeof(kWriteRates) / sizeof(kWriteRates[0]); i++) {
+        if (kWriteRates[i] == 0) {
+            log_message("write bandwidth: unlimited");
+        } else {
+            sprintf(msg, "write bandwidth: %lu MB/s", (unsigned long)(kWriteRates[i] / (1024 * 1024)));
+            log_message(msg);
+        }
+        bench_one_backpressure(inputPath, outputPath, kWriteRates[i], FALSE, FALSE, FALSE, original);
+        bench_one_backpressure(inputPath, outputPath, kWriteRates[i], TRUE, FALSE, TRUE, original);
+        bench_one_backpressure(inputPath, outputPath, kWriteRates[i], TRUE, TRUE, FALSE, original);
+        log_message("");
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
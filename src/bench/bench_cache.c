@@ -0,0 +1,200 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <psapi.h> // GetPerformanceInfo
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../utility.h"
+
+#define CACHE_BENCH_INPUT_SIZE  (256 * 1024 * 1024 + 1234) // 압축 대상 크기 (Sector 배수가 아니도록 하여 파일 끝 처리를 확인)
+#define CACHE_BENCH_HOT_SIZE    (64 * 1024 * 1024)         // 함께 실행되는 작업이 자주 읽는 파일 크기
+#define CACHE_BENCH_RECORD_SIZE (4 * 1024)                 // 함께 실행되는 작업이 한 번에 읽는 크기
+#define CACHE_BENCH_HIT_MICROS  50.0                       // 이보다 빨리 끝난 읽기는 Cache 적중으로 간주
+#define CACHE_BENCH_MAX_SAMPLES (1024 * 1024)
+
+// 함께 실행되는 (Cache 에 의존하는) 작업의 상태
+typedef struct {
+    const TCHAR* path;        // 자주 읽는 파일
+    volatile LONG bStop;      // 종료 요청
+    double* samples;          // 읽기 지연 (초)
+    size_t sampleCount;       // 측정 횟수
+} HotReaderState;
+
+/**
+ * @brief 자주 읽는 파일의 임의 위치를 계속 읽고, 매 읽기의 지연을 기록합니다.
+ */
+static DWORD WINAPI hot_reader_thread(LPVOID param) {
+    HotReaderState* const state = (HotReaderState*)param;
+    char record[CACHE_BENCH_RECORD_SIZE];
+    DWORD dwRead;
+    unsigned int seed = 12345;
+
+    HANDLE hFile = CreateFile(state->path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return 1;
+    }
+
+    while (!state->bStop && state->sampleCount < CACHE_BENCH_MAX_SAMPLES) {
+        OVERLAPPED overlap = { 0, };
+        seed = seed * 1103515245u + 12345u;
+        async_set_offset(&overlap, (ULONGLONG)(seed % (CACHE_BENCH_HOT_SIZE / CACHE_BENCH_RECORD_SIZE)) * CACHE_BENCH_RECORD_SIZE);
+
+        double const start = bench_now();
+        ReadFile(hFile, record, sizeof(record), &dwRead, &overlap);
+        state->samples[state->sampleCount++] = bench_now() - start;
+    }
+
+    CloseHandle(hFile);
+    return 0;
+}
+
+/**
+ * @brief 시스템 File Cache 가 사용하는 메모리 크기를 구합니다.
+ */
+static double system_cache_mb(void) {
+    PERFORMANCE_INFORMATION info;
+    if (!GetPerformanceInfo(&info, sizeof(info))) {
+        return 0.0;
+    }
+    return (double)info.SystemCache * (double)info.PageSize / (1024.0 * 1024.0);
+}
+
+/**
+ * @brief 파일 전체를 읽어 File Cache 에 올립니다.
+ */
+static void warm_file(const TCHAR* path) {
+    char* const buffer = (char*)malloc(1024 * 1024);
+    FILE* const file = fopen(path, "rb");
+    if (buffer != NULL && file != NULL) {
+        while (fread(buffer, 1, 1024 * 1024, file) > 0) {
+        }
+    }
+    if (file) {
+        fclose(file);
+    }
+    free(buffer);
+}
+
+/**
+ * @brief 하나의 File Cache 사용 방식으로 압축하면서, 함께 실행되는 작업의 읽기 지연과 Cache 적중률을 측정합니다.
+ */
+static void bench_one_mode(
+    const TCHAR* inputPath, const TCHAR* outputPath, const TCHAR* hotPath,
+    CompressionAlgorithm algorithm, IoCacheMode cacheMode, const TCHAR* label, const char* original
+) {
+    TCHAR msg[300];
+    CompressionOptions options = { 0, };
+    HotReaderState state = { hotPath, 0, NULL, 0 };
+
+    options.cacheMode = cacheMode;
+    state.samples = (double*)malloc(CACHE_BENCH_MAX_SAMPLES * sizeof(double));
+    if (state.samples == NULL) {
+        return;
+    }
+
+    warm_file(hotPath); // 매번 같은 상태에서 시작
+    double const cacheBefore = system_cache_mb();
+
+    HANDLE hThread = CreateThread(NULL, 0, hot_reader_thread, &state, 0, NULL);
+
+    double const start = bench_now();
+    BOOL const bResult = compress_file_ex(inputPath, outputPath, algorithm, &options);
+    double const elapsed = bench_now() - start;
+
+    InterlockedExchange(&state.bStop, 1);
+    WaitForSingleObject(hThread, INFINITE);
+    CloseHandle(hThread);
+
+    double const cacheAfter = system_cache_mb();
+    BOOL const bVerified = bResult && bench_verify_file(outputPath, algorithm, original, CACHE_BENCH_INPUT_SIZE);
+
+    qsort(state.samples, state.sampleCount, sizeof(double), compare_double);
+    double sum = 0.0;
+    size_t hits = 0;
+    for (size_t i = 0; i < state.sampleCount; i++) {
+        sum += state.samples[i];
+        if (state.samples[i] * 1e6 < CACHE_BENCH_HIT_MICROS) {
+            hits++;
+        }
+    }
+
+    size_t const n = state.sampleCount ? state.sampleCount : 1;
+    sprintf(msg, "%-18s %s %6.2f s (%7.1f MB/s) | output %9llu B, verified %s | cache %+8.1f MB | "
+                 "hot reads %8zu, hit %6.2f %%, avg %7.1f us, p99 %8.1f us",
+            label, bResult ? "ok  " : "FAIL", elapsed, CACHE_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0),
+            bench_file_size(outputPath), bVerified ? "yes" : "NO ", cacheAfter - cacheBefore,
+            state.sampleCount, 100.0 * (double)hits / (double)n, sum / n * 1e6,
+            state.samples[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1] * 1e6);
+    log_message(msg);
+
+    free(state.samples);
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief File Cache 사용 방식 (기본, 순차 접근 힌트, Direct I/O) 별로 큰 파일을 압축하면서,
+ * 자주 쓰는 파일을 읽는 다른 작업의 Cache 적중률과 지연을 측정합니다.
+ *
+ * Cache 적중은 CACHE_BENCH_HIT_MICROS 보다 빨리 끝난 읽기로 추정합니다.
+ * 메모리가 충분하면 Cache 가 밀려나지 않으므로, File Cache 증가량도 함께 보고합니다.
+ */
+void bench_cache(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR hotPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_cache_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_cache_output.bin");
+    bench_temp_path(hotPath, sizeof(hotPath), "cesb_cache_hot.bin");
+
+    // 1. 입력 파일과 자주 읽는 파일 생성
+    size_t const inputSize = CACHE_BENCH_INPUT_SIZE;
+    char* const original = (char*)malloc(inputSize);
+    char* const hot = (char*)malloc(CACHE_BENCH_HOT_SIZE);
+    if (original == NULL || hot == NULL) {
+        free(original);
+        free(hot);
+        return;
+    }
+    bench_fill_log(original, inputSize, 7);
+    bench_fill_log(hot, CACHE_BENCH_HOT_SIZE, 8);
+    BOOL const bFiles = bench_write_file(inputPath, original, inputSize) &&
+                        bench_write_file(hotPath, hot, CACHE_BENCH_HOT_SIZE);
+    free(hot);
+
+    // 2. 방식별 측정
+    static const struct {
+        const TCHAR* label;
+        IoCacheMode cacheMode;
+    } kModes[] = {
+        { "cached",     IO_CACHE_DEFAULT },
+        { "sequential", IO_CACHE_SEQUENTIAL },
+        { "direct",     IO_CACHE_DIRECT },
+    };
+    for (int algorithm = LZ4; bFiles && algorithm < ALGORITHM_COUNT; algorithm++) {
+        TCHAR label[64];
+        for (size_t i = 0; i < sizeof(kModes) / sizeof(kModes[0]); i++) {
+            sprintf(label, "%s %s", (algorithm == LZ4) ? "LZ4 " : "ZSTD", kModes[i].label);
+            bench_one_mode(inputPath, outputPath, hotPath, algorithm, kModes[i].cacheMode, label, original);
+        }
+        log_message("");
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+    DeleteFile(hotPath);
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../crc32c.h"
+#include "../decompressor.h"
+#include "../utility.h"
+
+#define CHECKSUM_BENCH_INPUT_SIZE (64 * 1024 * 1024) // 압축 대상 크기
+#define CHECKSUM_BENCH_CRC_SIZE   (16 * 1024 * 1024) // CRC32C 측정 버퍼 크기
+#define CHECKSUM_BENCH_CRC_ROUNDS 8                  // CRC32C 측정 반복 횟수
+#define CHECKSUM_BENCH_REPEAT     3                  // 압축/압축 해제 측정 반복 횟수
+
+static const TCHAR* const kChecksumModeNames[] = {
+    "default", "none", "content", "block", "block+content"
+};
+
+/**
+ * @brief 압축 파일 가운데의 1 byte 를 뒤집어 손상된 파일을 만듭니다.
+ */
+static BOOL corrupt_copy(const TCHAR* srcPath, const TCHAR* dstPath) {
+    ULONGLONG const size = bench_file_size(srcPath);
+    char* const buffer = (char*)malloc((size_t)size + 1);
+    FILE* const file = fopen(srcPath, "rb");
+    BOOL bResult = (buffer && file && fread(buffer, 1, (size_t)size, file) == size);
+
+    if (file) {
+        fclose(file);
+    }
+    if (bResult) {
+        buffer[size / 2] ^= 0x01;
+        bResult = bench_write_file(dstPath, buffer, (size_t)size);
+    }
+    free(buffer);
+    return bResult;
+}
+
+/**
+ * @brief 압축 해제 결과가 원본과 같은지 확인합니다.
+ */
+static BOOL same_as_original(const TCHAR* path, const char* original, size_t size) {
+    FILE* const file = fopen(path, "rb");
+    char* const buffer = (char*)malloc(DECOMP_FILE_BUFFER_SIZE);
+    BOOL bResult = (file && buffer);
+    size_t offset = 0;
+
+    while (bResult && offset < size) {
+        size_t const toRead = (size - offset < DECOMP_FILE_BUFFER_SIZE) ? size - offset : DECOMP_FILE_BUFFER_SIZE;
+        bResult = fread(buffer, 1, toRead, file) == toRead && memcmp(buffer, original + offset, toRead) == 0;
+        offset += toRead;
+    }
+    bResult = bResult && fgetc(file) == EOF;
+
+    if (file) {
+        fclose(file);
+    }
+    free(buffer);
+    return bResult;
+}
+
+/**
+ * @brief 하나의 Checksum 설정으로 압축/압축 해제 속도와, 손상된 파일을 검출하는지 측정합니다.
+ *
+ * @param pBaseline CHECKSUM_NONE 의 [압축, 압축 해제] 속도 (MB/s). none 측정 시 설정됨
+ */
+static void bench_one_mode(
+    const TCHAR* inputPath, const TCHAR* compressedPath, const TCHAR* corruptPath, const TCHAR* outputPath,
+    const char* original, CompressionAlgorithm algorithm, ChecksumMode mode, double* pBaseline
+) {
+    TCHAR msg[300];
+    CompressionOptions options = { 0, };
+    DecompressionOptions skipOptions = { TRUE };
+    options.checksum = mode;
+
+    // 잡음을 줄이기 위해 여러 번 반복하여 가장 빠른 시간을 사용
+    BOOL bResult = TRUE;
+    double compressTime = 1e9, verifyTime = 1e9, skipTime = 1e9;
+    for (int round = 0; round < CHECKSUM_BENCH_REPEAT && bResult; round++) {
+        double start = bench_now(), elapsed;
+        bResult = compress_file_ex(inputPath, compressedPath, algorithm, &options);
+        elapsed = bench_now() - start;
+        compressTime = (elapsed < compressTime) ? elapsed : compressTime;
+
+        start = bench_now();
+        bResult = bResult && decompress_file(compressedPath, outputPath, algorithm, NULL);
+        elapsed = bench_now() - start;
+        verifyTime = (elapsed < verifyTime) ? elapsed : verifyTime;
+
+        start = bench_now();
+        bResult = bResult && decompress_file(compressedPath, outputPath, algorithm, &skipOptions);
+        elapsed = bench_now() - start;
+        skipTime = (elapsed < skipTime) ? elapsed : skipTime;
+    }
+    bResult = bResult && same_as_original(outputPath, original, CHECKSUM_BENCH_INPUT_SIZE);
+    ULONGLONG const compressedSize = bench_file_size(compressedPath);
+
+    // 손상 검출: 실패를 반환하거나, 성공했더라도 결과가 원본과 다르면 "조용한 손상"
+    const TCHAR* detection = "-";
+    if (bResult && corrupt_copy(compressedPath, corruptPath)) {
+        if (!decompress_file(corruptPath, outputPath, algorithm, NULL)) {
+            detection = "detected";
+        } else if (same_as_original(outputPath, original, CHECKSUM_BENCH_INPUT_SIZE)) {
+            detection = "harmless";
+        } else {
+            detection = "SILENT";
+        }
+    }
+
+    double const compressSpeed = CHECKSUM_BENCH_INPUT_SIZE / compressTime / (1024.0 * 1024.0);
+    double const verifySpeed = CHECKSUM_BENCH_INPUT_SIZE / verifyTime / (1024.0 * 1024.0);
+    double const skipSpeed = CHECKSUM_BENCH_INPUT_SIZE / skipTime / (1024.0 * 1024.0);
+    if (mode == CHECKSUM_NONE) {
+        pBaseline[0] = compressSpeed;
+        pBaseline[1] = verifySpeed;
+    }
+
+    sprintf(msg, "%s %-13s | %s size %9llu | compress %7.1f MB/s (%+5.1f %%) | decompress+verify %7.1f MB/s (%+5.1f %%), "
+                 "skip %7.1f MB/s | corruption %s",
+            (algorithm == LZ4) ? "LZ4 " : "ZSTD", kChecksumModeNames[mode], bResult ? "ok  " : "FAIL", compressedSize,
+            compressSpeed, pBaseline[0] > 0 ? (compressSpeed / pBaseline[0] - 1.0) * 100.0 : 0.0,
+            verifySpeed, pBaseline[1] > 0 ? (verifySpeed / pBaseline[1] - 1.0) * 100.0 : 0.0,
+            skipSpeed, detection);
+    log_message(msg);
+
+    DeleteFile(compressedPath);
+    DeleteFile(corruptPath);
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief CRC32C 하드웨어 구현과 소프트웨어 구현의 처리량을 측정합니다.
+ */
+static void bench_crc32c(const char* data) {
+    TCHAR msg[200];
+    DWORD crcHardware = 0, crcSoftware = 0;
+
+    double start = bench_now();
+    for (int i = 0; i < CHECKSUM_BENCH_CRC_ROUNDS; i++) {
+        crcHardware = crc32c(0, data, CHECKSUM_BENCH_CRC_SIZE);
+    }
+    double const hardwareTime = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < CHECKSUM_BENCH_CRC_ROUNDS; i++) {
+        crcSoftware = crc32c_software(0, data, CHECKSUM_BENCH_CRC_SIZE);
+    }
+    double const softwareTime = bench_now() - start;
+
+    // 표준 검사값: CRC32C("123456789") == 0xE3069283
+    BOOL const bValid = crcHardware == crcSoftware && crc32c(0, "123456789", 9) == 0xE3069283 &&
+        crc32c(crc32c(0, "1234", 4), "56789", 5) == 0xE3069283;
+
+    sprintf(msg, "CRC32C %s | %s (%s) %8.1f MB/s | software %8.1f MB/s",
+            bValid ? "ok  " : "FAIL", crc32c_hardware() ? "hardware" : "fallback", crc32c_hardware() ? "crc32 instr" : "table",
+            (double)CHECKSUM_BENCH_CRC_SIZE * CHECKSUM_BENCH_CRC_ROUNDS / hardwareTime / (1024.0 * 1024.0),
+            (double)CHECKSUM_BENCH_CRC_SIZE * CHECKSUM_BENCH_CRC_ROUNDS / softwareTime / (1024.0 * 1024.0));
+    log_message(msg);
+}
+
+/**
+ * @brief Checksum 설정별 압축/압축 해제 처리량 손실(none 대비 %)과 손상 검출 여부, CRC32C 속도를 측정합니다.
+ */
+void bench_checksum(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR compressedPath[MAX_PATH];
+    TCHAR corruptPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_checksum_input.log");
+    bench_temp_path(compressedPath, sizeof(compressedPath), "cesb_checksum_output.bin");
+    bench_temp_path(corruptPath, sizeof(corruptPath), "cesb_checksum_corrupt.bin");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_checksum_restored.log");
+
+    char* const original = (char*)malloc(CHECKSUM_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, CHECKSUM_BENCH_INPUT_SIZE, 13);
+
+    bench_crc32c(original);
+    log_message("");
+
+    if (!bench_write_file(inputPath, original, CHECKSUM_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        double baseline[2] = { 0, 0 };
+        for (int mode = CHECKSUM_NONE; mode <= CHECKSUM_BLOCK_AND_CONTENT; mode++) {
+            bench_one_mode(inputPath, compressedPath, corruptPath, outputPath, original, algorithm, mode, baseline);
+        }
+        log_message("");
+    }
+
+    DeleteFile(inputPath);
+    free(original);
+}
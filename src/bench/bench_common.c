@@ -0,0 +1,174 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../decompressor.h"
+
+/**
+ * @brief 고해상도 현재 시각 (초)
+ */
+double bench_now(void) {
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/**
+ * @brief Log 형태의 Benchmark 데이터를 생성합니다.
+ *
+ * 실제 Log 처럼 반복되는 문구와 변하는 숫자가 섞이도록 만들어, 압축률이 실제 Log 와 비슷하게 나오도록 합니다.
+ *
+ * @param buffer 데이터를 채울 버퍼
+ * @param size 버퍼 크기
+ * @param seed 난수 Seed (같은 Seed 는 같은 데이터를 생성)
+ */
+void bench_fill_log(char* buffer, size_t size, unsigned int seed) {
+    static const char* const kLevels[] = { "INFO", "DEBUG", "WARN", "ERROR" };
+    static const char* const kModules[] = { "sensor", "network", "storage", "scheduler", "power" };
+    static const char* const kMessages[] = {
+        "request completed",
+        "queue depth changed",
+        "retrying operation after timeout",
+        "value out of range, clamped",
+        "state transition",
+    };
+
+    size_t pos = 0;
+    unsigned int state = seed ? seed : 1;
+    unsigned int tick = 0;
+
+    while (pos < size) {
+        char line[160];
+        state = state * 1103515245u + 12345u;
+        tick += (state >> 16) % 50;
+
+        int const len = sprintf(
+            line, "%010u [%s] %s: %s id=%u value=%u\n",
+            tick, kLevels[(state >> 8) % 4], kModules[(state >> 12) % 5],
+            kMessages[(state >> 20) % 5], (state >> 4) % 1000, (state >> 10) % 65536
+        );
+
+        size_t const n = (size - pos < (size_t)len) ? (size - pos) : (size_t)len;
+        memcpy(buffer + pos, line, n);
+        pos += n;
+    }
+}
+
+/**
+ * @brief 데이터를 파일로 저장합니다.
+ *
+ * @param filePath 저장할 파일 경로
+ * @param data 저장할 데이터
+ * @param size 데이터 크기
+ * @return 성공 여부
+ */
+BOOL bench_write_file(const TCHAR* filePath, const void* data, size_t size) {
+    FILE* const file = fopen(filePath, "wb");
+    if (file == NULL) {
+        return FALSE;
+    }
+
+    size_t const written = fwrite(data, 1, size, file);
+    fclose(file);
+    return written == size;
+}
+
+/**
+ * @brief 파일 크기를 반환합니다. (파일이 없으면 0)
+ *
+ * @param filePath 파일 경로
+ * @return 파일 크기
+ */
+ULONGLONG bench_file_size(const TCHAR* filePath) {
+    LARGE_INTEGER size;
+    HANDLE hFile = CreateFile(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+
+    BOOL const bResult = GetFileSizeEx(hFile, &size);
+    CloseHandle(hFile);
+    return bResult ? (ULONGLONG)size.QuadPart : 0;
+}
+
+/**
+ * @brief 임시 폴더 아래의 Benchmark 파일 경로를 만듭니다.
+ *
+ * @param path 경로를 저장할 버퍼
+ * @param pathSize 버퍼 크기
+ * @param name 파일 이름
+ */
+void bench_temp_path(TCHAR* path, size_t pathSize, const TCHAR* name) {
+    TCHAR tempDir[MAX_PATH];
+    if (GetTempPath(MAX_PATH, tempDir) == 0) {
+        strcpy(tempDir, ".\\");
+    }
+    snprintf(path, pathSize, "%s%s", tempDir, name);
+}
+
+/**
+ * @brief 압축된 파일을 메모리에서 압축 해제하여 원본과 비교합니다. 이어 붙인 Frame 도 차례로 해제합니다.
+ *
+ * @param compressedPath 압축된 파일 경로
+ * @param algorithm 압축 알고리듬
+ * @param original 원본 데이터
+ * @param size 원본 크기
+ * @return 원본과 같으면 TRUE
+ */
+BOOL bench_verify_file(const TCHAR* compressedPath, CompressionAlgorithm algorithm, const void* original, size_t size) {
+    ULONGLONG const compressedSize = bench_file_size(compressedPath);
+    char* const compressed = (char*)malloc((size_t)compressedSize + 1);
+    char* const restored = (char*)malloc(size + 1);
+    DECOMP_Context_t* decomp = NULL;
+    BOOL bResult = FALSE;
+
+    FILE* const file = fopen(compressedPath, "rb");
+    if (compressed && restored && file &&
+        fread(compressed, 1, (size_t)compressedSize, file) == compressedSize &&
+        create_decompressor(&decomp, algorithm)) {
+        size_t srcPos = 0, restoredSize = 0;
+        bResult = TRUE;
+
+        // 원본보다 1 byte 큰 버퍼를 다 채우면 (원본보다 길면) 중단
+        while (bResult && srcPos < compressedSize && restoredSize <= size) {
+            size_t srcSize = (size_t)compressedSize - srcPos;
+            size_t dstSize = size + 1 - restoredSize;
+
+            bResult = decompress_stream(decomp, compressed + srcPos, &srcSize, restored + restoredSize, &dstSize);
+            if (bResult && srcSize == 0 && dstSize == 0) {
+                bResult = FALSE; // 진행 불가
+            }
+            srcPos += srcSize;
+            restoredSize += dstSize;
+        }
+        bResult = bResult && decomp->bFrameEnd &&
+                  restoredSize == size && memcmp(restored, original, size) == 0;
+    }
+
+    if (file) {
+        fclose(file);
+    }
+    free_decompressor(decomp);
+    free(compressed);
+    free(restored);
+    return bResult;
+}
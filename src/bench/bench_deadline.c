@@ -0,0 +1,102 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../adapt.h"
+#include "../compressor.h"
+#include "../utility.h"
+
+#define DEADLINE_BENCH_INPUT_SIZE (64 * 1024 * 1024) // 압축 대상 크기
+
+/**
+ * @brief 한 가지 마감 시간으로 압축하여 걸린 시간, 압축률, 사용한 Level 을 출력합니다.
+ *
+ * @param deadlineMillis 마감 시간 (ms, 0 이면 기본 Level 고정)
+ * @return 걸린 시간 (s), 실패 시 0
+ */
+static double bench_one_deadline(
+    const TCHAR* inputPath, const TCHAR* outputPath, CompressionAlgorithm algorithm,
+    DWORD deadlineMillis, const char* original
+) {
+    TCHAR msg[320];
+    ADAPT_Stats_t stats = { 0, };
+    CompressionOptions options = { 0, };
+
+    options.deadlineMillis = deadlineMillis;
+    options.adaptStats = &stats;
+
+    double const start = bench_now();
+    BOOL const bResult = compress_file_ex(inputPath, outputPath, algorithm, &options);
+    double const elapsed = bench_now() - start;
+
+    ULONGLONG const compressedSize = bench_file_size(outputPath);
+    BOOL const bVerified = bResult && bench_verify_file(outputPath, algorithm, original, DEADLINE_BENCH_INPUT_SIZE);
+    if (deadlineMillis == 0) {
+        sprintf(msg, "%s fixed level          %s %6.2f s | ratio %5.2f | verified %s",
+                (algorithm == LZ4) ? "LZ4 " : "ZSTD", bResult ? "ok  " : "FAIL", elapsed,
+                compressedSize ? (double)DEADLINE_BENCH_INPUT_SIZE / compressedSize : 0.0, bVerified ? "yes" : "NO ");
+    } else {
+        sprintf(msg, "%s deadline %6.2f s    %s %6.2f s (%s) | ratio %5.2f | verified %s | level %3d -> %3d "
+                     "(min %3d, max %3d, %2lu changes)",
+                (algorithm == LZ4) ? "LZ4 " : "ZSTD", deadlineMillis / 1000.0, bResult ? "ok  " : "FAIL", elapsed,
+                stats.bMetDeadline ? "met " : "MISS",
+                compressedSize ? (double)DEADLINE_BENCH_INPUT_SIZE / compressedSize : 0.0, bVerified ? "yes" : "NO ",
+                stats.startLevel, stats.finalLevel, stats.minLevel, stats.maxLevel, (unsigned long)stats.levelChanges);
+    }
+    log_message(msg);
+
+    DeleteFile(outputPath);
+    return bResult ? elapsed : 0.0;
+}
+
+/**
+ * @brief 기본 Level 로 압축한 시간을 기준으로, 그보다 짧거나 긴 마감 시간을 주어 Level 조절 결과를 비교합니다.
+ *
+ * 마감 시간이 짧으면 Level 을 내려 시간을 맞추고, 길면 Level 을 올려 압축률을 높여야 합니다.
+ */
+void bench_deadline(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_deadline_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_deadline_output.bin");
+
+    char* const original = (char*)malloc(DEADLINE_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, DEADLINE_BENCH_INPUT_SIZE, 61);
+    if (!bench_write_file(inputPath, original, DEADLINE_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    static const double kDeadlineFactors[] = { 0.7, 1.5, 3.0, 6.0 }; // 기본 Level 로 걸린 시간의 배수
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        double const baseline = bench_one_deadline(inputPath, outputPath, algorithm, 0, original);
+        if (baseline == 0.0) {
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(kDeadlineFactors) / sizeof(kDeadlineFactors[0]); i++) {
+            DWORD const deadlineMillis = (DWORD)(baseline * kDeadlineFactors[i] * 1000.0) + 1;
+            bench_one_deadline(inputPath, outputPath, algorithm, deadlineMillis, original);
+        }
+        log_message("");
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../decompressor.h"
+#include "../utility.h"
+
+#define DELTA_BENCH_SNAPSHOT_SIZE (32 * 1024 * 1024) // 상태 Dump 하나의 크기 (대략)
+#define DELTA_BENCH_VERSIONS      5                  // 만드는 Snapshot 수
+#define DELTA_BENCH_CHANGE_RATE   0.03               // Snapshot 마다 바뀌는 줄의 비율
+#define DELTA_BENCH_LINE_SIZE     96                 // 한 줄의 최대 크기
+
+/**
+ * @brief xorshift32 난수를 구합니다.
+ */
+static unsigned int bench_delta_next(unsigned int* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**
+ * @brief 상태 Dump 의 한 줄을 만듭니다. (Key 는 줄 번호, 값과 Hash 는 난수)
+ */
+static int bench_delta_line(char* line, unsigned int index, unsigned int* state) {
+    return sprintf(line, "node[%05u].slot[%02u] state=%u value=%d hash=%08x\n",
+                   index / 64, index % 64, bench_delta_next(state) % 6,
+                   (int)(bench_delta_next(state) % 200000) - 100000, bench_delta_next(state));
+}
+
+/**
+ * @brief 이전 Snapshot 에서 DELTA_BENCH_CHANGE_RATE 만큼의 줄을 바꾸고, 가끔 줄을 넣거나 빼서 다음 Snapshot 을 만듭니다.
+ *
+ * @param prev 이전 Snapshot (NULL 이면 처음부터 만듦)
+ * @param pSize 이전 Snapshot 크기 (호출 후 새 크기)
+ * @return 새 Snapshot (호출한 쪽에서 free)
+ */
+static char* bench_delta_snapshot(const char* prev, size_t* pSize, unsigned int seed) {
+    char* const next = (char*)malloc(DELTA_BENCH_SNAPSHOT_SIZE + DELTA_BENCH_SNAPSHOT_SIZE / 8);
+    unsigned int state = seed;
+    unsigned int index = 0;
+    size_t pos = 0, prevPos = 0;
+    char line[DELTA_BENCH_LINE_SIZE];
+
+    if (next == NULL) {
+        return NULL;
+    }
+    while (pos + DELTA_BENCH_LINE_SIZE < DELTA_BENCH_SNAPSHOT_SIZE) {
+        // 이전 줄 하나 (없으면 새 줄)
+        size_t prevLen = 0;
+        if (prev != NULL && prevPos < *pSize) {
+            const char* const end = (const char*)memchr(prev + prevPos, '\n', *pSize - prevPos);
+            prevLen = (end != NULL) ? (size_t)(end - (prev + prevPos)) + 1 : *pSize - prevPos;
+        }
+
+        unsigned int const dice = bench_delta_next(&state) % 10000;
+        if (prevLen > 0 && dice >= DELTA_BENCH_CHANGE_RATE * 10000) {
+            memcpy(next + pos, prev + prevPos, prevLen); // 그대로
+            pos += prevLen;
+        } else if (prevLen > 0 && dice < 20) {
+            // 줄 삭제 (이후 내용이 앞으로 당겨짐)
+        } else {
+            int const len = bench_delta_line(line, index, &state);
+            memcpy(next + pos, line, (size_t)len); // 바뀐 줄 (또는 새 줄)
+            pos += (size_t)len;
+            if (prevLen > 0 && dice < 40) {
+                memcpy(next + pos, prev + prevPos, prevLen); // 줄 삽입 (이후 내용이 뒤로 밀림)
+                pos += prevLen;
+            }
+        }
+        prevPos += prevLen;
+        index++;
+    }
+    *pSize = pos;
+    return next;
+}
+
+/**
+ * @brief 압축 파일을 풀어서 원본과 비교하고, 걸린 시간을 구합니다.
+ *
+ * @param referencePath Delta 압축의 기준 파일 (NULL 이면 없음)
+ * @param pSeconds 압축 해제에 걸린 시간 (s)
+ * @return 원본과 같으면 TRUE
+ */
+static BOOL bench_delta_verify(
+    const TCHAR* compressedPath, const TCHAR* restoredPath, const TCHAR* referencePath,
+    const char* original, size_t size, double* pSeconds
+) {
+    DecompressionOptions options = { 0, };
+    BOOL bResult = FALSE;
+
+    options.referencePath = referencePath;
+    double const start = bench_now();
+    BOOL const bDecompressed = decompress_file(compressedPath, restoredPath, ZSTD, &options);
+    *pSeconds = bench_now() - start;
+    if (bDecompressed && bench_file_size(restoredPath) == size) {
+        char* const restored = (char*)malloc(size);
+        FILE* const file = fopen(restoredPath, "rb");
+        bResult = restored && file && fread(restored, 1, size, file) == size && memcmp(restored, original, size) == 0;
+        if (file) {
+            fclose(file);
+        }
+        free(restored);
+    }
+    DeleteFile(restoredPath);
+    return bResult;
+}
+
+/**
+ * @brief 조금씩 바뀌는 상태 Dump 를 이전 버전 없이 압축한 경우와, 이전 버전을 기준으로 Delta 압축한 경우의
+ *        압축률과 속도를 비교합니다.
+ */
+void bench_delta(void) {
+    TCHAR paths[2][MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR restoredPath[MAX_PATH];
+    TCHAR msg[320];
+    char* snapshots[2] = { NULL, NULL };
+    size_t sizes[2] = { 0, 0 };
+
+    bench_temp_path(paths[0], sizeof(paths[0]), "cesb_delta_a.dump");
+    bench_temp_path(paths[1], sizeof(paths[1]), "cesb_delta_b.dump");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_delta_output.zst");
+    bench_temp_path(restoredPath, sizeof(restoredPath), "cesb_delta_restored.dump");
+
+    snapshots[0] = bench_delta_snapshot(NULL, &(sizes[0]), 47);
+    if (snapshots[0] == NULL || !bench_write_file(paths[0], snapshots[0], sizes[0])) {
+        free(snapshots[0]);
+        return;
+    }
+
+    log_message("version | mode          | ratio   | compress MB/s | decompress MB/s");
+    for (int version = 1; version < DELTA_BENCH_VERSIONS; version++) {
+        int const cur = version % 2;
+        int const prev = 1 - cur;
+
+        sizes[cur] = sizes[prev];
+        free(snapshots[cur]);
+        snapshots[cur] = bench_delta_snapshot(snapshots[prev], &(sizes[cur]), 47 + version);
+        if (snapshots[cur] == NULL || !bench_write_file(paths[cur], snapshots[cur], sizes[cur])) {
+            break;
+        }
+
+        // 0: 기본 압축, 1: LDM 만 (Window 안의 반복만 찾음), 2: 이전 버전을 기준으로 Delta 압축
+        for (int mode = 0; mode < 3; mode++) {
+            static const char* const kModeNames[] = { "full", "full + ldm", "delta (prev)" };
+            CompressionOptions options = { 0, };
+            double decompressTime = 0.0;
+
+            options.bZstdLongDistance = (mode == 1);
+            options.referencePath = (mode == 2) ? paths[prev] : NULL;
+
+            double const start = bench_now();
+            BOOL const bCompressed = compress_file_ex(paths[cur], outputPath, ZSTD, &options);
+            double const elapsed = bench_now() - start;
+            ULONGLONG const compressedSize = bench_file_size(outputPath);
+            BOOL const bVerified = bCompressed && bench_delta_verify(
+                outputPath, restoredPath, options.referencePath, snapshots[cur], sizes[cur], &decompressTime);
+            DeleteFile(outputPath);
+
+            if (!bVerified || compressedSize == 0) {
+                sprintf(msg, "%7d | %-13s | compression or verification failed", version, kModeNames[mode]);
+            } else {
+                double const mb = 1024.0 * 1024.0;
+                sprintf(msg, "%7d | %-13s | %7.2f | %13.1f | %15.1f", version, kModeNames[mode],
+                        (double)sizes[cur] / compressedSize, sizes[cur] / elapsed / mb, sizes[cur] / decompressTime / mb);
+            }
+            log_message(msg);
+        }
+    }
+
+    free(snapshots[0]);
+    free(snapshots[1]);
+    DeleteFile(paths[0]);
+    DeleteFile(paths[1]);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../utility.h"
+
+#define DURABILITY_BENCH_INPUT_SIZE (128 * 1024 * 1024) // 압축 대상 크기
+
+/**
+ * @brief 내구성 정책 (동기화 안 함, 끝낼 때, 크기 / 시간 간격) 별로 compress_file_ex 의 처리량을 비교합니다.
+ */
+void bench_durability(void) {
+    TCHAR msg[256];
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_durability_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_durability_output.bin");
+
+    char* const original = (char*)malloc(DURABILITY_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, DURABILITY_BENCH_INPUT_SIZE, 31);
+    if (!bench_write_file(inputPath, original, DURABILITY_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    static const struct {
+        const TCHAR* label;
+        IoDurability durability;
+        ULONGLONG syncBytes;
+        DWORD syncMillis;
+    } kPolicies[] = {
+        { "none",             IO_DURABILITY_NONE,         0,                 0 },
+        { "on close",         IO_DURABILITY_ON_CLOSE,     0,                 0 },
+        { "every 1 MB",       IO_DURABILITY_EVERY_BYTES,  1024 * 1024,       0 },
+        { "every 8 MB",       IO_DURABILITY_EVERY_BYTES,  8 * 1024 * 1024,   0 },
+        { "every 64 MB",      IO_DURABILITY_EVERY_BYTES,  64 * 1024 * 1024,  0 },
+        { "every 10 ms",      IO_DURABILITY_EVERY_MILLIS, 0,                 10 },
+        { "every 100 ms",     IO_DURABILITY_EVERY_MILLIS, 0,                 100 },
+        { "every 1000 ms",    IO_DURABILITY_EVERY_MILLIS, 0,                 1000 },
+    };
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        for (size_t i = 0; i < sizeof(kPolicies) / sizeof(kPolicies[0]); i++) {
+            CompressionOptions options = { 0, };
+            options.durability = kPolicies[i].durability;
+            options.syncBytes = kPolicies[i].syncBytes;
+            options.syncMillis = kPolicies[i].syncMillis;
+
+            double const start = bench_now();
+            BOOL const bResult = compress_file_ex(inputPath, outputPath, algorithm, &options);
+            double const elapsed = bench_now() - start;
+
+            BOOL const bVerified = bResult &&
+                bench_verify_file(outputPath, algorithm, original, DURABILITY_BENCH_INPUT_SIZE);
+            sprintf(msg, "%s %-14s %s %6.2f s (%7.1f MB/s) | output %9llu B, verified %s",
+                    (algorithm == LZ4) ? "LZ4 " : "ZSTD", kPolicies[i].label, bResult ? "ok  " : "FAIL", elapsed,
+                    DURABILITY_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0),
+                    bench_file_size(outputPath), bVerified ? "yes" : "NO ");
+            log_message(msg);
+
+            DeleteFile(outputPath);
+        }
+        log_message("");
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
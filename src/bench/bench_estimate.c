@@ -0,0 +1,184 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../estimate.h"
+#include "../utility.h"
+
+#define ESTIMATE_BENCH_INPUT_SIZE (32 * 1024 * 1024) // 종류별 원본 크기
+#define ESTIMATE_BENCH_SEGMENT    (1024 * 1024)      // mixed 에서 Log 와 난수가 바뀌는 간격
+
+// enum 선언
+
+typedef enum {
+    ESTIMATE_BENCH_LOG,       // 텍스트 Log
+    ESTIMATE_BENCH_RANDOM,    // 난수 (압축 불가)
+    ESTIMATE_BENCH_SPARSE,    // 대부분 0 이고 가끔 난수
+    ESTIMATE_BENCH_MIXED,     // Log 와 난수가 ESTIMATE_BENCH_SEGMENT 마다 번갈아 나옴
+    ESTIMATE_BENCH_TABLE,     // 천천히 변하는 32 bit 값의 배열 (Sensor 기록 등)
+    ESTIMATE_BENCH_CORPUS_COUNT
+} EstimateBenchCorpus;
+
+/**
+ * @brief xorshift32 난수를 구합니다.
+ */
+static unsigned int bench_estimate_next(unsigned int* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**
+ * @brief 종류별 원본 데이터를 만듭니다.
+ */
+static void bench_estimate_fill(char* buffer, size_t size, EstimateBenchCorpus corpus) {
+    unsigned int state = 0x12345678u + (unsigned int)corpus;
+
+    switch (corpus) {
+    case ESTIMATE_BENCH_LOG:
+        bench_fill_log(buffer, size, 81);
+        break;
+    case ESTIMATE_BENCH_RANDOM:
+        for (size_t i = 0; i < size; i++) {
+            buffer[i] = (char)(bench_estimate_next(&state) >> 24);
+        }
+        break;
+    case ESTIMATE_BENCH_SPARSE:
+        memset(buffer, 0, size);
+        for (size_t i = 0; i < size; i += 1 + bench_estimate_next(&state) % 128) {
+            buffer[i] = (char)(bench_estimate_next(&state) >> 24);
+        }
+        break;
+    case ESTIMATE_BENCH_MIXED:
+        bench_fill_log(buffer, size, 82);
+        for (size_t i = ESTIMATE_BENCH_SEGMENT; i < size; i += 2 * ESTIMATE_BENCH_SEGMENT) {
+            for (size_t j = i; j < i + ESTIMATE_BENCH_SEGMENT && j < size; j++) {
+                buffer[j] = (char)(bench_estimate_next(&state) >> 24);
+            }
+        }
+        break;
+    default: {
+        DWORD value = 100000;
+        for (size_t i = 0; i + sizeof(DWORD) <= size; i += sizeof(DWORD)) {
+            value += bench_estimate_next(&state) % 7;
+            value -= 3;
+            write_le32((BYTE*)buffer + i, value);
+        }
+        break;
+    }
+    }
+}
+
+/**
+ * @brief 실제 값을 잽니다. 압축률은 파일을 실제로 압축하여, 압축기 속도는 모든 Block 을 압축하여 잽니다.
+ *
+ * @param pFileSpeed 파일 압축 속도 (읽기/쓰기 포함, 참고용)
+ * @return 성공 여부
+ */
+static BOOL bench_estimate_actual(
+    const TCHAR* inputPath, const TCHAR* outputPath, CompressionAlgorithm algorithm, int level,
+    const char* original, double* pRatio, double* pSpeed, double* pFileSpeed
+) {
+    ESTIMATE_Options_t options = { 0, };
+    ESTIMATE_Result_t full;
+
+    double const start = bench_now();
+    BOOL const bResult = compress_file_ex(inputPath, outputPath, algorithm, NULL);
+    double const elapsed = bench_now() - start;
+    ULONGLONG const compressedSize = bench_file_size(outputPath);
+    DeleteFile(outputPath);
+
+    options.sampleFraction = 1.0;
+    if (!bResult || compressedSize == 0 ||
+        !estimate_compression_buffer(original, ESTIMATE_BENCH_INPUT_SIZE, algorithm, level, &options, &full)) {
+        return FALSE;
+    }
+    *pRatio = (double)ESTIMATE_BENCH_INPUT_SIZE / compressedSize;
+    *pSpeed = full.speed;
+    *pFileSpeed = ESTIMATE_BENCH_INPUT_SIZE / elapsed;
+    return TRUE;
+}
+
+/**
+ * @brief 종류별 데이터를 실제로 압축한 결과와, 표본 비율을 바꿔가며 예측한 결과를 비교합니다.
+ *
+ * 예측 구간이 실제 값을 포함하는지와 예측에 걸린 시간 (파일 압축 시간 대비) 을 출력합니다.
+ */
+void bench_estimate(void) {
+    static const TCHAR* const kCorpusNames[ESTIMATE_BENCH_CORPUS_COUNT] = { "log", "random", "sparse", "mixed", "table" };
+    static const int kLevels[ALGORITHM_COUNT] = { 0, 1 }; // compress_file 의 기본 Level
+    static const double kFractions[] = { 0.01, 0.05, 0.20 };
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR msg[320];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_estimate_input.bin");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_estimate_output.bin");
+
+    char* const original = (char*)malloc(ESTIMATE_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+
+    for (int corpus = 0; corpus < ESTIMATE_BENCH_CORPUS_COUNT; corpus++) {
+        bench_estimate_fill(original, ESTIMATE_BENCH_INPUT_SIZE, corpus);
+        if (!bench_write_file(inputPath, original, ESTIMATE_BENCH_INPUT_SIZE)) {
+            break;
+        }
+
+        for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+            double actualRatio, actualSpeed, fileSpeed;
+            if (!bench_estimate_actual(inputPath, outputPath, algorithm, kLevels[algorithm], original,
+                                       &actualRatio, &actualSpeed, &fileSpeed)) {
+                log_message("compression failed");
+                continue;
+            }
+            sprintf(msg, "%-6s %s actual   | ratio %6.2f                      | speed %7.1f MB/s (file %7.1f MB/s)",
+                    kCorpusNames[corpus], (algorithm == LZ4) ? "LZ4 " : "ZSTD",
+                    actualRatio, actualSpeed / (1024.0 * 1024.0), fileSpeed / (1024.0 * 1024.0));
+            log_message(msg);
+
+            for (size_t i = 0; i < sizeof(kFractions) / sizeof(kFractions[0]); i++) {
+                ESTIMATE_Options_t options = { 0, };
+                ESTIMATE_Result_t result;
+
+                options.sampleFraction = kFractions[i];
+                if (!estimate_compression(inputPath, algorithm, kLevels[algorithm], &options, &result)) {
+                    log_message("estimation failed");
+                    continue;
+                }
+
+                double const mb = 1024.0 * 1024.0;
+                sprintf(msg, "%-6s %s est %3.0f%% | ratio %6.2f [%6.2f, %6.2f] %s     | speed %7.1f [%7.1f, %7.1f] %s"
+                             " | entropy %4.2f | %6.1f ms (%5.1f%% of compress)",
+                        "", "    ", kFractions[i] * 100.0,
+                        result.ratio, result.ratioLow, result.ratioHigh,
+                        (actualRatio >= result.ratioLow && actualRatio <= result.ratioHigh) ? "in " : "OUT",
+                        result.speed / mb, result.speedLow / mb, result.speedHigh / mb,
+                        (actualSpeed >= result.speedLow && actualSpeed <= result.speedHigh) ? "in " : "OUT",
+                        result.entropy, result.elapsedMicros / 1000.0,
+                        result.elapsedMicros / 10000.0 / (ESTIMATE_BENCH_INPUT_SIZE / fileSpeed));
+                log_message(msg);
+            }
+        }
+        log_message("");
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../include/lz4/lz4.h"
+
+#include "bench.h"
+#include "../asyncio_win.h"
+#include "../firmware.h"
+#include "../utility.h"
+
+#define FIRMWARE_BENCH_SLOT_SIZE  (8 * 1024 * 1024) // 장치의 Image 영역 크기 (Flash 한 Slot)
+#define FIRMWARE_BENCH_IMAGE_SIZE (FIRMWARE_BENCH_SLOT_SIZE - 64 * 1024) // Image 크기 (Slot 에 64 KB 여유)
+#define FIRMWARE_BENCH_RUNS       7                 // 압축 해제 반복 수 (중앙값 사용)
+
+/**
+ * @brief xorshift32 난수를 구합니다.
+ */
+static unsigned int bench_firmware_next(unsigned int* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**
+ * @brief Firmware 와 비슷한 Image 를 만듭니다.
+ *
+ * 명령어 영역 (적은 종류의 Opcode 와 임의의 Operand), 문자열 영역, 이미 압축된 Asset (난수), 0 으로 채운 영역 순입니다.
+ * random 이 TRUE 면 전체를 난수로 채웁니다. (암호화된 Image 등 압축되지 않는 경우)
+ */
+static void bench_firmware_fill(BYTE* image, size_t size, BOOL random) {
+    static const DWORD kOpcodes[] = {
+        0xE92D4000, 0xE8BD8000, 0xE59F0000, 0xE3A00000, 0xE1A00000, 0xEB000000, 0xE12FFF1E, 0xE5900000
+    };
+    unsigned int state = 0x2468ACE1u;
+    size_t const codeEnd = random ? 0 : size / 2;
+    size_t const textEnd = random ? 0 : codeEnd + size / 4;
+    size_t const assetEnd = random ? size : textEnd + size / 8;
+    size_t pos = 0;
+
+    for (; pos + sizeof(DWORD) <= codeEnd; pos += sizeof(DWORD)) {
+        unsigned int const r = bench_firmware_next(&state);
+        write_le32(image + pos, kOpcodes[r % 8] | ((r >> 8) & ((r & 0x80) ? 0xFFF : 0xF)));
+    }
+    bench_fill_log((char*)image + pos, textEnd - pos, 48);
+    for (pos = textEnd; pos < assetEnd; pos++) {
+        image[pos] = (BYTE)(bench_firmware_next(&state) >> 24);
+    }
+    memset(image + pos, 0, size - pos);
+}
+
+/**
+ * @brief 버퍼 끝에 Package 를 둔 뒤 제자리 압축 해제하는 시간의 중앙값을 구합니다.
+ *
+ * @return 걸린 시간 (s), 실패 시 0
+ */
+static double bench_firmware_inplace(BYTE* buffer, size_t bufferSize, const BYTE* package, size_t packageSize) {
+    double elapsed[FIRMWARE_BENCH_RUNS];
+
+    for (int run = 0; run < FIRMWARE_BENCH_RUNS; run++) {
+        size_t imageSize = 0;
+        memcpy(buffer + bufferSize - packageSize, package, packageSize); // 내려받기 (시간에 포함하지 않음)
+        double const start = bench_now();
+        BOOL const bResult = firmware_decompress_inplace(buffer, bufferSize, packageSize, &imageSize);
+        elapsed[run] = bench_now() - start;
+        if (!bResult) {
+            return 0.0;
+        }
+    }
+    qsort(elapsed, FIRMWARE_BENCH_RUNS, sizeof(double), compare_double);
+    return elapsed[FIRMWARE_BENCH_RUNS / 2];
+}
+
+/**
+ * @brief 입력과 출력 버퍼를 따로 두고 LZ4 Block 을 압축 해제하는 시간의 중앙값을 구합니다. (비교용)
+ */
+static double bench_firmware_separate(BYTE* output, const BYTE* package, size_t packageSize, size_t imageSize) {
+    double elapsed[FIRMWARE_BENCH_RUNS];
+
+    for (int run = 0; run < FIRMWARE_BENCH_RUNS; run++) {
+        double const start = bench_now();
+        int const decodedSize = LZ4_decompress_safe(
+            (const char*)package + FIRMWARE_HEADER_SIZE, (char*)output,
+            (int)(packageSize - FIRMWARE_HEADER_SIZE), (int)imageSize
+        );
+        elapsed[run] = bench_now() - start;
+        if (decodedSize != (int)imageSize) {
+            return 0.0;
+        }
+    }
+    qsort(elapsed, FIRMWARE_BENCH_RUNS, sizeof(double), compare_double);
+    return elapsed[FIRMWARE_BENCH_RUNS / 2];
+}
+
+/**
+ * @brief Firmware Image 를 Package 로 만들고, Flash Slot 크기의 버퍼에서 제자리 압축 해제합니다.
+ *
+ * Package 가 Slot 에 들어가는지, 필요한 메모리 (버퍼 하나) 와 여유, 압축 해제 시간을
+ * 입력/출력 버퍼를 따로 두는 방식과 비교하여 출력합니다. 압축되지 않는 Image 도 함께 확인합니다.
+ */
+void bench_firmware(void) {
+    static const TCHAR* const kImageNames[] = { "firmware", "encrypted" };
+    TCHAR imagePath[MAX_PATH];
+    TCHAR packagePath[MAX_PATH];
+    TCHAR msg[320];
+
+    bench_temp_path(imagePath, sizeof(imagePath), "cesb_firmware.img");
+    bench_temp_path(packagePath, sizeof(packagePath), "cesb_firmware.pkg");
+
+    BYTE* const image = (BYTE*)malloc(FIRMWARE_BENCH_IMAGE_SIZE);
+    BYTE* const package = (BYTE*)malloc(firmware_package_bound(FIRMWARE_BENCH_IMAGE_SIZE));
+    BYTE* const slot = (BYTE*)malloc(FIRMWARE_BENCH_SLOT_SIZE);          // 장치의 Flash Slot
+    BYTE* const output = (BYTE*)malloc(FIRMWARE_BENCH_IMAGE_SIZE);       // 비교용 별도 출력 버퍼
+    if (image == NULL || package == NULL || slot == NULL || output == NULL) {
+        free(image);
+        free(package);
+        free(slot);
+        free(output);
+        return;
+    }
+
+    sprintf(msg, "slot %lu KB, image %lu KB",
+            (unsigned long)(FIRMWARE_BENCH_SLOT_SIZE / 1024), (unsigned long)(FIRMWARE_BENCH_IMAGE_SIZE / 1024));
+    log_message(msg);
+
+    for (int kind = 0; kind < 2; kind++) {
+        FIRMWARE_Header_t header;
+
+        bench_firmware_fill(image, FIRMWARE_BENCH_IMAGE_SIZE, kind == 1);
+        if (!bench_write_file(imagePath, image, FIRMWARE_BENCH_IMAGE_SIZE)) {
+            break;
+        }
+
+        double const start = bench_now();
+        BOOL const bPackaged = firmware_package_file(imagePath, packagePath);
+        double const packageTime = bench_now() - start;
+        ULONGLONG const packageSize = bench_file_size(packagePath);
+        HANDLE const hPackage = init_file_read(packagePath);
+        OVERLAPPED readOverlap = { 0, };
+        DWORD dwBytesRead = 0;
+        BOOL const bRead = bPackaged && hPackage != INVALID_HANDLE_VALUE &&
+                           async_read(hPackage, package, (DWORD)packageSize, &dwBytesRead, &readOverlap, TRUE) &&
+                           dwBytesRead == packageSize;
+        if (hPackage != INVALID_HANDLE_VALUE) {
+            CloseHandle(hPackage);
+        }
+        if (!bRead || !firmware_read_header(package, (size_t)packageSize, &header)) {
+            log_message("packaging failed");
+            continue;
+        }
+
+        sprintf(msg, "%-9s package %8lu bytes (ratio %5.2f%s) in %6.1f ms | in-place buffer %8lu bytes"
+                     " (image + %lu bytes, %s slot)",
+                kImageNames[kind], (unsigned long)packageSize,
+                (double)FIRMWARE_BENCH_IMAGE_SIZE / (double)packageSize,
+                (header.flags & FIRMWARE_FLAG_STORED) ? ", stored" : "", packageTime * 1000.0,
+                (unsigned long)header.bufferSize, (unsigned long)(header.bufferSize - header.imageSize),
+                (header.bufferSize <= FIRMWARE_BENCH_SLOT_SIZE) ? "fits" : "EXCEEDS");
+        log_message(msg);
+
+        // Flash Slot 끝에 Package 를 받았다고 보고 Slot 전체를 버퍼로 사용
+        double const inplaceTime = bench_firmware_inplace(slot, FIRMWARE_BENCH_SLOT_SIZE, package, (size_t)packageSize);
+        BOOL const bMatch = (inplaceTime > 0.0) && memcmp(slot, image, FIRMWARE_BENCH_IMAGE_SIZE) == 0;
+        sprintf(msg, "%-9s in-place : peak %8lu bytes, %7.2f ms (%7.1f MB/s) %s",
+                "", (unsigned long)FIRMWARE_BENCH_SLOT_SIZE, inplaceTime * 1000.0,
+                FIRMWARE_BENCH_IMAGE_SIZE / inplaceTime / (1024.0 * 1024.0), bMatch ? "OK" : "MISMATCH");
+        log_message(msg);
+
+        if ((header.flags & FIRMWARE_FLAG_STORED) == 0) {
+            double const separateTime = bench_firmware_separate(output, package, (size_t)packageSize,
+                                                                FIRMWARE_BENCH_IMAGE_SIZE);
+            sprintf(msg, "%-9s separate : peak %8lu bytes, %7.2f ms (%7.1f MB/s)",
+                    "", (unsigned long)(FIRMWARE_BENCH_IMAGE_SIZE + packageSize), separateTime * 1000.0,
+                    FIRMWARE_BENCH_IMAGE_SIZE / separateTime / (1024.0 * 1024.0));
+            log_message(msg);
+        }
+
+        // 필요한 버퍼보다 1 byte 작으면 풀지 않고 거부해야 함
+        size_t imageSize = 0;
+        memcpy(slot + header.bufferSize - 1 - packageSize, package, (size_t)packageSize);
+        sprintf(msg, "%-9s buffer - 1 byte: %s", "",
+                firmware_decompress_inplace(slot, header.bufferSize - 1, (size_t)packageSize, &imageSize)
+                    ? "accepted (BUG)" : "rejected");
+        log_message(msg);
+        log_message("");
+    }
+
+    free(image);
+    free(package);
+    free(slot);
+    free(output);
+    DeleteFile(imagePath);
+    DeleteFile(packagePath);
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../decompressor.h"
+#include "../utility.h"
+#include "../zstd_nb.h"
+
+#define LONGRANGE_BENCH_INPUT_SIZE   (256 * 1024 * 1024) // 원본 크기
+#define LONGRANGE_BENCH_STANZA_SIZE  (1024 * 1024)       // 반복되는 덩어리 (Stack Trace, 설정 Dump) 하나의 크기
+#define LONGRANGE_BENCH_STANZA_COUNT 48                  // 서로 다른 덩어리 수 (같은 덩어리는 평균 150 MB 정도 떨어져 다시 나옴)
+#define LONGRANGE_BENCH_LOG_RUN      (2 * 1024 * 1024)   // 덩어리 사이의 일반 Log 크기
+
+/**
+ * @brief 일반 Log 사이에 큰 덩어리가 멀리 떨어져 반복되는 원본을 만듭니다.
+ *
+ * 덩어리는 주소와 줄 번호가 난수인 Stack Trace 라 안에서는 잘 압축되지 않고, 같은 덩어리끼리만 일치합니다.
+ */
+static void bench_longrange_fill(char* buffer, size_t size) {
+    unsigned int state = 4501;
+    char* const stanzas = (char*)malloc((size_t)LONGRANGE_BENCH_STANZA_SIZE * LONGRANGE_BENCH_STANZA_COUNT);
+
+    bench_fill_log(buffer, size, 45);
+    if (stanzas == NULL) {
+        return;
+    }
+    for (size_t pos = 0; pos < (size_t)LONGRANGE_BENCH_STANZA_SIZE * LONGRANGE_BENCH_STANZA_COUNT; ) {
+        char line[160];
+        state = state * 1103515245u + 12345u;
+        int const len = sprintf(line, "    at module%u.Class%u.method%u(Source%u.java:%u) [0x%08x]\n",
+                                (state >> 24) % 64, (state >> 16) % 256, (state >> 8) % 128,
+                                state % 97, (state >> 4) % 5000, state ^ 0x5bd1e995u);
+        size_t const n = ((size_t)LONGRANGE_BENCH_STANZA_SIZE * LONGRANGE_BENCH_STANZA_COUNT - pos < (size_t)len) ?
+                         ((size_t)LONGRANGE_BENCH_STANZA_SIZE * LONGRANGE_BENCH_STANZA_COUNT - pos) : (size_t)len;
+        memcpy(stanzas + pos, line, n);
+        pos += n;
+    }
+
+    for (size_t pos = LONGRANGE_BENCH_LOG_RUN; pos + LONGRANGE_BENCH_STANZA_SIZE <= size;
+         pos += LONGRANGE_BENCH_LOG_RUN + LONGRANGE_BENCH_STANZA_SIZE) {
+        state = state * 1103515245u + 12345u;
+        memcpy(buffer + pos, stanzas + (size_t)((state >> 16) % LONGRANGE_BENCH_STANZA_COUNT) * LONGRANGE_BENCH_STANZA_SIZE,
+               LONGRANGE_BENCH_STANZA_SIZE);
+    }
+    free(stanzas);
+}
+
+/**
+ * @brief 압축된 파일을 풀어 원본과 비교합니다.
+ *
+ * @param windowLogMax 압축 해제에 허용할 최대 Window (0 이면 기본값)
+ * @return 원본과 같으면 TRUE
+ */
+static BOOL bench_longrange_verify(
+    const TCHAR* compressedPath, const TCHAR* restoredPath, int windowLogMax, const char* original, size_t size
+) {
+    DecompressionOptions options = { 0, };
+    BOOL bResult = FALSE;
+
+    options.windowLogMax = windowLogMax;
+    if (decompress_file(compressedPath, restoredPath, ZSTD, &options) && bench_file_size(restoredPath) == size) {
+        char* const restored = (char*)malloc(size);
+        FILE* const file = fopen(restoredPath, "rb");
+        bResult = restored && file && fread(restored, 1, size, file) == size && memcmp(restored, original, size) == 0;
+        if (file) {
+            fclose(file);
+        }
+        free(restored);
+    }
+    DeleteFile(restoredPath);
+    return bResult;
+}
+
+/**
+ * @brief 멀리 떨어져 반복되는 덩어리가 있는 Log 를 ZSTD 기본 설정과 장거리 모드 (LDM, 큰 Window) 로 압축하여
+ *        압축률, 속도, 예상/실제 메모리 사용량을 비교합니다.
+ *
+ * Window 가 27 보다 크면 기본 압축 해제 설정으로는 풀리지 않고 windowLogMax 가 필요한지도 확인합니다.
+ */
+void bench_longrange(void) {
+    static const struct {
+        const char* name;
+        BOOL bLongDistance;
+        int windowLog;
+        int ldmMinMatch;
+        int ldmHashRateLog;
+    } kConfigs[] = {
+        { "level 1 (default)", FALSE, 0, 0, 0 },
+        { "window 27",         FALSE, 27, 0, 0 },
+        { "ldm",               TRUE,  0, 0, 0 },
+        { "ldm window 30",     TRUE,  30, 0, 0 },
+        { "ldm window 31",     TRUE,  31, 0, 0 },
+        { "ldm 31 sparse",     TRUE,  31, 256, 7 },
+    };
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR restoredPath[MAX_PATH];
+    TCHAR msg[320];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_longrange_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_longrange_output.zst");
+    bench_temp_path(restoredPath, sizeof(restoredPath), "cesb_longrange_restored.log");
+
+    char* const original = (char*)malloc(LONGRANGE_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_longrange_fill(original, LONGRANGE_BENCH_INPUT_SIZE);
+    if (!bench_write_file(inputPath, original, LONGRANGE_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    log_message("config            | ratio | MB/s  | est. compress MB | used MB | est. decompress MB | default decoder");
+    for (size_t i = 0; i < sizeof(kConfigs) / sizeof(kConfigs[0]); i++) {
+        CompressionOptions options = { 0, };
+        size_t memoryUsage = 0;
+        size_t decompressMemory = 0;
+
+        options.bZstdLongDistance = kConfigs[i].bLongDistance;
+        options.zstdWindowLog = kConfigs[i].windowLog;
+        options.zstdLdmMinMatch = kConfigs[i].ldmMinMatch;
+        options.zstdLdmHashRateLog = kConfigs[i].ldmHashRateLog;
+        options.zstdMemoryUsage = &memoryUsage;
+        size_t const compressMemory = zstd_estimate_memory(&options, LONGRANGE_BENCH_INPUT_SIZE, &decompressMemory);
+
+        double const start = bench_now();
+        BOOL const bCompressed = compress_file_ex(inputPath, outputPath, ZSTD, &options);
+        double const elapsed = bench_now() - start;
+        ULONGLONG const compressedSize = bench_file_size(outputPath);
+
+        // 기본 설정으로 풀리는지, windowLogMax 를 올리면 원본과 같은지
+        BOOL const bDefaultDecoder = bCompressed &&
+            bench_longrange_verify(outputPath, restoredPath, 0, original, LONGRANGE_BENCH_INPUT_SIZE);
+        BOOL const bVerified = bDefaultDecoder || (bCompressed &&
+            bench_longrange_verify(outputPath, restoredPath, 31, original, LONGRANGE_BENCH_INPUT_SIZE));
+        DeleteFile(outputPath);
+
+        if (!bVerified || compressedSize == 0) {
+            sprintf(msg, "%-17s | compression or verification failed", kConfigs[i].name);
+            log_message(msg);
+            continue;
+        }
+        double const mb = 1024.0 * 1024.0;
+        sprintf(msg, "%-17s | %5.2f | %5.1f | %16.1f | %7.1f | %18.1f | %s",
+                kConfigs[i].name, (double)LONGRANGE_BENCH_INPUT_SIZE / compressedSize,
+                LONGRANGE_BENCH_INPUT_SIZE / elapsed / mb, compressMemory / mb, memoryUsage / mb,
+                decompressMemory / mb, bDefaultDecoder ? "ok" : "needs windowLogMax");
+        log_message(msg);
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
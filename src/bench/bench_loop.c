@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compress_loop.h"
+#include "../utility.h"
+
+#define LOOP_BENCH_JOB_COUNT 100                // 동시에 진행하는 압축 작업 수
+#define LOOP_BENCH_FILE_SIZE (1024 * 1024)      // 작업별 입력 크기
+
+// 작업 완료 집계
+typedef struct {
+    DWORD completed;       // 완료된 작업 수
+    DWORD failed;          // 실패한 작업 수
+    ULONGLONG totalIn;     // 압축한 입력 크기 합계
+    ULONGLONG totalOut;    // 쓴 출력 크기 합계
+} LoopBenchResult;
+
+static void on_job_done(BOOL bSuccess, ULONGLONG totalIn, ULONGLONG totalOut, void* userData) {
+    LoopBenchResult* const result = (LoopBenchResult*)userData;
+    result->completed++;
+    if (!bSuccess) {
+        result->failed++;
+    }
+    result->totalIn += totalIn;
+    result->totalOut += totalOut;
+}
+
+static void job_path(TCHAR* path, size_t pathSize, const TCHAR* kind, int index) {
+    TCHAR name[64];
+    sprintf(name, "cesb_loop_%s_%03d.bin", kind, index);
+    bench_temp_path(path, pathSize, name);
+}
+
+/**
+ * @brief 한 Thread 의 Event Loop 로 여러 작업을 동시에 압축하고, Loop 한 바퀴의 최대 소요 시간을 측정합니다.
+ */
+static void bench_one_loop(CompressionAlgorithm algorithm, char** originals, size_t stepBytes, DWORD stepMicros) {
+    TCHAR msg[256];
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    LoopBenchResult result = { 0, };
+
+    COMPRESS_Loop_t* loop = compress_loop_create(stepBytes, stepMicros);
+    if (loop == NULL) {
+        return;
+    }
+
+    double const start = bench_now();
+    for (int i = 0; i < LOOP_BENCH_JOB_COUNT; i++) {
+        job_path(inputPath, sizeof(inputPath), "input", i);
+        job_path(outputPath, sizeof(outputPath), "output", i);
+        if (!compress_loop_add(loop, inputPath, outputPath, algorithm, NULL, on_job_done, &result)) {
+            result.failed++;
+        }
+    }
+
+    // Application 의 Main Loop: 다른 일을 하면서 1 ms 이내로 통지를 확인
+    double maxIteration = 0.0;
+    ULONGLONG iterations = 0;
+    for (;;) {
+        double const iterationStart = bench_now();
+        LONG const active = compress_loop_poll(loop, 1);
+        double const iterationTime = bench_now() - iterationStart;
+        if (iterationTime > maxIteration) {
+            maxIteration = iterationTime;
+        }
+        iterations++;
+        if (active <= 0) {
+            break; // 모두 끝남, 또는 Loop 오류 (남은 작업은 실패로 끝남)
+        }
+    }
+    double const elapsed = bench_now() - start;
+
+    // 결과 확인
+    DWORD verified = 0;
+    for (int i = 0; i < LOOP_BENCH_JOB_COUNT; i++) {
+        job_path(outputPath, sizeof(outputPath), "output", i);
+        if (bench_verify_file(outputPath, algorithm, originals[i], LOOP_BENCH_FILE_SIZE)) {
+            verified++;
+        }
+        DeleteFile(outputPath);
+    }
+
+    sprintf(msg, "%s 1 thread, %3d jobs, step %6zu B / %4lu us | %6.3f s (%7.1f MB/s) | done %3lu, failed %lu, verified %3lu | "
+                 "ratio %5.2f | %8llu steps, %8llu wakeups, %7llu polls, max poll %7.1f us",
+            (algorithm == LZ4) ? "LZ4 " : "ZSTD", LOOP_BENCH_JOB_COUNT, stepBytes, (unsigned long)stepMicros,
+            elapsed, (double)LOOP_BENCH_JOB_COUNT * LOOP_BENCH_FILE_SIZE / elapsed / (1024.0 * 1024.0),
+            (unsigned long)result.completed, (unsigned long)result.failed, (unsigned long)verified,
+            result.totalOut ? (double)result.totalIn / (double)result.totalOut : 0.0,
+            loop->stepCount, loop->wakeupCount, iterations, maxIteration * 1e6);
+    log_message(msg);
+
+    compress_loop_free(loop);
+}
+
+/**
+ * @brief 100 개의 압축 작업을 한 Thread 의 I/O Completion Port Event Loop 로 동시에 진행하는 예제이자 Benchmark 입니다.
+ *
+ * 같은 작업을 compress_file 로 하나씩 처리한 경우와 비교합니다.
+ */
+void bench_loop(void) {
+    TCHAR msg[200];
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    char* originals[LOOP_BENCH_JOB_COUNT] = { 0, };
+
+    // 1. 입력 파일 생성
+    for (int i = 0; i < LOOP_BENCH_JOB_COUNT; i++) {
+        originals[i] = (char*)malloc(LOOP_BENCH_FILE_SIZE);
+        if (originals[i] == NULL) {
+            goto cleanup;
+        }
+        bench_fill_log(originals[i], LOOP_BENCH_FILE_SIZE, (unsigned int)i + 1);
+        job_path(inputPath, sizeof(inputPath), "input", i);
+        bench_write_file(inputPath, originals[i], LOOP_BENCH_FILE_SIZE);
+    }
+
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        // 2. 기준: compress_file 로 하나씩 처리
+        DWORD failed = 0;
+        double const start = bench_now();
+        for (int i = 0; i < LOOP_BENCH_JOB_COUNT; i++) {
+            job_path(inputPath, sizeof(inputPath), "input", i);
+            job_path(outputPath, sizeof(outputPath), "output", i);
+            if (!compress_file(inputPath, outputPath, algorithm)) {
+                failed++;
+            }
+        }
+        double const elapsed = bench_now() - start;
+        for (int i = 0; i < LOOP_BENCH_JOB_COUNT; i++) {
+            job_path(outputPath, sizeof(outputPath), "output", i);
+            DeleteFile(outputPath);
+        }
+
+        sprintf(msg, "%s sequential compress_file, %3d jobs                | %6.3f s (%7.1f MB/s) | failed %lu",
+                (algorithm == LZ4) ? "LZ4 " : "ZSTD", LOOP_BENCH_JOB_COUNT, elapsed,
+                (double)LOOP_BENCH_JOB_COUNT * LOOP_BENCH_FILE_SIZE / elapsed / (1024.0 * 1024.0),
+                (unsigned long)failed);
+        log_message(msg);
+
+        // 3. Event Loop 로 동시에 처리
+        bench_one_loop(algorithm, originals, 16 * 1024, 0);
+        bench_one_loop(algorithm, originals, 64 * 1024, 0);
+        bench_one_loop(algorithm, originals, 0, 200);
+        log_message("");
+    }
+
+cleanup:
+    for (int i = 0; i < LOOP_BENCH_JOB_COUNT; i++) {
+        job_path(inputPath, sizeof(inputPath), "input", i);
+        DeleteFile(inputPath);
+        free(originals[i]);
+    }
+}
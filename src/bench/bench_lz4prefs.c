@@ -0,0 +1,135 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../decompressor.h"
+#include "../utility.h"
+
+#define LZ4PREFS_BENCH_INPUT_SIZE (32 * 1024 * 1024) // Log 원본 크기
+
+/**
+ * @brief 압축된 파일을 메모리로 읽은 뒤, 압축 해제에 걸린 시간만 잽니다. (결과는 원본과 비교)
+ *
+ * @param pSeconds 압축 해제에 걸린 시간 (s)
+ * @return 원본과 같으면 TRUE
+ */
+static BOOL bench_lz4prefs_decompress(const TCHAR* compressedPath, const char* original, size_t size, double* pSeconds) {
+    ULONGLONG const compressedSize = bench_file_size(compressedPath);
+    char* const compressed = (char*)malloc((size_t)compressedSize + 1);
+    char* const restored = (char*)malloc(size + 1);
+    DECOMP_Context_t* decomp = NULL;
+    BOOL bResult = FALSE;
+
+    FILE* const file = fopen(compressedPath, "rb");
+    if (compressed && restored && file &&
+        fread(compressed, 1, (size_t)compressedSize, file) == compressedSize &&
+        create_decompressor(&decomp, LZ4)) {
+        size_t srcPos = 0, restoredSize = 0;
+        bResult = TRUE;
+
+        double const start = bench_now();
+        while (bResult && srcPos < compressedSize && restoredSize <= size) {
+            size_t srcSize = (size_t)compressedSize - srcPos;
+            size_t dstSize = size + 1 - restoredSize;
+
+            bResult = decompress_stream(decomp, compressed + srcPos, &srcSize, restored + restoredSize, &dstSize);
+            if (bResult && srcSize == 0 && dstSize == 0) {
+                bResult = FALSE; // 진행 불가
+            }
+            srcPos += srcSize;
+            restoredSize += dstSize;
+        }
+        *pSeconds = bench_now() - start;
+        bResult = bResult && decomp->bFrameEnd &&
+                  restoredSize == size && memcmp(restored, original, size) == 0;
+    }
+
+    if (file) {
+        fclose(file);
+    }
+    free_decompressor(decomp);
+    free(compressed);
+    free(restored);
+    return bResult;
+}
+
+/**
+ * @brief Log 데이터를 LZ4 Frame 설정 조합 (Block 크기, Block 독립, Level, favorDecSpeed) 마다 압축하고,
+ *        압축 속도, 압축률, 압축 해제 속도를 출력합니다.
+ */
+void bench_lz4prefs(void) {
+    static const DWORD kBlockSizes[] = { 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+    static const struct {
+        int level;
+        BOOL bFavorDecSpeed;
+    } kLevels[] = { { -8, FALSE }, { 0, FALSE }, { 3, FALSE }, { 9, FALSE }, { 12, FALSE }, { 12, TRUE } };
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR msg[320];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_lz4prefs_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_lz4prefs_output.lz4");
+
+    char* const original = (char*)malloc(LZ4PREFS_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, LZ4PREFS_BENCH_INPUT_SIZE, 44);
+    if (!bench_write_file(inputPath, original, LZ4PREFS_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    log_message(" block | blocks      | level | favorDec | compress MB/s | ratio | decompress MB/s");
+    for (size_t b = 0; b < sizeof(kBlockSizes) / sizeof(kBlockSizes[0]); b++) {
+        for (int independent = 0; independent <= 1; independent++) {
+            for (size_t l = 0; l < sizeof(kLevels) / sizeof(kLevels[0]); l++) {
+                CompressionOptions options = { 0, };
+                double decompressTime = 0.0;
+
+                options.lz4BlockSize = kBlockSizes[b];
+                options.bLz4IndependentBlocks = independent;
+                options.lz4Level = kLevels[l].level;
+                options.bLz4FavorDecSpeed = kLevels[l].bFavorDecSpeed;
+
+                double const start = bench_now();
+                BOOL const bCompressed = compress_file_ex(inputPath, outputPath, LZ4, &options);
+                double const compressTime = bench_now() - start;
+                ULONGLONG const compressedSize = bench_file_size(outputPath);
+                BOOL const bVerified = bCompressed &&
+                    bench_lz4prefs_decompress(outputPath, original, LZ4PREFS_BENCH_INPUT_SIZE, &decompressTime);
+                DeleteFile(outputPath);
+
+                if (!bVerified || compressedSize == 0) {
+                    log_message("compression or verification failed");
+                    continue;
+                }
+                double const mb = 1024.0 * 1024.0;
+                sprintf(msg, "%4lu K | %-11s | %5d | %-8s | %13.1f | %5.2f | %15.1f",
+                        (unsigned long)(kBlockSizes[b] / 1024), independent ? "independent" : "linked",
+                        kLevels[l].level, kLevels[l].bFavorDecSpeed ? "yes" : "no",
+                        LZ4PREFS_BENCH_INPUT_SIZE / compressTime / mb,
+                        (double)LZ4PREFS_BENCH_INPUT_SIZE / compressedSize,
+                        LZ4PREFS_BENCH_INPUT_SIZE / decompressTime / mb);
+                log_message(msg);
+            }
+        }
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
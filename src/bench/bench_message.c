@@ -0,0 +1,295 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../msg_stream.h"
+#include "../utility.h"
+#include "../../include/lz4/lz4frame.h"
+
+#define MESSAGE_BENCH_COUNT      100000      // Message 수
+#define MESSAGE_BENCH_MAX_SIZE   1024        // Message 크기 최대값 (만드는 Message 는 700 bytes 보다 작음)
+#define MESSAGE_BENCH_SLOT_SIZE  768         // Message 를 만들 때 하나에 잡는 공간
+#define MESSAGE_BENCH_DICT_SIZE  (16 * 1024) // 미리 모아 둔 Message 로 만든 사전 크기
+#define MESSAGE_BENCH_SHORT_COUNT 50000      // Ring Buffer 가 돈 뒤의 짧은 Message 확인에 쓰는 Message 수
+#define MESSAGE_BENCH_SHORT_MAX  (16 * 1024) // 위 확인의 Message 크기 최대값 (만드는 Message 보다 훨씬 큼)
+
+// Message 하나씩 LZ4F Frame 으로 만들 때의 옵션 (compress_lz4 와 같음)
+static const LZ4F_preferences_t kMessagePrefs = {
+    {
+        LZ4F_max64KB,
+        LZ4F_blockLinked,
+        LZ4F_noContentChecksum,
+        LZ4F_frame,
+        0, // Unknown size of uncompressed content
+        0, // No dictionary ID
+        LZ4F_noBlockChecksum
+    }, // Frame info
+    0, // Compression level. Default 는 0
+    0, // Auto flush
+    0, // Favor decompression speed
+    { 0, 0, 0 },  // reserved. 0 으로 설정해야함
+};
+
+// 만든 Message 들
+typedef struct {
+    char* data;               // 모든 Message 를 이어 붙인 버퍼
+    size_t* offsets;          // Message 별 시작 위치 (MESSAGE_BENCH_COUNT + 1 개)
+    BYTE* compressed;         // 압축 결과 (Message 순서대로 이어 붙임)
+    size_t compressedCapacity; // compressed 크기
+    size_t* compressedSizes;  // Message 별 압축 크기
+} MessageBenchData;
+
+/**
+ * @brief xorshift32 난수를 구합니다.
+ */
+static unsigned int bench_message_next(unsigned int* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**
+ * @brief 장치 상태 보고와 비슷한 JSON Message 를 만듭니다. (대략 150 ~ 600 bytes)
+ *
+ * @return Message 크기
+ */
+static int bench_message_make(char* p, unsigned int index, unsigned int* state) {
+    static const char* const kKinds[] = { "heartbeat", "telemetry", "alarm", "config_ack" };
+    static const char* const kZones[] = { "north-a", "north-b", "south-a", "east-c", "west-d" };
+    int length = sprintf(p, "{\"seq\":%u,\"ts\":%u,\"device\":\"sensor-%04u\",\"kind\":\"%s\",\"zone\":\"%s\",\"values\":[",
+                         index, 1700000000u + index * 3, bench_message_next(state) % 500,
+                         kKinds[bench_message_next(state) % 4], kZones[bench_message_next(state) % 5]);
+    unsigned int const valueCount = 4 + bench_message_next(state) % 24;
+
+    for (unsigned int i = 0; i < valueCount; i++) {
+        length += sprintf(p + length, "%s{\"ch\":%u,\"v\":%d}", (i == 0) ? "" : ",",
+                          i, (int)(bench_message_next(state) % 20000) - 10000);
+    }
+    length += sprintf(p + length, "],\"status\":\"%s\"}", (bench_message_next(state) % 50 == 0) ? "degraded" : "ok");
+    return length;
+}
+
+/**
+ * @brief Message 를 하나씩 LZ4F Frame 으로 압축하고 풉니다. (같은 Context 재사용)
+ *
+ * @return 성공 여부
+ */
+static BOOL bench_message_frames(MessageBenchData* bench, char* out, double* pEncode, double* pDecode, size_t* pTotal) {
+    LZ4F_cctx* cctx = NULL;
+    LZ4F_dctx* dctx = NULL;
+    BOOL bResult = !LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION)) &&
+                   !LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION));
+    size_t pos = 0;
+
+    *pTotal = 0;
+    double start = bench_now();
+    for (unsigned int i = 0; bResult && i < MESSAGE_BENCH_COUNT; i++) {
+        BYTE* const dst = bench->compressed + pos;
+        size_t const bound = bench->compressedCapacity - pos;
+        size_t const srcSize = bench->offsets[i + 1] - bench->offsets[i];
+        size_t const header = LZ4F_compressBegin(cctx, dst, bound, &kMessagePrefs);
+        size_t const body = LZ4F_isError(header) ? header :
+                            LZ4F_compressUpdate(cctx, dst + header, bound - header,
+                                                bench->data + bench->offsets[i], srcSize, NULL);
+        size_t const end = LZ4F_isError(body) ? body : LZ4F_compressEnd(cctx, dst + header + body, bound - header - body, NULL);
+        bResult = !LZ4F_isError(end);
+        bench->compressedSizes[i] = header + body + end;
+        pos += bench->compressedSizes[i];
+    }
+    *pEncode = bench_now() - start;
+    *pTotal = pos;
+
+    pos = 0;
+    start = bench_now();
+    for (unsigned int i = 0; bResult && i < MESSAGE_BENCH_COUNT; i++) {
+        size_t srcSize = bench->compressedSizes[i];
+        size_t dstSize = MESSAGE_BENCH_MAX_SIZE;
+        size_t const hint = LZ4F_decompress(dctx, out, &dstSize, bench->compressed + pos, &srcSize, NULL);
+        bResult = (hint == 0) && dstSize == bench->offsets[i + 1] - bench->offsets[i] &&
+                  memcmp(out, bench->data + bench->offsets[i], dstSize) == 0;
+        pos += bench->compressedSizes[i];
+    }
+    *pDecode = bench_now() - start;
+
+    LZ4F_freeCompressionContext(cctx);
+    LZ4F_freeDecompressionContext(dctx);
+    return bResult;
+}
+
+/**
+ * @brief Message Stream 으로 모든 Message 를 압축하고 풉니다.
+ *
+ * @return 성공 여부
+ */
+static BOOL bench_message_stream(
+    MessageBenchData* bench, const MSG_Options_t* options, char* out,
+    double* pEncode, double* pDecode, size_t* pTotal
+) {
+    MSG_Encoder_t* encoder = NULL;
+    MSG_Decoder_t* decoder = NULL;
+    BOOL bResult = msg_encoder_create(&encoder, options) && msg_decoder_create(&decoder, options);
+    size_t pos = 0;
+
+    double start = bench_now();
+    for (unsigned int i = 0; bResult && i < MESSAGE_BENCH_COUNT; i++) {
+        bResult = msg_encode(encoder, bench->data + bench->offsets[i], bench->offsets[i + 1] - bench->offsets[i],
+                             bench->compressed + pos, bench->compressedCapacity - pos, &(bench->compressedSizes[i]));
+        pos += bench->compressedSizes[i];
+    }
+    *pEncode = bench_now() - start;
+    *pTotal = pos;
+
+    pos = 0;
+    start = bench_now();
+    for (unsigned int i = 0; bResult && i < MESSAGE_BENCH_COUNT; i++) {
+        size_t dstSize = 0;
+        bResult = msg_decode(decoder, bench->compressed + pos, bench->compressedSizes[i],
+                             out, MESSAGE_BENCH_MAX_SIZE, &dstSize) &&
+                  dstSize == bench->offsets[i + 1] - bench->offsets[i] &&
+                  memcmp(out, bench->data + bench->offsets[i], dstSize) == 0;
+        pos += bench->compressedSizes[i];
+    }
+    *pDecode = bench_now() - start;
+
+    msg_encoder_free(encoder);
+    msg_decoder_free(decoder);
+    return bResult;
+}
+
+/**
+ * @brief maxMessageSize 보다 훨씬 짧은 Message 를 Ring Buffer 가 여러 번 돌 때까지 보내고, 모두 그대로 풀리는지 확인합니다.
+ *
+ * 푼 Message 의 끝 너머에 쓰는 복사가 이전 바퀴의 (아직 참조하는) 내용을 덮으면 여기서 실패합니다.
+ *
+ * @param ringSize Encoder 의 Ring Buffer 크기 (0 이면 기본값)
+ * @return 성공 여부
+ */
+static BOOL bench_message_short_after_wrap(DWORD ringSize) {
+    MSG_Options_t options = { 0, };
+    MSG_Encoder_t* encoder = NULL;
+    MSG_Decoder_t* decoder = NULL;
+    char message[MESSAGE_BENCH_SLOT_SIZE];
+    BYTE compressed[LZ4_COMPRESSBOUND(MESSAGE_BENCH_SLOT_SIZE)];
+    char out[MESSAGE_BENCH_SHORT_MAX];
+    unsigned int state = 0x2468ACE1u;
+
+    options.maxMessageSize = MESSAGE_BENCH_SHORT_MAX;
+    options.ringSize = ringSize;
+    BOOL bResult = msg_encoder_create(&encoder, &options) && msg_decoder_create(&decoder, &options);
+    for (unsigned int i = 0; bResult && i < MESSAGE_BENCH_SHORT_COUNT; i++) {
+        int const length = bench_message_make(message, i, &state);
+        size_t compressedSize = 0;
+        size_t dstSize = 0;
+        bResult = msg_encode(encoder, message, (size_t)length, compressed, sizeof(compressed), &compressedSize) &&
+                  msg_decode(decoder, compressed, compressedSize, out, sizeof(out), &dstSize) &&
+                  dstSize == (size_t)length && memcmp(out, message, dstSize) == 0;
+    }
+
+    msg_encoder_free(encoder);
+    msg_decoder_free(decoder);
+    return bResult;
+}
+
+/**
+ * @brief 작은 Message 를 하나씩 LZ4F Frame 으로 만드는 방식과 Message Stream 을 비교합니다.
+ *
+ * Message Stream 은 Acceleration, Ring Buffer 크기, 사전 유무를 바꿔 가며 초당 Message 수와 압축률을 출력합니다.
+ * 압축률은 원본 합 / 압축 결과 합이며, 전송 계층이 붙이는 길이 정보는 포함하지 않습니다.
+ */
+void bench_message(void) {
+    static const TCHAR* const kNames[] = {
+        "stream accel 1", "stream accel 4", "stream accel 16", "stream 8 KB ring", "stream + 16 KB dict"
+    };
+    static const int kAccelerations[] = { 1, 4, 16, 1, 1 };
+    static const DWORD kRingSizes[] = { 0, 0, 0, 8 * 1024, 0 };
+    MessageBenchData bench;
+    char out[MESSAGE_BENCH_MAX_SIZE];
+    char dictionary[MESSAGE_BENCH_DICT_SIZE + MESSAGE_BENCH_MAX_SIZE];
+    TCHAR msg[320];
+    unsigned int state = 0x13579BDFu;
+    double encodeTime, decodeTime;
+    size_t total;
+
+    // Frame 하나는 Message 마다 Header 와 EndMark, Block 크기가 붙으므로 원본보다 최대 LZ4F_HEADER_SIZE_MAX + 64 bytes 큼
+    bench.data = (char*)malloc((size_t)MESSAGE_BENCH_COUNT * MESSAGE_BENCH_SLOT_SIZE);
+    bench.offsets = (size_t*)malloc((MESSAGE_BENCH_COUNT + 1) * sizeof(size_t));
+    bench.compressedCapacity = (size_t)MESSAGE_BENCH_COUNT * (MESSAGE_BENCH_SLOT_SIZE + LZ4F_HEADER_SIZE_MAX + 64);
+    bench.compressed = (BYTE*)malloc(bench.compressedCapacity);
+    bench.compressedSizes = (size_t*)malloc(MESSAGE_BENCH_COUNT * sizeof(size_t));
+    if (bench.data == NULL || bench.offsets == NULL || bench.compressed == NULL || bench.compressedSizes == NULL) {
+        free(bench.data);
+        free(bench.offsets);
+        free(bench.compressed);
+        free(bench.compressedSizes);
+        return;
+    }
+
+    bench.offsets[0] = 0;
+    for (unsigned int i = 0; i < MESSAGE_BENCH_COUNT; i++) {
+        bench.offsets[i + 1] = bench.offsets[i] + bench_message_make(bench.data + bench.offsets[i], i, &state);
+    }
+    size_t const rawTotal = bench.offsets[MESSAGE_BENCH_COUNT];
+
+    // 사전: 미리 모아 둔 (벤치마크와 다른) Message 들
+    size_t dictionarySize = 0;
+    for (unsigned int i = 0; dictionarySize < MESSAGE_BENCH_DICT_SIZE; i++) {
+        dictionarySize += bench_message_make(dictionary + dictionarySize, MESSAGE_BENCH_COUNT + i, &state);
+    }
+
+    sprintf(msg, "%u messages, average %.0f bytes", MESSAGE_BENCH_COUNT, (double)rawTotal / MESSAGE_BENCH_COUNT);
+    log_message(msg);
+
+    if (bench_message_frames(&bench, out, &encodeTime, &decodeTime, &total)) {
+        sprintf(msg, "%-19s | ratio %5.2f | encode %9.0f msg/s | decode %9.0f msg/s",
+                "LZ4F frame each", (double)rawTotal / total,
+                MESSAGE_BENCH_COUNT / encodeTime, MESSAGE_BENCH_COUNT / decodeTime);
+    } else {
+        sprintf(msg, "%-19s | FAILED", "LZ4F frame each");
+    }
+    log_message(msg);
+
+    for (size_t i = 0; i < sizeof(kNames) / sizeof(kNames[0]); i++) {
+        MSG_Options_t options = { 0, };
+
+        options.maxMessageSize = MESSAGE_BENCH_MAX_SIZE;
+        options.ringSize = kRingSizes[i];
+        options.acceleration = kAccelerations[i];
+        if (i == sizeof(kNames) / sizeof(kNames[0]) - 1) {
+            options.dictionary = dictionary;
+            options.dictionarySize = dictionarySize;
+        }
+        if (bench_message_stream(&bench, &options, out, &encodeTime, &decodeTime, &total)) {
+            sprintf(msg, "%-19s | ratio %5.2f | encode %9.0f msg/s | decode %9.0f msg/s",
+                    kNames[i], (double)rawTotal / total,
+                    MESSAGE_BENCH_COUNT / encodeTime, MESSAGE_BENCH_COUNT / decodeTime);
+        } else {
+            sprintf(msg, "%-19s | FAILED", kNames[i]);
+        }
+        log_message(msg);
+    }
+
+    // 짧은 Message 가 Ring Buffer 를 여러 번 돌아도 이전 Message 를 망가뜨리지 않는지 확인
+    sprintf(msg, "%-19s | 20 KB ring %s, default ring %s", "short after wrap",
+            bench_message_short_after_wrap(MESSAGE_BENCH_SHORT_MAX + 4 * 1024) ? "ok" : "FAILED",
+            bench_message_short_after_wrap(0) ? "ok" : "FAILED");
+    log_message(msg);
+
+    free(bench.data);
+    free(bench.offsets);
+    free(bench.compressed);
+    free(bench.compressedSizes);
+}
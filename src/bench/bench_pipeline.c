@@ -0,0 +1,102 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../pipeline.h"
+#include "../utility.h"
+
+#define PIPELINE_BENCH_INPUT_SIZE  (128 * 1024 * 1024) // 압축 대상 크기
+#define PIPELINE_BENCH_READ_RATE   (96 * 1024 * 1024)  // 느린 Storage 의 읽기 대역폭 (bytes/s)
+#define PIPELINE_BENCH_WRITE_RATE  (48 * 1024 * 1024)  // 느린 Storage 의 쓰기 대역폭 (bytes/s)
+
+/**
+ * @brief 한 가지 설정으로 ZSTD 압축하여 처리량과 Stage 별로 기다린 시간을 출력합니다.
+ */
+static void bench_one_pipeline(
+    const TCHAR* inputPath, const TCHAR* outputPath, const TCHAR* storage,
+    BOOL bSlow, BOOL bPipeline, DWORD depth, const char* original
+) {
+    TCHAR msg[320];
+    IO_Throttle_t throttle;
+    PIPE_Stats_t stats = { 0, };
+    CompressionOptions options = { 0, };
+
+    if (bSlow && !io_throttle_init(&throttle, PIPELINE_BENCH_READ_RATE, PIPELINE_BENCH_WRITE_RATE, 0)) {
+        return;
+    }
+    options.throttle = bSlow ? &throttle : NULL;
+    options.bPipeline = bPipeline;
+    options.pipelineDepth = depth;
+    options.pipelineStats = &stats;
+
+    double const start = bench_now();
+    BOOL const bResult = compress_file_ex(inputPath, outputPath, ZSTD, &options);
+    double const elapsed = bench_now() - start;
+
+    BOOL const bVerified = bResult && bench_verify_file(outputPath, ZSTD, original, PIPELINE_BENCH_INPUT_SIZE);
+    if (bPipeline) {
+        sprintf(msg, "%-5s pipeline depth %2lu %s %6.2f s (%7.1f MB/s) | verified %s | stall ms: reader %6.0f, "
+                     "input %6.0f, output %6.0f, writer %6.0f",
+                storage, (unsigned long)depth, bResult ? "ok  " : "FAIL", elapsed,
+                PIPELINE_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0), bVerified ? "yes" : "NO ",
+                stats.readerStallMicros / 1000.0, stats.inputStallMicros / 1000.0,
+                stats.outputStallMicros / 1000.0, stats.writerStallMicros / 1000.0);
+    } else {
+        sprintf(msg, "%-5s single thread     %s %6.2f s (%7.1f MB/s) | verified %s",
+                storage, bResult ? "ok  " : "FAIL", elapsed,
+                PIPELINE_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0), bVerified ? "yes" : "NO ");
+    }
+    log_message(msg);
+
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief 한 Thread 에서 읽기, 압축, 쓰기 완료 대기를 모두 하는 경우와 읽기 / 압축 / 쓰기 Pipeline 을 비교합니다.
+ *
+ * 빠른 Storage 는 Temp 폴더 (대부분 File Cache 에서 처리), 느린 Storage 는 I/O 대역폭을 제한하여 흉내냅니다.
+ */
+void bench_pipeline(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_pipeline_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_pipeline_output.bin");
+
+    char* const original = (char*)malloc(PIPELINE_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, PIPELINE_BENCH_INPUT_SIZE, 41);
+    if (!bench_write_file(inputPath, original, PIPELINE_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    static const DWORD kDepths[] = { 2, 4, 8, 16 };
+    for (int slow = 0; slow < 2; slow++) {
+        const TCHAR* const storage = slow ? "slow" : "fast";
+        bench_one_pipeline(inputPath, outputPath, storage, slow, FALSE, 0, original);
+        for (size_t i = 0; i < sizeof(kDepths) / sizeof(kDepths[0]); i++) {
+            bench_one_pipeline(inputPath, outputPath, storage, slow, TRUE, kDepths[i], original);
+        }
+        log_message("");
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../task_pool.h"
+#include "../utility.h"
+
+#define POOL_BENCH_INPUT_SIZE (8 * 1024 * 1024) // 작업별 원본 크기
+#define POOL_BENCH_MAX_JOBS   64                // 최대 동시 작업 수
+
+// 구조체 선언
+
+typedef struct {
+    const TCHAR* inputPath;          // 원본 파일 (모든 작업이 공유)
+    TCHAR outputPath[MAX_PATH];      // 작업별 출력 파일
+    CompressionAlgorithm algorithm;  // 압축 알고리듬
+    TASK_Pool_t* pool;               // 공유 Pool (NULL 이면 작업 Thread 에서 압축)
+    TaskPriority priority;           // Pool 에서의 우선순위
+    BOOL bResult;                    // 압축 성공 여부
+    double elapsed;                  // 작업 시작부터 끝까지 걸린 시간 (s)
+} POOL_BENCH_Job_t;
+
+/**
+ * @brief 작업 Thread: 파일 하나를 압축합니다.
+ */
+static DWORD WINAPI bench_pool_job(LPVOID param) {
+    POOL_BENCH_Job_t* const job = (POOL_BENCH_Job_t*)param;
+    CompressionOptions options = { 0, };
+
+    options.pool = job->pool;
+    options.priority = job->priority;
+
+    double const start = bench_now();
+    job->bResult = compress_file_ex(job->inputPath, job->outputPath, job->algorithm, &options);
+    job->elapsed = bench_now() - start;
+    return 0;
+}
+
+/**
+ * @brief 작업 여러 개를 동시에 시작하여 끝날 때까지 기다리고, 전체 처리량과 작업별 지연을 출력합니다.
+ *
+ * @param bMixedPriority TRUE 이면 짝수 번째 작업은 HIGH, 홀수 번째 작업은 LOW 우선순위
+ */
+static void bench_pool_run(
+    const TCHAR* inputPath, CompressionAlgorithm algorithm, TASK_Pool_t* pool,
+    DWORD jobCount, BOOL bMixedPriority, const char* original
+) {
+    TCHAR msg[320];
+    static POOL_BENCH_Job_t jobs[POOL_BENCH_MAX_JOBS];
+    HANDLE hThreads[POOL_BENCH_MAX_JOBS];
+
+    for (DWORD i = 0; i < jobCount; i++) {
+        TCHAR name[64];
+        sprintf(name, "cesb_pool_output_%lu.bin", (unsigned long)i);
+        jobs[i].inputPath = inputPath;
+        bench_temp_path(jobs[i].outputPath, sizeof(jobs[i].outputPath), name);
+        jobs[i].algorithm = algorithm;
+        jobs[i].pool = pool;
+        jobs[i].priority = !bMixedPriority ? TASK_PRIORITY_NORMAL : (i % 2 == 0) ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW;
+        jobs[i].bResult = FALSE;
+    }
+
+    ULONGLONG executedBefore = 0, stolenBefore = 0, executedAfter = 0, stolenAfter = 0;
+    if (pool != NULL) {
+        task_pool_get_counts(pool, &executedBefore, &stolenBefore);
+    }
+
+    double const start = bench_now();
+    for (DWORD i = 0; i < jobCount; i++) {
+        hThreads[i] = CreateThread(NULL, 0, bench_pool_job, &(jobs[i]), 0, NULL);
+    }
+    for (DWORD i = 0; i < jobCount; i++) {
+        if (hThreads[i] != NULL) {
+            WaitForSingleObject(hThreads[i], INFINITE);
+            CloseHandle(hThreads[i]);
+        }
+    }
+    double const elapsed = bench_now() - start;
+
+    if (pool != NULL) {
+        task_pool_get_counts(pool, &executedAfter, &stolenAfter);
+    }
+
+    // 결과 (검증은 첫 작업의 출력만)
+    BOOL bResult = TRUE;
+    double sum[TASK_PRIORITY_COUNT] = { 0.0, };
+    double maxLatency[TASK_PRIORITY_COUNT] = { 0.0, };
+    DWORD count[TASK_PRIORITY_COUNT] = { 0, };
+    for (DWORD i = 0; i < jobCount; i++) {
+        bResult = bResult && jobs[i].bResult;
+        sum[jobs[i].priority] += jobs[i].elapsed;
+        count[jobs[i].priority]++;
+        if (jobs[i].elapsed > maxLatency[jobs[i].priority]) {
+            maxLatency[jobs[i].priority] = jobs[i].elapsed;
+        }
+    }
+    BOOL const bVerified = bResult && bench_verify_file(jobs[0].outputPath, algorithm, original, POOL_BENCH_INPUT_SIZE);
+    for (DWORD i = 0; i < jobCount; i++) {
+        DeleteFile(jobs[i].outputPath);
+    }
+
+    sprintf(msg, "%s %-11s %2lu jobs %s %6.2f s (%7.1f MB/s) | verified %s | tasks %6llu, stolen %4llu",
+            (algorithm == LZ4) ? "LZ4 " : "ZSTD", (pool != NULL) ? "shared pool" : "own thread",
+            (unsigned long)jobCount, bResult ? "ok  " : "FAIL", elapsed,
+            (double)POOL_BENCH_INPUT_SIZE * jobCount / elapsed / (1024.0 * 1024.0), bVerified ? "yes" : "NO ",
+            executedAfter - executedBefore, stolenAfter - stolenBefore);
+    log_message(msg);
+
+    for (int p = 0; p < TASK_PRIORITY_COUNT; p++) {
+        static const TCHAR* const kNames[TASK_PRIORITY_COUNT] = { "normal", "high", "low" };
+        if (count[p] > 0) {
+            sprintf(msg, "    %-6s job latency avg %6.2f s, max %6.2f s",
+                    kNames[p], sum[p] / count[p], maxLatency[p]);
+            log_message(msg);
+        }
+    }
+}
+
+/**
+ * @brief 동시에 압축하는 작업 수를 1 ~ 64 로 늘려가며, 작업마다 Thread 에서 압축하는 경우와 공유 Pool 을 사용하는 경우를 비교합니다.
+ *
+ * 마지막으로 공유 Pool 에서 HIGH 와 LOW 우선순위 작업을 섞어, 우선순위별 지연을 비교합니다.
+ */
+void bench_pool(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR msg[128];
+
+    TASK_Pool_t* const pool = task_pool_shared();
+    if (pool == NULL) {
+        return;
+    }
+    sprintf(msg, "shared pool: %lu task workers, %lu zstd workers",
+            (unsigned long)pool->workerCount, (unsigned long)pool->zstdWorkerCount);
+    log_message(msg);
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_pool_input.log");
+    char* const original = (char*)malloc(POOL_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, POOL_BENCH_INPUT_SIZE, 51);
+    if (!bench_write_file(inputPath, original, POOL_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    static const DWORD kJobCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        for (size_t i = 0; i < sizeof(kJobCounts) / sizeof(kJobCounts[0]); i++) {
+            bench_pool_run(inputPath, algorithm, NULL, kJobCounts[i], FALSE, original);
+            bench_pool_run(inputPath, algorithm, pool, kJobCounts[i], FALSE, original);
+        }
+        log_message("");
+    }
+
+    log_message("mixed priority (half HIGH, half LOW):");
+    bench_pool_run(inputPath, LZ4, pool, 16, TRUE, original);
+
+    free(original);
+    DeleteFile(inputPath);
+}
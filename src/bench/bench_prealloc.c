@@ -0,0 +1,209 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <winioctl.h> // FSCTL_GET_RETRIEVAL_POINTERS
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../io_stage.h"
+#include "../utility.h"
+
+#define PREALLOC_BENCH_WRITERS    4                   // 동시에 커지는 출력 파일 수
+#define PREALLOC_BENCH_FILE_SIZE  (64 * 1024 * 1024)  // 출력 파일별 크기
+#define PREALLOC_BENCH_PIECE_SIZE (20 * 1024)         // 한 번에 쓰는 압축 결과 크기
+#define PREALLOC_BENCH_RATIO      3                   // 가정한 압축률 (원본 / 압축)
+#define PREALLOC_BENCH_INPUT_SIZE (128 * 1024 * 1024) // compress_file_ex 측정의 원본 크기
+
+/**
+ * @brief 파일이 Disk 에서 몇 조각 (Extent) 으로 나뉘어 있는지 셉니다.
+ *
+ * @param filePath 파일 경로
+ * @return Extent 수, 알 수 없으면 0
+ */
+static DWORD count_extents(const TCHAR* filePath) {
+    STARTING_VCN_INPUT_BUFFER input = { 0, };
+    ULONGLONG output[512]; // RETRIEVAL_POINTERS_BUFFER (8 byte 정렬)
+    RETRIEVAL_POINTERS_BUFFER* const pointers = (RETRIEVAL_POINTERS_BUFFER*)output;
+    DWORD dwBytes;
+    DWORD extents = 0;
+
+    HANDLE hFile = CreateFile(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+
+    for (;;) {
+        BOOL const bResult = DeviceIoControl(
+            hFile, FSCTL_GET_RETRIEVAL_POINTERS, &input, sizeof(input),
+            pointers, sizeof(output), &dwBytes, NULL
+        );
+        if (!bResult && GetLastError() != ERROR_MORE_DATA) {
+            break;
+        }
+        extents += pointers->ExtentCount;
+        if (bResult || pointers->ExtentCount == 0) {
+            break;
+        }
+        input.StartingVcn = pointers->Extents[pointers->ExtentCount - 1].NextVcn; // 이어서 조회
+    }
+
+    CloseHandle(hFile);
+    return extents;
+}
+
+/**
+ * @brief 여러 출력 파일이 번갈아 커지는 상황에서, 미리 할당 여부에 따른 쓰기 지연과 조각 수를 측정합니다.
+ */
+static void bench_interleaved(BOOL bPreallocate, const BYTE* piece) {
+    TCHAR msg[256];
+    TCHAR paths[PREALLOC_BENCH_WRITERS][MAX_PATH];
+    HANDLE hFiles[PREALLOC_BENCH_WRITERS];
+    IO_Stage_t* stages[PREALLOC_BENCH_WRITERS] = { 0, };
+    size_t const piecesPerFile = PREALLOC_BENCH_FILE_SIZE / PREALLOC_BENCH_PIECE_SIZE;
+    size_t const sampleCount = piecesPerFile * PREALLOC_BENCH_WRITERS;
+    BOOL bResult = TRUE;
+
+    double* const samples = (double*)malloc(sampleCount * sizeof(double));
+    if (samples == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < PREALLOC_BENCH_WRITERS; i++) {
+        TCHAR name[64];
+        sprintf(name, "cesb_prealloc_%d.bin", i);
+        bench_temp_path(paths[i], sizeof(paths[i]), name);
+        hFiles[i] = init_file_write(paths[i]);
+        if (hFiles[i] != INVALID_HANDLE_VALUE) {
+            stages[i] = io_stage_create(hFiles[i], IO_STAGE_DEFAULT_SIZE, IO_DEFAULT_ALIGNMENT, FALSE, NULL);
+        }
+        if (stages[i] == NULL) {
+            bResult = FALSE;
+        } else if (bPreallocate) {
+            io_stage_preallocate(stages[i], (ULONGLONG)PREALLOC_BENCH_FILE_SIZE * PREALLOC_BENCH_RATIO);
+        }
+    }
+
+    // 1. 압축 결과 크기의 조각을 파일마다 번갈아 씀
+    double const start = bench_now();
+    for (size_t n = 0; bResult && n < sampleCount; n++) {
+        IO_Stage_t* const stage = stages[n % PREALLOC_BENCH_WRITERS];
+        io_stage_add_input(stage, (ULONGLONG)PREALLOC_BENCH_PIECE_SIZE * PREALLOC_BENCH_RATIO);
+
+        double const writeStart = bench_now();
+        bResult = io_stage_write(stage, piece, PREALLOC_BENCH_PIECE_SIZE);
+        samples[n] = bench_now() - writeStart;
+    }
+
+    ULONGLONG allocations = 0;
+    for (int i = 0; i < PREALLOC_BENCH_WRITERS; i++) {
+        if (stages[i] != NULL) {
+            bResult = io_stage_finish(stages[i]) && bResult;
+            allocations += stages[i]->allocationCount;
+            io_stage_free(stages[i]);
+        }
+        if (hFiles[i] != INVALID_HANDLE_VALUE) {
+            FlushFileBuffers(hFiles[i]); // 지연 할당되는 File System 에서도 실제 위치가 정해지도록
+            CloseHandle(hFiles[i]);
+        }
+    }
+    double const elapsed = bench_now() - start;
+
+    // 2. 결과
+    DWORD extents = 0;
+    BOOL bSizeOk = TRUE;
+    for (int i = 0; i < PREALLOC_BENCH_WRITERS; i++) {
+        extents += count_extents(paths[i]);
+        bSizeOk = bSizeOk && (bench_file_size(paths[i]) == piecesPerFile * PREALLOC_BENCH_PIECE_SIZE);
+        DeleteFile(paths[i]);
+    }
+
+    qsort(samples, sampleCount, sizeof(double), compare_double);
+    double sum = 0.0;
+    for (size_t i = 0; i < sampleCount; i++) {
+        sum += samples[i];
+    }
+
+    sprintf(msg, "%d writers, %-13s %s %6.2f s (%7.1f MB/s) | size %s | write avg %6.1f us, p99 %7.1f us, max %8.1f us | "
+                 "allocations %3llu, extents %5lu",
+            PREALLOC_BENCH_WRITERS, bPreallocate ? "preallocated" : "growing", bResult ? "ok  " : "FAIL", elapsed,
+            (double)PREALLOC_BENCH_FILE_SIZE * PREALLOC_BENCH_WRITERS / elapsed / (1024.0 * 1024.0),
+            bSizeOk ? "exact" : "WRONG", sum / (double)sampleCount * 1e6, samples[(sampleCount * 99) / 100] * 1e6,
+            samples[sampleCount - 1] * 1e6, allocations, (unsigned long)extents);
+    log_message(msg);
+
+    free(samples);
+}
+
+/**
+ * @brief compress_file_ex 의 미리 할당 여부에 따른 처리량과 출력 파일의 조각 수를 측정합니다.
+ */
+static void bench_compress(CompressionAlgorithm algorithm, BOOL bPreallocate, const TCHAR* inputPath, const char* original) {
+    TCHAR msg[256];
+    TCHAR outputPath[MAX_PATH];
+    CompressionOptions options = { 0, };
+
+    options.bOutputStaging = TRUE;
+    options.bPreallocate = bPreallocate;
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_prealloc_output.bin");
+
+    double const start = bench_now();
+    BOOL const bResult = compress_file_ex(inputPath, outputPath, algorithm, &options);
+    double const elapsed = bench_now() - start;
+
+    BOOL const bVerified = bResult && bench_verify_file(outputPath, algorithm, original, PREALLOC_BENCH_INPUT_SIZE);
+    sprintf(msg, "%s compress, %-13s %s %6.2f s (%7.1f MB/s) | output %9llu B, verified %s | extents %5lu",
+            (algorithm == LZ4) ? "LZ4 " : "ZSTD", bPreallocate ? "preallocated" : "growing", bResult ? "ok  " : "FAIL",
+            elapsed, PREALLOC_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0),
+            bench_file_size(outputPath), bVerified ? "yes" : "NO ", (unsigned long)count_extents(outputPath));
+    log_message(msg);
+
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief 출력 파일을 예상 크기만큼 미리 할당한 경우와 쓰는 대로 커지게 둔 경우의 쓰기 지연과 파일 조각 수를 비교합니다.
+ */
+void bench_prealloc(void) {
+    TCHAR inputPath[MAX_PATH];
+
+    // 1. 여러 파일이 번갈아 커지는 경우 (압축 결과 크기의 조각을 바로 씀)
+    BYTE* const piece = (BYTE*)malloc(PREALLOC_BENCH_PIECE_SIZE);
+    if (piece == NULL) {
+        return;
+    }
+    bench_fill_log((char*)piece, PREALLOC_BENCH_PIECE_SIZE, 21);
+    bench_interleaved(FALSE, piece);
+    bench_interleaved(TRUE, piece);
+    free(piece);
+    log_message("");
+
+    // 2. compress_file_ex
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_prealloc_input.log");
+    char* const original = (char*)malloc(PREALLOC_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, PREALLOC_BENCH_INPUT_SIZE, 22);
+    if (bench_write_file(inputPath, original, PREALLOC_BENCH_INPUT_SIZE)) {
+        for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+            bench_compress(algorithm, FALSE, inputPath, original);
+            bench_compress(algorithm, TRUE, inputPath, original);
+        }
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../recover.h"
+#include "../utility.h"
+
+#define RECOVER_BENCH_INPUT_SIZE (64 * 1024 * 1024) // 압축 대상 크기
+#define RECOVER_BENCH_CUT_PERMILLE 618               // 압축 파일을 자르는 위치 (전체의 61.8 %)
+
+/**
+ * @brief 파일 앞부분 size bytes 를 다른 파일로 복사합니다. (전원 차단으로 잘린 파일 흉내)
+ */
+static BOOL copy_prefix(const TCHAR* srcPath, const TCHAR* dstPath, ULONGLONG size) {
+    FILE* const src = fopen(srcPath, "rb");
+    FILE* const dst = fopen(dstPath, "wb");
+    char* const buffer = (char*)malloc(RECOVER_READ_SIZE);
+    BOOL bResult = (src && dst && buffer);
+
+    while (bResult && size > 0) {
+        size_t const toCopy = (size_t)(size < RECOVER_READ_SIZE ? size : RECOVER_READ_SIZE);
+        bResult = fread(buffer, 1, toCopy, src) == toCopy && fwrite(buffer, 1, toCopy, dst) == toCopy;
+        size -= toCopy;
+    }
+
+    if (src) {
+        fclose(src);
+    }
+    if (dst) {
+        fclose(dst);
+    }
+    free(buffer);
+    return bResult;
+}
+
+/**
+ * @brief 복구된 파일이 원본의 앞부분과 같은지 확인합니다.
+ */
+static BOOL verify_prefix(const TCHAR* restoredPath, const char* original, ULONGLONG size) {
+    FILE* const file = fopen(restoredPath, "rb");
+    char* const buffer = (char*)malloc(RECOVER_READ_SIZE);
+    BOOL bResult = (file && buffer);
+    ULONGLONG offset = 0;
+
+    while (bResult && offset < size) {
+        size_t const toRead = (size_t)(size - offset < RECOVER_READ_SIZE ? size - offset : RECOVER_READ_SIZE);
+        bResult = fread(buffer, 1, toRead, file) == toRead && memcmp(buffer, original + offset, toRead) == 0;
+        offset += toRead;
+    }
+
+    if (file) {
+        fclose(file);
+    }
+    free(buffer);
+    return bResult;
+}
+
+/**
+ * @brief 하나의 Flush Point 간격으로 압축하고, 압축률 손실과 잘린 파일의 복구량/복구 속도를 측정합니다.
+ */
+static void bench_one_interval(
+    const TCHAR* inputPath, const TCHAR* outputPath, const TCHAR* cutPath, const TCHAR* restoredPath,
+    const char* original, CompressionAlgorithm algorithm, ULONGLONG flushPointBytes
+) {
+    TCHAR msg[300];
+    CompressionOptions options = { 0, };
+    RECOVER_Result_t scanResult, extractResult;
+    options.flushPointBytes = flushPointBytes;
+
+    double const start = bench_now();
+    BOOL const bCompressed = compress_file_ex(inputPath, outputPath, algorithm, &options);
+    double const compressTime = bench_now() - start;
+    ULONGLONG const compressedSize = bench_file_size(outputPath);
+
+    // 압축 파일을 중간에서 자르고 복구
+    ULONGLONG const cutSize = compressedSize * RECOVER_BENCH_CUT_PERMILLE / 1000;
+    BOOL bResult = bCompressed && copy_prefix(outputPath, cutPath, cutSize);
+
+    double const scanStart = bench_now();
+    bResult = bResult && recover_scan(cutPath, &scanResult);
+    double const scanTime = bench_now() - scanStart;
+
+    double const extractStart = bench_now();
+    bResult = bResult && recover_extract(cutPath, restoredPath, &extractResult);
+    double const extractTime = bench_now() - extractStart;
+
+    bResult = bResult && verify_prefix(restoredPath, original, extractResult.restoredBytes);
+
+    TCHAR interval[32];
+    if (flushPointBytes == 0) {
+        strcpy(interval, "none");
+    } else {
+        sprintf(interval, "%llu KB", flushPointBytes / 1024);
+    }
+
+    sprintf(msg, "%s flush point %-8s | %s ratio %5.2f, %6.1f MB/s | %6llu frames kept, salvaged %5.1f %% of cut input | "
+                 "scan %7.1f MB/s, extract %6.1f MB/s",
+            (algorithm == LZ4) ? "LZ4 " : "ZSTD", interval, bResult ? "ok  " : "FAIL",
+            compressedSize ? (double)RECOVER_BENCH_INPUT_SIZE / (double)compressedSize : 0.0,
+            RECOVER_BENCH_INPUT_SIZE / compressTime / (1024.0 * 1024.0),
+            bResult ? scanResult.frameCount : 0ULL,
+            bResult ? extractResult.restoredBytes * 100.0 / (RECOVER_BENCH_INPUT_SIZE * (RECOVER_BENCH_CUT_PERMILLE / 1000.0)) : 0.0,
+            bResult && scanTime > 0 ? cutSize / scanTime / (1024.0 * 1024.0) : 0.0,
+            bResult && extractTime > 0 ? cutSize / extractTime / (1024.0 * 1024.0) : 0.0);
+    log_message(msg);
+
+    DeleteFile(outputPath);
+    DeleteFile(cutPath);
+    DeleteFile(restoredPath);
+}
+
+/**
+ * @brief Flush Point 간격별 압축률 손실과, 잘린 압축 파일에서 복구할 수 있는 양을 측정합니다.
+ */
+void bench_recover(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR cutPath[MAX_PATH];
+    TCHAR restoredPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_recover_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_recover_output.bin");
+    bench_temp_path(cutPath, sizeof(cutPath), "cesb_recover_cut.bin");
+    bench_temp_path(restoredPath, sizeof(restoredPath), "cesb_recover_restored.log");
+
+    char* const original = (char*)malloc(RECOVER_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, RECOVER_BENCH_INPUT_SIZE, 5);
+    if (!bench_write_file(inputPath, original, RECOVER_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    static const ULONGLONG kIntervals[] = {
+        0, 16 * 1024 * 1024, 4 * 1024 * 1024, 1024 * 1024, 256 * 1024, 64 * 1024
+    };
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        for (size_t i = 0; i < sizeof(kIntervals) / sizeof(kIntervals[0]); i++) {
+            bench_one_interval(inputPath, outputPath, cutPath, restoredPath, original, algorithm, kIntervals[i]);
+        }
+        log_message("");
+    }
+
+    DeleteFile(inputPath);
+    free(original);
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../decompressor.h"
+#include "../seekable.h"
+#include "../utility.h"
+
+#define SEEKABLE_BENCH_INPUT_SIZE   (64 * 1024 * 1024) // 원본 크기
+#define SEEKABLE_BENCH_READ_SIZE    4096               // 임의 읽기 한 번의 크기
+#define SEEKABLE_BENCH_READS        20000              // 임의 읽기 수
+#define SEEKABLE_BENCH_FRAME_READS  16                 // Frame 에서의 임의 읽기 수 (처음부터 풀어야 하므로 적게)
+#define SEEKABLE_BENCH_HOT_SIZE     (1024 * 1024)      // 국소성 있는 읽기에서 자주 읽는 영역 크기
+#define SEEKABLE_BENCH_HOT_PERCENT  90                 // 국소성 있는 읽기에서 자주 읽는 영역을 읽는 비율
+#define SEEKABLE_BENCH_SCRATCH_SIZE (1024 * 1024)      // Frame 을 풀 때 쓰는 버퍼
+
+/**
+ * @brief xorshift32 난수를 구합니다.
+ */
+static unsigned int bench_seekable_next(unsigned int* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**
+ * @brief 읽을 위치를 고릅니다.
+ *
+ * @param bLocal TRUE 면 SEEKABLE_BENCH_HOT_PERCENT 확률로 앞부분 SEEKABLE_BENCH_HOT_SIZE 안에서 고름
+ */
+static ULONGLONG bench_seekable_offset(unsigned int* state, BOOL bLocal) {
+    ULONGLONG range = SEEKABLE_BENCH_INPUT_SIZE - SEEKABLE_BENCH_READ_SIZE;
+
+    if (bLocal && bench_seekable_next(state) % 100 < SEEKABLE_BENCH_HOT_PERCENT) {
+        range = SEEKABLE_BENCH_HOT_SIZE - SEEKABLE_BENCH_READ_SIZE;
+    }
+    return ((ULONGLONG)bench_seekable_next(state) << 8 ^ bench_seekable_next(state)) % range;
+}
+
+/**
+ * @brief compress_file 로 만든 LZ4 Frame 을 처음부터 target 위치까지 풉니다.
+ *
+ * Frame 의 Block 은 이어져 있으므로 임의 위치를 읽으려면 이렇게 해야 합니다.
+ *
+ * @return 성공 여부
+ */
+static BOOL bench_seekable_frame_to(
+    DECOMP_Context_t* decomp, const BYTE* src, size_t srcSize, BYTE* scratch, ULONGLONG target
+) {
+    ULONGLONG produced = 0;
+    size_t pos = 0;
+
+    LZ4F_resetDecompressionContext(decomp->lz4DctxPtr);
+    while (produced < target && pos < srcSize) {
+        size_t srcLength = srcSize - pos;
+        size_t dstLength = SEEKABLE_BENCH_SCRATCH_SIZE;
+        if (!decompress_stream(decomp, src + pos, &srcLength, scratch, &dstLength)) {
+            return FALSE;
+        }
+        pos += srcLength;
+        produced += dstLength;
+    }
+    return produced >= target;
+}
+
+/**
+ * @brief 임의 읽기를 SEEKABLE_BENCH_READS 번 하여 지연의 중앙값과 99 백분위 값을 구하고, 읽은 내용을 원본과 비교합니다.
+ *
+ * @return 성공 여부
+ */
+static BOOL bench_seekable_random(
+    SEEKABLE_Reader_t* reader, const char* original, BOOL bLocal, double* latencies, double* pMedian, double* pP99
+) {
+    BYTE buffer[SEEKABLE_BENCH_READ_SIZE];
+    unsigned int state = 0x9E3779B9u;
+
+    for (int i = 0; i < SEEKABLE_BENCH_READS; i++) {
+        ULONGLONG const offset = bench_seekable_offset(&state, bLocal);
+        size_t bytesRead = 0;
+        double const start = bench_now();
+        BOOL const bResult = seekable_reader_read(reader, offset, buffer, SEEKABLE_BENCH_READ_SIZE, &bytesRead);
+        latencies[i] = bench_now() - start;
+        if (!bResult || bytesRead != SEEKABLE_BENCH_READ_SIZE ||
+            memcmp(buffer, original + offset, SEEKABLE_BENCH_READ_SIZE) != 0) {
+            return FALSE;
+        }
+    }
+    qsort(latencies, SEEKABLE_BENCH_READS, sizeof(double), compare_double);
+    *pMedian = latencies[SEEKABLE_BENCH_READS / 2];
+    *pP99 = latencies[SEEKABLE_BENCH_READS * 99 / 100];
+    return TRUE;
+}
+
+/**
+ * @brief 같은 원본을 LZ4 Frame (compress_file) 과 Block Index 형식 (Block 크기별) 으로 압축하고,
+ *        압축률과 순차 전체 읽기 시간, 4 KB 임의 읽기 지연 (고른 분포 / 국소성 있는 분포) 을 비교합니다.
+ */
+void bench_seekable(void) {
+    static const DWORD kBlockSizes[] = { 4 * 1024, 16 * 1024, 64 * 1024, 256 * 1024 };
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR msg[320];
+    double const mb = 1024.0 * 1024.0;
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_seekable_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_seekable_output.bin");
+
+    char* const original = (char*)malloc(SEEKABLE_BENCH_INPUT_SIZE);
+    BYTE* const scratch = (BYTE*)malloc(SEEKABLE_BENCH_INPUT_SIZE);
+    double* const latencies = (double*)malloc(SEEKABLE_BENCH_READS * sizeof(double));
+    if (original == NULL || scratch == NULL || latencies == NULL) {
+        free(original);
+        free(scratch);
+        free(latencies);
+        return;
+    }
+    bench_fill_log(original, SEEKABLE_BENCH_INPUT_SIZE, 49);
+    if (!bench_write_file(inputPath, original, SEEKABLE_BENCH_INPUT_SIZE)) {
+        free(original);
+        free(scratch);
+        free(latencies);
+        return;
+    }
+
+    // LZ4 Frame: 임의 위치를 읽으려면 처음부터 그 위치까지 풀어야 함
+    DECOMP_Context_t* decomp = NULL;
+    IO_Mapping_t frame = { INVALID_HANDLE_VALUE, NULL, NULL, 0 };
+    if (compress_file(inputPath, outputPath, LZ4) && io_map_file(outputPath, &frame) &&
+        create_decompressor(&decomp, LZ4)) {
+        unsigned int state = 0x9E3779B9u;
+        double elapsed = 0.0;
+        BOOL bResult = TRUE;
+
+        double const start = bench_now();
+        bResult = bench_seekable_frame_to(decomp, frame.data, frame.size, scratch, SEEKABLE_BENCH_INPUT_SIZE);
+        double const sequential = bench_now() - start;
+        for (int i = 0; bResult && i < SEEKABLE_BENCH_FRAME_READS; i++) {
+            ULONGLONG const offset = bench_seekable_offset(&state, FALSE);
+            double const readStart = bench_now();
+            bResult = bench_seekable_frame_to(decomp, frame.data, frame.size, scratch,
+                                              offset + SEEKABLE_BENCH_READ_SIZE);
+            elapsed += bench_now() - readStart;
+        }
+        sprintf(msg, "LZ4 frame      | ratio %5.2f | sequential %7.1f ms (%7.1f MB/s) | random 4 KB avg %9.1f us%s",
+                (double)SEEKABLE_BENCH_INPUT_SIZE / frame.size, sequential * 1000.0,
+                SEEKABLE_BENCH_INPUT_SIZE / sequential / mb,
+                elapsed * 1e6 / SEEKABLE_BENCH_FRAME_READS, bResult ? "" : " (FAILED)");
+        log_message(msg);
+    } else {
+        log_message("LZ4 frame compression failed");
+    }
+    free_decompressor(decomp);
+    io_unmap_file(&frame);
+    DeleteFile(outputPath);
+
+    for (size_t i = 0; i < sizeof(kBlockSizes) / sizeof(kBlockSizes[0]); i++) {
+        SEEKABLE_Options_t options = { 0, };
+        double uniformMedian, uniformP99, localMedian, localP99;
+
+        options.blockSize = kBlockSizes[i];
+        if (!seekable_compress_file(inputPath, outputPath, &options)) {
+            log_message("seekable compression failed");
+            continue;
+        }
+        ULONGLONG const compressedSize = bench_file_size(outputPath);
+        SEEKABLE_Reader_t* const reader = seekable_reader_open(outputPath, 0);
+        if (reader == NULL) {
+            DeleteFile(outputPath);
+            continue;
+        }
+
+        size_t bytesRead = 0;
+        double const start = bench_now();
+        BOOL bResult = seekable_reader_read(reader, 0, scratch, SEEKABLE_BENCH_INPUT_SIZE, &bytesRead);
+        double const sequential = bench_now() - start;
+        bResult = bResult && bytesRead == SEEKABLE_BENCH_INPUT_SIZE &&
+                  memcmp(scratch, original, SEEKABLE_BENCH_INPUT_SIZE) == 0;
+
+        reader->hits = reader->misses = 0;
+        bResult = bResult && bench_seekable_random(reader, original, FALSE, latencies, &uniformMedian, &uniformP99);
+        double const uniformHitRate = (double)reader->hits / (reader->hits + reader->misses);
+        reader->hits = reader->misses = 0;
+        bResult = bResult && bench_seekable_random(reader, original, TRUE, latencies, &localMedian, &localP99);
+        double const localHitRate = (double)reader->hits / (reader->hits + reader->misses);
+
+        if (bResult) {
+            sprintf(msg, "seekable %3lu KB | ratio %5.2f | sequential %7.1f ms (%7.1f MB/s) | random 4 KB p50 %6.1f us"
+                         " p99 %6.1f us (hit %4.1f%%) | local p50 %6.1f us p99 %6.1f us (hit %4.1f%%)",
+                    (unsigned long)(kBlockSizes[i] / 1024), (double)SEEKABLE_BENCH_INPUT_SIZE / compressedSize,
+                    sequential * 1000.0, SEEKABLE_BENCH_INPUT_SIZE / sequential / mb,
+                    uniformMedian * 1e6, uniformP99 * 1e6, uniformHitRate * 100.0,
+                    localMedian * 1e6, localP99 * 1e6, localHitRate * 100.0);
+        } else {
+            sprintf(msg, "seekable %3lu KB | verification FAILED", (unsigned long)(kBlockSizes[i] / 1024));
+        }
+        log_message(msg);
+
+        seekable_reader_close(reader);
+        DeleteFile(outputPath);
+    }
+
+    free(original);
+    free(scratch);
+    free(latencies);
+    DeleteFile(inputPath);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../utility.h"
+
+#define STAGE_BENCH_INPUT_SIZE (128 * 1024 * 1024) // 압축 대상 크기
+#define STAGE_BENCH_REPEAT     3                   // 설정별 반복 횟수 (가장 빠른 결과 사용)
+
+/**
+ * @brief 하나의 출력 Staging 설정으로 압축하여 쓰기 요청 수와 처리량을 측정합니다.
+ */
+static void bench_one_stage(
+    const TCHAR* inputPath, const TCHAR* outputPath, CompressionAlgorithm algorithm,
+    const TCHAR* label, BOOL bOutputStaging, size_t stageSize, const char* original
+) {
+    TCHAR msg[256];
+    CompressionOptions options = { 0, };
+    ULONGLONG readsBefore, writesBefore, readsAfter, writesAfter;
+
+    options.bOutputStaging = bOutputStaging;
+    options.outputStageSize = stageSize;
+
+    BOOL bResult = TRUE;
+    double best = 0.0;
+    ULONGLONG reads = 0, writes = 0;
+    for (int i = 0; i < STAGE_BENCH_REPEAT; i++) {
+        async_get_request_counts(&readsBefore, &writesBefore);
+        double const start = bench_now();
+        bResult = compress_file_ex(inputPath, outputPath, algorithm, &options) && bResult;
+        double const elapsed = bench_now() - start;
+        async_get_request_counts(&readsAfter, &writesAfter);
+
+        if (i == 0 || elapsed < best) {
+            best = elapsed;
+        }
+        reads = readsAfter - readsBefore;
+        writes = writesAfter - writesBefore;
+    }
+
+    ULONGLONG const outputSize = bench_file_size(outputPath);
+    BOOL const bVerified = bResult && bench_verify_file(outputPath, algorithm, original, STAGE_BENCH_INPUT_SIZE);
+
+    sprintf(msg, "%-18s %s %6.3f s (%7.1f MB/s) | output %9llu B, verified %s | reads %6llu, writes %6llu (avg %8.1f KB)",
+            label, bResult ? "ok  " : "FAIL", best, STAGE_BENCH_INPUT_SIZE / best / (1024.0 * 1024.0),
+            outputSize, bVerified ? "yes" : "NO ", reads, writes,
+            writes ? (double)outputSize / (double)writes / 1024.0 : 0.0);
+    log_message(msg);
+
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief 압축 결과마다 쓰는 경우와 출력 Staging 으로 모아 쓰는 경우의 쓰기 요청 (System Call) 수와 처리량을 비교합니다.
+ */
+void bench_stage(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_stage_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_stage_output.bin");
+
+    char* const original = (char*)malloc(STAGE_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, STAGE_BENCH_INPUT_SIZE, 11);
+    if (!bench_write_file(inputPath, original, STAGE_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    static const struct {
+        const TCHAR* label;
+        BOOL bOutputStaging;
+        size_t stageSize;
+    } kStages[] = {
+        { "per piece",      FALSE, 0 },
+        { "stage 64 KB",    TRUE,  64 * 1024 },
+        { "stage 256 KB",   TRUE,  256 * 1024 },
+        { "stage 1 MB",     TRUE,  1024 * 1024 },
+        { "stage 4 MB",     TRUE,  4 * 1024 * 1024 },
+    };
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        TCHAR label[64];
+        for (size_t i = 0; i < sizeof(kStages) / sizeof(kStages[0]); i++) {
+            sprintf(label, "%s %s", (algorithm == LZ4) ? "LZ4 " : "ZSTD", kStages[i].label);
+            bench_one_stage(inputPath, outputPath, algorithm, label,
+                            kStages[i].bOutputStaging, kStages[i].stageSize, original);
+        }
+        log_message("");
+    }
+
+    free(original);
+    DeleteFile(inputPath);
+}
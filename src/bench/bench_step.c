@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compress_step.h"
+#include "../utility.h"
+
+#define STEP_BENCH_INPUT_SIZE (64 * 1024 * 1024) // 압축 대상 크기
+
+/**
+ * @brief 하나의 예산 설정으로 단계 압축을 실행하고, 호출별 소요 시간을 측정합니다.
+ */
+static void bench_one_budget(
+    const TCHAR* inputPath, const TCHAR* outputPath, const char* original,
+    CompressionAlgorithm algorithm, size_t budgetBytes, DWORD budgetMicros
+) {
+    TCHAR msg[256];
+    size_t sampleMax = 64 * 1024;
+    size_t sampleCount = 0;
+    double* samples = (double*)malloc(sampleMax * sizeof(double));
+    size_t wouldBlock = 0;
+    if (samples == NULL) {
+        return;
+    }
+
+    double const start = bench_now();
+    COMPRESS_Context_t* ctx = compress_begin(inputPath, outputPath, algorithm, NULL);
+    CompressStepResult result = (ctx != NULL) ? COMPRESS_STEP_PROGRESS : COMPRESS_STEP_ERROR;
+
+    while (result == COMPRESS_STEP_PROGRESS || result == COMPRESS_STEP_WOULD_BLOCK) {
+        double const stepStart = bench_now();
+        result = compress_step(ctx, budgetBytes, budgetMicros);
+        double const stepTime = bench_now() - stepStart;
+
+        if (sampleCount == sampleMax) {
+            double* const grown = (double*)realloc(samples, sampleMax * 2 * sizeof(double));
+            if (grown == NULL) {
+                break;
+            }
+            samples = grown;
+            sampleMax *= 2;
+        }
+        samples[sampleCount++] = stepTime;
+
+        if (result == COMPRESS_STEP_WOULD_BLOCK) {
+            wouldBlock++;
+            SwitchToThread(); // 실제 Main Loop 에서는 다른 작업을 수행하는 자리
+        }
+    }
+
+    BOOL const bDone = compress_end(ctx) && result == COMPRESS_STEP_DONE;
+    double const elapsed = bench_now() - start;
+    BOOL const bVerified = bDone && bench_verify_file(outputPath, algorithm, original, STEP_BENCH_INPUT_SIZE);
+
+    qsort(samples, sampleCount, sizeof(double), compare_double);
+    size_t const n = sampleCount ? sampleCount : 1;
+    sprintf(msg, "%s budget %6zu B / %5lu us | %s %6.2f s (%7.1f MB/s) | %7zu calls, %7zu would-block | "
+                 "step p50 %7.1f us, p99 %7.1f us, max %8.1f us",
+            (algorithm == LZ4) ? "LZ4 " : "ZSTD", budgetBytes, (unsigned long)budgetMicros,
+            bVerified ? "ok  " : "FAIL", elapsed, STEP_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0),
+            sampleCount, wouldBlock,
+            samples[n / 2 < sampleCount ? n / 2 : 0] * 1e6,
+            samples[(n * 99) / 100 < sampleCount ? (n * 99) / 100 : 0] * 1e6,
+            sampleCount ? samples[sampleCount - 1] * 1e6 : 0.0);
+    log_message(msg);
+
+    free(samples);
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief 단계 압축 API 의 호출당 최악 소요 시간과, 한 번에 끝까지 압축하는 compress_file 대비 처리량을 측정합니다.
+ */
+void bench_step(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR msg[200];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_step_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_step_output.bin");
+
+    char* const original = (char*)malloc(STEP_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, STEP_BENCH_INPUT_SIZE, 7);
+    if (!bench_write_file(inputPath, original, STEP_BENCH_INPUT_SIZE)) {
+        free(original);
+        return;
+    }
+
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        double const start = bench_now();
+        BOOL const bResult = compress_file(inputPath, outputPath, algorithm);
+        double const elapsed = bench_now() - start;
+        sprintf(msg, "%s compress_file (blocking)            | %s %6.2f s (%7.1f MB/s)",
+                (algorithm == LZ4) ? "LZ4 " : "ZSTD", bResult ? "ok  " : "FAIL",
+                elapsed, STEP_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0));
+        log_message(msg);
+        DeleteFile(outputPath);
+
+        bench_one_budget(inputPath, outputPath, original, algorithm, 4 * 1024, 0);
+        bench_one_budget(inputPath, outputPath, original, algorithm, 16 * 1024, 0);
+        bench_one_budget(inputPath, outputPath, original, algorithm, 0, 100);
+        bench_one_budget(inputPath, outputPath, original, algorithm, 0, 1000);
+        bench_one_budget(inputPath, outputPath, original, algorithm, 256 * 1024, 1000);
+        log_message("");
+    }
+
+    DeleteFile(inputPath);
+    free(original);
+}
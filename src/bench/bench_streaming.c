@@ -0,0 +1,241 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../decompressor.h"
+#include "../log_appender.h"
+#include "../utility.h"
+
+#define STREAMING_BENCH_PIPE_NAME    "\\\\.\\pipe\\cesb_streaming_bench" // Socket 대신 사용하는 Local Pipe
+#define STREAMING_BENCH_RECORDS      2500         // 보내는 Record 수
+#define STREAMING_BENCH_INTERVAL_US  200          // Record 간격 (us, 약 600 KB/s 의 원본)
+#define STREAMING_BENCH_SEGMENT_SIZE 1460         // 받는 쪽이 한 번에 받는 크기 (TCP Segment 하나)
+#define STREAMING_BENCH_LINK_RATE    (256.0 * 1024.0) // 흉내내는 Link 대역폭 (bytes/s, 느린 무선 Uplink)
+#define STREAMING_BENCH_LINE_SIZE    256          // Record 한 줄의 최대 크기
+
+// 구조체 선언
+
+typedef struct {
+    HANDLE hPipe;               // 받는 쪽 Pipe
+    double firstDecodeTime;     // 처음으로 풀린 Byte 가 나온 시각 (bench_now, 0 이면 아직 없음)
+    double* latencies;          // Record 별 보낸 시각부터 풀린 시각까지의 시간 (s)
+    size_t count;               // 받은 Record 수
+    ULONGLONG compressedBytes;  // 받은 압축 데이터 크기
+    ULONGLONG decodedBytes;     // 풀린 크기
+    BOOL bFailed;               // 압축 해제 실패 여부
+} StreamingBenchReceiver;
+
+/**
+ * @brief bench_now 기준으로 target 시각까지 기다립니다. (1 ms 보다 많이 남으면 Sleep)
+ */
+static void bench_streaming_wait_until(double target) {
+    for (double now = bench_now(); now < target; now = bench_now()) {
+        if (target - now > 0.002) {
+            Sleep(1);
+        } else {
+            SwitchToThread();
+        }
+    }
+}
+
+/**
+ * @brief 받는 쪽 Thread: Segment 단위로 Link 대역폭에 맞춰 받고, 받는 즉시 풀어서 Record 별 지연을 잽니다.
+ *
+ * 각 Record 는 보낸 시각 (us) 으로 시작하므로, 줄이 완성된 시각과의 차이가 전송 전체의 지연입니다.
+ */
+static DWORD WINAPI bench_streaming_receiver(LPVOID param) {
+    StreamingBenchReceiver* const receiver = (StreamingBenchReceiver*)param;
+    DECOMP_Context_t* decomp = NULL;
+    char segment[STREAMING_BENCH_SEGMENT_SIZE];
+    char decoded[64 * 1024];
+    char line[STREAMING_BENCH_LINE_SIZE];
+    size_t lineLen = 0;
+    double linkFree = 0.0; // Link 가 이전 Segment 를 다 보낸 시각
+
+    if (!create_decompressor(&decomp, ZSTD)) {
+        receiver->bFailed = TRUE;
+        return 0;
+    }
+
+    for (;;) {
+        DWORD dwBytesRead = 0;
+        if (!ReadFile(receiver->hPipe, segment, sizeof(segment), &dwBytesRead, NULL) || dwBytesRead == 0) {
+            break; // 보내는 쪽이 닫음
+        }
+        receiver->compressedBytes += dwBytesRead;
+
+        // Link 를 지나는 시간: 도착한 Segment 는 앞 Segment 가 다 지나간 뒤에 bytes / 대역폭 만큼 걸림
+        double const now = bench_now();
+        linkFree = ((linkFree > now) ? linkFree : now) + dwBytesRead / STREAMING_BENCH_LINK_RATE;
+        bench_streaming_wait_until(linkFree);
+
+        size_t srcPos = 0;
+        while (srcPos < dwBytesRead && !receiver->bFailed) {
+            size_t srcSize = dwBytesRead - srcPos;
+            size_t dstSize = sizeof(decoded);
+            if (!decompress_stream(decomp, segment + srcPos, &srcSize, decoded, &dstSize)) {
+                receiver->bFailed = TRUE;
+                break;
+            }
+            srcPos += srcSize;
+            if (dstSize == 0) {
+                if (srcSize == 0) {
+                    break; // 다음 Segment 가 있어야 진행 가능
+                }
+                continue;
+            }
+
+            double const decodeTime = bench_now();
+            if (receiver->firstDecodeTime == 0.0) {
+                receiver->firstDecodeTime = decodeTime;
+            }
+            receiver->decodedBytes += dstSize;
+            for (size_t i = 0; i < dstSize; i++) {
+                if (lineLen < sizeof(line) - 1) {
+                    line[lineLen++] = decoded[i];
+                }
+                if (decoded[i] == '\n') {
+                    line[lineLen] = '\0';
+                    if (receiver->count < STREAMING_BENCH_RECORDS) {
+                        receiver->latencies[receiver->count++] = decodeTime - strtoull(line, NULL, 10) / 1e6;
+                    }
+                    lineLen = 0;
+                }
+            }
+        }
+    }
+
+    free_decompressor(decomp);
+    return 0;
+}
+
+/**
+ * @brief Appender 옵션 하나로 Record 를 일정한 간격으로 Pipe 에 흘려 보내고, 받는 쪽의 지연을 출력합니다.
+ */
+static void bench_streaming_run(const char* name, const LogAppenderOptions* options) {
+    StreamingBenchReceiver receiver = { 0, };
+    TCHAR msg[320];
+
+    receiver.latencies = (double*)malloc(STREAMING_BENCH_RECORDS * sizeof(double));
+    receiver.hPipe = CreateNamedPipe(
+        STREAMING_BENCH_PIPE_NAME, PIPE_ACCESS_INBOUND, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+        1, 0, 64 * 1024, 0, NULL
+    );
+    if (receiver.latencies == NULL || receiver.hPipe == INVALID_HANDLE_VALUE) {
+        free(receiver.latencies);
+        return;
+    }
+
+    HANDLE const hClient = CreateFile(
+        STREAMING_BENCH_PIPE_NAME, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL
+    );
+    BOOL const bConnected = (hClient != INVALID_HANDLE_VALUE) &&
+        (ConnectNamedPipe(receiver.hPipe, NULL) || GetLastError() == ERROR_PIPE_CONNECTED);
+    HANDLE const hThread = bConnected ? CreateThread(NULL, 0, bench_streaming_receiver, &receiver, 0, NULL) : NULL;
+    LOG_Appender_t* const appender = (hThread != NULL) ? log_appender_open_handle(hClient, ZSTD, options) : NULL;
+
+    double firstSendTime = 0.0;
+    BOOL bResult = (appender != NULL);
+    if (bResult) {
+        unsigned int state = 46;
+        double const start = bench_now();
+        for (unsigned int i = 0; i < STREAMING_BENCH_RECORDS && bResult; i++) {
+            double const due = start + i * (STREAMING_BENCH_INTERVAL_US / 1e6);
+            while (bResult && bench_now() < due) {
+                bResult = log_appender_tick(appender);
+                bench_streaming_wait_until((due - bench_now() > 0.002) ? bench_now() + 0.001 : due);
+            }
+
+            char record[STREAMING_BENCH_LINE_SIZE];
+            double const now = bench_now();
+            state = state * 1103515245u + 12345u;
+            int const len = sprintf(record, "%llu seq=%06u [%s] collector: batch %u forwarded, queue=%u latency_us=%u\n",
+                                    (unsigned long long)(now * 1e6), i, ((state >> 8) % 8 == 0) ? "WARN" : "INFO",
+                                    (state >> 12) % 4096, (state >> 4) % 64, (state >> 16) % 2000);
+            if (i == 0) {
+                firstSendTime = now;
+            }
+            bResult = bResult && log_appender_write(appender, record, (size_t)len);
+        }
+        ULONGLONG const totalIn = appender->totalIn;
+        ULONGLONG const flushCount = appender->flushCount;
+        bResult = log_appender_close(appender) && bResult;
+
+        // 보내는 쪽을 닫아 받는 쪽이 끝을 알게 함
+        CloseHandle(hClient);
+        WaitForSingleObject(hThread, INFINITE);
+
+        if (bResult && !receiver.bFailed && receiver.count == STREAMING_BENCH_RECORDS) {
+            qsort(receiver.latencies, receiver.count, sizeof(double), compare_double);
+            sprintf(msg, "%-26s | %6.2f | %6llu | %9.2f | %7.2f | %7.2f | %7.2f",
+                    name, (double)totalIn / receiver.compressedBytes, (unsigned long long)flushCount,
+                    (receiver.firstDecodeTime - firstSendTime) * 1000.0,
+                    receiver.latencies[receiver.count / 2] * 1000.0,
+                    receiver.latencies[receiver.count * 99 / 100] * 1000.0,
+                    receiver.latencies[receiver.count - 1] * 1000.0);
+        } else {
+            sprintf(msg, "%-26s | failed (%zu of %d records decoded)", name, receiver.count, STREAMING_BENCH_RECORDS);
+        }
+        log_message(msg);
+    } else {
+        log_message("failed to open the pipe");
+        if (hClient != INVALID_HANDLE_VALUE) {
+            CloseHandle(hClient);
+        }
+        if (hThread != NULL) {
+            WaitForSingleObject(hThread, INFINITE);
+        }
+    }
+
+    if (hThread != NULL) {
+        CloseHandle(hThread);
+    }
+    CloseHandle(receiver.hPipe);
+    free(receiver.latencies);
+}
+
+/**
+ * @brief ZSTD Log Appender 를 Network 전송에 쓸 때의 지연을, Link 대역폭을 흉내낸 Local Pipe 로 잽니다.
+ *
+ * 기본 옵션, 기본 Flush 에 압축 Block 만 작게 한 경우, Flush 간격만 줄인 경우, Streaming 옵션
+ * (log_appender_streaming_options) 을 비교하여 처음 풀린 Byte 까지의 시간 (TTFB) 과 Record 별 지연을 출력합니다.
+ */
+void bench_streaming(void) {
+    LogAppenderOptions options;
+    TCHAR msg[200];
+
+    sprintf(msg, "%d records every %d us, link %.0f KB/s in %d byte segments",
+            STREAMING_BENCH_RECORDS, STREAMING_BENCH_INTERVAL_US, STREAMING_BENCH_LINK_RATE / 1024.0,
+            STREAMING_BENCH_SEGMENT_SIZE);
+    log_message(msg);
+    log_message("profile                    | ratio  | flushes | TTFB (ms) | p50 ms  | p99 ms  | max ms");
+
+    memset(&options, 0, sizeof(options));
+    bench_streaming_run("default (64 KB / 1 s)", &options);
+
+    memset(&options, 0, sizeof(options));
+    options.targetBlockSize = LOG_APPENDER_STREAM_BLOCK_SIZE;
+    bench_streaming_run("default + target block", &options);
+
+    memset(&options, 0, sizeof(options));
+    options.flushBytes = LOG_APPENDER_STREAM_FLUSH_BYTES;
+    options.flushMillis = LOG_APPENDER_STREAM_FLUSH_MILLIS;
+    bench_streaming_run("small flush (4 KB / 10 ms)", &options);
+
+    memset(&options, 0, sizeof(options));
+    log_appender_streaming_options(&options);
+    bench_streaming_run("streaming", &options);
+}
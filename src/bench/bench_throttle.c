@@ -0,0 +1,260 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../utility.h"
+
+#define THROTTLE_BENCH_INPUT_SIZE  (128 * 1024 * 1024) // Background 압축 대상 크기
+#define THROTTLE_BENCH_RECORD_SIZE (4 * 1024)          // Foreground 가 한 번에 쓰는 크기
+#define THROTTLE_BENCH_PERIOD_MS   2                   // Foreground 쓰기 주기
+#define THROTTLE_BENCH_MAX_SAMPLES (256 * 1024)
+#define THROTTLE_BENCH_SHARED_SIZE (8 * 1024 * 1024)   // 동시 진행 I/O 1 개 회귀 확인용 입력 크기
+#define THROTTLE_BENCH_SHARED_JOBS 2                   // 같은 제한을 공유하는 최대 작업 수
+
+// Foreground (지연에 민감한) Thread 의 상태
+typedef struct {
+    const TCHAR* path;        // Foreground 가 쓰는 파일
+    volatile LONG bStop;      // 종료 요청
+    double* samples;          // 쓰기 지연 (초)
+    size_t sampleCount;       // 측정 횟수
+} ForegroundState;
+
+/**
+ * @brief 일정 주기로 작은 Log 를 동기식으로 쓰고, 매 쓰기의 지연을 기록합니다.
+ */
+static DWORD WINAPI foreground_thread(LPVOID param) {
+    ForegroundState* const state = (ForegroundState*)param;
+    char record[THROTTLE_BENCH_RECORD_SIZE];
+    DWORD dwWritten;
+
+    bench_fill_log(record, sizeof(record), 99);
+    HANDLE hFile = CreateFile(state->path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_FLAG_WRITE_THROUGH, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return 1;
+    }
+
+    while (!state->bStop && state->sampleCount < THROTTLE_BENCH_MAX_SAMPLES) {
+        double const start = bench_now();
+        WriteFile(hFile, record, sizeof(record), &dwWritten, NULL);
+        state->samples[state->sampleCount++] = bench_now() - start;
+        Sleep(THROTTLE_BENCH_PERIOD_MS);
+    }
+
+    CloseHandle(hFile);
+    return 0;
+}
+
+/**
+ * @brief 하나의 제한 설정에서 Background 압축과 Foreground 쓰기 지연을 측정합니다.
+ */
+static void bench_one_limit(
+    const TCHAR* inputPath, const TCHAR* outputPath, const TCHAR* fgPath,
+    CompressionAlgorithm algorithm, const TCHAR* label,
+    DWORD readBytesPerSec, DWORD writeBytesPerSec, LONG maxInFlight
+) {
+    TCHAR msg[200];
+    IO_Throttle_t throttle;
+    CompressionOptions options = { 0, };
+    ForegroundState state = { fgPath, 0, NULL, 0 };
+
+    BOOL const bLimited = (readBytesPerSec || writeBytesPerSec || maxInFlight);
+    if (bLimited) {
+        if (!io_throttle_init(&throttle, readBytesPerSec, writeBytesPerSec, maxInFlight)) {
+            return;
+        }
+        options.throttle = &throttle;
+    }
+
+    state.samples = (double*)malloc(THROTTLE_BENCH_MAX_SAMPLES * sizeof(double));
+    if (state.samples == NULL) {
+        return;
+    }
+
+    HANDLE hThread = CreateThread(NULL, 0, foreground_thread, &state, 0, NULL);
+    Sleep(50); // Foreground 가 먼저 자리잡도록 대기
+
+    double const start = bench_now();
+    BOOL const bResult = compress_file_ex(inputPath, outputPath, algorithm, &options);
+    double const elapsed = bench_now() - start;
+
+    InterlockedExchange(&state.bStop, 1);
+    WaitForSingleObject(hThread, INFINITE);
+    CloseHandle(hThread);
+
+    qsort(state.samples, state.sampleCount, sizeof(double), compare_double);
+    double sum = 0.0;
+    for (size_t i = 0; i < state.sampleCount; i++) {
+        sum += state.samples[i];
+    }
+
+    size_t const n = state.sampleCount ? state.sampleCount : 1;
+    sprintf(msg, "%-28s %s %7.2f s (%7.1f MB/s) | fg write avg %7.1f us, p99 %8.1f us, max %8.1f us | throttled %6.2f s",
+            label, bResult ? "ok  " : "FAIL", elapsed, THROTTLE_BENCH_INPUT_SIZE / elapsed / (1024.0 * 1024.0),
+            sum / n * 1e6, state.samples[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1] * 1e6,
+            state.sampleCount ? state.samples[state.sampleCount - 1] * 1e6 : 0.0,
+            bLimited ? (double)throttle.delayedMicros / 1e6 : 0.0);
+    log_message(msg);
+
+    free(state.samples);
+    DeleteFile(outputPath);
+}
+
+// 같은 IO_Throttle_t 를 공유하는 압축 작업 하나
+typedef struct {
+    const TCHAR* inputPath;
+    TCHAR outputPath[MAX_PATH];
+    CompressionAlgorithm algorithm;
+    CompressionOptions options;
+    BOOL bResult;
+} SharedJob;
+
+/**
+ * @brief 압축 작업 하나를 실행합니다.
+ */
+static DWORD WINAPI shared_job_thread(LPVOID param) {
+    SharedJob* const job = (SharedJob*)param;
+    job->bResult = compress_file_ex(job->inputPath, job->outputPath, job->algorithm, &(job->options));
+    return 0;
+}
+
+/**
+ * @brief 동시 진행 I/O 를 1 개로 제한한 IO_Throttle_t 를 작업 여러 개가 공유할 때,
+ *        대기 없이 요청한 쓰기를 남겨 둔 채 대기하는 읽기를 요청해도 멈추지 않고 올바른 결과를 만드는지 확인합니다.
+ *        (Staging 사용 여부와 작업 수별로, 두 알고리즘 모두)
+ */
+static void bench_shared_in_flight(const TCHAR* inputPath) {
+    TCHAR msg[200];
+    SharedJob jobs[THROTTLE_BENCH_SHARED_JOBS];
+    HANDLE hThreads[THROTTLE_BENCH_SHARED_JOBS];
+
+    char* const original = (char*)malloc(THROTTLE_BENCH_SHARED_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, THROTTLE_BENCH_SHARED_SIZE, 7);
+    if (!bench_write_file(inputPath, original, THROTTLE_BENCH_SHARED_SIZE)) {
+        free(original);
+        return;
+    }
+
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        for (int bStaging = 0; bStaging <= 1; bStaging++) {
+            for (int jobCount = 1; jobCount <= THROTTLE_BENCH_SHARED_JOBS; jobCount++) {
+                IO_Throttle_t throttle;
+                if (!io_throttle_init(&throttle, 0, 0, 1)) {
+                    continue;
+                }
+
+                double const start = bench_now();
+                for (int i = 0; i < jobCount; i++) {
+                    TCHAR name[64];
+                    sprintf(name, "cesb_throttle_shared_%d.bin", i);
+                    jobs[i].inputPath = inputPath;
+                    bench_temp_path(jobs[i].outputPath, sizeof(jobs[i].outputPath), name);
+                    jobs[i].algorithm = (CompressionAlgorithm)algorithm;
+                    memset(&(jobs[i].options), 0, sizeof(CompressionOptions));
+                    jobs[i].options.throttle = &throttle;
+                    jobs[i].options.bOutputStaging = bStaging;
+                    jobs[i].bResult = FALSE;
+                    hThreads[i] = CreateThread(NULL, 0, shared_job_thread, &jobs[i], 0, NULL);
+                }
+                WaitForMultipleObjects((DWORD)jobCount, hThreads, TRUE, INFINITE);
+                double const elapsed = bench_now() - start;
+
+                BOOL bResult = TRUE;
+                for (int i = 0; i < jobCount; i++) {
+                    CloseHandle(hThreads[i]);
+                    bResult = bResult && jobs[i].bResult &&
+                              bench_verify_file(jobs[i].outputPath, jobs[i].algorithm, original, THROTTLE_BENCH_SHARED_SIZE);
+                    DeleteFile(jobs[i].outputPath);
+                }
+                sprintf(msg, "%s in-flight <= 1, %s, %d job(s) %s %7.2f s",
+                        (algorithm == LZ4) ? "LZ4 " : "ZSTD", bStaging ? "staged" : "direct", jobCount,
+                        bResult ? "ok  " : "FAIL", elapsed);
+                log_message(msg);
+            }
+        }
+    }
+    log_message("");
+
+    free(original);
+    DeleteFile(inputPath);
+}
+
+/**
+ * @brief Background 압축의 I/O 제한 설정별로, 함께 실행되는 Foreground Thread 의 쓰기 지연 (Jitter) 을 측정합니다.
+ */
+void bench_throttle(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR fgPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_throttle_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_throttle_output.bin");
+    bench_temp_path(fgPath, sizeof(fgPath), "cesb_throttle_foreground.log");
+
+    // 1. 동시 진행 I/O 1 개를 공유하는 작업이 멈추지 않는지 확인
+    bench_shared_in_flight(inputPath);
+
+    // 2. 입력 파일 생성 (1 MB 단위)
+    size_t const pieceSize = 1024 * 1024;
+    char* const piece = (char*)malloc(pieceSize);
+    FILE* const file = fopen(inputPath, "wb");
+    if (piece == NULL || file == NULL) {
+        free(piece);
+        if (file) {
+            fclose(file);
+        }
+        return;
+    }
+    for (size_t i = 0; i < THROTTLE_BENCH_INPUT_SIZE / pieceSize; i++) {
+        bench_fill_log(piece, pieceSize, (unsigned int)i + 1);
+        fwrite(piece, 1, pieceSize, file);
+    }
+    fclose(file);
+    free(piece);
+
+    // 3. 제한 설정별 측정 (대역폭과 동시 진행 I/O 수는 따로 측정하여 효과가 섞이지 않도록 함)
+    static const struct {
+        const TCHAR* label;
+        DWORD readBytesPerSec;
+        DWORD writeBytesPerSec;
+        LONG maxInFlight;
+    } kLimits[] = {
+        { "unlimited",       0,         0,        0 },
+        { "in-flight <= 2",  0,         0,        2 },
+        { "in-flight <= 1",  0,         0,        1 },
+        { "read 256 MB/s",   256u << 20, 0,       0 },
+        { "read 64 MB/s",    64u << 20, 0,        0 },
+        { "read 16 MB/s",    16u << 20, 0,        0 },
+        { "write 64 MB/s",   0,         64u << 20, 0 },
+        { "write 16 MB/s",   0,         16u << 20, 0 },
+        { "write 4 MB/s",    0,         4u << 20, 0 },
+    };
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        TCHAR label[64];
+        for (size_t i = 0; i < sizeof(kLimits) / sizeof(kLimits[0]); i++) {
+            sprintf(label, "%s %s", (algorithm == LZ4) ? "LZ4 " : "ZSTD", kLimits[i].label);
+            bench_one_limit(inputPath, outputPath, fgPath, algorithm, label,
+                            kLimits[i].readBytesPerSec, kLimits[i].writeBytesPerSec, kLimits[i].maxInFlight);
+        }
+        log_message("");
+    }
+
+    DeleteFile(inputPath);
+    DeleteFile(fgPath);
+}
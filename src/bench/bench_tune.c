@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../compressor.h"
+#include "../tune.h"
+#include "../utility.h"
+
+#define TUNE_BENCH_INPUT_SIZE (64 * 1024 * 1024) // 예제 파일 크기
+#define TUNE_BENCH_RUNS       3                  // 비교할 때 반복 수 (중앙값 사용)
+
+/**
+ * @brief 지정한 Chunk 크기로 TUNE_BENCH_RUNS 번 압축하여 걸린 시간의 중앙값을 구합니다.
+ *
+ * @param chunkSize Chunk 크기 (0 이면 보정 값)
+ * @return 걸린 시간 (s), 실패 시 0
+ */
+static double bench_tune_run(
+    const TCHAR* inputPath, const TCHAR* outputPath, CompressionAlgorithm algorithm, DWORD chunkSize
+) {
+    double elapsed[TUNE_BENCH_RUNS];
+    CompressionOptions options = { 0, };
+
+    options.chunkSize = chunkSize;
+    for (int run = 0; run < TUNE_BENCH_RUNS; run++) {
+        double const start = bench_now();
+        BOOL const bResult = compress_file_ex(inputPath, outputPath, algorithm, &options);
+        elapsed[run] = bench_now() - start;
+        DeleteFile(outputPath);
+        if (!bResult) {
+            return 0.0;
+        }
+    }
+    qsort(elapsed, TUNE_BENCH_RUNS, sizeof(double), compare_double);
+    return elapsed[TUNE_BENCH_RUNS / 2];
+}
+
+/**
+ * @brief 임시 폴더가 있는 장치에서 알고리듬별로 Chunk 크기를 보정하고, 크기별 측정 결과를 출력합니다.
+ *
+ * 이후 기본 Chunk 크기와 보정 값 (chunkSize 0) 으로 압축한 시간을 비교합니다.
+ */
+void bench_tune(void) {
+    static const DWORD kDefaultChunkSizes[ALGORITHM_COUNT] = { 16 * 1024, 128 * 1024 }; // LZ4 CHUNK_SIZE, ZSTD_CStreamInSize
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+    TCHAR profilePath[MAX_PATH];
+    TCHAR msg[320];
+    static TUNE_Result_t result;
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_tune_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_tune_output.bin");
+
+    char* const original = (char*)malloc(TUNE_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, TUNE_BENCH_INPUT_SIZE, 91);
+    BOOL const bWritten = bench_write_file(inputPath, original, TUNE_BENCH_INPUT_SIZE);
+    free(original);
+    if (!bWritten) {
+        return;
+    }
+
+    if (tune_profile_path(profilePath, MAX_PATH)) {
+        sprintf(msg, "profile: %s", profilePath);
+        log_message(msg);
+    }
+
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        if (!tune_calibrate(inputPath, algorithm, NULL, &result)) {
+            log_message("calibration failed");
+            continue;
+        }
+        sprintf(msg, "%s (volume %08lX):  chunk | read MB/s | read us/req | compress MB/s | file MB/s",
+                result.profile, (unsigned long)result.volumeSerial);
+        log_message(msg);
+        for (DWORD i = 0; i < result.count; i++) {
+            const TUNE_Measure_t* const measure = &(result.measures[i]);
+            double const mb = 1024.0 * 1024.0;
+            sprintf(msg, "                        %5lu KB | %9.1f | %11.1f | %13.1f | %9.1f%s",
+                    (unsigned long)(measure->chunkSize / 1024), measure->readSpeed / mb, measure->readLatencyMicros,
+                    measure->compressSpeed / mb, measure->fileSpeed / mb,
+                    (measure->chunkSize == result.bestChunkSize) ? "  <- best" : "");
+            log_message(msg);
+        }
+
+        double const defaultTime = bench_tune_run(inputPath, outputPath, algorithm, kDefaultChunkSizes[algorithm]);
+        double const tunedTime = bench_tune_run(inputPath, outputPath, algorithm, 0);
+        sprintf(msg, "%s default %lu KB: %6.3f s | calibrated (%lu KB): %6.3f s",
+                result.profile, (unsigned long)(kDefaultChunkSizes[algorithm] / 1024), defaultTime,
+                (unsigned long)(result.bestChunkSize / 1024), tunedTime);
+        log_message(msg);
+        log_message("");
+    }
+
+    DeleteFile(inputPath);
+}
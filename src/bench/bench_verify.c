@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include "../crc32c.h"
+#include "../decompressor.h"
+#include "../verify.h"
+#include "../utility.h"
+
+#define VERIFY_BENCH_INPUT_SIZE (128 * 1024 * 1024) // 압축 대상 크기
+#define VERIFY_BENCH_READ_SIZE  (1024 * 1024)       // 별도 검증 단계의 읽기 단위
+
+/**
+ * @brief 파일 전체의 CRC32C 를 계산합니다.
+ */
+static BOOL hash_file(const TCHAR* path, DWORD* pHash, ULONGLONG* pSize) {
+    FILE* const file = fopen(path, "rb");
+    BYTE* const buffer = (BYTE*)malloc(VERIFY_BENCH_READ_SIZE);
+    BOOL const bResult = (file && buffer);
+    size_t n;
+
+    *pHash = 0;
+    *pSize = 0;
+    while (bResult && (n = fread(buffer, 1, VERIFY_BENCH_READ_SIZE, file)) > 0) {
+        *pHash = crc32c(*pHash, buffer, n);
+        *pSize += n;
+    }
+
+    if (file) {
+        fclose(file);
+    }
+    free(buffer);
+    return bResult;
+}
+
+/**
+ * @brief 기존 방식의 별도 검증 단계: 압축 파일을 다시 읽어 압축 해제하고, 원본 파일도 다시 읽어 비교합니다.
+ */
+static BOOL verify_separate_pass(const TCHAR* inputPath, const TCHAR* compressedPath, CompressionAlgorithm algorithm) {
+    DECOMP_Context_t* decomp = NULL;
+    FILE* const file = fopen(compressedPath, "rb");
+    BYTE* const srcBuf = (BYTE*)malloc(VERIFY_BENCH_READ_SIZE);
+    BYTE* const dstBuf = (BYTE*)malloc(VERIFY_BENCH_READ_SIZE);
+    BOOL bResult = file && srcBuf && dstBuf && create_decompressor(&decomp, algorithm);
+    DWORD outputHash = 0, inputHash = 0;
+    ULONGLONG outputSize = 0, inputSize = 0;
+    size_t n;
+
+    while (bResult && (n = fread(srcBuf, 1, VERIFY_BENCH_READ_SIZE, file)) > 0) {
+        size_t srcPos = 0;
+        BOOL bOutputFull = FALSE;
+        while (bResult && (srcPos < n || bOutputFull)) {
+            size_t srcSize = n - srcPos;
+            size_t dstSize = VERIFY_BENCH_READ_SIZE;
+            bResult = decompress_stream(decomp, srcBuf + srcPos, &srcSize, dstBuf, &dstSize);
+            srcPos += srcSize;
+            bOutputFull = (dstSize == VERIFY_BENCH_READ_SIZE);
+            outputHash = crc32c(outputHash, dstBuf, dstSize);
+            outputSize += dstSize;
+        }
+    }
+    bResult = bResult && decomp->bFrameEnd &&
+        hash_file(inputPath, &inputHash, &inputSize) &&
+        inputSize == outputSize && inputHash == outputHash;
+
+    free_decompressor(decomp);
+    if (file) {
+        fclose(file);
+    }
+    free(srcBuf);
+    free(dstBuf);
+    return bResult;
+}
+
+/**
+ * @brief 압축만, 압축 후 별도 검증, 쓰기 후 검증 (Background Thread) 의 소요 시간을 비교합니다.
+ */
+static void bench_one_algorithm(const TCHAR* inputPath, const TCHAR* outputPath, CompressionAlgorithm algorithm) {
+    TCHAR msg[300];
+    const TCHAR* const name = (algorithm == LZ4) ? "LZ4 " : "ZSTD";
+    double const sizeMB = VERIFY_BENCH_INPUT_SIZE / (1024.0 * 1024.0);
+
+    // 1. 압축만
+    double start = bench_now();
+    BOOL bResult = compress_file(inputPath, outputPath, algorithm);
+    double const compressTime = bench_now() - start;
+    sprintf(msg, "%s compress only                 | %s %6.3f s (%7.1f MB/s)",
+            name, bResult ? "ok  " : "FAIL", compressTime, sizeMB / compressTime);
+    log_message(msg);
+
+    // 2. 압축 후 별도 검증 단계 (입력과 출력을 모두 다시 읽음)
+    start = bench_now();
+    bResult = compress_file(inputPath, outputPath, algorithm);
+    bResult = bResult && verify_separate_pass(inputPath, outputPath, algorithm);
+    double const separateTime = bench_now() - start;
+    sprintf(msg, "%s compress + separate verify    | %s %6.3f s (%7.1f MB/s) | %+6.1f %% time, re-reads %.0f MB",
+            name, bResult ? "ok  " : "FAIL", separateTime, sizeMB / separateTime,
+            (separateTime / compressTime - 1.0) * 100.0, sizeMB + bench_file_size(outputPath) / (1024.0 * 1024.0));
+    log_message(msg);
+
+    // 3. 쓰기 후 검증 (압축 데이터를 메모리에서 바로 검증 Thread 로 전달)
+    VERIFY_Result_t verifyResult;
+    CompressionOptions options = { 0, };
+    options.verify = &verifyResult;
+
+    start = bench_now();
+    bResult = compress_file_ex(inputPath, outputPath, algorithm, &options);
+    double const inlineTime = bench_now() - start;
+    sprintf(msg, "%s compress + verify-after-write | %s %6.3f s (%7.1f MB/s) | %+6.1f %% time, re-reads 0 MB | "
+                 "hash %08lX/%08lX, %llu -> %llu bytes, stalled %.1f ms",
+            name, bResult && verifyResult.bVerified ? "ok  " : "FAIL", inlineTime, sizeMB / inlineTime,
+            (inlineTime / compressTime - 1.0) * 100.0,
+            (unsigned long)verifyResult.inputHash, (unsigned long)verifyResult.outputHash,
+            verifyResult.compressedBytes, verifyResult.outputBytes, verifyResult.stallMicros / 1000.0);
+    log_message(msg);
+
+    DeleteFile(outputPath);
+}
+
+/**
+ * @brief 별도 검증 단계와 쓰기 후 검증의 비용을 측정합니다.
+ */
+void bench_verify(void) {
+    TCHAR inputPath[MAX_PATH];
+    TCHAR outputPath[MAX_PATH];
+
+    bench_temp_path(inputPath, sizeof(inputPath), "cesb_verify_input.log");
+    bench_temp_path(outputPath, sizeof(outputPath), "cesb_verify_output.bin");
+
+    char* const original = (char*)malloc(VERIFY_BENCH_INPUT_SIZE);
+    if (original == NULL) {
+        return;
+    }
+    bench_fill_log(original, VERIFY_BENCH_INPUT_SIZE, 17);
+    BOOL const bWritten = bench_write_file(inputPath, original, VERIFY_BENCH_INPUT_SIZE);
+    free(original);
+    if (!bWritten) {
+        return;
+    }
+
+    for (int algorithm = LZ4; algorithm < ALGORITHM_COUNT; algorithm++) {
+        bench_one_algorithm(inputPath, outputPath, algorithm);
+        log_message("");
+    }
+
+    DeleteFile(inputPath);
+}
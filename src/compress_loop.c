@@ -0,0 +1,262 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compress_loop.h"
+#include "asyncio_win.h"
+#include "utility.h"
+
+/**
+ * @brief 작업을 다시 실행하도록 Port 에 재실행 통지를 넣습니다. (OVERLAPPED 가 NULL 인 통지)
+ */
+static BOOL loop_requeue(COMPRESS_Loop_t* loop, COMPRESS_LoopJob_t* job) {
+    if (job->bQueued) {
+        return TRUE;
+    }
+
+    if (!PostQueuedCompletionStatus(loop->hPort, 0, (ULONG_PTR)job, NULL)) {
+        log_message("Failed to post completion packet.");
+        return FALSE;
+    }
+
+    job->bQueued = TRUE;
+    return TRUE;
+}
+
+/**
+ * @brief 작업을 종료하고 완료 함수를 호출합니다.
+ */
+static void loop_finish(COMPRESS_Loop_t* loop, COMPRESS_LoopJob_t* job, BOOL bSuccess) {
+    ULONGLONG const totalIn = job->ctx->totalIn;
+    ULONGLONG const totalOut = job->ctx->totalOut;
+
+    bSuccess = compress_end(job->ctx) && bSuccess;
+    job->ctx = NULL; // 이후 도착하는 통지는 무시
+    loop->activeCount--;
+
+    if (job->callback != NULL) {
+        job->callback(bSuccess, totalIn, totalOut, job->userData);
+    }
+}
+
+/**
+ * @brief 통지를 받은 작업을 한 번 진행시킵니다.
+ */
+static void loop_run_job(COMPRESS_Loop_t* loop, COMPRESS_LoopJob_t* job) {
+    CompressStepResult const result = compress_step(job->ctx, loop->stepBytes, loop->stepMicros);
+    loop->stepCount++;
+
+    switch (result) {
+        case COMPRESS_STEP_PROGRESS:
+            // 예산을 모두 사용함 -> 다른 작업 뒤에 다시 실행
+            if (!loop_requeue(loop, job)) {
+                loop_finish(loop, job, FALSE);
+            }
+            break;
+        case COMPRESS_STEP_WOULD_BLOCK:
+            break; // 진행 중인 I/O 의 완료 통지가 다시 깨움
+        case COMPRESS_STEP_DONE:
+            loop_finish(loop, job, TRUE);
+            break;
+        default:
+            loop_finish(loop, job, FALSE);
+            break;
+    }
+}
+
+/**
+ * @brief 압축 Event Loop 를 생성합니다.
+ *
+ * @param stepBytes 작업이 한 번 실행될 때 압축할 최대 입력 크기 (0 이면 제한 없음)
+ * @param stepMicros 작업이 한 번 실행될 때의 최대 시간 (us, 0 이면 제한 없음)
+ * @return 압축 Event Loop, 실패 시 NULL
+ */
+COMPRESS_Loop_t* compress_loop_create(size_t stepBytes, DWORD stepMicros) {
+    COMPRESS_Loop_t* loop = (COMPRESS_Loop_t*)calloc(1, sizeof(COMPRESS_Loop_t));
+    if (loop == NULL) {
+        return NULL;
+    }
+
+    loop->hPort = async_create_port();
+    if (loop->hPort == NULL) {
+        free(loop);
+        return NULL;
+    }
+
+    loop->stepBytes = stepBytes;
+    loop->stepMicros = stepMicros;
+    return loop;
+}
+
+/**
+ * @brief Event Loop 가 사용하는 I/O Completion Port 를 반환합니다.
+ *
+ * 이 Port 에서 직접 통지를 꺼낸 경우, 꺼낸 통지를 모두 compress_loop_dispatch 에 넘겨야 합니다.
+ * Port 에 다른 파일 핸들을 연결하거나 직접 통지를 넣으면 안 됩니다.
+ *
+ * @param loop 압축 Event Loop
+ * @return I/O Completion Port 핸들
+ */
+HANDLE compress_loop_handle(const COMPRESS_Loop_t* loop) {
+    return loop->hPort;
+}
+
+/**
+ * @brief 압축 작업을 시작하고 Event Loop 에 추가합니다.
+ *
+ * @param loop 압축 Event Loop
+ * @param inputFilePath 읽을 파일 경로
+ * @param outputFilePath 쓸 파일 경로
+ * @param algorithm 압축 알고리즘
+ * @param options 작업별 옵션 (NULL 이면 기본값)
+ * @param callback 작업 완료 시 호출할 함수 (NULL 허용)
+ * @param userData callback 에 전달할 값
+ * @return 추가 성공 여부
+ */
+BOOL compress_loop_add(
+    COMPRESS_Loop_t* loop,
+    const TCHAR* inputFilePath, const TCHAR* outputFilePath,
+    CompressionAlgorithm algorithm, const CompressionOptions* options,
+    CompressLoopCallback callback, void* userData
+) {
+    COMPRESS_LoopJob_t* job = (COMPRESS_LoopJob_t*)calloc(1, sizeof(COMPRESS_LoopJob_t));
+    if (job == NULL) {
+        return FALSE;
+    }
+
+    job->ctx = compress_begin(inputFilePath, outputFilePath, algorithm, options);
+    if (job->ctx == NULL) {
+        free(job);
+        return FALSE;
+    }
+    if (!compress_step_attach(job->ctx, loop->hPort, (ULONG_PTR)job)) {
+        compress_end(job->ctx);
+        free(job);
+        return FALSE;
+    }
+
+    job->callback = callback;
+    job->userData = userData;
+    job->next = loop->jobs;
+    loop->jobs = job;
+    loop->activeCount++;
+
+    // 첫 실행 (첫 읽기 요청) 을 위한 통지
+    if (!loop_requeue(loop, job)) {
+        loop_finish(loop, job, FALSE);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Port 에서 꺼낸 완료 통지를 처리하여, 통지를 받은 작업을 진행시킵니다.
+ *
+ * Application 이 자신의 Main Loop 에서 compress_loop_handle 의 Port 를 직접 기다리는 경우에 사용합니다.
+ *
+ * @param loop 압축 Event Loop
+ * @param entries GetQueuedCompletionStatusEx 로 꺼낸 통지
+ * @param count 통지 수
+ * @return 아직 진행 중인 작업 수
+ */
+DWORD compress_loop_dispatch(COMPRESS_Loop_t* loop, const OVERLAPPED_ENTRY* entries, ULONG count) {
+    loop->wakeupCount += count;
+
+    for (ULONG i = 0; i < count; i++) {
+        COMPRESS_LoopJob_t* const job = (COMPRESS_LoopJob_t*)entries[i].lpCompletionKey;
+        if (entries[i].lpOverlapped == NULL) {
+            job->bQueued = FALSE; // 재실행 통지
+        }
+        if (job->ctx == NULL) {
+            continue; // 이미 끝난 작업에 늦게 도착한 통지
+        }
+        loop_run_job(loop, job);
+    }
+
+    return loop->activeCount;
+}
+
+/**
+ * @brief 완료 통지를 최대 timeoutMs 동안 기다리고, 통지를 받은 작업을 진행시킵니다.
+ *
+ * Port 를 기다리는 데 실패하면 (시간 초과 제외) 진행 중인 모든 작업을 실패로 끝내고 -1 을 반환합니다.
+ * 이후 호출은 0 을 반환하므로, 반환값이 0 보다 큰 동안 반복하는 Loop 는 항상 끝납니다.
+ *
+ * @param loop 압축 Event Loop
+ * @param timeoutMs 최대 대기 시간 (ms, 0 이면 대기하지 않음, INFINITE 가능)
+ * @return 아직 진행 중인 작업 수, 오류 시 -1
+ */
+LONG compress_loop_poll(COMPRESS_Loop_t* loop, DWORD timeoutMs) {
+    OVERLAPPED_ENTRY entries[COMPRESS_LOOP_BATCH];
+    ULONG ulRemoved = 0;
+
+    if (loop->activeCount == 0) {
+        return 0;
+    }
+
+    if (!GetQueuedCompletionStatusEx(loop->hPort, entries, COMPRESS_LOOP_BATCH, &ulRemoved, timeoutMs, FALSE)) {
+        if (GetLastError() == WAIT_TIMEOUT) {
+            return (LONG)loop->activeCount;
+        }
+
+        log_message("GetQueuedCompletionStatusEx failed.");
+        for (COMPRESS_LoopJob_t* job = loop->jobs; job != NULL; job = job->next) {
+            if (job->ctx != NULL) {
+                loop_finish(loop, job, FALSE);
+            }
+        }
+        return -1;
+    }
+
+    return (LONG)compress_loop_dispatch(loop, entries, ulRemoved);
+}
+
+/**
+ * @brief 모든 작업이 끝날 때까지 Event Loop 를 실행합니다.
+ *
+ * @param loop 압축 Event Loop
+ * @return Event Loop 오류 없이 끝나면 TRUE (개별 작업의 성공 여부는 완료 함수로 전달)
+ */
+BOOL compress_loop_run(COMPRESS_Loop_t* loop) {
+    LONG active;
+    while ((active = compress_loop_poll(loop, INFINITE)) > 0) {
+    }
+    return active == 0;
+}
+
+/**
+ * @brief Event Loop 를 해제합니다. 진행 중인 작업은 중단됩니다.
+ *
+ * @param loop 압축 Event Loop (NULL 허용)
+ */
+void compress_loop_free(COMPRESS_Loop_t* loop) {
+    if (loop == NULL) {
+        return;
+    }
+
+    COMPRESS_LoopJob_t* job = loop->jobs;
+    while (job != NULL) {
+        COMPRESS_LoopJob_t* const next = job->next;
+        if (job->ctx != NULL) {
+            loop_finish(loop, job, FALSE);
+        }
+        free(job);
+        job = next;
+    }
+
+    CloseHandle(loop->hPort);
+    free(loop);
+}
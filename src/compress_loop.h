@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMPRESS_LOOP_H
+#define COMPRESS_LOOP_H
+
+#include <windows.h>
+
+#include "compress_step.h"
+
+/*
+ * I/O Completion Port 기반 압축 Event Loop
+ *
+ * 여러 압축 작업의 입력/출력 파일을 하나의 I/O Completion Port 에 연결하고,
+ * 한 Thread 에서 완료 통지가 온 작업만 compress_step 으로 진행시킵니다.
+ * Application 의 Main Loop 는 compress_loop_poll(loop, 0) 을 주기적으로 호출하거나
+ * compress_loop_poll(loop, timeout) 으로 통지를 기다리면 됩니다.
+ *
+ * Port 를 기다리면 완료 통지가 Port 에서 꺼내지므로, compress_loop_handle 의 Port 를
+ * Application 이 직접 GetQueuedCompletionStatusEx 로 기다리는 경우에는 꺼낸 통지를 모두
+ * compress_loop_dispatch 에 넘겨야 합니다. (그렇지 않으면 해당 작업이 멈춤)
+ * 이 Port 에는 다른 파일 핸들을 연결하면 안 됩니다.
+ *
+ * 예산을 모두 사용하여 멈춘 작업 (COMPRESS_STEP_PROGRESS) 은 Port 에 재실행 통지를 넣어,
+ * I/O 완료 통지와 같은 순서로 공평하게 다시 실행됩니다.
+ */
+
+#define COMPRESS_LOOP_BATCH 64 // 한 번에 꺼내는 최대 완료 통지 수
+
+// 구조체 선언
+
+typedef struct COMPRESS_LoopJob_s COMPRESS_LoopJob_t;
+typedef struct COMPRESS_Loop_s COMPRESS_Loop_t;
+
+/**
+ * @brief 작업 완료 시 호출되는 함수
+ *
+ * @param bSuccess 압축 성공 여부
+ * @param totalIn 압축한 입력 크기
+ * @param totalOut 쓴 출력 크기
+ * @param userData compress_loop_add 에 전달한 값
+ */
+typedef void (*CompressLoopCallback)(BOOL bSuccess, ULONGLONG totalIn, ULONGLONG totalOut, void* userData);
+
+struct COMPRESS_LoopJob_s {
+    COMPRESS_Context_t* ctx;         // 단계 압축 컨텍스트 (완료 후 NULL)
+    CompressLoopCallback callback;   // 완료 시 호출할 함수
+    void* userData;                  // callback 에 전달할 값
+    BOOL bQueued;                    // 재실행 통지가 Port 에 대기 중인지 여부
+    COMPRESS_LoopJob_t* next;        // 다음 작업 (Loop 가 해제될 때 함께 해제)
+};
+
+struct COMPRESS_Loop_s {
+    HANDLE hPort;                    // I/O Completion Port
+    size_t stepBytes;                // 작업별 compress_step 입력 예산
+    DWORD stepMicros;                // 작업별 compress_step 시간 예산 (us)
+    COMPRESS_LoopJob_t* jobs;        // 추가된 모든 작업
+    DWORD activeCount;               // 진행 중인 작업 수
+    ULONGLONG stepCount;             // compress_step 호출 수 (통계용)
+    ULONGLONG wakeupCount;           // 받은 완료 통지 수 (통계용)
+};
+
+// 함수 선언
+
+COMPRESS_Loop_t* compress_loop_create(size_t stepBytes, DWORD stepMicros);
+HANDLE compress_loop_handle(const COMPRESS_Loop_t* loop);
+BOOL compress_loop_add(
+    COMPRESS_Loop_t* loop,
+    const TCHAR* inputFilePath, const TCHAR* outputFilePath,
+    CompressionAlgorithm algorithm, const CompressionOptions* options,
+    CompressLoopCallback callback, void* userData
+);
+DWORD compress_loop_dispatch(COMPRESS_Loop_t* loop, const OVERLAPPED_ENTRY* entries, ULONG count);
+LONG compress_loop_poll(COMPRESS_Loop_t* loop, DWORD timeoutMs);
+BOOL compress_loop_run(COMPRESS_Loop_t* loop);
+void compress_loop_free(COMPRESS_Loop_t* loop);
+
+#endif // COMPRESS_LOOP_H
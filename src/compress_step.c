@@ -0,0 +1,552 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compress_step.h"
+#include "asyncio_win.h"
+#include "utility.h"
+
+#define STEP_LZ4_READ_SIZE (64 * 1024) // LZ4 읽기 단위 (ZSTD 는 ZSTD_CStreamInSize)
+
+static const CompressionOptions kDefaultOptions = { 0, };
+
+/**
+ * @brief 비어 있는 입력 버퍼로 다음 읽기를 요청합니다. 입력 파일 끝 이후로는 요청하지 않습니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @return 요청 성공 (또는 더 읽을 것이 없음) 시 TRUE, 실패 시 FALSE
+ */
+static BOOL step_issue_read(COMPRESS_Context_t* ctx) {
+    if (ctx->readOffset >= ctx->inputSize) {
+        return TRUE;
+    }
+
+    ULONGLONG const remaining = ctx->inputSize - ctx->readOffset;
+    DWORD const toRead = (DWORD)(remaining < ctx->srcBufMaxSize ? remaining : ctx->srcBufMaxSize);
+    int const index = 1 - ctx->srcIndex;
+    DWORD dwBytesRead;
+
+    async_set_offset(&(ctx->readOverlap), ctx->readOffset);
+    if (!async_read_ex(ctx->hInput, ctx->srcBuf[index], toRead, &dwBytesRead, &(ctx->readOverlap), FALSE, NULL)) {
+        return FALSE;
+    }
+
+    ctx->srcLen[index] = toRead;
+    ctx->readOffset += toRead;
+    ctx->bReadPending = TRUE;
+    return TRUE;
+}
+
+/**
+ * @brief 진행 중인 읽기/쓰기의 완료 여부를 대기 없이 확인합니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @param pbProgressed 완료된 I/O 가 있으면 TRUE 로 설정
+ * @return I/O 오류가 없으면 TRUE
+ */
+static BOOL step_poll_io(COMPRESS_Context_t* ctx, BOOL* pbProgressed) {
+    BOOL bCompleted;
+    DWORD dwBytes;
+
+    if (ctx->bWritePending) {
+        if (!async_poll(ctx->hOutput, &(ctx->writeOverlap), &dwBytes, &bCompleted, NULL)) {
+            return FALSE;
+        }
+        if (bCompleted) {
+            ctx->bWritePending = FALSE;
+            ctx->totalOut += dwBytes;
+            *pbProgressed = TRUE;
+        }
+    }
+
+    if (ctx->bReadPending) {
+        if (!async_poll(ctx->hInput, &(ctx->readOverlap), &dwBytes, &bCompleted, NULL)) {
+            return FALSE;
+        }
+        if (bCompleted) {
+            int const index = 1 - ctx->srcIndex;
+            if (dwBytes < ctx->srcLen[index]) {
+                // 작업 도중 파일이 줄어든 경우, 읽은 곳까지를 입력의 끝으로 간주
+                ctx->inputSize = ctx->readOffset - ctx->srcLen[index] + dwBytes;
+                ctx->readOffset = ctx->inputSize;
+                ctx->srcLen[index] = dwBytes;
+            }
+            ctx->bReadPending = FALSE;
+            ctx->bReadReady = TRUE;
+            *pbProgressed = TRUE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 채우는 중인 출력 버퍼를 쓰기 요청하고 다른 출력 버퍼로 전환합니다.
+ *
+ * 호출 전에 진행 중인 쓰기가 없어야 합니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @return 요청 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL step_issue_write(COMPRESS_Context_t* ctx) {
+    DWORD dwBytesWritten;
+
+    if (ctx->dstLen == 0) {
+        return TRUE;
+    }
+
+    async_set_offset(&(ctx->writeOverlap), ctx->writeOffset);
+    if (!async_write_ex(
+        ctx->hOutput, ctx->dstBuf[ctx->dstIndex], (DWORD)ctx->dstLen,
+        &dwBytesWritten, &(ctx->writeOverlap), FALSE, NULL
+    )) {
+        return FALSE;
+    }
+
+    ctx->writeOffset += ctx->dstLen;
+    ctx->bWritePending = TRUE;
+    ctx->dstIndex = 1 - ctx->dstIndex;
+    ctx->dstLen = 0;
+    return TRUE;
+}
+
+/**
+ * @brief 출력 버퍼에 need bytes 의 여유 공간을 확보합니다.
+ *
+ * 공간이 부족하면 채워진 버퍼를 쓰기 요청하고 다른 버퍼로 전환합니다.
+ * 다른 버퍼가 아직 쓰는 중이면 기다리지 않고 *pbReady 를 FALSE 로 설정합니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @param need 필요한 여유 공간
+ * @param pbReady 공간 확보 여부
+ * @return 쓰기 요청 실패 시 FALSE
+ */
+static BOOL step_reserve(COMPRESS_Context_t* ctx, size_t need, BOOL* pbReady) {
+    *pbReady = TRUE;
+    if (ctx->dstBufMaxSize - ctx->dstLen >= need) {
+        return TRUE;
+    }
+
+    if (ctx->bWritePending) {
+        *pbReady = FALSE;
+        return TRUE;
+    }
+
+    return step_issue_write(ctx);
+}
+
+/**
+ * @brief 현재 입력 버퍼에서 최대 pieceSize bytes 를 압축하여 출력 버퍼에 추가합니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @param pieceSize 압축할 최대 입력 크기
+ * @param pbBlocked 출력 공간이 없어 진행하지 못한 경우 TRUE
+ * @return 실제로 소비한 입력 크기, 오류 시 (size_t)-1
+ */
+static size_t step_compress_piece(COMPRESS_Context_t* ctx, size_t pieceSize, BOOL* pbBlocked) {
+    const BYTE* const src = (const BYTE*)ctx->srcBuf[ctx->srcIndex] + ctx->srcPos;
+    BOOL bReady;
+
+    *pbBlocked = FALSE;
+
+    if (ctx->algorithm == LZ4) {
+        // LZ4F_compressUpdate 는 최악의 경우 크기만큼의 공간이 있어야 함
+        if (!step_reserve(ctx, LZ4F_compressBound(pieceSize, &(ctx->lz4NB->prefs)), &bReady)) {
+            return (size_t)-1;
+        }
+        if (!bReady) {
+            *pbBlocked = TRUE;
+            return 0;
+        }
+
+        size_t const compressedSize = LZ4F_compressUpdate(
+            ctx->lz4NB->cctxPtr, (BYTE*)ctx->dstBuf[ctx->dstIndex] + ctx->dstLen,
+            ctx->dstBufMaxSize - ctx->dstLen, src, pieceSize, NULL
+        );
+        if (LZ4F_isError(compressedSize)) {
+            log_message("Compression failed!");
+            return (size_t)-1;
+        }
+
+        ctx->dstLen += compressedSize;
+        return pieceSize;
+    }
+
+    // ZSTD 는 출력 공간이 부족하면 내부에 보관했다가 다음 호출에서 내보냄
+    if (!step_reserve(ctx, 1, &bReady)) {
+        return (size_t)-1;
+    }
+    if (!bReady) {
+        *pbBlocked = TRUE;
+        return 0;
+    }
+
+    ZSTD_inBuffer input = { src, pieceSize, 0 };
+    ZSTD_outBuffer output = { ctx->dstBuf[ctx->dstIndex], ctx->dstBufMaxSize, ctx->dstLen };
+    size_t const remaining = ZSTD_compressStream2(ctx->ress->cctxPtr, &output, &input, ZSTD_e_continue);
+    if (ZSTD_isError(remaining)) {
+        log_message("ZSTD Compress Stream failed!");
+        return (size_t)-1;
+    }
+
+    ctx->dstLen = output.pos;
+    return input.pos;
+}
+
+/**
+ * @brief 압축을 마무리하는 Frame 끝 (End Mark, Checksum) 을 출력 버퍼에 추가합니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @param pbFinished Frame 이 모두 출력 버퍼에 추가되었으면 TRUE
+ * @param pbBlocked 출력 공간이 없어 진행하지 못한 경우 TRUE
+ * @return 오류가 없으면 TRUE
+ */
+static BOOL step_compress_end(COMPRESS_Context_t* ctx, BOOL* pbFinished, BOOL* pbBlocked) {
+    BOOL bReady;
+
+    *pbFinished = FALSE;
+    *pbBlocked = FALSE;
+
+    if (ctx->algorithm == LZ4) {
+        if (!step_reserve(ctx, LZ4F_compressBound(0, &(ctx->lz4NB->prefs)), &bReady)) {
+            return FALSE;
+        }
+        if (!bReady) {
+            *pbBlocked = TRUE;
+            return TRUE;
+        }
+
+        size_t const compressedSize = LZ4F_compressEnd(
+            ctx->lz4NB->cctxPtr, (BYTE*)ctx->dstBuf[ctx->dstIndex] + ctx->dstLen,
+            ctx->dstBufMaxSize - ctx->dstLen, NULL
+        );
+        if (LZ4F_isError(compressedSize)) {
+            log_message("Failed to end compression!");
+            return FALSE;
+        }
+
+        ctx->dstLen += compressedSize;
+        *pbFinished = TRUE;
+        return TRUE;
+    }
+
+    if (!step_reserve(ctx, 1, &bReady)) {
+        return FALSE;
+    }
+    if (!bReady) {
+        *pbBlocked = TRUE;
+        return TRUE;
+    }
+
+    ZSTD_inBuffer input = { NULL, 0, 0 };
+    ZSTD_outBuffer output = { ctx->dstBuf[ctx->dstIndex], ctx->dstBufMaxSize, ctx->dstLen };
+    size_t const remaining = ZSTD_compressStream2(ctx->ress->cctxPtr, &output, &input, ZSTD_e_end);
+    if (ZSTD_isError(remaining)) {
+        log_message("ZSTD Compress Stream failed!");
+        return FALSE;
+    }
+
+    ctx->dstLen = output.pos;
+    *pbFinished = (remaining == 0);
+    return TRUE;
+}
+
+/**
+ * @brief 단계 단위 압축 작업을 시작합니다.
+ *
+ * 파일을 열고 압축 자원을 할당한 뒤 바로 반환합니다. I/O 는 첫 compress_step 에서 시작합니다.
+ * 이후 compress_step 을 반복 호출하여 압축을 진행하고, compress_end 로 정리합니다.
+ *
+ * options->throttle 은 사용하지 않습니다. 제한에 걸리면 호출한 Thread 가 대기하므로,
+ * 진행 속도는 compress_step 의 예산으로 조절합니다.
+ *
+ * @param inputFilePath 읽을 파일 경로
+ * @param outputFilePath 쓸 파일 경로
+ * @param algorithm 압축 알고리즘
+ * @param options 작업별 옵션 (NULL 이면 기본값)
+ * @return 단계 압축 컨텍스트, 실패 시 NULL
+ */
+COMPRESS_Context_t* compress_begin(
+    const TCHAR* inputFilePath, const TCHAR* outputFilePath,
+    CompressionAlgorithm algorithm, const CompressionOptions* options
+) {
+    if (options == NULL) {
+        options = &kDefaultOptions;
+    }
+
+    COMPRESS_Context_t* ctx = (COMPRESS_Context_t*)calloc(1, sizeof(COMPRESS_Context_t));
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    ctx->algorithm = algorithm;
+    ctx->phase = STEP_PHASE_BODY;
+    ctx->hInput = init_file_read(inputFilePath);
+    ctx->hOutput = init_file_write(outputFilePath);
+    if (ctx->hInput == INVALID_HANDLE_VALUE || ctx->hOutput == INVALID_HANDLE_VALUE) {
+        compress_end(ctx);
+        return NULL;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(ctx->hInput, &fileSize)) {
+        log_message("Failed to get input file size.");
+        compress_end(ctx);
+        return NULL;
+    }
+    ctx->inputSize = (ULONGLONG)fileSize.QuadPart;
+
+    // 기존 압축 자원을 재사용하고, Double Buffer 의 두 번째 버퍼만 추가로 할당
+    BOOL bResult = FALSE;
+    switch (algorithm) {
+        case LZ4:
+            if (LZ4F_createNB(&(ctx->lz4NB), ctx->hInput, ctx->hOutput, STEP_LZ4_READ_SIZE, 0, FALSE, options)) {
+                ctx->srcBuf[0] = ctx->lz4NB->srcBuf;
+                ctx->srcBufMaxSize = ctx->lz4NB->srcBufMaxSize;
+                ctx->dstBuf[0] = ctx->lz4NB->dstBuf;
+                ctx->dstBufMaxSize = ctx->lz4NB->dstBufMaxSize;
+                bResult = TRUE;
+            }
+            break;
+        case ZSTD:
+            if (create_resources(&(ctx->ress), options)) {
+                ctx->srcBuf[0] = ctx->ress->srcBuf;
+                ctx->srcBufMaxSize = ctx->ress->srcBufMaxSize;
+                ctx->dstBuf[0] = ctx->ress->dstBuf;
+                ctx->dstBufMaxSize = ctx->ress->dstBufMaxSize;
+                bResult = TRUE;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (bResult) {
+        ctx->srcBuf[1] = malloc(ctx->srcBufMaxSize);
+        ctx->dstBuf[1] = malloc(ctx->dstBufMaxSize);
+        bResult = (ctx->srcBuf[1] != NULL && ctx->dstBuf[1] != NULL);
+    }
+
+    if (bResult && algorithm == LZ4) {
+        size_t const headerSize = LZ4F_compressBegin(
+            ctx->lz4NB->cctxPtr, ctx->dstBuf[0], ctx->dstBufMaxSize, &(ctx->lz4NB->prefs)
+        );
+        if (LZ4F_isError(headerSize)) {
+            log_message("Failed to start compression (header)...");
+            bResult = FALSE;
+        } else {
+            ctx->dstLen = headerSize;
+        }
+    }
+
+    // 비어 있는 버퍼 0 을 모두 소비한 상태로 시작하며, 첫 읽기는 첫 compress_step 에서 요청
+    if (!bResult) {
+        compress_end(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+/**
+ * @brief 정해진 예산만큼 압축을 진행하고, I/O 완료를 기다리지 않고 반환합니다.
+ *
+ * 입력은 COMPRESS_STEP_PIECE_SIZE 단위로 압축하며, 단위마다 예산을 확인합니다.
+ * 예산이 남아 있어도 읽기 또는 쓰기가 완료되지 않아 진행할 수 없으면 바로 반환합니다.
+ * 한 번의 호출은 예산과 관계없이 최소 한 단위를 진행할 수 있으므로, 최악의 경우 호출 시간은
+ * 한 단위의 압축 시간 (LZ4/ZSTD 내부 Block 이 가득 차 압축이 일어나는 경우) 으로 제한됩니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @param budgetBytes 이번 호출에서 압축할 최대 입력 크기 (0 이면 제한 없음)
+ * @param budgetMicros 이번 호출의 최대 시간 (us, 0 이면 제한 없음)
+ * @return COMPRESS_STEP_PROGRESS, COMPRESS_STEP_WOULD_BLOCK, COMPRESS_STEP_DONE 또는 COMPRESS_STEP_ERROR
+ */
+CompressStepResult compress_step(COMPRESS_Context_t* ctx, size_t budgetBytes, DWORD budgetMicros) {
+    if (ctx == NULL || ctx->phase == STEP_PHASE_ERROR) {
+        return COMPRESS_STEP_ERROR;
+    }
+    if (ctx->phase == STEP_PHASE_DONE) {
+        return COMPRESS_STEP_DONE;
+    }
+
+    ULONGLONG const start = now_micros();
+
+    BOOL bProgressed = FALSE;
+    BOOL bBlocked = FALSE;
+    size_t bytesDone = 0;
+
+    while (!bBlocked) {
+        if (!step_poll_io(ctx, &bProgressed)) {
+            ctx->phase = STEP_PHASE_ERROR;
+            return COMPRESS_STEP_ERROR;
+        }
+
+        if (ctx->phase == STEP_PHASE_BODY) {
+            // 현재 입력 버퍼를 모두 소비했으면 읽기가 완료된 버퍼로 전환
+            if (ctx->srcPos == ctx->srcLen[ctx->srcIndex]) {
+                if (ctx->bReadReady) {
+                    ctx->srcIndex = 1 - ctx->srcIndex;
+                    ctx->srcPos = 0;
+                    ctx->bReadReady = FALSE;
+                    if (!step_issue_read(ctx)) {
+                        ctx->phase = STEP_PHASE_ERROR;
+                        return COMPRESS_STEP_ERROR;
+                    }
+                } else if (!ctx->bReadPending) {
+                    if (ctx->readOffset < ctx->inputSize) {
+                        if (!step_issue_read(ctx)) { // 첫 읽기
+                            ctx->phase = STEP_PHASE_ERROR;
+                            return COMPRESS_STEP_ERROR;
+                        }
+                    } else {
+                        ctx->phase = STEP_PHASE_END; // 더 읽을 입력 없음
+                    }
+                } else {
+                    bBlocked = TRUE; // 읽기 완료 대기
+                }
+                continue;
+            }
+
+            size_t pieceSize = ctx->srcLen[ctx->srcIndex] - ctx->srcPos;
+            if (pieceSize > COMPRESS_STEP_PIECE_SIZE) {
+                pieceSize = COMPRESS_STEP_PIECE_SIZE;
+            }
+            if (budgetBytes != 0 && pieceSize > budgetBytes - bytesDone) {
+                pieceSize = budgetBytes - bytesDone;
+            }
+
+            size_t const consumed = step_compress_piece(ctx, pieceSize, &bBlocked);
+            if (consumed == (size_t)-1) {
+                ctx->phase = STEP_PHASE_ERROR;
+                return COMPRESS_STEP_ERROR;
+            }
+
+            ctx->srcPos += consumed;
+            ctx->totalIn += consumed;
+            bytesDone += consumed;
+            if (consumed > 0) {
+                bProgressed = TRUE;
+            }
+        } else if (ctx->phase == STEP_PHASE_END) {
+            BOOL bFinished;
+            size_t const dstLenBefore = ctx->dstLen;
+            int const dstIndexBefore = ctx->dstIndex;
+            if (!step_compress_end(ctx, &bFinished, &bBlocked)) {
+                ctx->phase = STEP_PHASE_ERROR;
+                return COMPRESS_STEP_ERROR;
+            }
+            // ZSTD 는 End Mark 를 여러 번에 나누어 내보낼 수 있으므로, 출력이 늘거나 쓰기를 요청했으면 진행으로 간주
+            if (bFinished || ctx->dstLen != dstLenBefore || ctx->dstIndex != dstIndexBefore) {
+                bProgressed = TRUE;
+            }
+            if (bFinished) {
+                ctx->phase = STEP_PHASE_DRAIN;
+            }
+        } else { // STEP_PHASE_DRAIN
+            if (ctx->bWritePending) {
+                bBlocked = TRUE; // 쓰기 완료 대기
+            } else if (ctx->dstLen > 0) {
+                if (!step_issue_write(ctx)) {
+                    ctx->phase = STEP_PHASE_ERROR;
+                    return COMPRESS_STEP_ERROR;
+                }
+            } else {
+                ctx->phase = STEP_PHASE_DONE;
+                return COMPRESS_STEP_DONE;
+            }
+        }
+
+        // 예산 확인
+        // (I/O 완료를 기다리는 중이 아니면 예산을 다 쓴 것이므로 다시 실행되도록 진행으로 간주)
+        if (budgetBytes != 0 && bytesDone >= budgetBytes) {
+            bProgressed = bProgressed || !bBlocked;
+            break;
+        }
+        if (budgetMicros != 0 && now_micros() - start >= budgetMicros) {
+            bProgressed = bProgressed || !bBlocked;
+            break;
+        }
+    }
+
+    // 완료 통지가 다시 깨울 수 있도록, 진행 중인 I/O 가 있을 때만 WOULD_BLOCK 을 반환
+    if (bProgressed || !(ctx->bReadPending || ctx->bWritePending)) {
+        return COMPRESS_STEP_PROGRESS;
+    }
+    return COMPRESS_STEP_WOULD_BLOCK;
+}
+
+/**
+ * @brief 단계 압축 작업을 종료하고 자원을 해제합니다.
+ *
+ * 완료 전에 호출하면 진행 중인 I/O 를 취소하고, 출력 파일은 완결되지 않은 상태로 남습니다.
+ *
+ * @param ctx 단계 압축 컨텍스트 (NULL 허용)
+ * @return 압축이 완료된 상태였으면 TRUE, 아니면 FALSE
+ */
+BOOL compress_end(COMPRESS_Context_t* ctx) {
+    if (ctx == NULL) {
+        return FALSE;
+    }
+
+    BOOL const bResult = (ctx->phase == STEP_PHASE_DONE);
+    DWORD dwBytes;
+
+    // 진행 중인 I/O 가 끝나기 전에 버퍼를 해제하지 않도록 취소 후 대기
+    if (ctx->bReadPending) {
+        CancelIo(ctx->hInput);
+        async_wait(ctx->hInput, &(ctx->readOverlap), &dwBytes, NULL);
+    }
+    if (ctx->bWritePending) {
+        CancelIo(ctx->hOutput);
+        async_wait(ctx->hOutput, &(ctx->writeOverlap), &dwBytes, NULL);
+    }
+
+    if (!bResult) {
+        log_message("Step compression ended before completion.");
+    }
+
+    if (ctx->hInput != INVALID_HANDLE_VALUE && ctx->hInput != NULL) {
+        CloseHandle(ctx->hInput);
+    }
+    if (ctx->hOutput != INVALID_HANDLE_VALUE && ctx->hOutput != NULL) {
+        CloseHandle(ctx->hOutput);
+    }
+
+    free(ctx->srcBuf[1]);
+    free(ctx->dstBuf[1]);
+    LZ4F_freeNB(ctx->lz4NB);
+    if (ctx->ress != NULL) {
+        free_resources(ctx->ress);
+        free(ctx->ress);
+    }
+    free(ctx);
+
+    return bResult;
+}
+
+/**
+ * @brief 단계 압축 작업의 입력/출력 파일을 I/O Completion Port 에 연결합니다.
+ *
+ * 연결 후에는 읽기/쓰기가 완료될 때마다 key 로 완료 통지가 전달되므로,
+ * 호출자는 COMPRESS_STEP_WOULD_BLOCK 을 받은 작업을 통지가 올 때까지 다시 호출하지 않아도 됩니다.
+ *
+ * @param ctx 단계 압축 컨텍스트
+ * @param hPort I/O Completion Port 핸들
+ * @param key 완료 통지에 함께 전달할 값
+ * @return 연결 성공 여부
+ */
+BOOL compress_step_attach(COMPRESS_Context_t* ctx, HANDLE hPort, ULONG_PTR key) {
+    return async_attach_port(hPort, ctx->hInput, key) && async_attach_port(hPort, ctx->hOutput, key);
+}
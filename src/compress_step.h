@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMPRESS_STEP_H
+#define COMPRESS_STEP_H
+
+#include <windows.h>
+
+#include "compressor.h"
+#include "lz4nb.h"
+#include "zstd_nb.h"
+
+/*
+ * 단계 (Step) 단위 압축 API
+ *
+ * compress_file 은 파일 전체를 압축할 때까지 반환하지 않으므로, 단일 Thread Main Loop (Super Loop) 를 막습니다.
+ * compress_step 은 정해진 작업량 (입력 bytes 또는 시간) 만큼만 진행하고 반환하며, I/O 완료를 기다리지 않습니다.
+ *
+ *   COMPRESS_Context_t* ctx = compress_begin(input, output, LZ4, NULL);
+ *   while (ctx != NULL) {
+ *       CompressStepResult r = compress_step(ctx, 16 * 1024, 500);
+ *       if (r == COMPRESS_STEP_DONE || r == COMPRESS_STEP_ERROR) break;
+ *       // ... 다른 작업 수행 ...
+ *   }
+ *   compress_end(ctx);
+ */
+
+#define COMPRESS_STEP_PIECE_SIZE (16 * 1024) // 한 번에 압축하는 최대 입력 크기 (시간 예산 확인 단위)
+
+// enum 선언
+
+typedef enum {
+    COMPRESS_STEP_ERROR = -1,   // 오류 발생 (compress_end 로 정리)
+    COMPRESS_STEP_WOULD_BLOCK,  // I/O 완료 대기 중이라 진행하지 못함
+    COMPRESS_STEP_PROGRESS,     // 일부 진행함, 다시 호출 필요
+    COMPRESS_STEP_DONE          // 압축 완료
+} CompressStepResult;
+
+typedef enum {
+    STEP_PHASE_BODY,            // 입력을 읽어 압축하는 중
+    STEP_PHASE_END,             // 입력을 모두 압축함, Frame 마무리 중
+    STEP_PHASE_DRAIN,           // Frame 마무리 완료, 남은 쓰기 완료 대기 중
+    STEP_PHASE_DONE,            // 완료
+    STEP_PHASE_ERROR            // 오류
+} CompressStepPhase;
+
+// 구조체 선언
+
+typedef struct COMPRESS_Context_s COMPRESS_Context_t;
+
+struct COMPRESS_Context_s {
+    CompressionAlgorithm algorithm; // 압축 알고리듬
+    CompressStepPhase phase;        // 현재 단계
+    HANDLE hInput;                  // 입력 핸들
+    HANDLE hOutput;                 // 출력 핸들
+    LZ4_NB_Core_t* lz4NB;           // LZ4 압축 자원 (LZ4 인 경우)
+    resources_t* ress;              // ZSTD 압축 자원 (ZSTD 인 경우)
+
+    // 입력 (Double Buffer: 하나를 압축하는 동안 다른 하나를 읽음)
+    LPVOID srcBuf[2];               // 원본 데이터 버퍼
+    size_t srcBufMaxSize;           // 원본 데이터 버퍼의 최대 크기
+    DWORD srcLen[2];                // 버퍼에 읽힌 크기
+    int srcIndex;                   // 압축 중인 버퍼 번호
+    size_t srcPos;                  // 압축 중인 버퍼에서 소비한 위치
+    BOOL bReadPending;              // 다른 버퍼로 읽기 진행 중 여부
+    BOOL bReadReady;                // 다른 버퍼의 읽기 완료 여부
+    OVERLAPPED readOverlap;         // Non-Blocking 읽기 작업을 위한 OVERLAPPED 구조체
+    ULONGLONG readOffset;           // 다음 읽기 위치
+    ULONGLONG inputSize;            // 입력 파일 크기 (EOF 이후 읽기 요청을 하지 않기 위함)
+
+    // 출력 (Double Buffer: 하나를 쓰는 동안 다른 하나에 압축)
+    LPVOID dstBuf[2];               // 압축된 데이터 버퍼
+    size_t dstBufMaxSize;           // 압축된 데이터 버퍼의 최대 크기
+    size_t dstLen;                  // 채우는 중인 버퍼에 쌓인 크기
+    int dstIndex;                   // 채우는 중인 버퍼 번호
+    BOOL bWritePending;             // 쓰기 진행 중 여부
+    OVERLAPPED writeOverlap;        // Non-Blocking 쓰기 작업을 위한 OVERLAPPED 구조체
+    ULONGLONG writeOffset;          // 다음 쓰기 위치
+
+    ULONGLONG totalIn;              // 압축한 입력 크기
+    ULONGLONG totalOut;             // 쓴 출력 크기
+};
+
+// 함수 선언
+
+COMPRESS_Context_t* compress_begin(
+    const TCHAR* inputFilePath, const TCHAR* outputFilePath,
+    CompressionAlgorithm algorithm, const CompressionOptions* options
+);
+CompressStepResult compress_step(COMPRESS_Context_t* ctx, size_t budgetBytes, DWORD budgetMicros);
+BOOL compress_end(COMPRESS_Context_t* ctx);
+BOOL compress_step_attach(COMPRESS_Context_t* ctx, HANDLE hPort, ULONG_PTR key);
+
+#endif // COMPRESS_STEP_H
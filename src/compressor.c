@@ -17,6 +17,10 @@
 #include "compressor.h"
 #include "lz4nb.h"
 #include "zstd_nb.h"
+#include "tune.h"
+#include "utility.h"
+
+static const CompressionOptions kDefaultOptions = { 0, };
 
 /**
 * @brief Non-Blocking 방식으로 읽기와 쓰기 작업을 수행하고, 데이터를 압축하여 파일에 씁니다.
@@ -29,16 +33,143 @@
 * @return 압축 성공 여부
 */
 BOOL compress_file(const TCHAR* inputFilePath, const TCHAR* outputFilePath, CompressionAlgorithm algorithm) {
+    return compress_file_ex(inputFilePath, outputFilePath, algorithm, NULL);
+}
+
+/**
+* @brief 작업별 옵션을 지정하여 파일을 압축합니다.
+*
+* @param inputFilePath 읽을 파일 경로
+* @param outputFilePath 쓸 파일 경로
+* @param algorithm 압축 알고리즘
+* @param options 작업별 옵션 (NULL 이면 기본값)
+* @return 압축 성공 여부
+*/
+BOOL compress_file_ex(
+    const TCHAR* inputFilePath, const TCHAR* outputFilePath,
+    CompressionAlgorithm algorithm, const CompressionOptions* options
+) {
+    if (options == NULL) {
+        options = &kDefaultOptions;
+    }
 
     BOOL bResult = FALSE;
     switch(algorithm) {
         case LZ4:
-            bResult = compress_lz4(inputFilePath, outputFilePath);
+            bResult = compress_lz4(inputFilePath, outputFilePath, options);
             break;
         case ZSTD:
-            bResult = compress_zstd(inputFilePath, outputFilePath);
+            bResult = compress_zstd(inputFilePath, outputFilePath, options);
             break;
     }
 
     return bResult;
 }
+
+/**
+* @brief Flush Point (Frame 끝) 를 만들 때가 되었는지 확인합니다.
+*
+* @param options 작업별 옵션
+* @param bytesSinceFlush 마지막 Flush Point 이후 압축한 원본 크기
+* @param lastFlushTick 마지막 Flush Point 시각 (GetTickCount64)
+* @return Flush Point 를 만들어야 하면 TRUE
+*/
+BOOL compress_flush_point_due(const CompressionOptions* options, ULONGLONG bytesSinceFlush, ULONGLONG lastFlushTick) {
+    if (bytesSinceFlush == 0) {
+        return FALSE;
+    }
+    if (options->flushPointBytes != 0 && bytesSinceFlush >= options->flushPointBytes) {
+        return TRUE;
+    }
+    if (options->flushPointMillis != 0 && GetTickCount64() - lastFlushTick >= options->flushPointMillis) {
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+* @brief 한 번에 읽어 압축하는 크기를 정합니다.
+*
+* options->chunkSize 가 있으면 그 값을, 없으면 입력 파일이 있는 Volume 의 보정 값을, 둘 다 없으면 defaultSize 를 사용합니다.
+*
+* @param options 작업별 옵션
+* @param algorithm 압축 알고리듬 (보정 값의 Profile)
+* @param hInput 입력 핸들
+* @param defaultSize 알고리듬 기본값
+* @return 읽기 크기
+*/
+DWORD compress_chunk_size(
+    const CompressionOptions* options, CompressionAlgorithm algorithm, HANDLE hInput, DWORD defaultSize
+) {
+    DWORD chunkSize = options->chunkSize;
+    if (chunkSize == 0) {
+        chunkSize = tune_lookup_chunk_size(hInput, algorithm, options);
+    }
+    if (chunkSize == 0) {
+        return defaultSize;
+    }
+
+    if (chunkSize < TUNE_MIN_CHUNK_SIZE) {
+        chunkSize = TUNE_MIN_CHUNK_SIZE;
+    }
+    if (chunkSize > TUNE_MAX_CHUNK_SIZE) {
+        chunkSize = TUNE_MAX_CHUNK_SIZE;
+    }
+    DWORD const alignment = (options->cacheMode == IO_CACHE_DIRECT) ? async_sector_size(hInput) : TUNE_MIN_CHUNK_SIZE;
+    return (chunkSize + alignment - 1) / alignment * alignment;
+}
+
+/**
+* @brief 작업별 옵션에 따라 압축 결과를 모아 쓸 출력 Staging 을 생성합니다.
+*
+* Direct I/O 이면 Sector 단위로 정렬하여 쓰고 마지막을 잘라내며, 읽기 크기도 Sector 크기의 배수인지 확인합니다.
+* bPreallocate 이면 출력 파일을 입력 크기와 압축률로 예상한 크기만큼 미리 할당합니다. (압축하면서 io_stage_add_input 으로 진행률을 알려야 함)
+* 내구성 정책도 함께 설정합니다.
+* bOutputStaging 이 아니고 Direct I/O 도, 내구성 정책도 없으면 Staging 없이 성공합니다.
+*
+* @param options 작업별 옵션
+* @param hInput 입력 핸들
+* @param hOutput 출력 핸들
+* @param readSize 한 번에 읽는 크기
+* @param maxPieceSize 한 번에 모으는 압축 결과의 최대 크기 (io_stage_reserve 크기)
+* @param pStage 생성한 출력 Staging (사용하지 않으면 NULL)
+* @return 성공 여부
+*/
+BOOL compress_create_stage(
+    const CompressionOptions* options, HANDLE hInput, HANDLE hOutput,
+    size_t readSize, size_t maxPieceSize, IO_Stage_t** pStage
+) {
+    BOOL const bDirect = (options->cacheMode == IO_CACHE_DIRECT);
+    DWORD alignment = IO_DEFAULT_ALIGNMENT;
+
+    *pStage = NULL;
+    if (!options->bOutputStaging && !bDirect && options->durability == IO_DURABILITY_NONE) {
+        return TRUE;
+    }
+
+    if (bDirect) {
+        alignment = async_sector_size(hOutput);
+        if (readSize % async_sector_size(hInput) != 0) {
+            log_message("error : Unsupported sector size for direct I/O.");
+            return FALSE;
+        }
+    }
+
+    size_t stageSize = (options->outputStageSize != 0) ? options->outputStageSize : IO_STAGE_DEFAULT_SIZE;
+    if (stageSize < maxPieceSize + alignment) {
+        stageSize = maxPieceSize + alignment; // 압축 결과 하나는 항상 들어가야 함
+    }
+
+    *pStage = io_stage_create(hOutput, stageSize, alignment, bDirect, options->throttle);
+    if (*pStage == NULL) {
+        return FALSE;
+    }
+
+    LARGE_INTEGER inputSize;
+    if (options->bPreallocate && GetFileSizeEx(hInput, &inputSize)) {
+        io_stage_preallocate(*pStage, (ULONGLONG)inputSize.QuadPart);
+    }
+
+    // 호출한 쪽이 실패 시에도 io_stage_free 로 정리하므로 여기서는 결과만 돌려줌
+    return io_stage_set_durability(*pStage, options->durability, options->syncBytes, options->syncMillis);
+}
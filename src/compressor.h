@@ -19,6 +19,10 @@
 
 #include <windows.h>
 
+#include "asyncio_win.h"
+#include "io_stage.h"
+#include "task_pool.h"
+
 // enum 선언
 
 typedef enum {
@@ -27,7 +31,111 @@ typedef enum {
     ALGORITHM_COUNT // 사용 가능한 알고리듬의 수
 } CompressionAlgorithm;
 
+typedef enum {
+    CHECKSUM_DEFAULT,           // 알고리듬 기본값 (LZ4: 없음, ZSTD: Content)
+    CHECKSUM_NONE,              // Checksum 없음
+    CHECKSUM_CONTENT,           // Frame 전체 원본의 Checksum (LZ4: XXH32, ZSTD: XXH64 하위 32 bit)
+    CHECKSUM_BLOCK,             // 압축된 Block 마다 Checksum (LZ4: XXH32, ZSTD 는 형식에 없으므로 CHECKSUM_CONTENT 와 같음)
+    CHECKSUM_BLOCK_AND_CONTENT  // Block 과 Content 모두
+} ChecksumMode;
+
+// 구조체 선언
+
+typedef struct VERIFY_Result_s VERIFY_Result_t; // verify.h
+typedef struct PIPE_Stats_s PIPE_Stats_t;       // pipeline.h
+typedef struct ADAPT_Stats_s ADAPT_Stats_t;     // adapt.h
+
+/*
+ * 압축 작업별 옵션. 0 으로 초기화하면 기본 동작을 사용합니다.
+ */
+typedef struct {
+    IO_Throttle_t* throttle;  // 읽기/쓰기 대역폭 및 동시 진행 I/O 제한 (NULL 이면 제한 없음, 여러 작업이 공유 가능)
+
+    // Flush Point: Frame 을 끝내고 새 Frame 을 시작하여, 출력이 중간에 잘려도 앞부분을 복구할 수 있게 함 (recover.h)
+    // compress_file_ex 에만 적용되며, 둘 다 0 이면 파일 전체가 하나의 Frame
+    ULONGLONG flushPointBytes; // 원본 기준 이 크기마다 Flush Point 생성 (0 이면 크기 기준 없음)
+    DWORD flushPointMillis;    // 마지막 Flush Point 이후 이 시간이 지나면 Flush Point 생성 (ms, 0 이면 시간 기준 없음)
+
+    ChecksumMode checksum;     // Frame 에 포함할 Checksum (압축 해제 시 기본으로 검증됨)
+
+    // 쓰기 후 검증: NULL 이 아니면 압축 데이터를 별도 Thread 에서 바로 압축 해제하여 원본과 비교하고,
+    // 결과를 여기에 저장함. 검증에 실패하면 compress_file_ex 도 실패 (compress_file_ex 에만 적용)
+    VERIFY_Result_t* verify;
+
+    // 입력/출력 파일의 File Cache 사용 방식 (compress_file_ex 에만 적용)
+    // IO_CACHE_DIRECT 이면 큰 파일을 압축해도 다른 작업이 사용하는 Cache 를 밀어내지 않음
+    IoCacheMode cacheMode;
+
+    // 출력 Staging: 압축 결과를 모아 큰 정렬된 쓰기로 합침 (io_stage.h, compress_file_ex 에만 적용)
+    // 작업마다 버퍼 두 개를 할당하므로 기본은 압축 결과마다 바로 씀 (IO_CACHE_DIRECT 이거나 durability 를 정하면 항상 사용)
+    BOOL bOutputStaging;       // TRUE 이면 Staging 사용
+    size_t outputStageSize;    // 모아 쓰는 크기 (0 이면 IO_STAGE_DEFAULT_SIZE)
+    BOOL bPreallocate;         // TRUE 이면 출력 파일을 예상 크기만큼 미리 할당 (Staging 을 사용할 때만 적용)
+
+    // 내구성: 출력을 언제 Disk 에 동기화할지 (IO_DURABILITY_NONE 이 아니면 Staging 을 사용, 주기적인 동기화는 별도 Thread 에서 진행)
+    IoDurability durability;   // 기본값은 IO_DURABILITY_NONE
+    ULONGLONG syncBytes;       // IO_DURABILITY_EVERY_BYTES 의 동기화 간격 (0 이면 IO_STAGE_DEFAULT_SIZE)
+    DWORD syncMillis;          // IO_DURABILITY_EVERY_MILLIS 의 동기화 간격 (ms)
+
+    // 읽기 / 압축 / 쓰기 Pipeline: 읽기와 쓰기를 별도 Thread 에서 진행하여 압축과 겹침 (pipeline.h, ZSTD 의 compress_file_ex 에만 적용)
+    BOOL bPipeline;            // TRUE 이면 Pipeline 사용
+    DWORD pipelineDepth;       // 방향별 Chunk 수 (0 이면 PIPE_DEFAULT_DEPTH)
+    PIPE_Stats_t* pipelineStats; // NULL 이 아니면 Stage 별로 기다린 시간 등을 저장
+
+    // 공유 Thread Pool: 여러 압축 작업이 같은 Worker 를 나눠 씀 (task_pool.h, compress_file_ex 에만 적용)
+    // LZ4 는 원본을 LZ4_POOL_CHUNK_SIZE 마다 독립된 Frame 으로 나누어 Pool 에서 병렬로 압축하고,
+    // ZSTD 는 Pool 의 ZSTD_threadPool 을 Worker 로 사용 (ZSTD Thread 가 하나 이하이면 호출한 Thread 에서 압축, bPipeline 과 함께 사용 가능)
+    TASK_Pool_t* pool;         // NULL 이면 사용 안 함 (보통 task_pool_shared())
+    TaskPriority priority;     // Pool 에서의 우선순위 (LZ4 Chunk Task 에 적용, ZSTD_threadPool 은 우선순위 없음)
+
+    // 마감 시간: 압축하면서 속도를 재어, 이 시간 안에 끝나는 가장 높은 Level 로 조절 (adapt.h, compress_file_ex 에만 적용)
+    // ZSTD 는 압축 중에 ZSTD_CCtx_setParameter 로 Level 을 바꾸고, LZ4 는 새 Frame 을 시작하여 HC Level 로 바꿈
+    DWORD deadlineMillis;      // 압축 시작부터 마감까지의 시간 (ms, 0 이면 Level 고정)
+    // 출력 속도에 맞춘 Level: 쓰기를 기다리면 (I/O 병목) 올리고 CPU 가 병목이면 내림 (ZSTD 에만 적용, deadlineMillis 가 우선)
+    BOOL bAdaptToOutput;       // TRUE 이면 사용
+    ADAPT_Stats_t* adaptStats; // NULL 이 아니면 사용한 Level, Level 변경 기록, 마감 여부 등을 저장
+
+    // 한 번에 읽어 압축하는 크기 (compress_file_ex 에만 적용, LZ4 의 Pool 사용 시에는 LZ4_POOL_CHUNK_SIZE 고정)
+    // 0 이면 입력 파일이 있는 Volume 에 보정 값 (tune.h) 이 있으면 그 값을, 없으면 알고리듬 기본값 사용
+    // TUNE_MIN_CHUNK_SIZE ~ TUNE_MAX_CHUNK_SIZE 로 자르고 TUNE_MIN_CHUNK_SIZE (Direct I/O 이면 Sector 크기) 의 배수로 올림
+    DWORD chunkSize;
+
+    // LZ4 Frame 설정 (LZ4 에만 적용, 0 으로 두면 기본값: 64 KB 연결된 Block, Level 0)
+    DWORD lz4BlockSize;        // Block 최대 크기 (64 KB, 256 KB, 1 MB, 4 MB 중 이 값 이상인 가장 작은 것, 0 이면 64 KB)
+    BOOL bLz4IndependentBlocks; // TRUE 이면 Block 끼리 참조하지 않음 (압축률은 낮아지지만 Block 별로 압축 해제 가능)
+    int lz4Level;              // 음수는 가속 (Acceleration), 0 ~ 2 는 기본, 3 ~ 12 는 HC (deadlineMillis 가 있으면 무시)
+    BOOL bLz4FavorDecSpeed;    // TRUE 이면 압축 해제가 빠른 쪽을 고름 (HC Level 10 이상에서만 효과)
+
+    // 장거리 일치 (Long Distance Matching): Window 를 키우고, 멀리 떨어져 반복되는 큰 덩어리 (Stack Trace, 설정 Dump 등) 를 찾음
+    // ZSTD 에만 적용. Window 만큼 메모리를 사용하며 (zstd_estimate_memory), Window 가 27 보다 크면 압축 해제 시
+    // DecompressionOptions.windowLogMax 도 같은 값 이상으로 지정해야 함. Window 는 입력 파일 크기보다 커지지 않음
+    BOOL bZstdLongDistance;    // TRUE 이면 LDM 사용
+    int zstdWindowLog;         // Window 크기 (2^n bytes, 10 ~ 31, 0 이면 LDM 사용 시 27, 아니면 Level 기본값)
+    int zstdLdmHashLog;        // LDM Hash Table 크기 (2^n 항목, 0 이면 zstd 기본값)
+    int zstdLdmMinMatch;       // LDM 이 찾는 최소 일치 길이 (bytes, 0 이면 zstd 기본값 64)
+    int zstdLdmBucketSizeLog;  // Hash Bucket 크기 (2^n 항목, 0 이면 zstd 기본값)
+    int zstdLdmHashRateLog;    // 2^n 위치마다 하나를 Hash 에 넣음 (0 이면 zstd 기본값)
+    size_t* zstdMemoryUsage;   // NULL 이 아니면 압축에 사용한 ZSTD Context 의 메모리 크기를 저장 (ZSTD_sizeof_CCtx)
+
+    // Delta 압축: 기준 파일 (이전 버전) 을 Memory 에 Map 하여 Prefix 로 붙이고, 기준과 같은 부분을 참조로 압축 (zstd --patch-from)
+    // ZSTD 의 compress_file_ex 에만 적용. 압축 해제할 때도 DecompressionOptions.referencePath 로 같은 파일이 필요함
+    // Window 를 기준 + 입력 크기로 키우고 LDM 을 켜며, 파일 전체가 하나의 Frame 이어야 하므로 Flush Point 와 Level 조절은 무시
+    const TCHAR* referencePath; // 기준 파일 경로 (NULL 이면 사용 안 함)
+} CompressionOptions;
+
 // 함수 선언
+BOOL compress_flush_point_due(const CompressionOptions* options, ULONGLONG bytesSinceFlush, ULONGLONG lastFlushTick);
+DWORD compress_chunk_size(
+    const CompressionOptions* options, CompressionAlgorithm algorithm, HANDLE hInput, DWORD defaultSize
+);
+BOOL compress_create_stage(
+    const CompressionOptions* options, HANDLE hInput, HANDLE hOutput,
+    size_t readSize, size_t maxPieceSize, IO_Stage_t** pStage
+);
 BOOL compress_file(const TCHAR *inputFilePath, const TCHAR *outputFilePath, CompressionAlgorithm algorithm);
+BOOL compress_file_ex(
+    const TCHAR *inputFilePath, const TCHAR *outputFilePath,
+    CompressionAlgorithm algorithm, const CompressionOptions* options
+);
 
 #endif // COMPRESSOR_H
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <windows.h>
+
+/*
+ * CRC32C (Castagnoli)
+ *
+ * Archive Index 처럼 LZ4/ZSTD Frame 밖에 있는 Metadata 의 무결성 검사에 사용합니다.
+ * x64 의 SSE4.2 crc32 명령, ARM64 의 ARMv8 CRC32 명령을 실행 시점에 감지하여 사용하고,
+ * 둘 다 없으면 Table 기반 소프트웨어 구현으로 계산합니다.
+ *
+ * crc 인자에 이전 결과를 넘기면 여러 조각을 이어서 계산할 수 있습니다. (처음에는 0)
+ */
+
+// 함수 선언
+
+DWORD crc32c(DWORD crc, const void* data, size_t size);
+DWORD crc32c_software(DWORD crc, const void* data, size_t size);
+BOOL crc32c_hardware(void);
+
+#endif // CRC32C_H
@@ -0,0 +1,324 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define ZSTD_STATIC_LINKING_ONLY // ZSTD_d_forceIgnoreChecksum
+
+#include "decompressor.h"
+#include "asyncio_win.h"
+#include "utility.h"
+
+static const DecompressionOptions kDefaultDecompressionOptions = { 0, };
+
+/**
+ * @brief Delta 압축의 기준 파일을 다음 Frame 의 Prefix 로 붙입니다. (zstd 는 Frame 하나에만 사용)
+ *
+ * @param decomp 압축 해제 컨텍스트 (ZSTD)
+ * @return 성공 여부 (기준 파일이 없으면 아무것도 하지 않음)
+ */
+static BOOL decompressor_ref_prefix(DECOMP_Context_t* decomp) {
+    if (decomp->reference.data == NULL) {
+        return TRUE;
+    }
+    return !ZSTD_isError(ZSTD_DCtx_refPrefix(decomp->zstdDctxPtr, decomp->reference.data, decomp->reference.size));
+}
+
+/**
+ * @brief 압축 해제 컨텍스트를 생성합니다. Frame 에 Checksum 이 있으면 검증합니다.
+ *
+ * 압축 해제 컨텍스트는 여러 번의 압축 해제에 재사용하여, 매 호출마다 발생하는 할당 비용을 줄입니다.
+ *
+ * @param decomp 압축 해제 컨텍스트 이중 포인터
+ * @param algorithm 압축 해제할 알고리듬
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL create_decompressor(DECOMP_Context_t** decomp, CompressionAlgorithm algorithm) {
+    return create_decompressor_ex(decomp, algorithm, NULL);
+}
+
+/**
+ * @brief 옵션을 지정하여 압축 해제 컨텍스트를 생성합니다.
+ *
+ * @param decomp 압축 해제 컨텍스트 이중 포인터
+ * @param algorithm 압축 해제할 알고리듬
+ * @param options 압축 해제 옵션 (NULL 이면 기본값)
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL create_decompressor_ex(DECOMP_Context_t** decomp, CompressionAlgorithm algorithm, const DecompressionOptions* options) {
+    if (options == NULL) {
+        options = &kDefaultDecompressionOptions;
+    }
+
+    *decomp = (DECOMP_Context_t*)calloc(1, sizeof(DECOMP_Context_t));
+    if (*decomp == NULL) {
+        return FALSE;
+    }
+
+    (*decomp)->algorithm = algorithm;
+    (*decomp)->bSkipChecksum = options->bSkipChecksum;
+    (*decomp)->bFrameEnd = TRUE;
+
+    BOOL bResult = FALSE;
+    switch (algorithm) {
+        case LZ4:
+            bResult = !LZ4F_isError(LZ4F_createDecompressionContext(&((*decomp)->lz4DctxPtr), LZ4F_VERSION));
+            break;
+        case ZSTD:
+            (*decomp)->zstdDctxPtr = ZSTD_createDCtx();
+            bResult = ((*decomp)->zstdDctxPtr != NULL) &&
+                !ZSTD_isError(ZSTD_DCtx_setParameter((*decomp)->zstdDctxPtr, ZSTD_d_forceIgnoreChecksum,
+                    options->bSkipChecksum ? ZSTD_d_ignoreChecksum : ZSTD_d_validateChecksum));
+            if (bResult && options->windowLogMax != 0) {
+                bResult = !ZSTD_isError(ZSTD_DCtx_setParameter((*decomp)->zstdDctxPtr, ZSTD_d_windowLogMax,
+                    options->windowLogMax));
+            } else if (bResult && options->referencePath != NULL) {
+                // Delta Frame 의 Window 는 기준 + 원본 크기 (기준 파일을 믿으므로 크기 제한 없음)
+                bResult = !ZSTD_isError(ZSTD_DCtx_setParameter((*decomp)->zstdDctxPtr, ZSTD_d_windowLogMax,
+                    ZSTD_WINDOWLOG_MAX));
+            }
+            if (bResult && options->referencePath != NULL) {
+                bResult = io_map_file(options->referencePath, &((*decomp)->reference)) &&
+                    decompressor_ref_prefix(*decomp);
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (bResult) {
+        return TRUE;
+    }
+
+    log_message("Failed to create decompression context.");
+
+    free_decompressor(*decomp);
+    *decomp = NULL;
+
+    return FALSE;
+}
+
+/**
+ * @brief 압축 해제 컨텍스트의 자원을 해제합니다.
+ *
+ * @param decomp 압축 해제 컨텍스트 포인터
+ */
+void free_decompressor(DECOMP_Context_t* decomp) {
+    if (decomp == NULL) {
+        return;
+    }
+
+    LZ4F_freeDecompressionContext(decomp->lz4DctxPtr);
+    ZSTD_freeDCtx(decomp->zstdDctxPtr);
+    io_unmap_file(&(decomp->reference));
+    free(decomp);
+}
+
+/**
+ * @brief 메모리에 있는 완결된 Frame 하나를 압축 해제합니다.
+ *
+ * @param decomp 압축 해제 컨텍스트
+ * @param src 압축된 Frame
+ * @param srcSize 압축된 Frame 크기
+ * @param dst 압축 해제 결과를 저장할 버퍼
+ * @param dstCapacity dst 버퍼 크기
+ * @param pDstSize 압축 해제된 크기
+ * @return 성공 시 TRUE, 실패(손상된 Frame, 버퍼 부족) 시 FALSE
+ */
+BOOL decompress_buffer(
+    DECOMP_Context_t* decomp,
+    const void* src, size_t srcSize,
+    void* dst, size_t dstCapacity, size_t* pDstSize
+) {
+    *pDstSize = 0;
+
+    if (decomp->algorithm == ZSTD) {
+        size_t const dSize = ZSTD_decompressDCtx(decomp->zstdDctxPtr, dst, dstCapacity, src, srcSize);
+        if (ZSTD_isError(dSize) || !decompressor_ref_prefix(decomp)) {
+            log_message("ZSTD decompression failed!");
+            return FALSE;
+        }
+
+        *pDstSize = dSize;
+        return TRUE;
+    }
+
+    // LZ4F_decompress 는 Frame 끝에 도달하면 0 을 반환
+    const BYTE* srcPtr = (const BYTE*)src;
+    const BYTE* const srcEnd = srcPtr + srcSize;
+    BYTE* dstPtr = (BYTE*)dst;
+    BYTE* const dstEnd = dstPtr + dstCapacity;
+    size_t hint = 1;
+    LZ4F_decompressOptions_t decompressOptions = { 0, };
+    decompressOptions.skipChecksums = decomp->bSkipChecksum;
+
+    while (hint != 0 && srcPtr < srcEnd) {
+        size_t srcChunk = (size_t)(srcEnd - srcPtr);
+        size_t dstChunk = (size_t)(dstEnd - dstPtr);
+
+        hint = LZ4F_decompress(decomp->lz4DctxPtr, dstPtr, &dstChunk, srcPtr, &srcChunk, &decompressOptions);
+        if (LZ4F_isError(hint)) {
+            log_message("LZ4 decompression failed!");
+            LZ4F_resetDecompressionContext(decomp->lz4DctxPtr);
+            return FALSE;
+        }
+
+        srcPtr += srcChunk;
+        dstPtr += dstChunk;
+
+        if (hint != 0 && srcChunk == 0 && dstChunk == 0) {
+            break; // 더 이상 진행 불가 (출력 버퍼 부족)
+        }
+    }
+
+    if (hint != 0) {
+        log_message("LZ4 frame is truncated or destination is too small.");
+        LZ4F_resetDecompressionContext(decomp->lz4DctxPtr);
+        return FALSE;
+    }
+
+    *pDstSize = (size_t)(dstPtr - (BYTE*)dst);
+    return TRUE;
+}
+
+/**
+ * @brief 입력 일부를 압축 해제합니다. Frame 중간에서 끊긴 입력도 다음 호출에 이어서 처리합니다.
+ *
+ * 이어 붙인 Frame 은 앞 Frame 이 끝나면 다음 Frame 을 이어서 해제합니다. Checksum 이 맞지 않으면 실패합니다.
+ * 호출 후 decomp->bFrameEnd 가 TRUE 이면 Frame 경계에서 끝난 것입니다.
+ * 출력 버퍼를 가득 채운 경우 Decoder 내부에 남은 출력이 있을 수 있으므로 다시 호출해야 합니다.
+ *
+ * @param decomp 압축 해제 컨텍스트
+ * @param src 압축된 입력
+ * @param pSrcSize 입력 크기 (호출 후 사용한 크기)
+ * @param dst 압축 해제 결과를 저장할 버퍼
+ * @param pDstSize dst 버퍼 크기 (호출 후 쓴 크기)
+ * @return 성공 시 TRUE, 실패(손상된 Frame, Checksum 불일치) 시 FALSE
+ */
+BOOL decompress_stream(
+    DECOMP_Context_t* decomp,
+    const void* src, size_t* pSrcSize,
+    void* dst, size_t* pDstSize
+) {
+    if (decomp->algorithm == LZ4) {
+        LZ4F_decompressOptions_t decompressOptions = { 0, };
+        decompressOptions.skipChecksums = decomp->bSkipChecksum;
+
+        size_t const hint = LZ4F_decompress(decomp->lz4DctxPtr, dst, pDstSize, src, pSrcSize, &decompressOptions);
+        if (LZ4F_isError(hint)) {
+            log_message("LZ4 decompression failed!");
+            LZ4F_resetDecompressionContext(decomp->lz4DctxPtr);
+            return FALSE;
+        }
+        if (*pSrcSize > 0 || *pDstSize > 0) {
+            decomp->bFrameEnd = (hint == 0);
+        }
+        return TRUE;
+    }
+
+    ZSTD_inBuffer input = { src, *pSrcSize, 0 };
+    ZSTD_outBuffer output = { dst, *pDstSize, 0 };
+    size_t const hint = ZSTD_decompressStream(decomp->zstdDctxPtr, &output, &input);
+    if (ZSTD_isError(hint)) {
+        log_message("ZSTD decompression failed!");
+        ZSTD_DCtx_reset(decomp->zstdDctxPtr, ZSTD_reset_session_only);
+        decompressor_ref_prefix(decomp);
+        return FALSE;
+    }
+    if (hint == 0 && !decompressor_ref_prefix(decomp)) { // 다음 Frame 도 기준 파일을 참조
+        return FALSE;
+    }
+
+    *pSrcSize = input.pos;
+    *pDstSize = output.pos;
+    if (input.pos > 0 || output.pos > 0) {
+        decomp->bFrameEnd = (hint == 0); // 아무것도 처리하지 않은 호출은 이전 상태 유지
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 압축 파일 전체를 압축 해제하여 다른 파일로 저장합니다.
+ *
+ * 기본으로 Frame 의 Checksum 을 검증하며, 불일치하거나 마지막 Frame 이 잘려 있으면 실패합니다.
+ *
+ * @param inputFilePath 압축 파일 경로
+ * @param outputFilePath 압축 해제 결과를 저장할 파일 경로
+ * @param algorithm 압축 알고리듬
+ * @param options 압축 해제 옵션 (NULL 이면 기본값)
+ * @return 성공 여부
+ */
+BOOL decompress_file(
+    const TCHAR* inputFilePath, const TCHAR* outputFilePath,
+    CompressionAlgorithm algorithm, const DecompressionOptions* options
+) {
+    HANDLE hInput = init_file_read(inputFilePath);
+    HANDLE hOutput = init_file_write(outputFilePath);
+    DECOMP_Context_t* decomp = NULL;
+    BYTE* const srcBuf = (BYTE*)malloc(DECOMP_FILE_BUFFER_SIZE);
+    BYTE* const dstBuf = (BYTE*)malloc(DECOMP_FILE_BUFFER_SIZE);
+
+    BOOL bResult = hInput != INVALID_HANDLE_VALUE && hOutput != INVALID_HANDLE_VALUE && srcBuf && dstBuf &&
+        create_decompressor_ex(&decomp, algorithm, options);
+
+    OVERLAPPED readOverlap = { 0, }, writeOverlap = { 0, };
+    ULONGLONG readOffset = 0, writeOffset = 0;
+    while (bResult) {
+        DWORD dwBytesRead = 0;
+        async_set_offset(&readOverlap, readOffset);
+        if (!async_read(hInput, srcBuf, DECOMP_FILE_BUFFER_SIZE, &dwBytesRead, &readOverlap, TRUE)) {
+            bResult = FALSE;
+            break;
+        }
+        if (dwBytesRead == 0) {
+            break;
+        }
+        readOffset += dwBytesRead;
+
+        size_t srcPos = 0;
+        BOOL bOutputFull = FALSE;
+        while (bResult && (srcPos < dwBytesRead || bOutputFull)) {
+            size_t srcSize = dwBytesRead - srcPos;
+            size_t dstSize = DECOMP_FILE_BUFFER_SIZE;
+
+            bResult = decompress_stream(decomp, srcBuf + srcPos, &srcSize, dstBuf, &dstSize);
+            srcPos += srcSize;
+            bOutputFull = (dstSize == DECOMP_FILE_BUFFER_SIZE);
+
+            if (bResult && dstSize > 0) {
+                DWORD dwBytesWritten;
+                async_set_offset(&writeOverlap, writeOffset);
+                bResult = async_write(hOutput, dstBuf, (DWORD)dstSize, &dwBytesWritten, &writeOverlap, TRUE);
+                writeOffset += dstSize;
+            }
+        }
+    }
+
+    if (bResult && !decomp->bFrameEnd) {
+        log_message("Compressed file is truncated.");
+        bResult = FALSE;
+    }
+
+    free_decompressor(decomp);
+    free(srcBuf);
+    free(dstBuf);
+    if (hInput != INVALID_HANDLE_VALUE) {
+        CloseHandle(hInput);
+    }
+    if (hOutput != INVALID_HANDLE_VALUE) {
+        CloseHandle(hOutput);
+    }
+
+    return bResult;
+}
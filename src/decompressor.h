@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+
+#include <windows.h>
+
+#include "compressor.h"
+#include "../include/lz4/lz4frame.h"
+#include "../include/zstd/zstd.h"
+
+#define DECOMP_FILE_BUFFER_SIZE (1024 * 1024) // decompress_file 의 읽기/쓰기 단위 (1 MB)
+
+// 구조체 선언
+
+typedef struct DECOMP_Context_s DECOMP_Context_t;
+
+typedef struct {
+    BOOL bSkipChecksum;  // TRUE 이면 Frame 의 Block/Content Checksum 검증을 생략 (기본은 검증)
+    int windowLogMax;    // ZSTD: 허용할 최대 Window 크기 (2^n bytes, 0 이면 zstd 기본값 27 = 128 MB)
+                         //       CompressionOptions.zstdWindowLog 를 27 보다 크게 하여 압축한 Frame 을 풀 때 같은 값 이상 필요
+    const TCHAR* referencePath; // ZSTD: Delta 압축 (CompressionOptions.referencePath) 에 사용한 기준 파일 (NULL 이면 없음)
+                                //       지정하면 windowLogMax 가 0 일 때 기준 크기에 맞는 큰 Window 를 허용
+} DecompressionOptions;
+
+struct DECOMP_Context_s {
+    CompressionAlgorithm algorithm;  // 압축 해제할 알고리듬
+    LZ4F_dctx* lz4DctxPtr;           // LZ4F 압축 해제 컨텍스트 포인터 (LZ4 인 경우)
+    ZSTD_DCtx* zstdDctxPtr;          // ZSTD 압축 해제 컨텍스트 포인터 (ZSTD 인 경우)
+    BOOL bSkipChecksum;              // Checksum 검증 생략 여부
+    BOOL bFrameEnd;                  // decompress_stream 이 Frame 경계에서 끝났는지 여부
+    IO_Mapping_t reference;          // Delta 압축의 기준 파일 (Frame 마다 Prefix 로 붙임, ZSTD 인 경우)
+};
+
+// 함수 선언
+
+BOOL create_decompressor(DECOMP_Context_t** decomp, CompressionAlgorithm algorithm);
+BOOL create_decompressor_ex(DECOMP_Context_t** decomp, CompressionAlgorithm algorithm, const DecompressionOptions* options);
+void free_decompressor(DECOMP_Context_t* decomp);
+BOOL decompress_buffer(
+    DECOMP_Context_t* decomp,
+    const void* src, size_t srcSize,
+    void* dst, size_t dstCapacity, size_t* pDstSize
+);
+BOOL decompress_stream(
+    DECOMP_Context_t* decomp,
+    const void* src, size_t* pSrcSize,
+    void* dst, size_t* pDstSize
+);
+BOOL decompress_file(
+    const TCHAR* inputFilePath, const TCHAR* outputFilePath,
+    CompressionAlgorithm algorithm, const DecompressionOptions* options
+);
+
+#endif // DECOMPRESSOR_H
@@ -0,0 +1,451 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/lz4/lz4frame.h"
+#include "../include/zstd/zstd.h"
+#include "estimate.h"
+#include "asyncio_win.h"
+#include "utility.h"
+
+// 구조체 선언
+
+/*
+ * 표본 Block 을 압축하며 모으는 값
+ */
+typedef struct {
+    CompressionAlgorithm algorithm;
+    LZ4F_cctx* lz4;           // LZ4 압축 컨텍스트 (Block 마다 재사용)
+    ZSTD_CCtx* zstd;          // ZSTD 압축 컨텍스트 (Block 마다 재사용)
+    LZ4F_preferences_t prefs; // LZ4 압축 옵션 (lz4nb.c 와 같은 Frame 형식)
+    void* dst;                // 압축 결과 버퍼
+    size_t dstCapacity;       // 압축 결과 버퍼 크기
+    BOOL bWarm;               // 첫 Block 을 시간을 재지 않고 한 번 압축했는지 (Cache, 할당 영향 제거)
+
+    DWORD count;              // 압축한 Block 수
+    ULONGLONG rawBytes;       // 압축한 원본 크기
+    ULONGLONG compressedBytes;// 압축 결과 크기
+    double sumRatio;          // Block 별 압축 비율 (압축 / 원본) 의 합
+    double sumRatioSq;        // Block 별 압축 비율의 제곱의 합
+    double minRatio;          // Block 별 압축 비율 최소값
+    double maxRatio;          // Block 별 압축 비율 최대값
+    double sumCost;           // Block 별 Byte 당 시간 (us/byte) 의 합
+    double sumCostSq;         // Block 별 Byte 당 시간의 제곱의 합
+    double minCost;           // Block 별 Byte 당 시간 최소값
+    double maxCost;           // Block 별 Byte 당 시간 최대값
+    ULONGLONG micros;         // 압축에 걸린 시간의 합 (us)
+    double sumEntropy;        // Block 별 Entropy 의 합
+    double minEntropy;        // Block 별 Entropy 최소값
+    double maxEntropy;        // Block 별 Entropy 최대값
+} ESTIMATE_Sampler_t;
+
+/**
+ * @brief 데이터의 0 차 Entropy (Byte 분포의 Shannon Entropy) 를 구합니다.
+ *
+ * Byte 빈도는 4 개의 Table 에 나누어 세고 마지막에 합칩니다. 같은 Byte 가 이어질 때
+ * 같은 Counter 를 연달아 증가시키며 생기는 Store-to-Load 지연을 피하기 위함입니다. (LZ4/ZSTD 의 Histogram 과 같은 방식)
+ *
+ * @param data 데이터
+ * @param size 데이터 크기
+ * @return Entropy (bits/byte, 0 ~ 8). 크기가 0 이면 0
+ */
+double estimate_entropy(const void* data, size_t size) {
+    DWORD counts[4][256];
+    const BYTE* p = (const BYTE*)data;
+    const BYTE* const end = p + size;
+
+    if (size == 0) {
+        return 0.0;
+    }
+    memset(counts, 0, sizeof(counts));
+
+    while (end - p >= 16) {
+        DWORD words[4];
+        memcpy(words, p, sizeof(words));
+        for (int i = 0; i < 4; i++) {
+            counts[0][words[i] & 0xFF]++;
+            counts[1][(words[i] >> 8) & 0xFF]++;
+            counts[2][(words[i] >> 16) & 0xFF]++;
+            counts[3][words[i] >> 24]++;
+        }
+        p += 16;
+    }
+    while (p < end) {
+        counts[0][*p++]++;
+    }
+
+    double entropy = 0.0;
+    double const total = (double)size;
+    for (int b = 0; b < 256; b++) {
+        DWORD const count = counts[0][b] + counts[1][b] + counts[2][b] + counts[3][b];
+        if (count != 0) {
+            double const probability = (double)count / total;
+            entropy -= probability * log2(probability);
+        }
+    }
+    return entropy;
+}
+
+/**
+ * @brief 표본 압축 컨텍스트와 버퍼를 준비합니다.
+ *
+ * @param level 알고리듬의 압축 Level
+ * @param blockSize 표본 Block 크기
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL estimate_sampler_init(ESTIMATE_Sampler_t* sampler, CompressionAlgorithm algorithm, int level, size_t blockSize) {
+    memset(sampler, 0, sizeof(ESTIMATE_Sampler_t));
+    sampler->algorithm = algorithm;
+    sampler->minRatio = sampler->minCost = sampler->minEntropy = HUGE_VAL;
+
+    if (algorithm == LZ4) {
+        sampler->prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+        sampler->prefs.frameInfo.blockMode = LZ4F_blockLinked;
+        sampler->prefs.compressionLevel = level;
+        if (LZ4F_isError(LZ4F_createCompressionContext(&(sampler->lz4), LZ4F_VERSION))) {
+            log_message("Failed to create LZ4 context for estimation.");
+            return FALSE;
+        }
+        sampler->dstCapacity = LZ4F_compressFrameBound(blockSize, &(sampler->prefs));
+    } else if (algorithm == ZSTD) {
+        sampler->zstd = ZSTD_createCCtx();
+        if (sampler->zstd == NULL ||
+            ZSTD_isError(ZSTD_CCtx_setParameter(sampler->zstd, ZSTD_c_compressionLevel, level))) {
+            log_message("Failed to create ZSTD context for estimation.");
+            return FALSE;
+        }
+        sampler->dstCapacity = ZSTD_compressBound(blockSize);
+    } else {
+        log_message("Unknown compression algorithm.");
+        return FALSE;
+    }
+
+    sampler->dst = malloc(sampler->dstCapacity);
+    if (sampler->dst == NULL) {
+        log_message("Failed to allocate estimation buffer.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 표본 압축 컨텍스트와 버퍼를 해제합니다.
+ */
+static void estimate_sampler_free(ESTIMATE_Sampler_t* sampler) {
+    if (sampler->lz4 != NULL) {
+        LZ4F_freeCompressionContext(sampler->lz4);
+    }
+    ZSTD_freeCCtx(sampler->zstd);
+    free(sampler->dst);
+}
+
+/**
+ * @brief Block 하나를 독립된 Frame 으로 압축합니다.
+ *
+ * @return 압축 결과 크기, 실패 시 0
+ */
+static size_t estimate_compress_block(ESTIMATE_Sampler_t* sampler, const void* src, size_t size) {
+    if (sampler->algorithm == LZ4) {
+        size_t const result = LZ4F_compressFrame_usingCDict(
+            sampler->lz4, sampler->dst, sampler->dstCapacity, src, size, NULL, &(sampler->prefs)
+        );
+        return LZ4F_isError(result) ? 0 : result;
+    }
+    size_t const result = ZSTD_compress2(sampler->zstd, sampler->dst, sampler->dstCapacity, src, size);
+    return ZSTD_isError(result) ? 0 : result;
+}
+
+/**
+ * @brief 표본 Block 하나의 Entropy 를 구하고, 압축하여 크기와 걸린 시간을 모읍니다.
+ *
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL estimate_sample(ESTIMATE_Sampler_t* sampler, const void* src, size_t size) {
+    double const entropy = estimate_entropy(src, size);
+
+    if (!sampler->bWarm) {
+        estimate_compress_block(sampler, src, size);
+        sampler->bWarm = TRUE;
+    }
+
+    ULONGLONG const start = now_micros();
+    size_t const compressedSize = estimate_compress_block(sampler, src, size);
+    ULONGLONG const micros = now_micros() - start;
+    if (compressedSize == 0) {
+        log_message("Failed to compress estimation sample.");
+        return FALSE;
+    }
+
+    double const ratio = (double)compressedSize / (double)size;
+    double const cost = (double)micros / (double)size;
+
+    sampler->count++;
+    sampler->rawBytes += size;
+    sampler->compressedBytes += compressedSize;
+    sampler->micros += micros;
+    sampler->sumRatio += ratio;
+    sampler->sumRatioSq += ratio * ratio;
+    sampler->minRatio = fmin(sampler->minRatio, ratio);
+    sampler->maxRatio = fmax(sampler->maxRatio, ratio);
+    sampler->sumCost += cost;
+    sampler->sumCostSq += cost * cost;
+    sampler->minCost = fmin(sampler->minCost, cost);
+    sampler->maxCost = fmax(sampler->maxCost, cost);
+    sampler->sumEntropy += entropy;
+    sampler->minEntropy = fmin(sampler->minEntropy, entropy);
+    sampler->maxEntropy = fmax(sampler->maxEntropy, entropy);
+    return TRUE;
+}
+
+/**
+ * @brief Block 별 값의 평균에 대한 신뢰 구간의 반폭을 구합니다.
+ *
+ * @param sum 값의 합
+ * @param sumSq 값의 제곱의 합
+ * @param count 표본 Block 수
+ * @param totalBlocks 전체 Block 수 (유한 모집단 보정)
+ * @return 신뢰 구간 반폭
+ */
+static double estimate_margin(double sum, double sumSq, DWORD count, DWORD totalBlocks) {
+    if (count < 2 || count >= totalBlocks) {
+        return 0.0;
+    }
+    double const mean = sum / count;
+    double variance = (sumSq - count * mean * mean) / (count - 1);
+    if (variance < 0.0) {
+        variance = 0.0; // 반올림 오차
+    }
+    double const correction = 1.0 - (double)count / (double)totalBlocks;
+    return ESTIMATE_CONFIDENCE_Z * sqrt(variance / count * correction);
+}
+
+/**
+ * @brief 모은 값으로 전체의 압축 크기와 속도를 예측합니다.
+ *
+ * 표본 오차 구간은 관측한 Block 중 가장 좋은 값과 가장 나쁜 값을 넘지 않게 자른 뒤, 모형 오차만큼 넓힙니다.
+ * 넓힌 아래쪽 경계는 가장 좋은 Block 값의 (1 - 모형 오차) 배 아래로 내려가지 않게 하여 0 이하가 되지 않게 합니다.
+ * (시간을 잴 수 없을 만큼 빠른 Block 이 있으면 costLow 는 0 이고 speedHigh 는 0 (알 수 없음))
+ */
+static void estimate_finish(const ESTIMATE_Sampler_t* sampler, ULONGLONG totalBytes, DWORD totalBlocks, ESTIMATE_Result_t* result) {
+    double const ratio = sampler->sumRatio / sampler->count;
+    double const ratioMargin = estimate_margin(sampler->sumRatio, sampler->sumRatioSq, sampler->count, totalBlocks);
+    double const ratioLow = fmax(fmax(ratio - ratioMargin, sampler->minRatio) - ratio * ESTIMATE_RATIO_MODEL_ERROR,
+                                 sampler->minRatio * (1.0 - ESTIMATE_RATIO_MODEL_ERROR));
+    double const ratioHigh = fmin(ratio + ratioMargin, sampler->maxRatio) + ratio * ESTIMATE_RATIO_MODEL_ERROR;
+
+    double const cost = sampler->sumCost / sampler->count;
+    double const costMargin = estimate_margin(sampler->sumCost, sampler->sumCostSq, sampler->count, totalBlocks);
+    double const costLow = fmax(fmax(cost - costMargin, sampler->minCost) - cost * ESTIMATE_SPEED_MODEL_ERROR,
+                                sampler->minCost * (1.0 - ESTIMATE_SPEED_MODEL_ERROR));
+    double const costHigh = fmin(cost + costMargin, sampler->maxCost) + cost * ESTIMATE_SPEED_MODEL_ERROR;
+
+    result->totalBytes = totalBytes;
+    result->sampledBytes = sampler->rawBytes;
+    result->totalBlocks = totalBlocks;
+    result->sampledBlocks = sampler->count;
+
+    result->compressedBytes = (ULONGLONG)(ratio * totalBytes);
+    result->compressedBytesLow = (ULONGLONG)(ratioLow * totalBytes);
+    result->compressedBytesHigh = (ULONGLONG)(ratioHigh * totalBytes);
+    result->ratio = 1.0 / ratio;
+    result->ratioLow = 1.0 / ratioHigh;
+    result->ratioHigh = 1.0 / ratioLow;
+
+    // 시간을 잴 수 없을 만큼 빠르면 (0 us) 속도는 0 (알 수 없음)
+    result->speed = (cost > 0.0) ? 1000000.0 / cost : 0.0;
+    result->speedLow = (costHigh > 0.0) ? 1000000.0 / costHigh : 0.0;
+    result->speedHigh = (costLow > 0.0) ? 1000000.0 / costLow : 0.0;
+
+    result->entropy = sampler->sumEntropy / sampler->count;
+    result->entropyMin = sampler->minEntropy;
+    result->entropyMax = sampler->maxEntropy;
+}
+
+/**
+ * @brief 옵션으로 Block 크기, 전체 Block 수, 표본 Block 수를 정합니다.
+ *
+ * 끝에 남는 Block 보다 작은 부분은 표본으로 고르지 않습니다. 원본이 Block 하나보다 작으면 전체가 Block 하나입니다.
+ */
+static void estimate_plan(
+    const ESTIMATE_Options_t* options, ULONGLONG totalBytes,
+    size_t* pBlockSize, DWORD* pTotalBlocks, DWORD* pSampleBlocks
+) {
+    double fraction = (options != NULL && options->sampleFraction > 0.0) ? options->sampleFraction : ESTIMATE_DEFAULT_FRACTION;
+    size_t blockSize = (options != NULL && options->blockSize != 0) ? options->blockSize : ESTIMATE_DEFAULT_BLOCK_SIZE;
+    DWORD const minBlocks = (options != NULL && options->minBlocks != 0) ? options->minBlocks : ESTIMATE_MIN_BLOCKS;
+
+    if (fraction > 1.0) {
+        fraction = 1.0;
+    }
+    if (totalBytes < blockSize) {
+        blockSize = (size_t)totalBytes;
+    }
+
+    DWORD const totalBlocks = (DWORD)(totalBytes / blockSize);
+    DWORD sampleBlocks = (DWORD)ceil(fraction * totalBlocks);
+    if (sampleBlocks < minBlocks) {
+        sampleBlocks = minBlocks;
+    }
+    if (sampleBlocks > totalBlocks) {
+        sampleBlocks = totalBlocks;
+    }
+
+    *pBlockSize = blockSize;
+    *pTotalBlocks = totalBlocks;
+    *pSampleBlocks = sampleBlocks;
+}
+
+/**
+ * @brief k 번째 표본 Block 의 위치를 정합니다.
+ *
+ * 전체 Block 을 표본 수만큼의 구역으로 나누고, 각 구역 안에서 임의의 Block 하나를 고릅니다. (층화 추출)
+ *
+ * @param state 난수 상태 (xorshift32)
+ */
+static DWORD estimate_pick_block(DWORD k, DWORD sampleBlocks, DWORD totalBlocks, unsigned int* state) {
+    DWORD const first = (DWORD)((ULONGLONG)k * totalBlocks / sampleBlocks);
+    DWORD const last = (DWORD)((ULONGLONG)(k + 1) * totalBlocks / sampleBlocks);
+
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return first + ((last > first) ? (*state % (last - first)) : 0);
+}
+
+/**
+ * @brief 메모리에 있는 데이터의 압축 크기와 압축 속도를 예측합니다.
+ *
+ * @param data 원본 데이터
+ * @param size 원본 크기
+ * @param algorithm 압축 알고리듬
+ * @param level 압축 Level (compress_file 의 기본값은 LZ4 0, ZSTD 1)
+ * @param options 표본 옵션 (NULL 이면 기본값)
+ * @param result 예측 결과를 저장할 곳
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL estimate_compression_buffer(
+    const void* data, size_t size, CompressionAlgorithm algorithm, int level,
+    const ESTIMATE_Options_t* options, ESTIMATE_Result_t* result
+) {
+    ESTIMATE_Sampler_t sampler;
+    size_t blockSize;
+    DWORD totalBlocks, sampleBlocks;
+    unsigned int state = (options != NULL && options->seed != 0) ? options->seed : 0x9E3779B9u;
+    ULONGLONG const start = now_micros();
+
+    memset(result, 0, sizeof(ESTIMATE_Result_t));
+    if (size == 0) {
+        log_message("Nothing to estimate.");
+        return FALSE;
+    }
+
+    estimate_plan(options, size, &blockSize, &totalBlocks, &sampleBlocks);
+    BOOL bResult = estimate_sampler_init(&sampler, algorithm, level, blockSize);
+    for (DWORD k = 0; bResult && k < sampleBlocks; k++) {
+        DWORD const block = estimate_pick_block(k, sampleBlocks, totalBlocks, &state);
+        bResult = estimate_sample(&sampler, (const BYTE*)data + (size_t)block * blockSize, blockSize);
+    }
+    if (bResult) {
+        estimate_finish(&sampler, size, totalBlocks, result);
+        result->elapsedMicros = now_micros() - start;
+    }
+
+    estimate_sampler_free(&sampler);
+    return bResult;
+}
+
+/**
+ * @brief 파일의 지정한 위치에서 정확히 지정한 크기만큼 읽습니다.
+ */
+static BOOL estimate_read_at(HANDLE hFile, ULONGLONG offset, void* buffer, DWORD size) {
+    OVERLAPPED readOverlap = { 0, };
+    DWORD dwTotalRead = 0;
+
+    while (dwTotalRead < size) {
+        DWORD dwBytesRead = 0;
+        async_set_offset(&readOverlap, offset + dwTotalRead);
+        if (!async_read(hFile, (BYTE*)buffer + dwTotalRead, size - dwTotalRead, &dwBytesRead, &readOverlap, TRUE) ||
+            dwBytesRead == 0) {
+            return FALSE;
+        }
+        dwTotalRead += dwBytesRead;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 파일의 압축 크기와 압축 속도를 예측합니다. 표본 Block 만 읽습니다.
+ *
+ * @param filePath 원본 파일 경로
+ * @param algorithm 압축 알고리듬
+ * @param level 압축 Level (compress_file 의 기본값은 LZ4 0, ZSTD 1)
+ * @param options 표본 옵션 (NULL 이면 기본값)
+ * @param result 예측 결과를 저장할 곳 (elapsedMicros 는 읽기 시간 포함)
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL estimate_compression(
+    const TCHAR* filePath, CompressionAlgorithm algorithm, int level,
+    const ESTIMATE_Options_t* options, ESTIMATE_Result_t* result
+) {
+    ESTIMATE_Sampler_t sampler;
+    LARGE_INTEGER fileSize;
+    size_t blockSize;
+    DWORD totalBlocks, sampleBlocks;
+    unsigned int state = (options != NULL && options->seed != 0) ? options->seed : 0x9E3779B9u;
+    ULONGLONG const start = now_micros();
+
+    memset(result, 0, sizeof(ESTIMATE_Result_t));
+    HANDLE const hFile = init_file_read(filePath);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return FALSE;
+    }
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+        log_message("Nothing to estimate.");
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    estimate_plan(options, (ULONGLONG)fileSize.QuadPart, &blockSize, &totalBlocks, &sampleBlocks);
+    BOOL bResult = estimate_sampler_init(&sampler, algorithm, level, blockSize);
+    BYTE* const block = bResult ? (BYTE*)malloc(blockSize) : NULL;
+    if (bResult && block == NULL) {
+        log_message("Failed to allocate estimation buffer.");
+        bResult = FALSE;
+    }
+
+    for (DWORD k = 0; bResult && k < sampleBlocks; k++) {
+        ULONGLONG const offset = (ULONGLONG)estimate_pick_block(k, sampleBlocks, totalBlocks, &state) * blockSize;
+        if (!estimate_read_at(hFile, offset, block, (DWORD)blockSize)) {
+            log_message("Failed to read estimation sample.");
+            bResult = FALSE;
+            break;
+        }
+        bResult = estimate_sample(&sampler, block, blockSize);
+    }
+    if (bResult) {
+        estimate_finish(&sampler, (ULONGLONG)fileSize.QuadPart, totalBlocks, result);
+        result->elapsedMicros = now_micros() - start;
+    }
+
+    free(block);
+    estimate_sampler_free(&sampler);
+    CloseHandle(hFile);
+    return bResult;
+}
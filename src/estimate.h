@@ -0,0 +1,97 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ESTIMATE_H
+#define ESTIMATE_H
+
+#include <windows.h>
+
+#include "compressor.h"
+
+/*
+ * 압축 결과 예측 (Sampling)
+ *
+ * 파일 전체를 압축하지 않고 압축 후 크기와 압축 속도를 예측합니다. (업로드 순서를 정하는 등의 용도)
+ * 원본을 blockSize 단위 Block 으로 나누고, 그 중 sampleFraction 만큼을 고르게 흩어진 위치에서 골라
+ * 실제 LZ4F / ZSTD 로 (Block 마다 독립된 Frame 으로) 압축하여 잽니다.
+ * Block 별 압축 비율과 Byte 당 시간의 표본 분산으로 95% 신뢰 구간을 구하며, 표본이 전체의 큰 부분이면
+ * 유한 모집단 보정으로 구간을 좁힙니다. 표본 오차만으로는 설명되지 않는 차이 (Block 경계, 실행마다 다른 CPU 속도) 는
+ * ESTIMATE_*_MODEL_ERROR 만큼 구간을 넓혀 반영합니다.
+ * 예측 속도는 압축기만의 속도이며, 파일 읽기/쓰기 시간은 포함하지 않습니다.
+ *
+ * Block 끼리의 중복은 보지 못하므로 (Window 가 Block 을 넘지 못함) 반복이 먼 거리에 있는 데이터는
+ * 압축률을 낮게 예측합니다. 각 Block 의 0 차 Entropy (Byte 분포) 도 함께 구합니다.
+ */
+
+#define ESTIMATE_DEFAULT_FRACTION   0.05         // 기본 표본 비율
+#define ESTIMATE_DEFAULT_BLOCK_SIZE (256 * 1024) // 기본 표본 Block 크기
+#define ESTIMATE_MIN_BLOCKS         8            // 표본 Block 수 최소값 (전체 Block 이 더 적으면 전체)
+#define ESTIMATE_CONFIDENCE_Z       1.96         // 신뢰 구간 폭 (정규 분포 95%)
+#define ESTIMATE_RATIO_MODEL_ERROR  0.02         // 압축 크기 구간에 더하는 비율 (Block 을 따로 압축하여 생기는 차이)
+#define ESTIMATE_SPEED_MODEL_ERROR  0.10         // 속도 구간에 더하는 비율 (실행마다 달라지는 CPU 속도, Cache 상태)
+
+// 구조체 선언
+
+typedef struct ESTIMATE_Options_s ESTIMATE_Options_t;
+typedef struct ESTIMATE_Result_s ESTIMATE_Result_t;
+
+/*
+ * 예측 옵션. 0 으로 초기화하면 기본값을 사용합니다.
+ */
+struct ESTIMATE_Options_s {
+    double sampleFraction;    // 압축해 볼 원본의 비율 (0 이면 ESTIMATE_DEFAULT_FRACTION, 1 이면 전체)
+    DWORD blockSize;          // 표본 Block 크기 (0 이면 ESTIMATE_DEFAULT_BLOCK_SIZE)
+    DWORD minBlocks;          // 표본 Block 수 최소값 (0 이면 ESTIMATE_MIN_BLOCKS)
+    unsigned int seed;        // 표본 위치를 정하는 난수 Seed (같은 Seed 면 같은 위치)
+};
+
+struct ESTIMATE_Result_s {
+    ULONGLONG totalBytes;     // 원본 크기
+    ULONGLONG sampledBytes;   // 압축해 본 원본 크기
+    DWORD totalBlocks;        // 전체 Block 수
+    DWORD sampledBlocks;      // 압축해 본 Block 수
+
+    double ratio;             // 예측 압축률 (원본 / 압축)
+    double ratioLow;          // 압축률 신뢰 구간 하한
+    double ratioHigh;         // 압축률 신뢰 구간 상한
+    ULONGLONG compressedBytes;     // 예측 압축 크기
+    ULONGLONG compressedBytesLow;  // 압축 크기 신뢰 구간 하한
+    ULONGLONG compressedBytesHigh; // 압축 크기 신뢰 구간 상한
+
+    double speed;             // 예측 압축 속도 (원본 기준 bytes/s, 이 Thread 하나로 압축할 때)
+    double speedLow;          // 속도 신뢰 구간 하한
+    double speedHigh;         // 속도 신뢰 구간 상한
+
+    double entropy;           // 표본의 0 차 Entropy 평균 (bits/byte, 0 ~ 8)
+    double entropyMin;        // Block 별 Entropy 최소값
+    double entropyMax;        // Block 별 Entropy 최대값
+
+    ULONGLONG elapsedMicros;  // 예측에 걸린 시간 (읽기 포함, us)
+};
+
+// 함수 선언
+
+double estimate_entropy(const void* data, size_t size);
+BOOL estimate_compression_buffer(
+    const void* data, size_t size, CompressionAlgorithm algorithm, int level,
+    const ESTIMATE_Options_t* options, ESTIMATE_Result_t* result
+);
+BOOL estimate_compression(
+    const TCHAR* filePath, CompressionAlgorithm algorithm, int level,
+    const ESTIMATE_Options_t* options, ESTIMATE_Result_t* result
+);
+
+#endif // ESTIMATE_H
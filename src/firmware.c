@@ -0,0 +1,245 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LZ4_STATIC_LINKING_ONLY // LZ4_DECOMPRESS_INPLACE_MARGIN
+#include "../include/lz4/lz4.h"
+
+#include "firmware.h"
+#include "asyncio_win.h"
+#include "crc32c.h"
+#include "utility.h"
+
+/**
+ * @brief Header 를 Package 앞 FIRMWARE_HEADER_SIZE bytes 에 씁니다.
+ */
+static void firmware_write_header(BYTE* p, const FIRMWARE_Header_t* header) {
+    write_le32(p + 0, FIRMWARE_MAGIC);
+    write_le32(p + 4, FIRMWARE_VERSION);
+    write_le32(p + 8, header->flags);
+    write_le32(p + 12, header->imageSize);
+    write_le32(p + 16, header->payloadSize);
+    write_le32(p + 20, header->bufferSize);
+    write_le32(p + 24, header->imageChecksum);
+    write_le32(p + 28, crc32c(0, p, 28));
+}
+
+/**
+ * @brief Package 의 최대 크기를 구합니다.
+ *
+ * 압축하여 커지는 Image 는 원본 그대로 저장하므로 Header 와 Image 크기의 합을 넘지 않습니다.
+ *
+ * @param imageSize 원본 Image 크기
+ * @return Package 최대 크기
+ */
+size_t firmware_package_bound(size_t imageSize) {
+    return FIRMWARE_HEADER_SIZE + imageSize;
+}
+
+/**
+ * @brief 제자리 압축 해제에 필요한 버퍼 크기를 구합니다.
+ *
+ * Image 가 들어갈 크기에 LZ4_DECOMPRESS_INPLACE_MARGIN 을 더한 값과, Package 전체가 들어갈 크기 중 큰 값입니다.
+ *
+ * @param header Package Header
+ * @return 버퍼 크기
+ */
+size_t firmware_inplace_buffer_size(const FIRMWARE_Header_t* header) {
+    size_t const packageSize = (size_t)FIRMWARE_HEADER_SIZE + header->payloadSize;
+    size_t imageSize = header->imageSize;
+
+    if ((header->flags & FIRMWARE_FLAG_STORED) == 0) {
+        imageSize += LZ4_DECOMPRESS_INPLACE_MARGIN((size_t)header->payloadSize);
+    }
+    return (imageSize > packageSize) ? imageSize : packageSize;
+}
+
+/**
+ * @brief Package 앞부분의 Header 를 읽고 검증합니다.
+ *
+ * @param package Package 시작 위치
+ * @param packageSize 읽을 수 있는 크기 (FIRMWARE_HEADER_SIZE 이상)
+ * @param header 읽은 Header
+ * @return 성공 여부 (Magic, Version, Header CRC32C 가 맞지 않으면 실패)
+ */
+BOOL firmware_read_header(const void* package, size_t packageSize, FIRMWARE_Header_t* header) {
+    const BYTE* const p = (const BYTE*)package;
+
+    if (packageSize < FIRMWARE_HEADER_SIZE ||
+        read_le32(p) != FIRMWARE_MAGIC || read_le32(p + 4) != FIRMWARE_VERSION ||
+        read_le32(p + 28) != crc32c(0, p, 28)) {
+        log_message("Firmware - invalid package header.");
+        return FALSE;
+    }
+
+    header->flags = read_le32(p + 8);
+    header->imageSize = read_le32(p + 12);
+    header->payloadSize = read_le32(p + 16);
+    header->bufferSize = read_le32(p + 20);
+    header->imageChecksum = read_le32(p + 24);
+    if (header->bufferSize != firmware_inplace_buffer_size(header)) {
+        log_message("Firmware - inconsistent package header.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Image 를 제자리 압축 해제할 수 있는 Package 로 만듭니다.
+ *
+ * Image 전체를 LZ4 Block 하나로 압축하고, 압축 결과가 원본보다 작지 않으면 원본 그대로 저장합니다.
+ * 만든 Package 는 bufferSize 크기의 버퍼에서 실제로 제자리 압축 해제하여 원본과 같은지 확인합니다.
+ *
+ * @param image 원본 Image
+ * @param imageSize 원본 Image 크기 (LZ4_MAX_INPUT_SIZE 이하)
+ * @param package Package 를 쓸 버퍼
+ * @param packageCapacity package 크기 (firmware_package_bound(imageSize) 이상)
+ * @param pPackageSize 만든 Package 크기
+ * @return 성공 여부
+ */
+BOOL firmware_package_buffer(
+    const void* image, size_t imageSize,
+    void* package, size_t packageCapacity, size_t* pPackageSize
+) {
+    BYTE* const dst = (BYTE*)package;
+    FIRMWARE_Header_t header = { 0, };
+
+    if (imageSize == 0 || imageSize > LZ4_MAX_INPUT_SIZE || packageCapacity < firmware_package_bound(imageSize)) {
+        log_message("Firmware - invalid image size or package capacity.");
+        return FALSE;
+    }
+
+    // 원본보다 작게 압축되지 않으면 0 을 돌려받고 원본을 그대로 저장
+    int const compressedSize = LZ4_compress_default(
+        (const char*)image, (char*)(dst + FIRMWARE_HEADER_SIZE), (int)imageSize, (int)imageSize - 1
+    );
+    if (compressedSize > 0) {
+        header.payloadSize = (DWORD)compressedSize;
+    } else {
+        memcpy(dst + FIRMWARE_HEADER_SIZE, image, imageSize);
+        header.flags |= FIRMWARE_FLAG_STORED;
+        header.payloadSize = (DWORD)imageSize;
+    }
+    header.imageSize = (DWORD)imageSize;
+    header.imageChecksum = crc32c(0, image, imageSize);
+    header.bufferSize = (DWORD)firmware_inplace_buffer_size(&header);
+    firmware_write_header(dst, &header);
+
+    size_t const packageSize = FIRMWARE_HEADER_SIZE + header.payloadSize;
+
+    // 장치와 같은 배치 (버퍼 끝에 Package) 로 풀어 보고 확인
+    BYTE* const buffer = (BYTE*)malloc(header.bufferSize);
+    if (buffer == NULL) {
+        log_message("Firmware - failed to allocate verification buffer.");
+        return FALSE;
+    }
+    memcpy(buffer + header.bufferSize - packageSize, dst, packageSize);
+    size_t decodedSize = 0;
+    BOOL const bResult = firmware_decompress_inplace(buffer, header.bufferSize, packageSize, &decodedSize) &&
+                         decodedSize == imageSize && memcmp(buffer, image, imageSize) == 0;
+    free(buffer);
+
+    if (!bResult) {
+        log_message("Firmware - in-place verification failed.");
+        return FALSE;
+    }
+    *pPackageSize = packageSize;
+    return TRUE;
+}
+
+/**
+ * @brief Image 파일로 Package 파일을 만듭니다.
+ *
+ * @param imagePath 원본 Image 파일 경로
+ * @param packagePath 만들 Package 파일 경로
+ * @return 성공 여부
+ */
+BOOL firmware_package_file(const TCHAR* imagePath, const TCHAR* packagePath) {
+    IO_Mapping_t mapping;
+    size_t packageSize = 0;
+
+    if (!io_map_file(imagePath, &mapping)) {
+        return FALSE;
+    }
+
+    size_t const capacity = firmware_package_bound(mapping.size);
+    BYTE* const package = (BYTE*)malloc(capacity);
+    BOOL bResult = (package != NULL) &&
+                   firmware_package_buffer(mapping.data, mapping.size, package, capacity, &packageSize);
+    io_unmap_file(&mapping);
+
+    if (bResult) {
+        HANDLE const hOutput = init_file_write(packagePath);
+        bResult = (hOutput != INVALID_HANDLE_VALUE);
+        if (bResult) {
+            OVERLAPPED writeOverlap = { 0, };
+            DWORD dwBytesWritten = 0;
+            bResult = async_write(hOutput, package, (DWORD)packageSize, &dwBytesWritten, &writeOverlap, TRUE) &&
+                      dwBytesWritten == packageSize;
+            CloseHandle(hOutput);
+        }
+        if (!bResult) {
+            log_message("Firmware - failed to write package file.");
+        }
+    }
+
+    free(package);
+    return bResult;
+}
+
+/**
+ * @brief 버퍼 끝에 받아 둔 Package 를 같은 버퍼의 앞에서부터 Image 로 풉니다.
+ *
+ * 추가 메모리를 할당하지 않습니다. Header 는 덮어쓰이기 전에 먼저 읽어 두며, 풀고 난 뒤 Image 의 CRC32C 를 확인합니다.
+ *
+ * @param buffer 버퍼 ([bufferSize - packageSize, bufferSize) 에 Package 가 있어야 함)
+ * @param bufferSize 버퍼 크기 (Header 의 bufferSize 이상)
+ * @param packageSize Package 크기
+ * @param pImageSize 푼 Image 크기 ([0, imageSize) 에 Image 가 있음)
+ * @return 성공 여부
+ */
+BOOL firmware_decompress_inplace(BYTE* buffer, size_t bufferSize, size_t packageSize, size_t* pImageSize) {
+    FIRMWARE_Header_t header;
+
+    if (packageSize > bufferSize ||
+        !firmware_read_header(buffer + bufferSize - packageSize, packageSize, &header)) {
+        return FALSE;
+    }
+    if (packageSize != (size_t)FIRMWARE_HEADER_SIZE + header.payloadSize || bufferSize < header.bufferSize) {
+        log_message("Firmware - package does not fit the in-place buffer.");
+        return FALSE;
+    }
+
+    // Payload 는 버퍼 끝에 붙어 있음
+    const BYTE* const payload = buffer + bufferSize - header.payloadSize;
+    if (header.flags & FIRMWARE_FLAG_STORED) {
+        memmove(buffer, payload, header.imageSize);
+    } else {
+        int const decodedSize = LZ4_decompress_safe(
+            (const char*)payload, (char*)buffer, (int)header.payloadSize, (int)header.imageSize
+        );
+        if (decodedSize != (int)header.imageSize) {
+            log_message("Firmware - LZ4 block decompression failed.");
+            return FALSE;
+        }
+    }
+
+    if (crc32c(0, buffer, header.imageSize) != header.imageChecksum) {
+        log_message("Firmware - image checksum mismatch.");
+        return FALSE;
+    }
+    *pImageSize = header.imageSize;
+    return TRUE;
+}
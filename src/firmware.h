@@ -0,0 +1,67 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRMWARE_H
+#define FIRMWARE_H
+
+#include <windows.h>
+
+/*
+ * Firmware 업데이트 Package (제자리 압축 해제용, 모든 정수는 Little Endian)
+ *
+ *   [Header]    FIRMWARE_HEADER_SIZE bytes
+ *   [Payload]   Image 전체를 압축한 LZ4 Block 하나 (Frame 아님), FIRMWARE_FLAG_STORED 면 Image 원본
+ *
+ * 장치는 Image 하나 크기에 작은 여유만 더한 버퍼 (Header 의 bufferSize) 끝에 Package 를 받아 두고,
+ * firmware_decompress_inplace 로 같은 버퍼의 앞에서부터 Image 를 풉니다. 별도의 입력 버퍼가 필요 없습니다.
+ * LZ4 는 압축 해제 중 쓰는 위치가 읽는 위치를 앞지르지 않으려면 Payload 끝이 출력 끝보다
+ * LZ4_DECOMPRESS_INPLACE_MARGIN(payloadSize) 만큼 뒤에 있어야 하므로, bufferSize 는
+ * imageSize + 이 여유 (또는 Package 크기 중 큰 값) 입니다.
+ *
+ * 여러 Block / Frame 으로 나누면 Block 마다 여유 조건을 따로 맞춰야 하므로 Payload 는 Block 하나로 만듭니다.
+ * (LZ4 Block 하나의 최대 크기는 LZ4_MAX_INPUT_SIZE)
+ */
+
+#define FIRMWARE_MAGIC       0x57464E53  // "SNFW"
+#define FIRMWARE_VERSION     1
+#define FIRMWARE_HEADER_SIZE 32
+#define FIRMWARE_FLAG_STORED 0x00000001  // 압축하면 더 커지는 Image 라 원본 그대로 저장
+
+// 구조체 선언
+
+typedef struct FIRMWARE_Header_s FIRMWARE_Header_t;
+
+struct FIRMWARE_Header_s {
+    DWORD flags;              // FIRMWARE_FLAG_*
+    DWORD imageSize;          // 원본 Image 크기
+    DWORD payloadSize;        // Payload 크기
+    DWORD bufferSize;         // 제자리 압축 해제에 필요한 버퍼 크기
+    DWORD imageChecksum;      // 원본 Image 의 CRC32C
+};
+
+// 함수 선언
+
+size_t firmware_package_bound(size_t imageSize);
+size_t firmware_inplace_buffer_size(const FIRMWARE_Header_t* header);
+BOOL firmware_read_header(const void* package, size_t packageSize, FIRMWARE_Header_t* header);
+BOOL firmware_package_buffer(
+    const void* image, size_t imageSize,
+    void* package, size_t packageCapacity, size_t* pPackageSize
+);
+BOOL firmware_package_file(const TCHAR* imagePath, const TCHAR* packagePath);
+BOOL firmware_decompress_inplace(BYTE* buffer, size_t bufferSize, size_t packageSize, size_t* pImageSize);
+
+#endif // FIRMWARE_H
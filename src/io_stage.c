@@ -0,0 +1,448 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io_stage.h"
+#include "utility.h"
+
+/**
+ * @brief 출력 Staging 을 생성합니다.
+ *
+ * @param hOutput 출력 핸들 (파일 처음부터 씀)
+ * @param bufSize 버퍼 크기 (alignment 의 배수로 올림)
+ * @param alignment 쓰기 크기와 파일 위치의 정렬 단위 (2 의 거듭제곱, IO_DEFAULT_ALIGNMENT 이하. 1 이면 정렬 없음)
+ * @param bPadTail 마지막 쓰기도 정렬 단위로 채워 쓰고 파일을 실제 크기로 자를지 여부 (Direct I/O 이면 TRUE)
+ * @param throttle I/O 제한 (NULL 이면 제한 없음)
+ * @return 출력 Staging, 실패 시 NULL
+ */
+IO_Stage_t* io_stage_create(HANDLE hOutput, size_t bufSize, DWORD alignment, BOOL bPadTail, IO_Throttle_t* throttle) {
+    if (alignment == 0 || alignment > IO_DEFAULT_ALIGNMENT || (alignment & (alignment - 1)) != 0) {
+        log_message("Stage - unsupported alignment.");
+        return NULL;
+    }
+
+    IO_Stage_t* const stage = (IO_Stage_t*)calloc(1, sizeof(IO_Stage_t));
+    if (stage == NULL) {
+        return NULL;
+    }
+
+    stage->hOutput = hOutput;
+    stage->throttle = throttle;
+    stage->alignment = alignment;
+    stage->bPadTail = bPadTail;
+    stage->bufSize = (bufSize + alignment - 1) & ~((size_t)alignment - 1);
+    if (stage->bufSize < 2 * (size_t)alignment) {
+        stage->bufSize = 2 * (size_t)alignment; // 정렬 단위 미만의 나머지를 옮기고도 채울 공간이 있도록
+    }
+    stage->buf[0] = (BYTE*)async_alloc_aligned(stage->bufSize);
+    stage->buf[1] = (BYTE*)async_alloc_aligned(stage->bufSize);
+    if (stage->buf[0] == NULL || stage->buf[1] == NULL) {
+        log_message("Stage - failed to allocate buffers.");
+        io_stage_free(stage);
+        return NULL;
+    }
+
+    return stage;
+}
+
+/**
+ * @brief 동기화 요청을 기다렸다가 FlushFileBuffers 를 호출하는 Thread 입니다.
+ *
+ * 동기화하는 동안 들어온 요청은 하나로 합쳐 다음 FlushFileBuffers 에서 함께 처리합니다.
+ */
+static DWORD WINAPI io_sync_thread(LPVOID param) {
+    IO_Stage_t* const stage = (IO_Stage_t*)param;
+    IO_Sync_t* const sync = stage->sync;
+
+    AcquireSRWLockExclusive(&(sync->lock));
+    for (;;) {
+        while (!sync->bRequested && !sync->bClosed) {
+            SleepConditionVariableSRW(&(sync->wake), &(sync->lock), INFINITE, 0);
+        }
+        if (!sync->bRequested) {
+            break; // 종료 요청
+        }
+
+        ULONGLONG const target = sync->requestedOffset;
+        sync->bRequested = FALSE;
+        ReleaseSRWLockExclusive(&(sync->lock));
+
+        BOOL const bResult = FlushFileBuffers(stage->hOutput); // 압축하는 Thread 는 계속 씀
+
+        AcquireSRWLockExclusive(&(sync->lock));
+        if (bResult) {
+            sync->syncedOffset = target;
+            sync->syncCount++;
+        } else {
+            sync->bFailed = TRUE;
+        }
+    }
+    ReleaseSRWLockExclusive(&(sync->lock));
+
+    return 0;
+}
+
+/**
+ * @brief 동기화 Thread 를 멈추고 기다립니다.
+ *
+ * @return 동기화 실패가 없었으면 TRUE
+ */
+static BOOL io_sync_stop(IO_Stage_t* stage) {
+    IO_Sync_t* const sync = stage->sync;
+    if (sync == NULL) {
+        return TRUE;
+    }
+
+    AcquireSRWLockExclusive(&(sync->lock));
+    sync->bClosed = TRUE;
+    ReleaseSRWLockExclusive(&(sync->lock));
+    WakeConditionVariable(&(sync->wake));
+
+    WaitForSingleObject(sync->hThread, INFINITE);
+    CloseHandle(sync->hThread);
+
+    BOOL const bResult = !sync->bFailed;
+    stage->syncCount += sync->syncCount;
+    free(sync);
+    stage->sync = NULL;
+    return bResult;
+}
+
+/**
+ * @brief 내구성 정책에 따라 동기화할 때가 되었으면 동기화 Thread 에 요청합니다. (기다리지 않음)
+ */
+static void io_stage_sync_check(IO_Stage_t* stage) {
+    IO_Sync_t* const sync = stage->sync;
+    if (sync == NULL || stage->completedOffset == stage->lastSyncOffset) {
+        return;
+    }
+
+    ULONGLONG const now = GetTickCount64();
+    BOOL bDue = FALSE;
+    if (stage->durability == IO_DURABILITY_EVERY_BYTES) {
+        bDue = (stage->completedOffset - stage->lastSyncOffset >= stage->syncBytes);
+    } else if (stage->durability == IO_DURABILITY_EVERY_MILLIS) {
+        bDue = (now - stage->lastSyncTick >= stage->syncMillis);
+    }
+    if (!bDue) {
+        return;
+    }
+
+    AcquireSRWLockExclusive(&(sync->lock));
+    sync->requestedOffset = stage->completedOffset;
+    sync->bRequested = TRUE;
+    ReleaseSRWLockExclusive(&(sync->lock));
+    WakeConditionVariable(&(sync->wake));
+
+    stage->lastSyncOffset = stage->completedOffset;
+    stage->lastSyncTick = now;
+}
+
+/**
+ * @brief 진행 중인 쓰기의 완료를 기다립니다.
+ */
+static BOOL io_stage_wait(IO_Stage_t* stage) {
+    DWORD dwBytesWritten;
+
+    if (!stage->bWritePending) {
+        return TRUE;
+    }
+
+    stage->bWritePending = FALSE;
+    if (!async_wait(stage->hOutput, &(stage->overlap), &dwBytesWritten, stage->throttle)) {
+        return FALSE;
+    }
+
+    stage->completedOffset = stage->fileOffset; // 진행 중인 쓰기는 항상 하나이므로 끝까지 완료됨
+    io_stage_sync_check(stage);
+    return TRUE;
+}
+
+/**
+ * @brief 쓰려는 위치까지 미리 할당되어 있지 않으면, 지금까지의 압축률로 예상한 최종 크기까지 할당을 늘립니다.
+ *
+ * 할당에 실패하면 (지원하지 않는 File System 등) 미리 할당을 멈추고 계속 씁니다.
+ *
+ * @param stage 출력 Staging
+ * @param needed 필요한 파일 크기
+ */
+static void io_stage_extend(IO_Stage_t* stage, ULONGLONG needed) {
+    if (stage->expectedInput == 0 || needed <= stage->allocatedBytes) {
+        return;
+    }
+
+    ULONGLONG estimate = needed;
+    if (stage->inputBytes > 0 && stage->inputBytes < stage->expectedInput) {
+        double const ratio = (double)stage->totalBytes / (double)stage->inputBytes;
+        estimate = (ULONGLONG)(ratio * (double)stage->expectedInput);
+    }
+
+    // 예상이 조금 빗나가도 다시 늘리지 않도록 여유분을 더하고, 할당 단위로 올림
+    ULONGLONG const step = IO_STAGE_ALLOCATION_STEP;
+    if (estimate < needed) {
+        estimate = needed;
+    }
+    estimate = ((estimate + step) / step) * step;
+
+    if (!async_set_allocation(stage->hOutput, estimate)) {
+        stage->expectedInput = 0;
+        return;
+    }
+    stage->allocatedBytes = estimate;
+    stage->allocationCount++;
+}
+
+/**
+ * @brief 현재 버퍼를 씁니다.
+ *
+ * 정렬 단위의 배수만큼만 쓰고, 나머지는 다른 버퍼의 앞으로 옮겨 이어서 채웁니다.
+ * bFinal 이면 나머지도 모두 씁니다. (bPadTail 이면 0 으로 채워 정렬 단위로 씀)
+ *
+ * @param stage 출력 Staging
+ * @param bFinal 마지막 쓰기 여부
+ * @return 성공 여부
+ */
+static BOOL io_stage_submit(IO_Stage_t* stage, BOOL bFinal) {
+    DWORD dwBytesWritten;
+    size_t const mask = (size_t)stage->alignment - 1;
+    size_t writeSize = stage->used & ~mask;
+    if (bFinal) {
+        writeSize = stage->bPadTail ? ((stage->used + mask) & ~mask) : stage->used;
+    }
+    if (writeSize == 0) {
+        return TRUE;
+    }
+
+    BYTE* const buf = stage->buf[stage->current];
+    BYTE* const next = stage->buf[1 - stage->current];
+    if (writeSize > stage->used) {
+        memset(buf + stage->used, 0, writeSize - stage->used);
+    }
+
+    // 1. 다른 버퍼의 쓰기가 끝나야 그 버퍼를 다시 채울 수 있음
+    if (!io_stage_wait(stage)) {
+        return FALSE;
+    }
+    io_stage_extend(stage, stage->fileOffset + writeSize);
+
+    // 2. 현재 버퍼 쓰기 (완료는 다음 쓰기 전 또는 io_stage_finish 에서 확인)
+    async_set_offset(&(stage->overlap), stage->fileOffset);
+    if (!async_write_ex(stage->hOutput, buf, (DWORD)writeSize, &dwBytesWritten, &(stage->overlap), FALSE, stage->throttle)) {
+        return FALSE;
+    }
+    stage->bWritePending = TRUE;
+    stage->writeCount++;
+    stage->fileOffset += writeSize;
+
+    // 3. 정렬 단위 미만의 나머지는 다른 버퍼로 옮겨 이어서 채움
+    size_t const remainder = bFinal ? 0 : stage->used - writeSize;
+    memcpy(next, buf + writeSize, remainder);
+    stage->current = 1 - stage->current;
+    stage->used = remainder;
+    return TRUE;
+}
+
+/**
+ * @brief 현재 버퍼에 이어서 채울 공간을 확보합니다. 남은 공간이 부족하면 현재 버퍼를 씁니다.
+ *
+ * 돌려받은 공간에 최대 io_stage_room 만큼 (size 이상) 채운 뒤 io_stage_commit 으로 채운 크기를 알려야 하며,
+ * 공간은 다음 io_stage_reserve/io_stage_commit/io_stage_write 전까지만 유효합니다.
+ *
+ * @param stage 출력 Staging
+ * @param size 필요한 크기 (bufSize - alignment 이하)
+ * @return 채울 공간, 실패 시 NULL
+ */
+BYTE* io_stage_reserve(IO_Stage_t* stage, size_t size) {
+    if (size > stage->bufSize - stage->alignment) {
+        log_message("Stage - reservation larger than the buffer.");
+        return NULL;
+    }
+
+    if (stage->bufSize - stage->used < size && !io_stage_submit(stage, FALSE)) {
+        return NULL;
+    }
+
+    return stage->buf[stage->current] + stage->used;
+}
+
+/**
+ * @brief 현재 버퍼에 이어서 채울 수 있는 크기를 구합니다. (io_stage_reserve 로 받은 공간은 이만큼 채울 수 있음)
+ *
+ * @param stage 출력 Staging
+ * @return 남은 공간 크기
+ */
+size_t io_stage_room(const IO_Stage_t* stage) {
+    return stage->bufSize - stage->used;
+}
+
+/**
+ * @brief io_stage_reserve 로 받은 공간에 채운 크기를 반영합니다. 버퍼가 가득 차면 씁니다.
+ *
+ * @param stage 출력 Staging
+ * @param size 채운 크기 (io_stage_room 이하)
+ * @return 성공 여부
+ */
+BOOL io_stage_commit(IO_Stage_t* stage, size_t size) {
+    stage->used += size;
+    stage->totalBytes += size;
+
+    if (stage->used == stage->bufSize) {
+        return io_stage_submit(stage, FALSE);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 데이터를 Staging 버퍼에 복사합니다. 버퍼가 가득 차면 씁니다.
+ *
+ * @param stage 출력 Staging
+ * @param data 쓸 데이터
+ * @param size 데이터 크기
+ * @return 성공 여부
+ */
+BOOL io_stage_write(IO_Stage_t* stage, const void* data, size_t size) {
+    const BYTE* src = (const BYTE*)data;
+
+    while (size > 0) {
+        size_t const room = stage->bufSize - stage->used;
+        size_t const toCopy = (size < room) ? size : room;
+
+        memcpy(stage->buf[stage->current] + stage->used, src, toCopy);
+        src += toCopy;
+        size -= toCopy;
+
+        if (!io_stage_commit(stage, toCopy)) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 출력 파일을 예상 크기만큼 미리 할당하도록 설정합니다.
+ *
+ * 첫 쓰기 때 (압축률을 알 수 있을 때) 할당하며, 이후 io_stage_add_input 으로 알린 진행률로 예상을 고칩니다.
+ *
+ * @param stage 출력 Staging (NULL 가능)
+ * @param expectedInput 예상 원본 크기 (0 이면 사용 안 함)
+ */
+void io_stage_preallocate(IO_Stage_t* stage, ULONGLONG expectedInput) {
+    if (stage != NULL) {
+        stage->expectedInput = expectedInput;
+    }
+}
+
+/**
+ * @brief 압축한 원본 크기를 알립니다. (미리 할당할 크기를 예상하는 데 사용)
+ *
+ * @param stage 출력 Staging (NULL 가능)
+ * @param inputBytes 이번에 압축한 원본 크기
+ */
+void io_stage_add_input(IO_Stage_t* stage, ULONGLONG inputBytes) {
+    if (stage != NULL) {
+        stage->inputBytes += inputBytes;
+    }
+}
+
+/**
+ * @brief 내구성 정책을 정합니다. 주기적으로 동기화하는 정책이면 동기화 Thread 를 시작합니다.
+ *
+ * @param stage 출력 Staging
+ * @param durability 내구성 정책
+ * @param syncBytes IO_DURABILITY_EVERY_BYTES 의 동기화 간격 (byte, 0 이면 IO_STAGE_DEFAULT_SIZE)
+ * @param syncMillis IO_DURABILITY_EVERY_MILLIS 의 동기화 간격 (ms)
+ * @return 성공 여부
+ */
+BOOL io_stage_set_durability(IO_Stage_t* stage, IoDurability durability, ULONGLONG syncBytes, DWORD syncMillis) {
+    stage->durability = durability;
+    stage->syncBytes = (syncBytes != 0) ? syncBytes : IO_STAGE_DEFAULT_SIZE;
+    stage->syncMillis = syncMillis;
+    stage->lastSyncTick = GetTickCount64();
+
+    if (durability != IO_DURABILITY_EVERY_BYTES && durability != IO_DURABILITY_EVERY_MILLIS) {
+        return TRUE;
+    }
+
+    stage->sync = (IO_Sync_t*)calloc(1, sizeof(IO_Sync_t));
+    if (stage->sync == NULL) {
+        return FALSE;
+    }
+    InitializeSRWLock(&(stage->sync->lock));
+    InitializeConditionVariable(&(stage->sync->wake));
+
+    stage->sync->hThread = CreateThread(NULL, 0, io_sync_thread, stage, 0, NULL);
+    if (stage->sync->hThread == NULL) {
+        log_message("Stage - failed to start the sync thread.");
+        free(stage->sync);
+        stage->sync = NULL;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 남은 데이터를 모두 쓰고 완료를 기다립니다. 채워 쓴 부분이 있으면 잘라 파일을 실제 크기로 맞추고,
+ * 미리 할당하고 남은 공간을 돌려줍니다. 내구성 정책이 있으면 마지막으로 모두 동기화합니다.
+ *
+ * @param stage 출력 Staging
+ * @return 성공 여부
+ */
+BOOL io_stage_finish(IO_Stage_t* stage) {
+    BOOL bResult = io_stage_submit(stage, TRUE);
+    if (!io_stage_wait(stage)) {
+        bResult = FALSE;
+    }
+
+    if (bResult && stage->fileOffset != stage->totalBytes) {
+        bResult = async_set_file_size(stage->hOutput, stage->totalBytes);
+    }
+    if (bResult && stage->allocatedBytes > stage->totalBytes) {
+        bResult = async_set_allocation(stage->hOutput, stage->totalBytes);
+    }
+
+    // 동기화 Thread 를 멈춘 뒤, 남은 내용과 크기 변경을 동기화
+    if (!io_sync_stop(stage)) {
+        log_message("Stage - failed to sync the output.");
+        bResult = FALSE;
+    }
+    if (bResult && stage->durability != IO_DURABILITY_NONE) {
+        if (FlushFileBuffers(stage->hOutput)) {
+            stage->syncCount++;
+        } else {
+            log_message("Stage - failed to sync the output.");
+            bResult = FALSE;
+        }
+    }
+
+    return bResult;
+}
+
+/**
+ * @brief 출력 Staging 을 해제합니다. 진행 중인 쓰기가 있으면 완료를 기다립니다.
+ *
+ * @param stage 출력 Staging (NULL 가능)
+ */
+void io_stage_free(IO_Stage_t* stage) {
+    if (stage == NULL) {
+        return;
+    }
+
+    io_stage_wait(stage);
+    io_sync_stop(stage);
+    async_free_aligned(stage->buf[0]);
+    async_free_aligned(stage->buf[1]);
+    free(stage);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IO_STAGE_H
+#define IO_STAGE_H
+
+#include <windows.h>
+
+#include "asyncio_win.h"
+
+/*
+ * 출력 Staging
+ *
+ * 압축된 조각을 정렬된 버퍼에 모았다가, 정렬 단위의 배수 크기로 정렬된 파일 위치에 씁니다.
+ * 작은 압축 결과마다 쓰기를 요청하지 않고 큰 쓰기로 합치며, Direct I/O (IO_CACHE_DIRECT) 로 연 파일에
+ * 크기가 제각각인 압축 결과를 쓸 수 있게 합니다. 버퍼 두 개를 번갈아 사용하여 한 버퍼를 쓰는 동안 다른 버퍼를 채웁니다.
+ *
+ * io_stage_reserve 로 받은 공간에 바로 압축하고 io_stage_commit 하면 복사 없이 모을 수 있습니다.
+ * Direct I/O 이면 마지막 정렬 단위는 0 으로 채워 쓴 뒤, io_stage_finish 에서 파일을 실제 크기로 자릅니다.
+ *
+ * io_stage_preallocate 를 호출하면, 지금까지의 압축률로 예상한 최종 크기만큼 Disk 공간을 큰 단위로 미리 할당하여
+ * 파일이 조금씩 커지면서 조각나는 것과 쓰기마다의 Metadata 갱신을 줄이고, io_stage_finish 에서 남은 할당을 돌려줍니다.
+ *
+ * io_stage_set_durability 로 내구성 정책을 정하면, 쓰기가 완료된 내용을 FlushFileBuffers 로 Disk 에 동기화합니다.
+ * 주기적인 동기화는 별도 Thread 에서 진행하여 압축과 쓰기를 멈추지 않으며, 동기화 중에 들어온 요청은 하나로 합칩니다.
+ */
+
+#define IO_STAGE_DEFAULT_SIZE     (1024 * 1024)      // Staging 버퍼 기본 크기
+#define IO_STAGE_ALLOCATION_STEP  (8 * 1024 * 1024)  // 미리 할당하는 최소 단위 (예상보다 커질 때의 여유분)
+
+// enum 선언
+
+typedef enum {
+    IO_DURABILITY_NONE,         // 동기화하지 않음 (OS 가 정한 때에 Disk 에 씀)
+    IO_DURABILITY_ON_CLOSE,     // 끝낼 때 한 번 동기화
+    IO_DURABILITY_EVERY_BYTES,  // syncBytes 만큼 쓸 때마다 동기화 (끝낼 때도 동기화)
+    IO_DURABILITY_EVERY_MILLIS  // syncMillis 가 지날 때마다 동기화 (끝낼 때도 동기화)
+} IoDurability;
+
+// 구조체 선언
+
+typedef struct IO_Sync_s IO_Sync_t;
+typedef struct IO_Stage_s IO_Stage_t;
+
+/*
+ * 주기적인 동기화 Thread 의 상태
+ */
+struct IO_Sync_s {
+    HANDLE hThread;               // 동기화 Thread
+    SRWLOCK lock;                 // 아래 상태 보호
+    CONDITION_VARIABLE wake;      // 동기화 요청 (또는 종료 요청)
+    BOOL bRequested;              // 처리하지 않은 요청 존재 여부 (여러 요청은 하나로 합침)
+    BOOL bClosed;                 // 종료 요청
+    BOOL bFailed;                 // 동기화 실패
+    ULONGLONG requestedOffset;    // 동기화를 요청한 크기 (이 앞의 쓰기는 완료됨)
+    ULONGLONG syncedOffset;       // 동기화가 끝난 크기 (이 앞은 전원이 꺼져도 남음)
+    ULONGLONG syncCount;          // 동기화 Thread 의 FlushFileBuffers 호출 수 (통계용)
+};
+
+struct IO_Stage_s {
+    HANDLE hOutput;           // 출력 핸들
+    IO_Throttle_t* throttle;  // I/O 제한 (NULL 이면 제한 없음)
+    BYTE* buf[2];             // 번갈아 채우는 정렬된 버퍼
+    size_t bufSize;           // 버퍼 크기 (alignment 의 배수)
+    size_t used;              // 현재 버퍼에 채운 크기
+    int current;              // 현재 채우는 버퍼 번호
+    DWORD alignment;          // 쓰기 크기와 파일 위치의 정렬 단위
+    BOOL bPadTail;            // 마지막 쓰기도 정렬 단위로 채워 쓰고 파일을 잘라냄 (Direct I/O)
+    BOOL bWritePending;       // 완료를 확인하지 않은 쓰기 존재 여부
+    OVERLAPPED overlap;       // 쓰기 작업을 위한 OVERLAPPED 구조체
+    ULONGLONG fileOffset;     // 다음 쓰기 위치
+    ULONGLONG totalBytes;     // 지금까지 받은 크기 (최종 파일 크기)
+    ULONGLONG writeCount;     // 요청한 쓰기 수 (통계용)
+
+    // 미리 할당 (expectedInput 이 0 이면 사용 안 함)
+    ULONGLONG expectedInput;  // 예상 원본 크기
+    ULONGLONG inputBytes;     // 지금까지 압축한 원본 크기 (압축률 추정용)
+    ULONGLONG allocatedBytes; // 지금까지 미리 할당한 크기
+    ULONGLONG allocationCount;// 할당을 늘린 횟수 (통계용)
+
+    // 내구성
+    IoDurability durability;  // 내구성 정책
+    ULONGLONG syncBytes;      // IO_DURABILITY_EVERY_BYTES 의 동기화 간격 (byte)
+    DWORD syncMillis;         // IO_DURABILITY_EVERY_MILLIS 의 동기화 간격 (ms)
+    ULONGLONG completedOffset;// 쓰기가 완료된 크기
+    ULONGLONG lastSyncOffset; // 마지막으로 동기화를 요청한 크기
+    ULONGLONG lastSyncTick;   // 마지막으로 동기화를 요청한 시각 (GetTickCount64)
+    IO_Sync_t* sync;          // 주기적인 동기화 Thread (NULL 이면 없음)
+    ULONGLONG syncCount;      // FlushFileBuffers 호출 수 (통계용)
+};
+
+// 함수 선언
+
+IO_Stage_t* io_stage_create(HANDLE hOutput, size_t bufSize, DWORD alignment, BOOL bPadTail, IO_Throttle_t* throttle);
+BYTE* io_stage_reserve(IO_Stage_t* stage, size_t size);
+size_t io_stage_room(const IO_Stage_t* stage);
+BOOL io_stage_commit(IO_Stage_t* stage, size_t size);
+BOOL io_stage_write(IO_Stage_t* stage, const void* data, size_t size);
+void io_stage_preallocate(IO_Stage_t* stage, ULONGLONG expectedInput);
+void io_stage_add_input(IO_Stage_t* stage, ULONGLONG inputBytes);
+BOOL io_stage_set_durability(IO_Stage_t* stage, IoDurability durability, ULONGLONG syncBytes, DWORD syncMillis);
+BOOL io_stage_finish(IO_Stage_t* stage);
+void io_stage_free(IO_Stage_t* stage);
+
+#endif // IO_STAGE_H
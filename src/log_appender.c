@@ -0,0 +1,410 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "log_appender.h"
+#include "asyncio_win.h"
+#include "utility.h"
+
+// Log Stream 압축 옵션 설정 (Record 사이의 중복을 찾도록 Block 을 연결)
+static const LZ4F_preferences_t kAppenderPrefs = {
+    {
+        LZ4F_max64KB,
+        LZ4F_blockLinked,
+        LZ4F_noContentChecksum,
+        LZ4F_frame,
+        0, // Unknown size of uncompressed content
+        0, // No dictionary ID
+        LZ4F_noBlockChecksum
+    }, // Frame info
+    0, // Compression level. Default 는 0
+    0, // Auto flush (Record 마다 Block 을 만들지 않도록 끔)
+    0, // Favor decompression speed
+    { 0, 0, 0 },  // reserved. 0 으로 설정해야함
+};
+
+static const LogAppenderOptions kDefaultAppenderOptions = { 0, };
+
+/**
+ * @brief 진행 중인 쓰기 작업의 완료를 기다립니다.
+ */
+static BOOL appender_wait_write(LOG_Appender_t* appender) {
+    DWORD dwBytesWritten;
+
+    if (!appender->bWritePending) {
+        return TRUE;
+    }
+
+    appender->bWritePending = FALSE;
+    return async_wait(appender->hOutput, &(appender->writeOverlap), &dwBytesWritten, appender->throttle);
+}
+
+/**
+ * @brief 채우는 중인 출력 버퍼를 Non-Blocking 방식으로 쓰기 요청하고, 다른 버퍼로 전환합니다.
+ *
+ * 다른 버퍼의 쓰기가 아직 진행 중이면 그 완료를 먼저 기다립니다.
+ */
+static BOOL appender_submit(LOG_Appender_t* appender) {
+    DWORD dwBytesWritten;
+
+    if (appender->dstLen == 0) {
+        return TRUE;
+    }
+    if (!appender_wait_write(appender)) {
+        return FALSE;
+    }
+
+    async_set_offset(&(appender->writeOverlap), appender->fileOffset);
+    if (!async_write_ex(
+        appender->hOutput, appender->dstBuf[appender->dstIndex], (DWORD)appender->dstLen,
+        &dwBytesWritten, &(appender->writeOverlap), FALSE, appender->throttle
+    )) {
+        log_message("Appender - write failed.");
+        return FALSE;
+    }
+
+    appender->bWritePending = TRUE;
+    appender->fileOffset += appender->dstLen;
+    appender->dstIndex = 1 - appender->dstIndex;
+    appender->dstLen = 0;
+    return TRUE;
+}
+
+/**
+ * @brief 출력 버퍼에 need bytes 의 여유 공간을 확보합니다.
+ */
+static BOOL appender_reserve(LOG_Appender_t* appender, size_t need) {
+    if (appender->dstBufMaxSize - appender->dstLen >= need) {
+        return TRUE;
+    }
+    return appender_submit(appender);
+}
+
+/**
+ * @brief ZSTD 압축 Stream 에 입력을 넣고, 출력 버퍼가 가득 차면 쓰기 요청합니다.
+ *
+ * @param appender Log Appender
+ * @param data 입력 (ZSTD_e_continue 가 아닌 경우 NULL 가능)
+ * @param size 입력 크기
+ * @param mode ZSTD_e_continue, ZSTD_e_flush 또는 ZSTD_e_end
+ * @return 성공 여부
+ */
+static BOOL appender_zstd_stream(LOG_Appender_t* appender, const void* data, size_t size, ZSTD_EndDirective mode) {
+    ZSTD_inBuffer input = { data, size, 0 };
+
+    for (;;) {
+        if (!appender_reserve(appender, 1)) {
+            return FALSE;
+        }
+
+        ZSTD_outBuffer output = { appender->dstBuf[appender->dstIndex], appender->dstBufMaxSize, appender->dstLen };
+        size_t const remaining = ZSTD_compressStream2(appender->zstdCctxPtr, &output, &input, mode);
+        if (ZSTD_isError(remaining)) {
+            log_message("ZSTD Compress Stream failed!");
+            return FALSE;
+        }
+        appender->dstLen = output.pos;
+
+        BOOL const bFinished = (mode == ZSTD_e_continue) ? (input.pos == input.size) : (remaining == 0);
+        if (bFinished) {
+            return TRUE;
+        }
+        if (!appender_submit(appender)) { // 출력 버퍼가 가득 참
+            return FALSE;
+        }
+    }
+}
+
+/**
+ * @brief 압축 Stream 을 Flush 하여, 지금까지 받은 Record 를 모두 쓰기 요청합니다.
+ *
+ * 쓰기 완료를 기다리지 않으므로 호출 Thread 는 막히지 않습니다.
+ *
+ * @param appender Log Appender
+ * @return 성공 여부
+ */
+BOOL log_appender_flush(LOG_Appender_t* appender) {
+    if (appender->algorithm == LZ4) {
+        if (!appender_reserve(appender, LZ4F_compressBound(0, &kAppenderPrefs))) {
+            return FALSE;
+        }
+
+        size_t const flushedSize = LZ4F_flush(
+            appender->lz4CctxPtr, (BYTE*)appender->dstBuf[appender->dstIndex] + appender->dstLen,
+            appender->dstBufMaxSize - appender->dstLen, NULL
+        );
+        if (LZ4F_isError(flushedSize)) {
+            log_message("LZ4F_flush failed!");
+            return FALSE;
+        }
+        appender->dstLen += flushedSize;
+    } else if (!appender_zstd_stream(appender, NULL, 0, ZSTD_e_flush)) {
+        return FALSE;
+    }
+
+    appender->unflushedBytes = 0;
+    appender->lastFlushTick = GetTickCount64();
+    appender->flushCount++;
+
+    return appender_submit(appender);
+}
+
+/**
+ * @brief Flush 기준을 넘었으면 Flush 합니다.
+ */
+static BOOL appender_check_flush(LOG_Appender_t* appender) {
+    if (appender->unflushedBytes == 0) {
+        return TRUE;
+    }
+    if (appender->unflushedBytes >= appender->flushBytes ||
+        GetTickCount64() - appender->lastFlushTick >= appender->flushMillis) {
+        return log_appender_flush(appender);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Log Appender 자원을 해제합니다.
+ */
+static void appender_free(LOG_Appender_t* appender) {
+    if (appender->bOwnsOutput && appender->hOutput != INVALID_HANDLE_VALUE && appender->hOutput != NULL) {
+        CloseHandle(appender->hOutput);
+    }
+    LZ4F_freeCompressionContext(appender->lz4CctxPtr);
+    ZSTD_freeCCtx(appender->zstdCctxPtr);
+    free(appender->dstBuf[0]);
+    free(appender->dstBuf[1]);
+    free(appender);
+}
+
+/**
+ * @brief 이미 연 출력 핸들에 쓰는 Log Appender 를 엽니다.
+ *
+ * @param hOutput 출력 핸들 (파일, 또는 FILE_FLAG_OVERLAPPED 로 연 Pipe / Socket)
+ * @param bOwnsOutput TRUE 이면 Appender 를 닫을 때 hOutput 도 닫음 (실패한 경우에도)
+ * @param algorithm 압축 알고리듬
+ * @param options Appender 옵션 (NULL 이면 기본값)
+ * @return Log Appender, 실패 시 NULL
+ */
+static LOG_Appender_t* appender_open(
+    HANDLE hOutput, BOOL bOwnsOutput, CompressionAlgorithm algorithm, const LogAppenderOptions* options
+) {
+    if (options == NULL) {
+        options = &kDefaultAppenderOptions;
+    }
+
+    LOG_Appender_t* appender = (LOG_Appender_t*)calloc(1, sizeof(LOG_Appender_t));
+    if (appender == NULL) {
+        if (bOwnsOutput) {
+            CloseHandle(hOutput);
+        }
+        return NULL;
+    }
+
+    appender->hOutput = hOutput;
+    appender->bOwnsOutput = bOwnsOutput;
+    appender->algorithm = algorithm;
+    appender->throttle = options->throttle;
+    appender->flushBytes = options->flushBytes ? options->flushBytes : LOG_APPENDER_FLUSH_BYTES_DEFAULT;
+    appender->flushMillis = options->flushMillis ? options->flushMillis : LOG_APPENDER_FLUSH_MILLIS_DEFAULT;
+    appender->lastFlushTick = GetTickCount64();
+
+    BOOL bResult = FALSE;
+    switch (algorithm) {
+        case LZ4:
+            // Record 를 나눈 단위 하나와 Frame Header 를 언제나 담을 수 있는 크기
+            appender->dstBufMaxSize = LZ4F_compressBound(LOG_APPENDER_CHUNK_SIZE, &kAppenderPrefs) + LZ4F_HEADER_SIZE_MAX;
+            bResult = !LZ4F_isError(LZ4F_createCompressionContext(&(appender->lz4CctxPtr), LZ4F_VERSION));
+            break;
+        case ZSTD:
+            appender->dstBufMaxSize = ZSTD_CStreamOutSize();
+            appender->zstdCctxPtr = ZSTD_createCCtx();
+            bResult = appender->zstdCctxPtr != NULL &&
+                !ZSTD_isError(ZSTD_CCtx_setParameter(appender->zstdCctxPtr, ZSTD_c_compressionLevel, ZSTD_fast)) &&
+                !ZSTD_isError(ZSTD_CCtx_setParameter(appender->zstdCctxPtr, ZSTD_c_checksumFlag, 1)) &&
+                !ZSTD_isError(ZSTD_CCtx_setParameter(appender->zstdCctxPtr, ZSTD_c_targetCBlockSize,
+                    (int)options->targetBlockSize));
+            break;
+        default:
+            break;
+    }
+
+    if (bResult) {
+        appender->dstBuf[0] = malloc(appender->dstBufMaxSize);
+        appender->dstBuf[1] = malloc(appender->dstBufMaxSize);
+        bResult = appender->dstBuf[0] != NULL && appender->dstBuf[1] != NULL;
+    }
+
+    if (bResult && algorithm == LZ4) {
+        size_t const headerSize = LZ4F_compressBegin(
+            appender->lz4CctxPtr, appender->dstBuf[0], appender->dstBufMaxSize, &kAppenderPrefs
+        );
+        bResult = !LZ4F_isError(headerSize);
+        appender->dstLen = bResult ? headerSize : 0;
+    }
+
+    if (!bResult) {
+        log_message("Failed to open log appender.");
+        appender_free(appender);
+        return NULL;
+    }
+
+    return appender;
+}
+
+/**
+ * @brief 압축된 Log 파일을 만들고 Log Appender 를 엽니다.
+ *
+ * @param outputFilePath 쓸 파일 경로
+ * @param algorithm 압축 알고리듬
+ * @param options Appender 옵션 (NULL 이면 기본값)
+ * @return Log Appender, 실패 시 NULL
+ */
+LOG_Appender_t* log_appender_open(
+    const TCHAR* outputFilePath, CompressionAlgorithm algorithm, const LogAppenderOptions* options
+) {
+    HANDLE const hOutput = init_file_write(outputFilePath);
+    if (hOutput == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    return appender_open(hOutput, TRUE, algorithm, options);
+}
+
+/**
+ * @brief 이미 연 Pipe 나 Socket 등에 압축된 Log 를 흘려 보내는 Log Appender 를 엽니다.
+ *
+ * 쓰기는 Non-Blocking 이므로 hOutput 은 FILE_FLAG_OVERLAPPED (Socket 은 WSA_FLAG_OVERLAPPED) 로 열어야 합니다.
+ * Appender 를 닫아도 hOutput 은 닫지 않습니다.
+ *
+ * @param hOutput 출력 핸들
+ * @param algorithm 압축 알고리듬
+ * @param options Appender 옵션 (NULL 이면 기본값, Network 전송은 log_appender_streaming_options 참고)
+ * @return Log Appender, 실패 시 NULL
+ */
+LOG_Appender_t* log_appender_open_handle(
+    HANDLE hOutput, CompressionAlgorithm algorithm, const LogAppenderOptions* options
+) {
+    return appender_open(hOutput, FALSE, algorithm, options);
+}
+
+/**
+ * @brief 짧은 지연으로 Network 에 흘려 보내기 위한 옵션을 채웁니다. (throttle 은 그대로 둠)
+ *
+ * Flush 간격을 LOG_APPENDER_STREAM_FLUSH_BYTES / LOG_APPENDER_STREAM_FLUSH_MILLIS 로 줄이고,
+ * ZSTD 압축 Block 을 LOG_APPENDER_STREAM_BLOCK_SIZE 정도로 잘라 받는 쪽이 Block 마다 바로 풀 수 있게 합니다.
+ *
+ * @param options 채울 옵션
+ */
+void log_appender_streaming_options(LogAppenderOptions* options) {
+    options->flushBytes = LOG_APPENDER_STREAM_FLUSH_BYTES;
+    options->flushMillis = LOG_APPENDER_STREAM_FLUSH_MILLIS;
+    options->targetBlockSize = LOG_APPENDER_STREAM_BLOCK_SIZE;
+}
+
+/**
+ * @brief Log Record 하나를 압축 Stream 에 추가합니다.
+ *
+ * Record 는 압축 컨텍스트의 내부 버퍼에 복사되므로, 호출 후 바로 재사용할 수 있습니다.
+ * Flush 기준을 넘으면 Flush 하여 쓰기 요청합니다.
+ *
+ * @param appender Log Appender
+ * @param record Record 데이터
+ * @param size Record 크기
+ * @return 성공 여부
+ */
+BOOL log_appender_write(LOG_Appender_t* appender, const void* record, size_t size) {
+    if (appender->algorithm == LZ4) {
+        const BYTE* src = (const BYTE*)record;
+        size_t remaining = size;
+
+        // LZ4F_compressUpdate 는 최악의 경우 크기만큼 출력 공간이 있어야 하므로, 큰 Record 는 나누어 압축
+        while (remaining > 0) {
+            size_t const chunk = (remaining < LOG_APPENDER_CHUNK_SIZE) ? remaining : LOG_APPENDER_CHUNK_SIZE;
+            if (!appender_reserve(appender, LZ4F_compressBound(chunk, &kAppenderPrefs))) {
+                return FALSE;
+            }
+
+            size_t const compressedSize = LZ4F_compressUpdate(
+                appender->lz4CctxPtr, (BYTE*)appender->dstBuf[appender->dstIndex] + appender->dstLen,
+                appender->dstBufMaxSize - appender->dstLen, src, chunk, NULL
+            );
+            if (LZ4F_isError(compressedSize)) {
+                log_message("Compression failed!");
+                return FALSE;
+            }
+
+            appender->dstLen += compressedSize;
+            src += chunk;
+            remaining -= chunk;
+        }
+    } else if (!appender_zstd_stream(appender, record, size, ZSTD_e_continue)) {
+        return FALSE;
+    }
+
+    appender->recordCount++;
+    appender->totalIn += size;
+    appender->unflushedBytes += size;
+
+    return appender_check_flush(appender);
+}
+
+/**
+ * @brief 시간 기준을 넘었으면 Flush 합니다. Record 가 뜸할 때 Main Loop 에서 주기적으로 호출합니다.
+ *
+ * @param appender Log Appender
+ * @return 성공 여부
+ */
+BOOL log_appender_tick(LOG_Appender_t* appender) {
+    return appender_check_flush(appender);
+}
+
+/**
+ * @brief Frame 을 마무리하고 남은 쓰기를 모두 완료한 뒤 Log Appender 를 닫습니다.
+ *
+ * @param appender Log Appender (NULL 허용)
+ * @return 성공 여부
+ */
+BOOL log_appender_close(LOG_Appender_t* appender) {
+    if (appender == NULL) {
+        return FALSE;
+    }
+
+    BOOL bResult = TRUE;
+    if (appender->algorithm == LZ4) {
+        bResult = appender_reserve(appender, LZ4F_compressBound(0, &kAppenderPrefs));
+        if (bResult) {
+            size_t const endSize = LZ4F_compressEnd(
+                appender->lz4CctxPtr, (BYTE*)appender->dstBuf[appender->dstIndex] + appender->dstLen,
+                appender->dstBufMaxSize - appender->dstLen, NULL
+            );
+            bResult = !LZ4F_isError(endSize);
+            if (bResult) {
+                appender->dstLen += endSize;
+            }
+        }
+    } else {
+        bResult = appender_zstd_stream(appender, NULL, 0, ZSTD_e_end);
+    }
+
+    bResult = bResult && appender_submit(appender);
+    bResult = appender_wait_write(appender) && bResult;
+
+    if (!bResult) {
+        log_message("Failed to close log appender.");
+    }
+
+    appender_free(appender);
+    return bResult;
+}
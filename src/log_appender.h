@@ -0,0 +1,105 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_APPENDER_H
+#define LOG_APPENDER_H
+
+#include <windows.h>
+
+#include "compressor.h"
+#include "../include/lz4/lz4frame.h"
+#include "../include/zstd/zstd.h"
+
+/*
+ * Streaming Log Appender
+ *
+ * Log Record 를 받는 즉시 압축 Stream 에 넣고, 압축된 결과를 Non-Blocking 방식으로 파일에 씁니다.
+ * 마지막 Flush 이후 flushBytes 이상 쌓이거나 flushMillis 이상 지나면 압축 Stream 을 Flush
+ * (LZ4F_flush / ZSTD_e_flush) 하여, 그때까지의 Record 를 모두 파일에 쓰기 요청합니다.
+ * 따라서 전원이 꺼지거나 Process 가 종료되어도 잃는 Record 는 최대 flushBytes 또는 flushMillis 분량입니다.
+ *
+ * 시간 기준은 Record 를 쓸 때와 log_appender_tick 을 호출할 때 확인하므로,
+ * Record 가 뜸한 경우에도 손실 범위를 지키려면 Main Loop 에서 주기적으로 log_appender_tick 을 호출해야 합니다.
+ *
+ * Network 전송 (Streaming): log_appender_open_handle 로 Overlapped 로 연 Pipe 나 Socket 에 바로 쓸 수 있습니다.
+ * ZSTD 는 Block (최대 128 KB) 전체를 받아야 풀 수 있으므로, log_appender_streaming_options 는 Flush 간격을 줄이고
+ * 압축된 Block 을 targetBlockSize (ZSTD_c_targetCBlockSize) 정도로 잘라, 받는 쪽이 Packet 하나마다 바로 풀 수 있게 합니다.
+ * 압축률은 조금 낮아집니다.
+ */
+
+#define LOG_APPENDER_FLUSH_BYTES_DEFAULT  (64 * 1024) // 기본 Flush 크기 기준 (64 KB)
+#define LOG_APPENDER_FLUSH_MILLIS_DEFAULT 1000        // 기본 Flush 시간 기준 (1 초)
+#define LOG_APPENDER_CHUNK_SIZE           (16 * 1024) // 큰 Record 를 나누어 압축하는 단위
+
+#define LOG_APPENDER_STREAM_FLUSH_BYTES   (4 * 1024)  // Streaming Flush 크기 기준 (4 KB)
+#define LOG_APPENDER_STREAM_FLUSH_MILLIS  10          // Streaming Flush 시간 기준 (10 ms)
+#define LOG_APPENDER_STREAM_BLOCK_SIZE    1340        // Streaming 압축 Block 목표 크기 (Ethernet Frame 하나, ZSTD_TARGETCBLOCKSIZE_MIN)
+
+// 구조체 선언
+
+/*
+ * Appender 옵션. 0 으로 초기화하면 기본값을 사용합니다.
+ */
+typedef struct {
+    size_t flushBytes;          // Flush 크기 기준 (원본 bytes, 0 이면 LOG_APPENDER_FLUSH_BYTES_DEFAULT)
+    DWORD flushMillis;          // Flush 시간 기준 (ms, 0 이면 LOG_APPENDER_FLUSH_MILLIS_DEFAULT)
+    IO_Throttle_t* throttle;    // 쓰기 대역폭 및 동시 진행 I/O 제한 (NULL 이면 제한 없음)
+    size_t targetBlockSize;     // ZSTD: 압축된 Block 의 목표 크기 (ZSTD_c_targetCBlockSize, 1340 이상, 0 이면 나누지 않음)
+} LogAppenderOptions;
+
+typedef struct LOG_Appender_s LOG_Appender_t;
+
+struct LOG_Appender_s {
+    HANDLE hOutput;                 // 출력 핸들
+    BOOL bOwnsOutput;               // hOutput 을 Appender 가 열었는지 (닫을 때 함께 닫음)
+    CompressionAlgorithm algorithm; // 압축 알고리듬
+    LZ4F_cctx* lz4CctxPtr;          // LZ4F 압축 컨텍스트 포인터 (LZ4 인 경우)
+    ZSTD_CCtx* zstdCctxPtr;         // ZSTD 압축 컨텍스트 포인터 (ZSTD 인 경우)
+
+    LPVOID dstBuf[2];               // 압축 결과 버퍼 (쓰기와 압축을 겹치기 위한 Double Buffer)
+    size_t dstBufMaxSize;           // 압축 결과 버퍼의 최대 크기
+    size_t dstLen;                  // 채우는 중인 버퍼에 쌓인 크기
+    int dstIndex;                   // 채우는 중인 버퍼 번호
+    BOOL bWritePending;             // 완료를 기다리는 쓰기 작업 존재 여부
+    OVERLAPPED writeOverlap;        // Non-Blocking 쓰기 작업을 위한 OVERLAPPED 구조체
+    ULONGLONG fileOffset;           // 다음 쓰기 위치
+    IO_Throttle_t* throttle;        // I/O 제한 (NULL 이면 제한 없음)
+
+    size_t flushBytes;              // Flush 크기 기준
+    DWORD flushMillis;              // Flush 시간 기준 (ms)
+    size_t unflushedBytes;          // 마지막 Flush 이후 받은 원본 크기
+    ULONGLONG lastFlushTick;        // 마지막 Flush 시각 (GetTickCount64)
+
+    ULONGLONG recordCount;          // 받은 Record 수 (통계용)
+    ULONGLONG totalIn;              // 받은 원본 크기 (통계용)
+    ULONGLONG flushCount;           // Flush 횟수 (통계용)
+};
+
+// 함수 선언
+
+LOG_Appender_t* log_appender_open(
+    const TCHAR* outputFilePath, CompressionAlgorithm algorithm, const LogAppenderOptions* options
+);
+LOG_Appender_t* log_appender_open_handle(
+    HANDLE hOutput, CompressionAlgorithm algorithm, const LogAppenderOptions* options
+);
+void log_appender_streaming_options(LogAppenderOptions* options);
+BOOL log_appender_write(LOG_Appender_t* appender, const void* record, size_t size);
+BOOL log_appender_tick(LOG_Appender_t* appender);
+BOOL log_appender_flush(LOG_Appender_t* appender);
+BOOL log_appender_close(LOG_Appender_t* appender);
+
+#endif // LOG_APPENDER_H
@@ -18,7 +18,7 @@
 #include "asyncio_win.h"
 #include "utility.h"
 
-#define CHUNK_SIZE (16 * 1024) // 읽기/쓰기 블록 크기 (16 KB)
+#define CHUNK_SIZE (16 * 1024) // 기본 읽기/쓰기 블록 크기 (16 KB, CompressionOptions.chunkSize 나 보정 값이 없을 때)
 
 // 압축 옵션 설정
 static const LZ4F_preferences_t kPrefs = {
@@ -37,6 +37,25 @@ static const LZ4F_preferences_t kPrefs = {
     { 0, 0, 0 },  // reserved. 0 으로 설정해야함
 };
 
+/**
+ * @brief CompressionOptions.lz4BlockSize 를 LZ4F Block 크기 ID 로 바꿉니다.
+ *
+ * @param blockSize Block 최대 크기 (bytes, 0 이면 기본값)
+ * @return blockSize 이상인 가장 작은 LZ4F Block 크기 (4 MB 보다 크면 4 MB)
+ */
+static LZ4F_blockSizeID_t lz4_block_size_id(DWORD blockSize) {
+    if (blockSize <= 64 * 1024) {
+        return LZ4F_max64KB;
+    }
+    if (blockSize <= 256 * 1024) {
+        return LZ4F_max256KB;
+    }
+    if (blockSize <= 1024 * 1024) {
+        return LZ4F_max1MB;
+    }
+    return LZ4F_max4MB;
+}
+
 /**
 * @brief Non-Blocking LZ4 압축 작업의 자원을 정리합니다.
 *
@@ -53,8 +72,13 @@ void LZ4F_freeNB(LZ4_NB_Core_t* lz4NB)
     }
 
     // 파일 작업 완료 후 자원 정리
+    if (lz4NB->verifier != NULL) {
+        verify_finish(lz4NB->verifier, NULL); // 검증 Thread 종료
+    }
+    io_stage_free(lz4NB->stage);
+    adapt_free(lz4NB->adapt);
     LZ4F_freeCompressionContext(lz4NB->cctxPtr);
-    free(lz4NB->srcBuf);
+    async_free_aligned(lz4NB->srcBuf);
     free(lz4NB->dstBuf);
     free(lz4NB);
 }
@@ -71,12 +95,14 @@ void LZ4F_freeNB(LZ4_NB_Core_t* lz4NB)
 * @param srcSize 입력 데이터 크기
 * @param dwTotalChunks 총 청크 수
 * @param bWait File I/O 작업 시, 대기 여부 (Blocking: TRUE, Non-Blocking: FALSE)
+* @param options 작업별 옵션
 * @return 성공 시 TRUE, 실패 시 FALSE
 */
 BOOL LZ4F_createNB(
     LZ4_NB_Core_t** lz4NB,
     HANDLE hInput, HANDLE hOutput,
-    size_t srcSize, DWORD dwTotalChunks, BOOL bWait
+    size_t srcSize, DWORD dwTotalChunks, BOOL bWait,
+    const CompressionOptions* options
 ) {
     // 자원 할당
     *lz4NB = (LZ4_NB_Core_t*)calloc(1, sizeof(LZ4_NB_Core_t));
@@ -85,12 +111,28 @@ BOOL LZ4F_createNB(
     (*lz4NB)->hOutput = hOutput;
     (*lz4NB)->dwTotalChunks = dwTotalChunks;
     (*lz4NB)->bWait = bWait;
+    (*lz4NB)->throttle = options->throttle;
+    (*lz4NB)->options = *options;
+    (*lz4NB)->prefs = kPrefs;
+    (*lz4NB)->prefs.frameInfo.blockSizeID = lz4_block_size_id(options->lz4BlockSize);
+    if (options->bLz4IndependentBlocks) {
+        (*lz4NB)->prefs.frameInfo.blockMode = LZ4F_blockIndependent;
+    }
+    (*lz4NB)->prefs.compressionLevel = options->lz4Level;
+    (*lz4NB)->prefs.favorDecSpeed = options->bLz4FavorDecSpeed ? 1 : 0;
+    if (options->checksum == CHECKSUM_CONTENT || options->checksum == CHECKSUM_BLOCK_AND_CONTENT) {
+        (*lz4NB)->prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+    }
+    if (options->checksum == CHECKSUM_BLOCK || options->checksum == CHECKSUM_BLOCK_AND_CONTENT) {
+        (*lz4NB)->prefs.frameInfo.blockChecksumFlag = LZ4F_blockChecksumEnabled;
+    }
     
     size_t const cctxCreation = LZ4F_createCompressionContext(&((*lz4NB)->cctxPtr), LZ4F_VERSION);
 
     (*lz4NB)->srcBufMaxSize = srcSize;
-    (*lz4NB)->srcBuf = malloc((*lz4NB)->srcBufMaxSize); // 읽을 데이터 버퍼
-    (*lz4NB)->dstBufMaxSize = LZ4F_compressBound(srcSize, &kPrefs); // 충분히 큰 크기로 설정 (<= srcSize)
+    (*lz4NB)->srcBuf = async_alloc_aligned((*lz4NB)->srcBufMaxSize); // 읽을 데이터 버퍼 (Direct I/O 로 읽을 수 있도록 정렬)
+    // 충분히 큰 크기로 설정 (Flush Point 에서 Frame 끝과 새 Frame header 를 함께 담을 수 있도록 header 크기 추가)
+    (*lz4NB)->dstBufMaxSize = LZ4F_compressBound(srcSize, &((*lz4NB)->prefs)) + LZ4F_HEADER_SIZE_MAX;
     (*lz4NB)->dstBuf = malloc((*lz4NB)->dstBufMaxSize); // 압축하여 저장할 데이터 버퍼 
     
     if (!LZ4F_isError(cctxCreation) &&
@@ -107,6 +149,63 @@ BOOL LZ4F_createNB(
     return FALSE;
 }
 
+/**
+ * @brief 압축 결과를 담을 공간을 구합니다. (dstBufMaxSize 크기)
+ *
+ * 출력 Staging 을 사용하면 Staging 버퍼에 바로 압축하도록 그 공간을, 아니면 dstBuf 를 돌려줍니다.
+ *
+ * @param lz4NB LZ4 Non-Blocking 작업 구조체
+ * @return 압축 결과를 담을 공간, 실패 시 NULL
+ */
+static BYTE* LZ4F_NB_Target(LZ4_NB_Core_t* lz4NB) {
+    if (lz4NB->stage != NULL) {
+        return io_stage_reserve(lz4NB->stage, lz4NB->dstBufMaxSize);
+    }
+    return (BYTE*)lz4NB->dstBuf;
+}
+
+/**
+ * @brief LZ4F_NB_Target 에 담은 압축 결과를 출력합니다.
+ *
+ * 출력 Staging 을 사용하면 Staging 에 반영하여 모아 쓰고, 아니면 바로 씁니다.
+ * 바로 쓰면서 bWait 가 FALSE 이면, 완료를 확인하지 않고 *pbWritePending 을 TRUE 로 설정합니다.
+ *
+ * @param lz4nbCtx LZ4 Non-Blocking 작업 Context
+ * @param dst 압축 결과 (LZ4F_NB_Target 이 돌려준 공간)
+ * @param size 출력할 크기
+ * @param bWait 쓰기 완료 대기 여부
+ * @param pbWritePending 완료를 확인하지 않은 쓰기 존재 여부 (bWait 가 TRUE 이면 NULL 가능)
+ * @return 성공 여부
+ */
+static BOOL LZ4F_NB_Write(LZ4_NB_Context_t* lz4nbCtx, const BYTE* dst, size_t size, BOOL bWait, BOOL* pbWritePending) {
+    DWORD dwBytesWritten;
+    LZ4_NB_Core_t* lz4NB = lz4nbCtx->lz4NB;
+
+    // 쓰기 전에 압축 결과를 복사하여 검증 Thread 로 보냄 (Staging 버퍼는 반영 후 바로 쓰일 수 있음)
+    if (!verify_output(lz4NB->verifier, dst, size)) {
+        return FALSE;
+    }
+
+    if (lz4NB->stage != NULL) {
+        return io_stage_commit(lz4NB->stage, size);
+    }
+
+    async_set_offset(&(lz4nbCtx->writeOverlap), lz4nbCtx->writeOffset);
+    if (!async_write_ex(
+            lz4NB->hOutput, dst, (DWORD)size,
+            &dwBytesWritten, &(lz4nbCtx->writeOverlap), bWait, lz4NB->throttle
+    )) {
+        return FALSE;
+    }
+
+    if (bWait) {
+        lz4nbCtx->writeOffset += dwBytesWritten; // 쓴 만큼 오프셋 갱신
+    } else {
+        *pbWritePending = TRUE;
+    }
+    return TRUE;
+}
+
 /**
  * @brief Frame header를 Non-Blocking 방식으로 씁니다.
  *
@@ -114,25 +213,23 @@ BOOL LZ4F_createNB(
  * @return Non-Blocking 작업 성공 여부
  */
 BOOL LZ4F_NB_Begin(LZ4_NB_Context_t* lz4nbCtx) {
-    DWORD dwBytesWritten;
     LZ4_NB_Core_t* lz4NB = lz4nbCtx->lz4NB;
+    BYTE* const dst = LZ4F_NB_Target(lz4NB);
+    if (dst == NULL) {
+        return FALSE;
+    }
 
-    size_t const headerSize = LZ4F_compressBegin(lz4NB->cctxPtr, lz4NB->dstBuf, lz4NB->dstBufMaxSize, &kPrefs);
+    size_t const headerSize = LZ4F_compressBegin(lz4NB->cctxPtr, dst, lz4NB->dstBufMaxSize, &(lz4NB->prefs));
     if (LZ4F_isError(headerSize)) {
         log_message("Failed to start compression (header)...");
         return FALSE;
     }
 
-    BOOL bResult = async_write(
-        lz4NB->hOutput, lz4NB->dstBuf, (DWORD)headerSize,
-        &dwBytesWritten, &(lz4nbCtx->writeOverlap), TRUE
-    );
-    if (bResult == FALSE) {
+    if (!LZ4F_NB_Write(lz4nbCtx, dst, headerSize, TRUE, NULL)) {
         log_message("Writing-->failed...");
         return FALSE;
     }
 
-    lz4nbCtx->writeOverlap.Offset += dwBytesWritten; // 쓴 만큼 오프셋 갱신
     return TRUE;
 }
 
@@ -143,17 +240,21 @@ BOOL LZ4F_NB_Begin(LZ4_NB_Context_t* lz4nbCtx) {
  * @return Non-Blocking 작업 성공 여부
  */
 BOOL LZ4F_NB_Process(LZ4_NB_Context_t* lz4nbCtx) {
-    BOOL bResult;
+    BOOL bResult = TRUE;
+    BOOL bWritePending = FALSE; // 완료를 확인하지 않은 쓰기 작업 존재 여부
     DWORD dwBytesRead, dwBytesWritten;
     size_t compressedSize;
     LZ4_NB_Core_t* lz4NB = lz4nbCtx->lz4NB;
+    ULONGLONG bytesSinceFlush = 0;             // 마지막 Flush Point 이후 압축한 원본 크기
+    ULONGLONG lastFlushTick = GetTickCount64(); // 마지막 Flush Point 시각
 
     for (DWORD chunk = 0; chunk < lz4NB->dwTotalChunks; chunk++) {
         
         // 1. 원본 파일 읽기
-        bResult = async_read(
+        async_set_offset(&(lz4nbCtx->readOverlap), lz4nbCtx->readOffset);
+        bResult = async_read_ex(
             lz4NB->hInput, lz4NB->srcBuf, lz4NB->srcBufMaxSize,
-            &dwBytesRead, &(lz4nbCtx->readOverlap), TRUE
+            &dwBytesRead, &(lz4nbCtx->readOverlap), TRUE, lz4NB->throttle
         ); // 압축을 진행하기 위해서는 대상 정보가 필요하기에, 읽기는 항상 동기식으로 진행
         if (bResult == FALSE) {
             break;  // 오류 발생 시 종료
@@ -162,46 +263,94 @@ BOOL LZ4F_NB_Process(LZ4_NB_Context_t* lz4nbCtx) {
             break;  // EOF 발생 시 종료
         }
 
-        lz4nbCtx->readOverlap.Offset += dwBytesRead; // 읽은 만큼 오프셋 갱신
+        lz4nbCtx->readOffset += dwBytesRead; // 읽은 만큼 오프셋 갱신
+        verify_input(lz4NB->verifier, lz4NB->srcBuf, dwBytesRead);
+        io_stage_add_input(lz4NB->stage, dwBytesRead);
+
+        // 2. 이전 쓰기가 dstBuf 를 다 읽을 때까지 기다린 후, 읽은 내용 압축하기
+        //    (이전 쓰기는 위의 읽기와 겹쳐서 진행됨)
+        if (bWritePending) {
+            bWritePending = FALSE;
+            bResult = async_wait(lz4NB->hOutput, &(lz4nbCtx->writeOverlap), &dwBytesWritten, lz4NB->throttle);
+            if (bResult == FALSE) {
+                break;  // 오류 발생 시 종료
+            }
+
+            lz4nbCtx->writeOffset += dwBytesWritten; // 쓴 만큼 오프셋 갱신
+        }
+
+        BYTE* const dst = LZ4F_NB_Target(lz4NB); // Staging 을 사용하면 가득 찬 Staging 버퍼를 여기서 씀
+        if (dst == NULL) {
+            bResult = FALSE;
+            break;
+        }
 
-        // 2. 읽은 내용 압축하기
         compressedSize = LZ4F_compressUpdate(
-            lz4NB->cctxPtr, lz4NB->dstBuf, lz4NB->dstBufMaxSize,
+            lz4NB->cctxPtr, dst, lz4NB->dstBufMaxSize,
             lz4NB->srcBuf, dwBytesRead, NULL
         );
         if (LZ4F_isError(compressedSize)) {
             log_message("Compression failed: error...");
-            return FALSE;
+            bResult = FALSE;
+            break;
         }
 
-        // 3. 압축한 내용 쓰기
-        if (chunk > 0) {
-            if (!lz4NB->bWait) {
-                bResult = GetOverlappedResult(
-                    lz4NB->hOutput, &(lz4nbCtx->writeOverlap),
-                    &dwBytesWritten, TRUE
-                );  // 비동기 작업 결과 확인
+        // 2-1. Flush Point: 현재 Frame 을 끝내고 새 Frame 을 시작 (Frame 끝까지는 독립적으로 복구 가능)
+        //      LZ4F 는 Frame 중간에 Level 을 바꿀 수 없으므로, 마감 시간에 맞춰 Level 을 바꿀 때도 새 Frame 을 시작
+        bytesSinceFlush += dwBytesRead;
+        BOOL const bLevelChanged = adapt_update(lz4NB->adapt, dwBytesRead);
+        if (bLevelChanged) {
+            lz4NB->prefs.compressionLevel = adapt_level(lz4NB->adapt);
+        }
+        if (chunk + 1 < lz4NB->dwTotalChunks && (bLevelChanged ||
+            compress_flush_point_due(&(lz4NB->options), bytesSinceFlush, lastFlushTick))) {
+            size_t const endSize = LZ4F_compressEnd(
+                lz4NB->cctxPtr, dst + compressedSize,
+                lz4NB->dstBufMaxSize - compressedSize, NULL
+            );
+            if (LZ4F_isError(endSize)) {
+                log_message("Failed to end compression: error...");
+                bResult = FALSE;
+                break;
             }
+            compressedSize += endSize;
+
+            size_t const headerSize = LZ4F_compressBegin(
+                lz4NB->cctxPtr, dst + compressedSize,
+                lz4NB->dstBufMaxSize - compressedSize, &(lz4NB->prefs)
+            );
+            if (LZ4F_isError(headerSize)) {
+                log_message("Failed to start compression (header)...");
+                bResult = FALSE;
+                break;
+            }
+            compressedSize += headerSize;
 
-            lz4nbCtx->writeOverlap.Offset += dwBytesWritten; // 쓴 만큼 오프셋 갱신
+            bytesSinceFlush = 0;
+            lastFlushTick = GetTickCount64();
         }
 
-        bResult = async_write(
-            lz4NB->hOutput, lz4NB->dstBuf, (DWORD)compressedSize,
-            &dwBytesWritten, &(lz4nbCtx->writeOverlap), lz4NB->bWait
-        );
+        if (compressedSize == 0) {
+            continue;  // Block 이 다 채워지지 않아 출력이 없음
+        }
 
+        // 3. 압축한 내용 쓰기
+        bResult = LZ4F_NB_Write(lz4nbCtx, dst, compressedSize, lz4NB->bWait, &bWritePending);
         if (bResult == FALSE) {
             break;  // 오류 발생 시 종료
         }
+    }
 
-        // Kernel Resources 포화 방지
-        // if ((chunk % 16) == 15) {
-        //     Sleep(1);
-        // }
+    // 마지막 쓰기 완료 확인 (Finalize 가 같은 OVERLAPPED 구조체와 이어지는 위치를 사용)
+    if (bWritePending) {
+        if (async_wait(lz4NB->hOutput, &(lz4nbCtx->writeOverlap), &dwBytesWritten, lz4NB->throttle)) {
+            lz4nbCtx->writeOffset += dwBytesWritten; // 쓴 만큼 오프셋 갱신
+        } else {
+            bResult = FALSE;
+        }
     }
 
-    return TRUE;
+    return bResult;
 }
 
 /**
@@ -211,24 +360,29 @@ BOOL LZ4F_NB_Process(LZ4_NB_Context_t* lz4nbCtx) {
  * @return Non-Blocking 작업 성공 여부
  */
 BOOL LZ4F_NB_Finalize(LZ4_NB_Context_t* lz4nbCtx) {
-    DWORD dwBytesWritten;
     LZ4_NB_Core_t* lz4NB = lz4nbCtx->lz4NB;
-    size_t const compressedSize = LZ4F_compressEnd(lz4NB->cctxPtr, lz4NB->dstBuf, lz4NB->dstBufMaxSize, NULL);
+    BYTE* const dst = LZ4F_NB_Target(lz4NB);
+    if (dst == NULL) {
+        return FALSE;
+    }
+
+    size_t const compressedSize = LZ4F_compressEnd(lz4NB->cctxPtr, dst, lz4NB->dstBufMaxSize, NULL);
     if (LZ4F_isError(compressedSize)) {
         log_message("Failed to end compression: error...");
         return FALSE;
     }
 
-    BOOL bResult = async_write(
-        lz4NB->hOutput, lz4NB->dstBuf, compressedSize,
-        &dwBytesWritten, &(lz4nbCtx->writeOverlap), TRUE
-    );
-    if (bResult == FALSE) {
+    if (!LZ4F_NB_Write(lz4nbCtx, dst, compressedSize, TRUE, NULL)) {
+        log_message("Writing-->failed...");
+        return FALSE;
+    }
+
+    // Staging 에 남은 내용을 쓰고 파일을 실제 크기로 맞춤
+    if (lz4NB->stage != NULL && !io_stage_finish(lz4NB->stage)) {
         log_message("Writing-->failed...");
         return FALSE;
     }
 
-    lz4nbCtx->writeOverlap.Offset += dwBytesWritten; // 쓴 만큼 오프셋 갱신
     return TRUE;
 }
 
@@ -243,6 +397,8 @@ BOOL LZ4F_NB_Compress(LZ4_NB_Core_t *lz4NB) {
         lz4NB,
         { 0, }, // Non-Blocking 읽기 작업을 위한 OVERLAPPED 구조체
         { 0, }, // Non-Blocking 쓰기 작업을 위한 OVERLAPPED 구조체
+        0,      // 다음 읽기 위치
+        0,      // 다음 쓰기 위치
     };
 
     // Frame header 쓰기
@@ -264,6 +420,129 @@ BOOL LZ4F_NB_Compress(LZ4_NB_Core_t *lz4NB) {
     return TRUE;
 }
 
+/**
+ * @brief Pool Task: Chunk 하나를 완결된 Frame 으로 압축합니다.
+ */
+static void LZ4F_NB_CompressSlot(void* param) {
+    LZ4_NB_Slot_t* const slot = (LZ4_NB_Slot_t*)param;
+    slot->dstSize = LZ4F_compressFrame(slot->dstBuf, slot->dstBufMaxSize, slot->srcBuf, slot->srcSize, &(slot->prefs));
+}
+
+/**
+ * @brief 원본을 LZ4_POOL_CHUNK_SIZE 마다 독립된 Frame 으로 나누어 공유 Thread Pool 에서 병렬로 압축하고, 순서대로 씁니다.
+ *
+ * 호출한 Thread 는 읽기와 쓰기만 하며, 동시에 압축하는 Chunk 수는 Worker 수 + 1 (최대 LZ4_POOL_MAX_SLOTS) 입니다.
+ * Frame 마다 독립적으로 복구할 수 있으므로 Flush Point 옵션은 따로 적용하지 않습니다.
+ *
+ * @param lz4NB LZ4 Non-Blocking 작업 구조체
+ * @param pool 공유 Thread Pool
+ * @param priority Pool 에서의 우선순위
+ * @return 압축 성공 여부
+ */
+BOOL LZ4F_NB_CompressPooled(LZ4_NB_Core_t* lz4NB, TASK_Pool_t* pool, TaskPriority priority) {
+    BOOL bResult = TRUE;
+    LZ4_NB_Slot_t slots[LZ4_POOL_MAX_SLOTS] = { 0, };
+    DWORD const slotCount = (pool->workerCount + 1 < LZ4_POOL_MAX_SLOTS) ? pool->workerCount + 1 : LZ4_POOL_MAX_SLOTS;
+    size_t const dstBufMaxSize = LZ4F_compressFrameBound(LZ4_POOL_CHUNK_SIZE, &(lz4NB->prefs));
+
+    for (DWORD i = 0; i < slotCount; i++) {
+        slots[i].srcBuf = (BYTE*)async_alloc_aligned(LZ4_POOL_CHUNK_SIZE);
+        slots[i].dstBuf = (BYTE*)malloc(dstBufMaxSize);
+        slots[i].dstBufMaxSize = dstBufMaxSize;
+        if (slots[i].srcBuf == NULL || slots[i].dstBuf == NULL) {
+            bResult = FALSE;
+        }
+    }
+
+    TASK_Job_t job;
+    task_job_init(&job, pool, priority);
+
+    OVERLAPPED readOverlap = { 0, }, writeOverlap = { 0, };
+    ULONGLONG readOffset = 0, writeOffset = 0;
+    DWORD submitted = 0, written = 0; // 압축을 맡긴 Chunk 수, 쓴 Chunk 수
+    BOOL bEof = FALSE;
+    while (bResult) {
+        // 1. 빈 Slot 을 모두 읽어서 압축을 맡김 (빈 파일도 Frame 하나는 씀)
+        while (!bEof && submitted - written < slotCount) {
+            LZ4_NB_Slot_t* const slot = &(slots[submitted % slotCount]);
+            DWORD dwBytesRead;
+
+            async_set_offset(&readOverlap, readOffset);
+            if (!async_read_ex(
+                    lz4NB->hInput, slot->srcBuf, LZ4_POOL_CHUNK_SIZE,
+                    &dwBytesRead, &readOverlap, TRUE, lz4NB->throttle
+            )) {
+                bResult = FALSE;
+                break;
+            }
+            readOffset += dwBytesRead;
+            bEof = (dwBytesRead < LZ4_POOL_CHUNK_SIZE);
+            if (dwBytesRead == 0 && submitted > 0) {
+                break;
+            }
+
+            verify_input(lz4NB->verifier, slot->srcBuf, dwBytesRead);
+            io_stage_add_input(lz4NB->stage, dwBytesRead);
+            slot->srcSize = dwBytesRead;
+            slot->prefs = lz4NB->prefs;
+            task_submit(&job, &(slot->task), LZ4F_NB_CompressSlot, slot);
+            submitted++;
+        }
+        if (!bResult || written == submitted) {
+            break;
+        }
+
+        // 2. 가장 오래된 Chunk 의 압축이 끝나면 순서대로 씀
+        LZ4_NB_Slot_t* const slot = &(slots[written % slotCount]);
+        task_wait(&(slot->task));
+        written++;
+        if (LZ4F_isError(slot->dstSize)) {
+            log_message("Compression failed: error...");
+            bResult = FALSE;
+            break;
+        }
+        if (!verify_output(lz4NB->verifier, slot->dstBuf, slot->dstSize)) {
+            bResult = FALSE;
+            break;
+        }
+
+        // 마감 시간에 맞춘 Level 은 다음에 맡기는 Chunk 부터 적용 (Chunk 마다 독립된 Frame)
+        if (adapt_update(lz4NB->adapt, slot->srcSize)) {
+            lz4NB->prefs.compressionLevel = adapt_level(lz4NB->adapt);
+        }
+
+        if (lz4NB->stage != NULL) {
+            bResult = io_stage_write(lz4NB->stage, slot->dstBuf, slot->dstSize);
+        } else {
+            DWORD dwBytesWritten = 0;
+            async_set_offset(&writeOverlap, writeOffset);
+            bResult = async_write_ex(
+                lz4NB->hOutput, slot->dstBuf, (DWORD)slot->dstSize,
+                &dwBytesWritten, &writeOverlap, TRUE, lz4NB->throttle
+            );
+            writeOffset += dwBytesWritten;
+        }
+        if (!bResult) {
+            log_message("Writing-->failed...");
+        }
+    }
+
+    // 실패한 경우에도 맡긴 Task 가 Slot 을 다 쓸 때까지 기다린 뒤 해제
+    task_job_wait(&job);
+    for (DWORD i = 0; i < slotCount; i++) {
+        async_free_aligned(slots[i].srcBuf);
+        free(slots[i].dstBuf);
+    }
+
+    // Staging 에 남은 내용을 쓰고 파일을 실제 크기로 맞춤
+    if (bResult && lz4NB->stage != NULL && !io_stage_finish(lz4NB->stage)) {
+        log_message("Writing-->failed...");
+        bResult = FALSE;
+    }
+
+    return bResult;
+}
+
 /**
 * @brief Non-Blocking 방식으로 읽기와 쓰기 작업을 수행하고, 데이터를 LZ4로 압축하여 파일에 씁니다.
 *
@@ -271,13 +550,14 @@ BOOL LZ4F_NB_Compress(LZ4_NB_Core_t *lz4NB) {
 *
 * @param inputFilePath 읽을 파일 경로
 * @param outputFilePath 쓸 파일 경로
+* @param options 작업별 옵션
 * @return 압축 성공 여부
 */
-BOOL compress_lz4(const TCHAR* inputFilePath, const TCHAR* outputFilePath) {
+BOOL compress_lz4(const TCHAR* inputFilePath, const TCHAR* outputFilePath, const CompressionOptions* options) {
     BOOL bResult = FALSE;
     
-    HANDLE hInput = init_file_read(inputFilePath);  // 읽을 파일
-    HANDLE hOutput = init_file_write(outputFilePath);  // 쓸 파일
+    HANDLE hInput = init_file_read_ex(inputFilePath, options->cacheMode);  // 읽을 파일
+    HANDLE hOutput = init_file_write_ex(outputFilePath, options->cacheMode);  // 쓸 파일
 
     // 파일 열기 오류 처리
     if (hInput == INVALID_HANDLE_VALUE) {
@@ -289,25 +569,57 @@ BOOL compress_lz4(const TCHAR* inputFilePath, const TCHAR* outputFilePath) {
         return bResult;
     }
 
-    DWORD dwFileSize = get_file_size(hInput);  // 파일 크기 얻기
-    DWORD dwTotalChunks = dwFileSize / CHUNK_SIZE;
-    if (dwFileSize % CHUNK_SIZE != 0) {
-        ++dwTotalChunks;
+    LARGE_INTEGER fileSize;  // 파일 크기 얻기 (4 GB 이상도 가능)
+    if (!GetFileSizeEx(hInput, &fileSize)) {
+        log_message("error : Failed to get input file size.");
+        CloseHandle(hInput);
+        CloseHandle(hOutput);
+        return bResult;
     }
+    DWORD const chunkSize = compress_chunk_size(options, LZ4, hInput, CHUNK_SIZE);
+    DWORD const dwTotalChunks = (DWORD)(((ULONGLONG)fileSize.QuadPart + chunkSize - 1) / chunkSize);
 
     LZ4_NB_Core_t* lz4NB;
-    if (LZ4F_createNB(&lz4NB, hInput, hOutput, CHUNK_SIZE, dwTotalChunks, FALSE)) {
-        bResult = LZ4F_NB_Compress(lz4NB);
+    if (LZ4F_createNB(&lz4NB, hInput, hOutput, chunkSize, dwTotalChunks, FALSE, options)) {
+        // 압축 결과를 Staging 에 모아 큰 쓰기로 합침 (Header, Block, Frame 끝 모두)
+        size_t const readSize = (options->pool != NULL) ? LZ4_POOL_CHUNK_SIZE : chunkSize;
+        BOOL bReady = compress_create_stage(options, hInput, hOutput, readSize, lz4NB->dstBufMaxSize, &(lz4NB->stage));
+
+        // 쓰기 후 검증 Thread 시작
+        if (bReady && options->verify != NULL) {
+            lz4NB->verifier = verify_start(LZ4, NULL);
+            bReady = (lz4NB->verifier != NULL);
+        }
+
+        // 마감 시간이 있으면 지금부터 속도를 재어 Level 조절
+        if (bReady && options->deadlineMillis != 0) {
+            lz4NB->adapt = adapt_create(LZ4, ADAPT_MODE_DEADLINE, (ULONGLONG)fileSize.QuadPart, options->deadlineMillis);
+            bReady = (lz4NB->adapt != NULL);
+            if (bReady) {
+                lz4NB->prefs.compressionLevel = adapt_level(lz4NB->adapt); // lz4Level 대신 조절 시작 Level
+            }
+        }
+        if (bReady && options->pool != NULL) {
+            bResult = LZ4F_NB_CompressPooled(lz4NB, options->pool, options->priority);
+        } else if (bReady) {
+            bResult = LZ4F_NB_Compress(lz4NB);
+        }
+        adapt_finish(lz4NB->adapt, options->adaptStats);
+        if (lz4NB->verifier != NULL) {
+            BOOL const bVerified = verify_finish(lz4NB->verifier, options->verify);
+            lz4NB->verifier = NULL;
+            bResult = bResult && bVerified;
+        }
     } else {
         log_message("error : LZ4 resource allocation failed.");
     }
 
     // log_message("Compression processing completed.");
     
-    // 파일 작업 완료 후 리소스 정리
+    // 파일 작업 완료 후 리소스 정리 (출력 Staging 의 진행 중인 쓰기가 있으면 핸들을 닫기 전에 끝나야 함)
+    LZ4F_freeNB(lz4NB);
     CloseHandle(hInput);
     CloseHandle(hOutput);
-    LZ4F_freeNB(lz4NB);
 
     return bResult;
 }
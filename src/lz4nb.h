@@ -21,28 +21,58 @@
 
 #include "../include/lz4/lz4frame.h"
 #include "../include/lz4/lz4frame_static.h"
+#include "adapt.h"
+#include "compressor.h"
+#include "io_stage.h"
+#include "task_pool.h"
+#include "verify.h"
+
+#define LZ4_POOL_CHUNK_SIZE (256 * 1024) // 공유 Thread Pool 사용 시 Task 하나가 압축하는 원본 크기 (독립된 Frame)
+#define LZ4_POOL_MAX_SLOTS  8            // 공유 Thread Pool 사용 시 작업별로 동시에 압축하는 Chunk 수 최대값
 
 // 구조체 선언
 
 typedef struct LZ4_NB_Core_s LZ4_NB_Core_t;
 typedef struct LZ4_NB_Context_s LZ4_NB_Context_t;
+typedef struct LZ4_NB_Slot_s LZ4_NB_Slot_t;
 
 struct LZ4_NB_Core_s {
     HANDLE hInput;            // 입력 핸들
     HANDLE hOutput;           // 출력 핸들
     LZ4F_cctx* cctxPtr;       // LZ4F 압축 컨텍스트 포인터
+    LZ4F_preferences_t prefs; // LZ4F Frame 압축 옵션
     LPVOID srcBuf;            // 원본 데이터 버퍼
     size_t srcBufMaxSize;     // 원본 데이터 버퍼의 최대 크기
     LPVOID dstBuf;            // 압축된 데이터 버퍼
     size_t dstBufMaxSize;     // 압축된 데이터 버퍼의 최대 크기
     DWORD dwTotalChunks;      // 총 청크 수
     BOOL bWait;               // File I/O 작업 시, 대기 여부 (Blocking: TRUE, Non-Blocking: FALSE)
+    IO_Throttle_t* throttle;  // I/O 제한 (NULL 이면 제한 없음)
+    CompressionOptions options; // 작업별 옵션 (복사본)
+    VERIFY_Context_t* verifier; // 쓰기 후 검증 (NULL 이면 사용 안 함)
+    IO_Stage_t* stage;        // 출력 Staging (압축 결과를 모아 정렬된 큰 쓰기로 씀, NULL 이면 바로 씀)
+    ADAPT_Context_t* adapt;   // 마감 시간에 맞춘 Level 조절 (NULL 이면 Level 고정)
 };
 
 struct LZ4_NB_Context_s {
     LZ4_NB_Core_t* lz4NB;            // Non-Blocking LZ4 Core 구조체 포인터
     OVERLAPPED readOverlap;          // Non-Blocking 읽기 작업을 위한 OVERLAPPED 구조체
     OVERLAPPED writeOverlap;         // Non-Blocking 쓰기 작업을 위한 OVERLAPPED 구조체
+    ULONGLONG readOffset;            // 다음 읽기 위치 (OVERLAPPED.Offset 만 쓰면 4 GB 에서 넘침)
+    ULONGLONG writeOffset;           // 다음 쓰기 위치
+};
+
+/*
+ * 공유 Thread Pool 에서 압축하는 Chunk 하나
+ */
+struct LZ4_NB_Slot_s {
+    TASK_Item_t task;                 // Pool Task
+    LZ4F_preferences_t prefs;         // Frame 압축 옵션 (맡길 때의 Level 을 복사)
+    BYTE* srcBuf;                     // 원본 (Direct I/O 로 읽을 수 있도록 정렬)
+    size_t srcSize;                   // 원본 크기
+    BYTE* dstBuf;                     // 압축 결과 (완결된 Frame)
+    size_t dstBufMaxSize;             // 압축 결과 버퍼 크기
+    size_t dstSize;                   // 압축 결과 크기 (LZ4F 오류 코드일 수 있음)
 };
 
 // 함수 선언
@@ -50,14 +80,16 @@ void LZ4F_freeNB(LZ4_NB_Core_t* lz4NB);
 BOOL LZ4F_createNB(
     LZ4_NB_Core_t** lz4NB,
     HANDLE hInput, HANDLE hOutput,
-    size_t srcSize, DWORD dwTotalChunks, BOOL bWait
+    size_t srcSize, DWORD dwTotalChunks, BOOL bWait,
+    const CompressionOptions* options
 );
 BOOL LZ4F_NB_Begin(LZ4_NB_Context_t* lz4nbCtx);
 BOOL LZ4F_NB_Process(LZ4_NB_Context_t* lz4nbCtx);
 BOOL LZ4F_NB_Finalize(LZ4_NB_Context_t* lz4nbCtx);
 
 BOOL LZ4F_NB_Compress(LZ4_NB_Core_t* lz4NB);
+BOOL LZ4F_NB_CompressPooled(LZ4_NB_Core_t* lz4NB, TASK_Pool_t* pool, TaskPriority priority);
 
-BOOL compress_lz4(const TCHAR* inputFilePath, const TCHAR* outputFilePath);
+BOOL compress_lz4(const TCHAR* inputFilePath, const TCHAR* outputFilePath, const CompressionOptions* options);
 
 #endif // LZ4NB_H
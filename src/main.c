@@ -16,12 +16,47 @@
 
 #include "utility.h"
 #include "compressor.h"
+#include "bench/bench.h"
 #include <time.h> // 소요 시간 확인용
 
 #define STRINGIFY(x) #x
 
 #define INPUT_FILE "../sample_files/input.txt"
 
+// 이름으로 실행할 수 있는 Benchmark 목록
+typedef struct {
+    const TCHAR* name;
+    void (*run)(void);
+} BenchmarkEntry;
+
+static const BenchmarkEntry kBenchmarks[] = {
+    { "archive", bench_archive },
+    { "throttle", bench_throttle },
+    { "step", bench_step },
+    { "loop", bench_loop },
+    { "appender", bench_appender },
+    { "recover", bench_recover },
+    { "checksum", bench_checksum },
+    { "verify", bench_verify },
+    { "cache", bench_cache },
+    { "stage", bench_stage },
+    { "prealloc", bench_prealloc },
+    { "durability", bench_durability },
+    { "pipeline", bench_pipeline },
+    { "pool", bench_pool },
+    { "deadline", bench_deadline },
+    { "backpressure", bench_backpressure },
+    { "estimate", bench_estimate },
+    { "tune", bench_tune },
+    { "lz4prefs", bench_lz4prefs },
+    { "longrange", bench_longrange },
+    { "streaming", bench_streaming },
+    { "delta", bench_delta },
+    { "firmware", bench_firmware },
+    { "seekable", bench_seekable },
+    { "message", bench_message },
+};
+
 void check_compress_time(CompressionAlgorithm algorithm, const TCHAR* name) {
     clock_t start, end;
     double time_spent;
@@ -42,7 +77,19 @@ void check_compress_time(CompressionAlgorithm algorithm, const TCHAR* name) {
     free(output);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // 인자로 Benchmark 이름이 주어지면 해당 Benchmark 만 실행
+    if (argc > 1) {
+        for (size_t i = 0; i < sizeof(kBenchmarks) / sizeof(kBenchmarks[0]); i++) {
+            if (strcmp(argv[1], kBenchmarks[i].name) == 0) {
+                kBenchmarks[i].run();
+                return 0;
+            }
+        }
+        log_message("Unknown benchmark name.");
+        return 1;
+    }
+
     for (int i = 0; i < 3; i++) {
         check_compress_time(LZ4, STRINGIFY(LZ4));
         check_compress_time(ZSTD, STRINGIFY(ZSTD));
@@ -0,0 +1,321 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "msg_stream.h"
+#include "utility.h"
+
+/**
+ * @brief 옵션의 기본값을 채우고, Ring Buffer 가 사전과 가장 큰 Message 를 담을 수 있는지 확인합니다.
+ *
+ * @param pDictionary 사용할 사전 (MSG_HISTORY_SIZE 보다 크면 뒷부분)
+ * @return 성공 여부
+ */
+static BOOL msg_resolve_options(
+    const MSG_Options_t* options, DWORD* pMaxMessageSize, DWORD* pRingSize,
+    const BYTE** pDictionary, DWORD* pDictionarySize
+) {
+    DWORD maxMessageSize = MSG_DEFAULT_MAX_MESSAGE;
+    DWORD ringSize = 0;
+    size_t dictionarySize = 0;
+
+    *pDictionary = NULL;
+    if (options != NULL) {
+        if (options->maxMessageSize != 0) {
+            maxMessageSize = options->maxMessageSize;
+        }
+        ringSize = options->ringSize;
+        if (options->dictionary != NULL) {
+            dictionarySize = options->dictionarySize;
+            if (dictionarySize > MSG_HISTORY_SIZE) {
+                dictionarySize = MSG_HISTORY_SIZE; // 가장 가까운 (뒷부분) 64 KB 만 참조 가능
+            }
+            *pDictionary = (const BYTE*)options->dictionary + options->dictionarySize - dictionarySize;
+        }
+    }
+    if (maxMessageSize > LZ4_MAX_INPUT_SIZE || maxMessageSize > MAXDWORD - MSG_HISTORY_SIZE) {
+        log_message("Message stream - max message size is too large.");
+        return FALSE;
+    }
+    if (ringSize == 0) {
+        ringSize = MSG_HISTORY_SIZE + maxMessageSize;
+    }
+    if (ringSize < dictionarySize + maxMessageSize) {
+        log_message("Message stream - ring buffer is smaller than dictionary + max message size.");
+        return FALSE;
+    }
+
+    *pMaxMessageSize = maxMessageSize;
+    *pRingSize = ringSize;
+    *pDictionarySize = (DWORD)dictionarySize;
+    return TRUE;
+}
+
+/**
+ * @brief 사전을 복사해 둡니다. (reset 할 때 Ring Buffer 앞에 다시 넣음)
+ */
+static BOOL msg_copy_dictionary(const BYTE* dictionary, DWORD dictionarySize, BYTE** pCopy) {
+    *pCopy = NULL;
+    if (dictionarySize == 0) {
+        return TRUE;
+    }
+    *pCopy = (BYTE*)malloc(dictionarySize);
+    if (*pCopy == NULL) {
+        return FALSE;
+    }
+    memcpy(*pCopy, dictionary, dictionarySize);
+    return TRUE;
+}
+
+/**
+ * @brief Message 하나를 압축했을 때의 최대 크기를 구합니다.
+ *
+ * @param messageSize Message 크기
+ * @return 압축 결과 최대 크기
+ */
+size_t msg_compress_bound(size_t messageSize) {
+    return (size_t)LZ4_COMPRESSBOUND(messageSize);
+}
+
+/* ---------- Encoder ---------- */
+
+/**
+ * @brief Message Encoder 를 만듭니다.
+ *
+ * @param encoder 만든 Encoder
+ * @param options 옵션 (NULL 이면 기본값)
+ * @return 성공 여부
+ */
+BOOL msg_encoder_create(MSG_Encoder_t** encoder, const MSG_Options_t* options) {
+    DWORD maxMessageSize, ringSize, dictionarySize;
+    const BYTE* dictionary;
+
+    *encoder = NULL;
+    if (!msg_resolve_options(options, &maxMessageSize, &ringSize, &dictionary, &dictionarySize)) {
+        return FALSE;
+    }
+
+    MSG_Encoder_t* const enc = (MSG_Encoder_t*)calloc(1, sizeof(MSG_Encoder_t));
+    if (enc == NULL) {
+        return FALSE;
+    }
+    enc->stream = LZ4_createStream();
+    enc->ring = (BYTE*)malloc(ringSize);
+    enc->ringSize = ringSize;
+    enc->maxMessageSize = maxMessageSize;
+    enc->acceleration = (options != NULL && options->acceleration > 0) ? options->acceleration : MSG_DEFAULT_ACCELERATION;
+    enc->dictionarySize = dictionarySize;
+    if (enc->stream == NULL || enc->ring == NULL ||
+        !msg_copy_dictionary(dictionary, dictionarySize, &(enc->dictionary))) {
+        log_message("Message stream - failed to create encoder.");
+        msg_encoder_free(enc);
+        return FALSE;
+    }
+
+    msg_encoder_reset(enc);
+    *encoder = enc;
+    return TRUE;
+}
+
+/**
+ * @brief Encoder 를 해제합니다.
+ */
+void msg_encoder_free(MSG_Encoder_t* encoder) {
+    if (encoder == NULL) {
+        return;
+    }
+    if (encoder->stream != NULL) {
+        LZ4_freeStream(encoder->stream);
+    }
+    free(encoder->ring);
+    free(encoder->dictionary);
+    free(encoder);
+}
+
+/**
+ * @brief 이전 Message 를 모두 잊고 사전만 남은 처음 상태로 돌아갑니다. (Decoder 도 함께 reset 해야 함)
+ */
+void msg_encoder_reset(MSG_Encoder_t* encoder) {
+    if (encoder->dictionarySize > 0) {
+        memcpy(encoder->ring, encoder->dictionary, encoder->dictionarySize);
+    }
+    LZ4_loadDict(encoder->stream, (const char*)encoder->ring, (int)encoder->dictionarySize); // Stream 도 초기화됨
+    encoder->ringPos = encoder->dictionarySize;
+}
+
+/**
+ * @brief Message 하나를 LZ4 Block 하나로 압축합니다.
+ *
+ * Message 를 Ring Buffer 에 복사한 뒤 압축하므로, 호출한 쪽은 src 를 바로 재사용할 수 있습니다.
+ * 실패하면 Stream 상태가 Decoder 와 어긋나므로 양쪽 모두 reset 해야 합니다.
+ *
+ * @param encoder Encoder
+ * @param src Message
+ * @param srcSize Message 크기 (maxMessageSize 이하)
+ * @param dst 압축 결과를 쓸 버퍼
+ * @param dstCapacity dst 크기 (msg_compress_bound(srcSize) 이상이면 항상 성공)
+ * @param pDstSize 압축 결과 크기
+ * @return 성공 여부
+ */
+BOOL msg_encode(
+    MSG_Encoder_t* encoder, const void* src, size_t srcSize,
+    void* dst, size_t dstCapacity, size_t* pDstSize
+) {
+    if (srcSize > encoder->maxMessageSize) {
+        log_message("Message stream - message is larger than max message size.");
+        return FALSE;
+    }
+    if (dstCapacity > LZ4_MAX_INPUT_SIZE) {
+        dstCapacity = LZ4_MAX_INPUT_SIZE;
+    }
+
+    // 남은 공간에 가장 큰 Message 가 들어가지 않으면 처음으로 (Decoder 도 자신의 Ring Buffer 에서 같은 규칙)
+    if (encoder->ringPos + encoder->maxMessageSize > encoder->ringSize) {
+        encoder->ringPos = 0;
+    }
+    BYTE* const message = encoder->ring + encoder->ringPos;
+    memcpy(message, src, srcSize);
+
+    int const compressedSize = LZ4_compress_fast_continue(
+        encoder->stream, (const char*)message, (char*)dst, (int)srcSize, (int)dstCapacity, encoder->acceleration
+    );
+    if (compressedSize <= 0) {
+        log_message("Message stream - LZ4 block compression failed.");
+        return FALSE;
+    }
+
+    encoder->ringPos += (DWORD)srcSize;
+    *pDstSize = (size_t)compressedSize;
+    return TRUE;
+}
+
+/* ---------- Decoder ---------- */
+
+/**
+ * @brief Message Decoder 를 만듭니다.
+ *
+ * Ring Buffer 는 Encoder 의 ringSize 와 관계없이 LZ4_decoderRingBufferSize(maxMessageSize) 크기로 만듭니다.
+ *
+ * @param decoder 만든 Decoder
+ * @param options 옵션 (Encoder 와 같은 maxMessageSize, dictionary, NULL 이면 기본값)
+ * @return 성공 여부
+ */
+BOOL msg_decoder_create(MSG_Decoder_t** decoder, const MSG_Options_t* options) {
+    DWORD maxMessageSize, ringSize, dictionarySize;
+    const BYTE* dictionary;
+
+    *decoder = NULL;
+    if (!msg_resolve_options(options, &maxMessageSize, &ringSize, &dictionary, &dictionarySize)) {
+        return FALSE;
+    }
+    int const decoderRingSize = LZ4_decoderRingBufferSize((int)maxMessageSize);
+    if (decoderRingSize <= 0) {
+        log_message("Message stream - max message size is too large.");
+        return FALSE;
+    }
+    ringSize = (DWORD)decoderRingSize; // 사전 + maxMessageSize 보다 항상 큼
+
+    MSG_Decoder_t* const dec = (MSG_Decoder_t*)calloc(1, sizeof(MSG_Decoder_t));
+    if (dec == NULL) {
+        return FALSE;
+    }
+    dec->stream = LZ4_createStreamDecode();
+    dec->ring = (BYTE*)malloc(ringSize);
+    dec->ringSize = ringSize;
+    dec->maxMessageSize = maxMessageSize;
+    dec->dictionarySize = dictionarySize;
+    if (dec->stream == NULL || dec->ring == NULL ||
+        !msg_copy_dictionary(dictionary, dictionarySize, &(dec->dictionary))) {
+        log_message("Message stream - failed to create decoder.");
+        msg_decoder_free(dec);
+        return FALSE;
+    }
+
+    msg_decoder_reset(dec);
+    *decoder = dec;
+    return TRUE;
+}
+
+/**
+ * @brief Decoder 를 해제합니다.
+ */
+void msg_decoder_free(MSG_Decoder_t* decoder) {
+    if (decoder == NULL) {
+        return;
+    }
+    if (decoder->stream != NULL) {
+        LZ4_freeStreamDecode(decoder->stream);
+    }
+    free(decoder->ring);
+    free(decoder->dictionary);
+    free(decoder);
+}
+
+/**
+ * @brief 이전 Message 를 모두 잊고 사전만 남은 처음 상태로 돌아갑니다. (Encoder 도 함께 reset 해야 함)
+ */
+void msg_decoder_reset(MSG_Decoder_t* decoder) {
+    if (decoder->dictionarySize > 0) {
+        memcpy(decoder->ring, decoder->dictionary, decoder->dictionarySize);
+    }
+    LZ4_setStreamDecode(decoder->stream, (const char*)decoder->ring, (int)decoder->dictionarySize);
+    decoder->ringPos = decoder->dictionarySize;
+}
+
+/**
+ * @brief msg_encode 로 압축한 Message 하나를 풉니다. Message 는 압축한 순서대로 풀어야 합니다.
+ *
+ * 실패하면 Stream 상태가 Encoder 와 어긋나므로 양쪽 모두 reset 해야 합니다.
+ *
+ * @param decoder Decoder
+ * @param src 압축된 Message
+ * @param srcSize 압축된 Message 크기 (msg_encode 의 *pDstSize)
+ * @param dst 푼 Message 를 쓸 버퍼
+ * @param dstCapacity dst 크기 (maxMessageSize 이상이면 항상 충분)
+ * @param pDstSize 푼 Message 크기
+ * @return 성공 여부 (손상된 입력이거나 dst 가 작으면 실패)
+ */
+BOOL msg_decode(
+    MSG_Decoder_t* decoder, const void* src, size_t srcSize,
+    void* dst, size_t dstCapacity, size_t* pDstSize
+) {
+    if (srcSize > LZ4_COMPRESSBOUND(decoder->maxMessageSize)) {
+        log_message("Message stream - compressed message is too large.");
+        return FALSE;
+    }
+
+    // 남은 공간에 가장 큰 Message 가 들어가지 않으면 처음으로 (Decoder 의 Ring Buffer 크기 기준)
+    if (decoder->ringPos + decoder->maxMessageSize > decoder->ringSize) {
+        decoder->ringPos = 0;
+    }
+    BYTE* const message = decoder->ring + decoder->ringPos;
+
+    int const decodedSize = LZ4_decompress_safe_continue(
+        decoder->stream, (const char*)src, (char*)message, (int)srcSize, (int)decoder->maxMessageSize
+    );
+    if (decodedSize < 0) {
+        log_message("Message stream - LZ4 block decompression failed.");
+        return FALSE;
+    }
+    decoder->ringPos += (DWORD)decodedSize;
+
+    if ((size_t)decodedSize > dstCapacity) {
+        log_message("Message stream - destination is too small.");
+        return FALSE;
+    }
+    memcpy(dst, message, decodedSize);
+    *pDstSize = (size_t)decodedSize;
+    return TRUE;
+}
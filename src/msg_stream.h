@@ -0,0 +1,106 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MSG_STREAM_H
+#define MSG_STREAM_H
+
+#include <windows.h>
+
+#include "../include/lz4/lz4.h"
+
+/*
+ * 작은 Message 연속 압축 (LZ4 Block Streaming)
+ *
+ * 수백 bytes 짜리 Message 를 하나씩 LZ4F Frame 으로 만들면 Frame Header/EndMark (최소 11 bytes) 와
+ * LZ4F_compressBegin/End 비용이 Message 보다 커집니다. 여기서는 Frame 없이 lz4.h 의 Block 함수로
+ * Message 하나를 LZ4 Block 하나로 압축하며, 앞선 Message 들을 Ring Buffer 에 남겨 다음 Message 의 사전으로 씁니다.
+ *
+ * Encoder 는 Message 를 자신의 Ring Buffer 에 복사한 뒤 LZ4_compress_fast_continue 로 압축하고,
+ * Decoder 는 LZ4_decompress_safe_continue 로 LZ4_decoderRingBufferSize(maxMessageSize) 크기의 Ring Buffer 에 풉니다.
+ * 푼 Message 의 크기를 미리 알 수 없으므로 Decoder 는 Message 끝 너머까지 복사할 수 있는데, 이 크기이면
+ * Encoder 의 Ring Buffer 크기와 관계없이 아직 참조하는 이전 Message 를 덮지 않습니다. (lz4.h 의 Ring Buffer 규칙)
+ * 양쪽은 각자의 Ring Buffer 에서 남은 공간이 maxMessageSize 보다 작으면 처음으로 돌아가며,
+ * maxMessageSize, dictionary 가 양쪽에서 같아야 합니다.
+ * Block 에는 크기 정보가 없으므로 압축된 Message 의 크기는 전송 계층 (Packet 길이 등) 이 전달해야 합니다.
+ *
+ * Message 는 보낸 순서대로 빠짐없이 풀어야 합니다. 한쪽에서 실패하거나 Message 를 잃으면
+ * 양쪽 모두 reset 하여 (사전만 남은) 처음 상태로 돌아가야 합니다.
+ */
+
+#define MSG_HISTORY_SIZE         (64 * 1024) // LZ4 가 참조할 수 있는 최대 거리 (사전 크기 최대값)
+#define MSG_DEFAULT_MAX_MESSAGE  4096        // Message 크기 최대값 기본값
+#define MSG_DEFAULT_ACCELERATION 1           // LZ4_compress_fast_continue 의 Acceleration 기본값
+
+// 구조체 선언
+
+typedef struct MSG_Options_s MSG_Options_t;
+typedef struct MSG_Encoder_s MSG_Encoder_t;
+typedef struct MSG_Decoder_s MSG_Decoder_t;
+
+/*
+ * Message Stream 옵션. 0 으로 초기화하면 기본값을 사용합니다. (maxMessageSize, dictionary 는 양쪽이 같아야 함)
+ */
+struct MSG_Options_s {
+    DWORD maxMessageSize;     // Message 크기 최대값 (0 이면 MSG_DEFAULT_MAX_MESSAGE)
+    DWORD ringSize;           // Encoder: Ring Buffer 크기 (0 이면 MSG_HISTORY_SIZE + maxMessageSize)
+                              // 작을수록 메모리가 적고 참조할 수 있는 이전 Message 가 줄어듦 (Decoder 는 사용하지 않음)
+    int acceleration;         // Encoder: 클수록 빠르고 압축률이 낮아짐 (0 이면 MSG_DEFAULT_ACCELERATION)
+    const void* dictionary;   // 첫 Message 부터 참조할 사전 (NULL 이면 없음, MSG_HISTORY_SIZE 보다 크면 뒷부분만 사용)
+    size_t dictionarySize;    // 사전 크기
+};
+
+struct MSG_Encoder_s {
+    LZ4_stream_t* stream;     // LZ4 Streaming 압축 상태
+    BYTE* ring;               // 이전 Message 를 남겨 두는 Ring Buffer
+    DWORD ringSize;           // Ring Buffer 크기
+    DWORD ringPos;            // 다음 Message 를 놓을 위치
+    DWORD maxMessageSize;     // Message 크기 최대값
+    int acceleration;         // Acceleration (Message 마다 바꿀 수 있음)
+    BYTE* dictionary;         // reset 할 때 다시 넣는 사전 (복사본)
+    DWORD dictionarySize;     // 사전 크기
+};
+
+struct MSG_Decoder_s {
+    LZ4_streamDecode_t* stream; // LZ4 Streaming 압축 해제 상태
+    BYTE* ring;               // 푼 Message 를 남겨 두는 Ring Buffer (LZ4_decoderRingBufferSize(maxMessageSize))
+    DWORD ringSize;           // Ring Buffer 크기
+    DWORD ringPos;            // 다음 Message 를 풀 위치
+    DWORD maxMessageSize;     // Message 크기 최대값
+    BYTE* dictionary;         // reset 할 때 다시 넣는 사전 (복사본)
+    DWORD dictionarySize;     // 사전 크기
+};
+
+// 함수 선언
+
+size_t msg_compress_bound(size_t messageSize);
+
+BOOL msg_encoder_create(MSG_Encoder_t** encoder, const MSG_Options_t* options);
+void msg_encoder_free(MSG_Encoder_t* encoder);
+void msg_encoder_reset(MSG_Encoder_t* encoder);
+BOOL msg_encode(
+    MSG_Encoder_t* encoder, const void* src, size_t srcSize,
+    void* dst, size_t dstCapacity, size_t* pDstSize
+);
+
+BOOL msg_decoder_create(MSG_Decoder_t** decoder, const MSG_Options_t* options);
+void msg_decoder_free(MSG_Decoder_t* decoder);
+void msg_decoder_reset(MSG_Decoder_t* decoder);
+BOOL msg_decode(
+    MSG_Decoder_t* decoder, const void* src, size_t srcSize,
+    void* dst, size_t dstCapacity, size_t* pDstSize
+);
+
+#endif // MSG_STREAM_H
@@ -0,0 +1,361 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pipeline.h"
+#include "utility.h"
+
+/**
+ * @brief Ring 에 Chunk 를 넣습니다. (생산자 Thread 에서 호출)
+ *
+ * Ring 의 크기가 돌고 있는 Chunk 수 이상이므로 항상 자리가 있습니다.
+ */
+static void pipe_push(PIPE_Ring_t* ring, PIPE_Chunk_t* chunk) {
+    LONG const tail = ring->tail;
+    ring->slots[tail % PIPE_MAX_DEPTH] = chunk;
+    InterlockedExchange(&(ring->tail), tail + 1); // Slot 내용이 tail 보다 먼저 보이도록 (Full Barrier)
+
+    if (InterlockedExchange(&(ring->bWaiting), FALSE)) {
+        SetEvent(ring->hEvent);
+    }
+}
+
+/**
+ * @brief Ring 에서 Chunk 를 꺼냅니다. 비어 있으면 잠시 Spin 한 뒤 들어올 때까지 잠듭니다. (소비자 Thread 에서 호출)
+ *
+ * @param pipe Pipeline 컨텍스트
+ * @param ring 꺼낼 Ring
+ * @param pStallMicros 잠들어 기다린 시간을 더할 곳
+ * @return 꺼낸 Chunk, 중단 요청이 있으면 NULL
+ */
+static PIPE_Chunk_t* pipe_pop(PIPE_Context_t* pipe, PIPE_Ring_t* ring, ULONGLONG* pStallMicros) {
+    LONG const head = ring->head;
+    ULONGLONG start = 0;
+
+    for (int spin = 0; ring->tail == head; spin++) {
+        if (pipe->bAbort) {
+            return NULL;
+        }
+        if (spin < PIPE_SPIN_COUNT) {
+            YieldProcessor();
+            continue;
+        }
+
+        // 잠들기 전에 bWaiting 을 알리고 다시 확인 (그 사이에 들어온 Chunk 를 놓치지 않도록)
+        if (start == 0) {
+            start = now_micros();
+        }
+        InterlockedExchange(&(ring->bWaiting), TRUE);
+        if (ring->tail == head && !pipe->bAbort) {
+            WaitForSingleObject(ring->hEvent, INFINITE);
+        }
+        InterlockedExchange(&(ring->bWaiting), FALSE);
+    }
+    if (start != 0) {
+        *pStallMicros += now_micros() - start;
+    }
+
+    PIPE_Chunk_t* const chunk = ring->slots[head % PIPE_MAX_DEPTH];
+    InterlockedExchange(&(ring->head), head + 1);
+    return chunk;
+}
+
+/**
+ * @brief 읽기 또는 쓰기 실패를 기록합니다. 압축 Thread 는 다음 Chunk 를 받을 때 실패를 확인합니다.
+ */
+static void pipe_fail(PIPE_Context_t* pipe, const TCHAR* message) {
+    log_message(message);
+    InterlockedExchange(&(pipe->bFailed), TRUE);
+}
+
+/**
+ * @brief 읽기 Thread: 빈 Chunk 에 입력을 읽어 압축 Thread 로 보냅니다. EOF 를 읽은 Chunk 가 마지막입니다.
+ */
+static DWORD WINAPI pipe_reader_thread(LPVOID param) {
+    PIPE_Context_t* const pipe = (PIPE_Context_t*)param;
+    OVERLAPPED overlap = { 0, };
+    ULONGLONG offset = 0;
+    DWORD dwBytesRead;
+
+    for (;;) {
+        PIPE_Chunk_t* const chunk = pipe_pop(pipe, &(pipe->inFree), &(pipe->stats.readerStallMicros));
+        if (chunk == NULL) {
+            break; // 중단 요청
+        }
+
+        async_set_offset(&overlap, offset);
+        if (!async_read_ex(pipe->hInput, chunk->data, pipe->readSize, &dwBytesRead, &overlap, TRUE, pipe->throttle)) {
+            pipe_fail(pipe, "Pipeline - read failed.");
+            dwBytesRead = 0;
+        }
+        offset += dwBytesRead;
+
+        chunk->size = dwBytesRead;
+        chunk->bLast = (dwBytesRead < pipe->readSize) || pipe->bFailed;
+        pipe->stats.readChunks++;
+        pipe_push(&(pipe->inFull), chunk);
+        if (chunk->bLast) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 출력 Chunk 하나를 씁니다. Staging 을 사용하면 Staging 에 모으고, 마지막 Chunk 이면 Staging 을 마무리합니다.
+ */
+static BOOL pipe_write_chunk(PIPE_Context_t* pipe, const PIPE_Chunk_t* chunk, OVERLAPPED* overlap, ULONGLONG* offset) {
+    DWORD dwBytesWritten;
+
+    if (pipe->stage != NULL) {
+        io_stage_add_input(pipe->stage, chunk->inputBytes);
+        if (chunk->size > 0 && !io_stage_write(pipe->stage, chunk->data, chunk->size)) {
+            return FALSE;
+        }
+        return !chunk->bLast || io_stage_finish(pipe->stage);
+    }
+
+    if (chunk->size == 0) {
+        return TRUE;
+    }
+    async_set_offset(overlap, *offset);
+    if (!async_write_ex(pipe->hOutput, chunk->data, (DWORD)chunk->size, &dwBytesWritten, overlap, TRUE, pipe->throttle)) {
+        return FALSE;
+    }
+    *offset += dwBytesWritten;
+    return TRUE;
+}
+
+/**
+ * @brief 쓰기 Thread: 압축 결과 Chunk 를 순서대로 쓰고 빈 Chunk 를 압축 Thread 로 돌려줍니다.
+ *
+ * 실패한 뒤에도 압축 Thread 가 기다리지 않도록, 중단 요청이나 마지막 Chunk 까지 Chunk 를 돌려주기만 합니다.
+ */
+static DWORD WINAPI pipe_writer_thread(LPVOID param) {
+    PIPE_Context_t* const pipe = (PIPE_Context_t*)param;
+    OVERLAPPED overlap = { 0, };
+    ULONGLONG offset = 0;
+
+    for (;;) {
+        PIPE_Chunk_t* const chunk = pipe_pop(pipe, &(pipe->outFull), &(pipe->stats.writerStallMicros));
+        if (chunk == NULL) {
+            break; // 중단 요청
+        }
+
+        if (!pipe->bFailed && !pipe_write_chunk(pipe, chunk, &overlap, &offset)) {
+            pipe_fail(pipe, "Pipeline - write failed.");
+        }
+
+        BOOL const bLast = chunk->bLast;
+        pipe->stats.writeChunks++;
+        pipe_push(&(pipe->outFree), chunk);
+        if (bLast) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Pipeline 의 자원을 해제합니다. (Thread 가 모두 끝난 뒤 호출)
+ */
+static void pipe_free(PIPE_Context_t* pipe) {
+    PIPE_Ring_t* const rings[] = { &(pipe->inFree), &(pipe->inFull), &(pipe->outFree), &(pipe->outFull) };
+    for (int i = 0; i < 4; i++) {
+        if (rings[i]->hEvent != NULL) {
+            CloseHandle(rings[i]->hEvent);
+        }
+    }
+
+    if (pipe->chunks != NULL) {
+        for (DWORD i = 0; i < pipe->depth * 2; i++) {
+            async_free_aligned(pipe->chunks[i].data);
+        }
+        free(pipe->chunks);
+    }
+    free(pipe);
+}
+
+/**
+ * @brief Chunk 와 Ring 을 준비하고 읽기 Thread 와 쓰기 Thread 를 시작합니다.
+ *
+ * @param hInput 입력 핸들 (처음부터 읽음)
+ * @param hOutput 출력 핸들 (stage 가 NULL 일 때 처음부터 씀)
+ * @param readSize 한 번에 읽는 크기 (Direct I/O 이면 Sector 크기의 배수)
+ * @param outputChunkSize 출력 Chunk 크기
+ * @param depth 방향별 Chunk 수 (0 이면 PIPE_DEFAULT_DEPTH, 최대 PIPE_MAX_DEPTH)
+ * @param stage 출력 Staging (NULL 허용, 쓰기 Thread 만 사용하며 마지막 Chunk 를 쓴 뒤 io_stage_finish 까지 진행)
+ * @param throttle I/O 제한 (NULL 이면 제한 없음)
+ * @return Pipeline 컨텍스트, 실패 시 NULL
+ */
+PIPE_Context_t* pipe_start(
+    HANDLE hInput, HANDLE hOutput, DWORD readSize, size_t outputChunkSize, DWORD depth,
+    IO_Stage_t* stage, IO_Throttle_t* throttle
+) {
+    if (depth == 0) {
+        depth = PIPE_DEFAULT_DEPTH;
+    }
+    if (depth > PIPE_MAX_DEPTH) {
+        log_message("Invalid pipeline depth.");
+        return NULL;
+    }
+
+    PIPE_Context_t* const pipe = (PIPE_Context_t*)calloc(1, sizeof(PIPE_Context_t));
+    if (pipe == NULL) {
+        return NULL;
+    }
+    pipe->hInput = hInput;
+    pipe->hOutput = hOutput;
+    pipe->stage = stage;
+    pipe->throttle = throttle;
+    pipe->readSize = readSize;
+    pipe->depth = depth;
+
+    // 1. Ring 과 Chunk (처음에는 모두 빈 Chunk Ring 에 있음)
+    BOOL bReady = TRUE;
+    PIPE_Ring_t* const rings[] = { &(pipe->inFree), &(pipe->inFull), &(pipe->outFree), &(pipe->outFull) };
+    for (int i = 0; i < 4; i++) {
+        rings[i]->hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+        bReady = bReady && (rings[i]->hEvent != NULL);
+    }
+
+    pipe->chunks = (PIPE_Chunk_t*)calloc(depth * 2, sizeof(PIPE_Chunk_t));
+    bReady = bReady && (pipe->chunks != NULL);
+    for (DWORD i = 0; bReady && i < depth * 2; i++) {
+        PIPE_Chunk_t* const chunk = &(pipe->chunks[i]);
+        chunk->capacity = (i < depth) ? readSize : outputChunkSize;
+        chunk->data = (BYTE*)async_alloc_aligned(chunk->capacity);
+        if (chunk->data == NULL) {
+            bReady = FALSE;
+            break;
+        }
+        pipe_push((i < depth) ? &(pipe->inFree) : &(pipe->outFree), chunk);
+    }
+
+    // 2. Thread 시작
+    if (bReady) {
+        pipe->hReader = CreateThread(NULL, 0, pipe_reader_thread, pipe, 0, NULL);
+        pipe->hWriter = CreateThread(NULL, 0, pipe_writer_thread, pipe, 0, NULL);
+        if (pipe->hReader != NULL && pipe->hWriter != NULL) {
+            return pipe;
+        }
+        pipe_finish(pipe, TRUE, NULL); // 시작한 Thread 를 멈추고 해제
+        return NULL;
+    }
+
+    log_message("Failed to start pipeline.");
+    pipe_free(pipe);
+    return NULL;
+}
+
+/**
+ * @brief 읽은 Chunk 를 받습니다. 읽기가 늦으면 기다립니다. (압축 Thread 에서 호출)
+ *
+ * @param pipe Pipeline 컨텍스트
+ * @return 읽은 Chunk (bLast 이면 EOF), 읽기나 쓰기가 실패했으면 NULL
+ */
+PIPE_Chunk_t* pipe_next_input(PIPE_Context_t* pipe) {
+    PIPE_Chunk_t* const chunk = pipe_pop(pipe, &(pipe->inFull), &(pipe->stats.inputStallMicros));
+    if (chunk != NULL && pipe->bFailed) {
+        pipe_push(&(pipe->inFree), chunk);
+        return NULL;
+    }
+    return chunk;
+}
+
+/**
+ * @brief 압축을 마친 읽기 Chunk 를 읽기 Thread 로 돌려줍니다. (압축 Thread 에서 호출)
+ */
+void pipe_release_input(PIPE_Context_t* pipe, PIPE_Chunk_t* chunk) {
+    pipe_push(&(pipe->inFree), chunk);
+}
+
+/**
+ * @brief 압축 결과를 담을 빈 출력 Chunk 를 받습니다. 쓰기가 늦으면 기다립니다. (압축 Thread 에서 호출)
+ *
+ * @param pipe Pipeline 컨텍스트
+ * @return 빈 출력 Chunk, 읽기나 쓰기가 실패했으면 NULL
+ */
+PIPE_Chunk_t* pipe_get_output(PIPE_Context_t* pipe) {
+    PIPE_Chunk_t* const chunk = pipe_pop(pipe, &(pipe->outFree), &(pipe->stats.outputStallMicros));
+    if (chunk == NULL) {
+        return NULL;
+    }
+    if (pipe->bFailed) {
+        pipe_push(&(pipe->outFree), chunk);
+        return NULL;
+    }
+
+    chunk->size = 0;
+    chunk->inputBytes = 0;
+    chunk->bLast = FALSE;
+    return chunk;
+}
+
+/**
+ * @brief 압축 결과 Chunk 를 쓰기 Thread 로 보냅니다. bLast 인 Chunk 를 보내면 쓰기 Thread 가 끝납니다. (압축 Thread 에서 호출)
+ */
+void pipe_submit_output(PIPE_Context_t* pipe, PIPE_Chunk_t* chunk) {
+    pipe_push(&(pipe->outFull), chunk);
+}
+
+/**
+ * @brief 쓰기 Thread 에 보냈지만 아직 다 쓰지 않은 출력 Chunk 수를 구합니다. (쓰기가 밀린 정도)
+ */
+DWORD pipe_pending_output(const PIPE_Context_t* pipe) {
+    return (DWORD)(pipe->outFull.tail - pipe->outFull.head);
+}
+
+/**
+ * @brief Thread 가 끝날 때까지 기다리고 Pipeline 을 해제합니다.
+ *
+ * 정상 종료이면 bLast 인 출력 Chunk 를 보낸 뒤 호출하며, 쓰기 Thread 는 그 Chunk 까지 쓰고 끝납니다.
+ * bAbort 이면 기다리는 Thread 를 모두 깨워 바로 끝냅니다.
+ *
+ * @param pipe Pipeline 컨텍스트 (NULL 허용)
+ * @param bAbort 중단 여부
+ * @param stats 통계 (NULL 허용)
+ * @return 읽기와 쓰기가 모두 성공했고 중단하지 않았으면 TRUE
+ */
+BOOL pipe_finish(PIPE_Context_t* pipe, BOOL bAbort, PIPE_Stats_t* stats) {
+    if (pipe == NULL) {
+        return FALSE;
+    }
+
+    if (bAbort) {
+        InterlockedExchange(&(pipe->bAbort), TRUE);
+        SetEvent(pipe->inFree.hEvent);
+        SetEvent(pipe->inFull.hEvent);
+        SetEvent(pipe->outFree.hEvent);
+        SetEvent(pipe->outFull.hEvent);
+    }
+
+    HANDLE const threads[] = { pipe->hReader, pipe->hWriter };
+    for (int i = 0; i < 2; i++) {
+        if (threads[i] != NULL) {
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        }
+    }
+
+    BOOL const bResult = !bAbort && !pipe->bFailed;
+    if (stats != NULL) {
+        *stats = pipe->stats;
+    }
+    pipe_free(pipe);
+    return bResult;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <windows.h>
+
+#include "asyncio_win.h"
+#include "compressor.h"
+#include "io_stage.h"
+
+/*
+ * 읽기 / 압축 / 쓰기 Pipeline
+ *
+ * 읽기 Thread 와 쓰기 Thread 를 따로 두고, 압축하는 Thread (호출한 Thread) 와 Chunk 버퍼를 주고받습니다.
+ * Chunk 는 미리 할당한 것을 돌려 쓰며, 각 방향은 생산자와 소비자가 하나씩인 Lock-Free Ring (SPSC) 으로 전달합니다.
+ *
+ *   읽기 Thread --(inFull)--> 압축 Thread --(outFull)--> 쓰기 Thread
+ *        ^------(inFree)--------'   ^--------(outFree)--------'
+ *
+ * Ring 의 크기는 Chunk 수 이상이므로 넣기는 항상 성공하고, 빈 Chunk 가 없으면 꺼내는 쪽이 기다립니다. (Back-Pressure)
+ * 압축 Thread 는 I/O 를 기다리지 않으며, 읽은 Chunk 가 없거나 빈 출력 Chunk 가 없을 때만 기다립니다.
+ * 기다릴 때는 잠시 Spin 한 뒤 Event 로 잠들고, 기다린 시간은 Stage 별로 기록하여 병목을 알 수 있게 합니다.
+ */
+
+#define PIPE_DEFAULT_DEPTH      4            // 방향별 Chunk 수 기본값
+#define PIPE_MAX_DEPTH          64           // 방향별 Chunk 수 최대값
+#define PIPE_DEFAULT_CHUNK_SIZE (256 * 1024) // 읽기 Chunk 와 출력 Chunk 의 기본 크기
+#define PIPE_SPIN_COUNT         256          // 잠들기 전에 Ring 을 다시 확인하는 횟수
+
+// 구조체 선언
+
+typedef struct PIPE_Chunk_s PIPE_Chunk_t;
+typedef struct PIPE_Ring_s PIPE_Ring_t;
+typedef struct PIPE_Context_s PIPE_Context_t;
+
+struct PIPE_Stats_s { // PIPE_Stats_t (compressor.h 에서 선언)
+    ULONGLONG readChunks;          // 읽은 Chunk 수
+    ULONGLONG writeChunks;         // 쓴 Chunk 수
+    ULONGLONG readerStallMicros;   // 읽기 Thread 가 빈 Chunk 를 기다린 시간 (압축이 느림)
+    ULONGLONG inputStallMicros;    // 압축 Thread 가 읽은 Chunk 를 기다린 시간 (읽기가 느림)
+    ULONGLONG outputStallMicros;   // 압축 Thread 가 빈 출력 Chunk 를 기다린 시간 (쓰기가 느림)
+    ULONGLONG writerStallMicros;   // 쓰기 Thread 가 출력 Chunk 를 기다린 시간 (압축이 느림)
+};
+
+struct PIPE_Chunk_s {
+    BYTE* data;               // 버퍼 (Direct I/O 를 위해 정렬)
+    size_t capacity;          // 버퍼 크기
+    size_t size;              // 채운 크기
+    ULONGLONG inputBytes;     // 출력 Chunk: 이 Chunk 를 채우는 동안 압축한 원본 크기 (미리 할당의 압축률 추정용)
+    BOOL bLast;               // 마지막 Chunk (읽기: EOF, 출력: 압축 끝)
+};
+
+/*
+ * 생산자와 소비자가 하나씩인 Lock-Free Ring
+ *
+ * tail 은 생산자만, head 는 소비자만 바꾸며 Interlocked 함수로 갱신하여 Slot 내용이 먼저 보이도록 합니다.
+ * 소비자가 잠들기 전에 bWaiting 을 설정하고, 생산자는 넣은 뒤 bWaiting 이 설정되어 있으면 깨웁니다.
+ */
+struct PIPE_Ring_s {
+    PIPE_Chunk_t* slots[PIPE_MAX_DEPTH]; // Chunk 포인터
+    volatile LONG head;        // 다음에 꺼낼 위치 (소비자)
+    volatile LONG tail;        // 다음에 넣을 위치 (생산자)
+    volatile LONG bWaiting;    // 소비자가 잠들었거나 잠들려는 중
+    HANDLE hEvent;             // 소비자를 깨우는 Event (Auto-Reset)
+};
+
+struct PIPE_Context_s {
+    HANDLE hInput;             // 입력 핸들 (읽기 Thread 만 사용)
+    HANDLE hOutput;            // 출력 핸들 (쓰기 Thread 만 사용)
+    IO_Stage_t* stage;         // 출력 Staging (NULL 이면 Chunk 마다 바로 씀, 쓰기 Thread 만 사용)
+    IO_Throttle_t* throttle;   // I/O 제한 (NULL 이면 제한 없음)
+    DWORD readSize;            // 한 번에 읽는 크기
+    DWORD depth;               // 방향별 Chunk 수
+
+    PIPE_Ring_t inFree;        // 빈 읽기 Chunk (압축 -> 읽기)
+    PIPE_Ring_t inFull;        // 읽은 Chunk (읽기 -> 압축)
+    PIPE_Ring_t outFree;       // 빈 출력 Chunk (쓰기 -> 압축)
+    PIPE_Ring_t outFull;       // 압축 결과 Chunk (압축 -> 쓰기)
+    PIPE_Chunk_t* chunks;      // 모든 Chunk (읽기 depth 개, 출력 depth 개)
+
+    HANDLE hReader;            // 읽기 Thread
+    HANDLE hWriter;            // 쓰기 Thread
+    volatile LONG bFailed;     // 읽기 또는 쓰기 실패
+    volatile LONG bAbort;      // 중단 요청 (기다리는 Thread 를 모두 깨움)
+    PIPE_Stats_t stats;        // 통계 (각 항목은 한 Thread 만 갱신)
+};
+
+// 함수 선언
+
+PIPE_Context_t* pipe_start(
+    HANDLE hInput, HANDLE hOutput, DWORD readSize, size_t outputChunkSize, DWORD depth,
+    IO_Stage_t* stage, IO_Throttle_t* throttle
+);
+PIPE_Chunk_t* pipe_next_input(PIPE_Context_t* pipe);
+void pipe_release_input(PIPE_Context_t* pipe, PIPE_Chunk_t* chunk);
+PIPE_Chunk_t* pipe_get_output(PIPE_Context_t* pipe);
+void pipe_submit_output(PIPE_Context_t* pipe, PIPE_Chunk_t* chunk);
+DWORD pipe_pending_output(const PIPE_Context_t* pipe);
+BOOL pipe_finish(PIPE_Context_t* pipe, BOOL bAbort, PIPE_Stats_t* stats);
+
+#endif // PIPELINE_H
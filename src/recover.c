@@ -0,0 +1,347 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "recover.h"
+#include "asyncio_win.h"
+#include "decompressor.h"
+#include "utility.h"
+
+#define RECOVER_LZ4_BLOCK_MAX (4 * 1024 * 1024) // LZ4 Frame 의 최대 Block 크기 (LZ4F_max4MB)
+
+// 순차 읽기 Scanner (Frame/Block Header 만 읽고 Block 내용은 건너뜀)
+typedef struct {
+    HANDLE hFile;           // 검사할 파일 핸들
+    ULONGLONG fileSize;     // 파일 크기
+    ULONGLONG pos;          // 현재 위치
+    BYTE* buf;              // 읽기 버퍼
+    DWORD bufLen;           // 읽기 버퍼에 읽힌 크기
+    ULONGLONG bufOffset;    // 읽기 버퍼 시작의 파일 내 위치
+} RecoverScanner;
+
+/**
+ * @brief 현재 위치에서 n bytes 를 읽어 그 시작 주소를 반환합니다. 파일 끝을 넘으면 NULL 을 반환합니다.
+ */
+static const BYTE* scanner_peek(RecoverScanner* scanner, DWORD n) {
+    if (scanner->pos + n > scanner->fileSize) {
+        return NULL;
+    }
+
+    if (scanner->pos < scanner->bufOffset || scanner->pos + n > scanner->bufOffset + scanner->bufLen) {
+        OVERLAPPED overlap = { 0, };
+        ULONGLONG const remaining = scanner->fileSize - scanner->pos;
+        DWORD const toRead = (DWORD)(remaining < RECOVER_READ_SIZE ? remaining : RECOVER_READ_SIZE);
+        DWORD dwBytesRead = 0;
+
+        async_set_offset(&overlap, scanner->pos);
+        if (!async_read(scanner->hFile, scanner->buf, toRead, &dwBytesRead, &overlap, TRUE) || dwBytesRead < n) {
+            return NULL;
+        }
+
+        scanner->bufOffset = scanner->pos;
+        scanner->bufLen = dwBytesRead;
+    }
+
+    return scanner->buf + (size_t)(scanner->pos - scanner->bufOffset);
+}
+
+/**
+ * @brief 현재 위치를 n bytes 건너뜁니다. 파일 끝을 넘으면 FALSE 를 반환합니다.
+ */
+static BOOL scanner_skip(RecoverScanner* scanner, ULONGLONG n) {
+    if (scanner->pos + n > scanner->fileSize) {
+        return FALSE;
+    }
+    scanner->pos += n;
+    return TRUE;
+}
+
+/**
+ * @brief Skippable Frame 을 건너뜁니다. (LZ4, ZSTD 공통 형식)
+ */
+static BOOL scan_skippable_frame(RecoverScanner* scanner) {
+    const BYTE* const header = scanner_peek(scanner, 8);
+    return header != NULL && scanner_skip(scanner, 8 + (ULONGLONG)read_le32(header + 4));
+}
+
+/**
+ * @brief LZ4 Frame 하나의 끝까지 Block Header 를 따라갑니다.
+ *
+ * @return Frame 이 완결되어 있으면 TRUE (현재 위치는 Frame 끝), 잘렸거나 손상되었으면 FALSE
+ */
+static BOOL scan_lz4_frame(RecoverScanner* scanner) {
+    const BYTE* header = scanner_peek(scanner, 7);
+    if (header == NULL) {
+        return FALSE;
+    }
+
+    BYTE const flg = header[4];
+    if ((flg >> 6) != 1 || (flg & 0x02) != 0) {
+        return FALSE; // 지원하지 않는 Version 또는 예약 Bit 사용
+    }
+    BOOL const bBlockChecksum = (flg >> 4) & 1;
+    BOOL const bContentSize = (flg >> 3) & 1;
+    BOOL const bContentChecksum = (flg >> 2) & 1;
+    BOOL const bDictId = flg & 1;
+
+    if (!scanner_skip(scanner, 4 + 2 + (bContentSize ? 8 : 0) + (bDictId ? 4 : 0) + 1)) {
+        return FALSE;
+    }
+
+    for (;;) {
+        const BYTE* const blockHeader = scanner_peek(scanner, 4);
+        if (blockHeader == NULL) {
+            return FALSE;
+        }
+
+        DWORD const value = read_le32(blockHeader);
+        if (value == 0) { // End Mark
+            return scanner_skip(scanner, 4 + (bContentChecksum ? 4 : 0));
+        }
+
+        DWORD const blockSize = value & 0x7FFFFFFF;
+        if (blockSize > RECOVER_LZ4_BLOCK_MAX) {
+            return FALSE;
+        }
+        if (!scanner_skip(scanner, 4 + (ULONGLONG)blockSize + (bBlockChecksum ? 4 : 0))) {
+            return FALSE;
+        }
+    }
+}
+
+/**
+ * @brief ZSTD Frame 하나의 끝까지 Block Header 를 따라갑니다.
+ *
+ * @return Frame 이 완결되어 있으면 TRUE (현재 위치는 Frame 끝), 잘렸거나 손상되었으면 FALSE
+ */
+static BOOL scan_zstd_frame(RecoverScanner* scanner) {
+    static const DWORD kDictIdSize[4] = { 0, 1, 2, 4 };
+    static const DWORD kContentSizeSize[4] = { 0, 2, 4, 8 };
+
+    const BYTE* header = scanner_peek(scanner, 5);
+    if (header == NULL) {
+        return FALSE;
+    }
+
+    BYTE const fhd = header[4];
+    if ((fhd & 0x08) != 0) {
+        return FALSE; // 예약 Bit 사용
+    }
+    BOOL const bSingleSegment = (fhd >> 5) & 1;
+    BOOL const bChecksum = (fhd >> 2) & 1;
+    DWORD const fcsFlag = fhd >> 6;
+    DWORD const contentSizeSize = (fcsFlag == 0 && bSingleSegment) ? 1 : kContentSizeSize[fcsFlag];
+
+    if (!scanner_skip(scanner, 4 + 1 + (bSingleSegment ? 0 : 1) + kDictIdSize[fhd & 3] + contentSizeSize)) {
+        return FALSE;
+    }
+
+    for (;;) {
+        const BYTE* const blockHeader = scanner_peek(scanner, 3);
+        if (blockHeader == NULL) {
+            return FALSE;
+        }
+
+        DWORD const value = (DWORD)blockHeader[0] | ((DWORD)blockHeader[1] << 8) | ((DWORD)blockHeader[2] << 16);
+        BOOL const bLastBlock = value & 1;
+        DWORD const blockType = (value >> 1) & 3;
+        DWORD const blockSize = value >> 3;
+
+        if (blockType == 3 || blockSize > ZSTD_BLOCKSIZE_MAX) {
+            return FALSE; // 예약된 Block 형식 또는 잘못된 크기
+        }
+        if (!scanner_skip(scanner, 3 + (blockType == 1 ? 1 : (ULONGLONG)blockSize))) { // RLE Block 은 1 byte
+            return FALSE;
+        }
+        if (bLastBlock) {
+            return scanner_skip(scanner, bChecksum ? 4 : 0);
+        }
+    }
+}
+
+/**
+ * @brief 압축 해제 없이 Frame 을 따라가며, 완결된 마지막 Frame 의 끝 위치를 찾습니다.
+ *
+ * 이어 붙인 LZ4/ZSTD Frame 과 Skippable Frame 을 인식하며, 잘렸거나 알 수 없는 데이터를 만나면 멈춥니다.
+ *
+ * @param filePath 검사할 파일 경로
+ * @param result 검사 결과
+ * @return 파일을 읽을 수 있으면 TRUE (완결된 Frame 이 없어도 TRUE)
+ */
+BOOL recover_scan(const TCHAR* filePath, RECOVER_Result_t* result) {
+    RecoverScanner scanner = { 0, };
+    LARGE_INTEGER fileSize;
+    BOOL bAlgorithmKnown = FALSE;
+
+    memset(result, 0, sizeof(RECOVER_Result_t));
+
+    scanner.hFile = init_file_read(filePath);
+    if (scanner.hFile == INVALID_HANDLE_VALUE) {
+        return FALSE;
+    }
+
+    scanner.buf = (BYTE*)malloc(RECOVER_READ_SIZE);
+    if (scanner.buf == NULL || !GetFileSizeEx(scanner.hFile, &fileSize)) {
+        free(scanner.buf);
+        CloseHandle(scanner.hFile);
+        return FALSE;
+    }
+    scanner.fileSize = (ULONGLONG)fileSize.QuadPart;
+    result->fileSize = scanner.fileSize;
+
+    for (;;) {
+        const BYTE* const magicPtr = scanner_peek(&scanner, 4);
+        if (magicPtr == NULL) {
+            break;
+        }
+
+        DWORD const magic = read_le32(magicPtr);
+        BOOL bComplete;
+        if ((magic & ZSTD_MAGIC_SKIPPABLE_MASK) == ZSTD_MAGIC_SKIPPABLE_START) {
+            bComplete = scan_skippable_frame(&scanner);
+        } else if (magic == LZ4F_MAGICNUMBER || magic == ZSTD_MAGICNUMBER) {
+            CompressionAlgorithm const algorithm = (magic == LZ4F_MAGICNUMBER) ? LZ4 : ZSTD;
+            if (!bAlgorithmKnown) {
+                result->algorithm = algorithm;
+                bAlgorithmKnown = TRUE;
+            } else if (algorithm != result->algorithm) {
+                break; // 한 파일에 섞인 알고리듬은 지원하지 않음
+            }
+            bComplete = (algorithm == LZ4) ? scan_lz4_frame(&scanner) : scan_zstd_frame(&scanner);
+        } else {
+            break; // 알 수 없는 데이터 (미리 할당된 영역, 손상 등)
+        }
+
+        if (!bComplete) {
+            break;
+        }
+
+        result->frameCount++;
+        result->validBytes = scanner.pos;
+    }
+
+    free(scanner.buf);
+    CloseHandle(scanner.hFile);
+    return TRUE;
+}
+
+/**
+ * @brief 파일을 마지막 완결된 Frame 의 끝에서 잘라, 일반 Decoder 로 읽을 수 있게 만듭니다.
+ *
+ * 압축 해제 없이 Header 검사와 파일 크기 변경만 수행합니다.
+ *
+ * @param filePath 복구할 파일 경로
+ * @param result 검사 결과
+ * @return 성공 여부
+ */
+BOOL recover_truncate(const TCHAR* filePath, RECOVER_Result_t* result) {
+    if (!recover_scan(filePath, result)) {
+        return FALSE;
+    }
+    if (result->validBytes == result->fileSize) {
+        return TRUE; // 잘린 부분 없음
+    }
+
+    HANDLE hFile = CreateFile(filePath, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        log_message("Failed to open file for truncation.");
+        return FALSE;
+    }
+
+    LARGE_INTEGER position;
+    position.QuadPart = (LONGLONG)result->validBytes;
+    BOOL const bResult = SetFilePointerEx(hFile, position, NULL, FILE_BEGIN) && SetEndOfFile(hFile);
+    CloseHandle(hFile);
+
+    if (!bResult) {
+        log_message("Failed to truncate file.");
+    }
+    return bResult;
+}
+
+/**
+ * @brief 마지막 완결된 Frame 까지를 압축 해제하여 다른 파일로 저장합니다.
+ *
+ * @param filePath 복구할 압축 파일 경로
+ * @param outputFilePath 복구한 원본을 저장할 파일 경로
+ * @param result 검사 결과 (restoredBytes 포함)
+ * @return 성공 여부
+ */
+BOOL recover_extract(const TCHAR* filePath, const TCHAR* outputFilePath, RECOVER_Result_t* result) {
+    if (!recover_scan(filePath, result)) {
+        return FALSE;
+    }
+
+    HANDLE hInput = init_file_read(filePath);
+    HANDLE hOutput = init_file_write(outputFilePath);
+    DECOMP_Context_t* decomp = NULL;
+    BYTE* const srcBuf = (BYTE*)malloc(RECOVER_READ_SIZE);
+    BYTE* const dstBuf = (BYTE*)malloc(RECOVER_READ_SIZE);
+
+    BOOL bResult = hInput != INVALID_HANDLE_VALUE && hOutput != INVALID_HANDLE_VALUE && srcBuf && dstBuf;
+    if (bResult && result->frameCount > 0) {
+        bResult = create_decompressor(&decomp, result->algorithm);
+    }
+
+    OVERLAPPED readOverlap = { 0, }, writeOverlap = { 0, };
+    ULONGLONG readOffset = 0;
+    while (bResult && readOffset < result->validBytes) {
+        ULONGLONG const remaining = result->validBytes - readOffset;
+        DWORD const toRead = (DWORD)(remaining < RECOVER_READ_SIZE ? remaining : RECOVER_READ_SIZE);
+        DWORD dwBytesRead = 0;
+
+        async_set_offset(&readOverlap, readOffset);
+        if (!async_read(hInput, srcBuf, toRead, &dwBytesRead, &readOverlap, TRUE) || dwBytesRead != toRead) {
+            bResult = FALSE;
+            break;
+        }
+        readOffset += dwBytesRead;
+
+        // 이어 붙인 Frame 은 두 Decoder 모두 Frame 이 끝나면 다음 Frame 을 이어서 해제
+        // 출력 버퍼를 가득 채운 경우 Decoder 내부에 남은 출력이 있을 수 있으므로 한 번 더 호출
+        size_t srcPos = 0;
+        BOOL bOutputFull = FALSE;
+        while (bResult && (srcPos < dwBytesRead || bOutputFull)) {
+            size_t srcSize = dwBytesRead - srcPos;
+            size_t dstSize = RECOVER_READ_SIZE;
+
+            if (!decompress_stream(decomp, srcBuf + srcPos, &srcSize, dstBuf, &dstSize)) {
+                bResult = FALSE;
+                break;
+            }
+            srcPos += srcSize;
+            bOutputFull = (dstSize == RECOVER_READ_SIZE);
+
+            if (dstSize > 0) {
+                DWORD dwBytesWritten;
+                async_set_offset(&writeOverlap, result->restoredBytes);
+                bResult = async_write(hOutput, dstBuf, (DWORD)dstSize, &dwBytesWritten, &writeOverlap, TRUE);
+                result->restoredBytes += dstSize;
+            }
+        }
+    }
+
+    free_decompressor(decomp);
+    free(srcBuf);
+    free(dstBuf);
+    if (hInput != INVALID_HANDLE_VALUE) {
+        CloseHandle(hInput);
+    }
+    if (hOutput != INVALID_HANDLE_VALUE) {
+        CloseHandle(hOutput);
+    }
+
+    return bResult;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RECOVER_H
+#define RECOVER_H
+
+#include <windows.h>
+
+#include "compressor.h"
+
+/*
+ * 잘린 압축 파일 복구
+ *
+ * 압축 중에 전원이 꺼지면 마지막 Frame 이 잘린 채로 남아, 일반 Decoder 는 파일 전체를 거부합니다.
+ * CompressionOptions 의 Flush Point 로 여러 Frame 을 이어 붙인 파일은, 마지막 완결된 Frame 까지를
+ * 그대로 복구할 수 있습니다.
+ *
+ * recover_scan 은 압축을 해제하지 않고 Frame/Block Header 만 따라가며 완결된 Frame 의 끝을 찾으므로,
+ * 디스크 읽기 속도로 동작합니다.
+ */
+
+#define RECOVER_READ_SIZE (1024 * 1024) // 검사/복구 시 읽기 단위 (1 MB)
+
+// 구조체 선언
+
+typedef struct {
+    CompressionAlgorithm algorithm; // 첫 Frame 의 압축 알고리듬
+    ULONGLONG fileSize;             // 파일 크기
+    ULONGLONG validBytes;           // 마지막 완결된 Frame 의 끝 위치 (이 크기까지는 온전함)
+    ULONGLONG frameCount;           // 완결된 Frame 수 (Skippable Frame 포함)
+    ULONGLONG restoredBytes;        // 복구한 원본 크기 (recover_extract 만 설정)
+} RECOVER_Result_t;
+
+// 함수 선언
+
+BOOL recover_scan(const TCHAR* filePath, RECOVER_Result_t* result);
+BOOL recover_truncate(const TCHAR* filePath, RECOVER_Result_t* result);
+BOOL recover_extract(const TCHAR* filePath, const TCHAR* outputFilePath, RECOVER_Result_t* result);
+
+#endif // RECOVER_H
@@ -0,0 +1,400 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../include/lz4/lz4.h"
+
+#include "seekable.h"
+#include "crc32c.h"
+#include "utility.h"
+
+/* ---------- Writer ---------- */
+
+/**
+ * @brief 출력 파일의 현재 위치에 정확히 지정한 크기만큼 씁니다.
+ *
+ * @param pWritten 지금까지 쓴 크기 (호출 후 size 만큼 증가)
+ */
+static BOOL seekable_write(HANDLE hOutput, ULONGLONG* pWritten, const void* data, size_t size) {
+    OVERLAPPED writeOverlap = { 0, };
+    size_t total = 0;
+
+    while (total < size) {
+        DWORD dwBytesWritten = 0;
+        async_set_offset(&writeOverlap, *pWritten + total);
+        if (!async_write(hOutput, (const BYTE*)data + total, (DWORD)(size - total),
+                         &dwBytesWritten, &writeOverlap, TRUE) || dwBytesWritten == 0) {
+            return FALSE;
+        }
+        total += dwBytesWritten;
+    }
+    *pWritten += size;
+    return TRUE;
+}
+
+/**
+ * @brief 파일을 독립된 LZ4 Block 과 Offset Table 로 이루어진 임의 위치 읽기용 형식으로 압축합니다.
+ *
+ * @param inputFilePath 원본 파일 경로
+ * @param outputFilePath 압축 파일 경로
+ * @param options 압축 옵션 (NULL 이면 기본값)
+ * @return 성공 여부
+ */
+BOOL seekable_compress_file(const TCHAR* inputFilePath, const TCHAR* outputFilePath, const SEEKABLE_Options_t* options) {
+    DWORD blockSize = SEEKABLE_DEFAULT_BLOCK_SIZE;
+    int acceleration = 1;
+    IO_Mapping_t input;
+
+    if (options != NULL) {
+        if (options->blockSize != 0) {
+            blockSize = options->blockSize;
+        }
+        if (options->acceleration > 0) {
+            acceleration = options->acceleration;
+        }
+    }
+    if (blockSize < SEEKABLE_MIN_BLOCK_SIZE || blockSize > SEEKABLE_MAX_BLOCK_SIZE) {
+        log_message("Seekable - invalid block size.");
+        return FALSE;
+    }
+    if (!io_map_file(inputFilePath, &input)) {
+        return FALSE;
+    }
+
+    ULONGLONG const blockCount = (input.size + blockSize - 1) / blockSize;
+    if (blockCount >= MAXDWORD) {
+        log_message("Seekable - input file is too large.");
+        io_unmap_file(&input);
+        return FALSE;
+    }
+    size_t const tableSize = ((size_t)blockCount + 1) * sizeof(DWORD);
+    size_t const bufferCapacity = SEEKABLE_WRITE_BUFFER_SIZE + LZ4_compressBound((int)blockSize);
+    BYTE* const table = (BYTE*)malloc(tableSize);
+    BYTE* const buffer = (BYTE*)malloc(bufferCapacity);
+    void* const state = malloc(LZ4_sizeofState());
+    HANDLE const hOutput = init_file_write(outputFilePath);
+    BOOL bResult = (table != NULL && buffer != NULL && state != NULL && hOutput != INVALID_HANDLE_VALUE);
+    ULONGLONG written = 0;
+    size_t buffered = 0;
+
+    for (ULONGLONG block = 0; bResult && block < blockCount; block++) {
+        size_t const offset = (size_t)block * blockSize;
+        int const srcSize = (int)((input.size - offset < blockSize) ? input.size - offset : blockSize);
+
+        if (written + buffered > MAXDWORD) {
+            log_message("Seekable - compressed file exceeds 4 GB.");
+            bResult = FALSE;
+            break;
+        }
+        write_le32(table + block * sizeof(DWORD), (DWORD)(written + buffered));
+
+        // 원본보다 작게 압축되지 않으면 0 을 돌려받고 원본을 그대로 저장
+        int compressedSize = LZ4_compress_fast_extState(
+            state, (const char*)input.data + offset, (char*)buffer + buffered, srcSize, srcSize - 1, acceleration
+        );
+        if (compressedSize <= 0) {
+            memcpy(buffer + buffered, input.data + offset, srcSize);
+            compressedSize = srcSize;
+        }
+        buffered += compressedSize;
+
+        if (buffered >= SEEKABLE_WRITE_BUFFER_SIZE) {
+            bResult = seekable_write(hOutput, &written, buffer, buffered);
+            buffered = 0;
+        }
+    }
+
+    if (bResult) {
+        bResult = seekable_write(hOutput, &written, buffer, buffered);
+    }
+    if (bResult && written > MAXDWORD) {
+        log_message("Seekable - compressed file exceeds 4 GB.");
+        bResult = FALSE;
+    }
+    if (bResult) {
+        BYTE footer[SEEKABLE_FOOTER_SIZE];
+
+        write_le32(table + blockCount * sizeof(DWORD), (DWORD)written);
+        write_le32(footer + 0, SEEKABLE_MAGIC);
+        write_le32(footer + 4, SEEKABLE_VERSION);
+        write_le32(footer + 8, blockSize);
+        write_le32(footer + 12, (DWORD)blockCount);
+        write_le64(footer + 16, input.size);
+        write_le32(footer + 24, crc32c(0, table, tableSize));
+        write_le32(footer + 28, crc32c(0, footer, 28));
+        bResult = seekable_write(hOutput, &written, table, tableSize) &&
+                  seekable_write(hOutput, &written, footer, SEEKABLE_FOOTER_SIZE);
+    }
+    if (!bResult) {
+        log_message("Seekable - failed to write compressed file.");
+    }
+
+    if (hOutput != INVALID_HANDLE_VALUE) {
+        CloseHandle(hOutput);
+    }
+    free(state);
+    free(buffer);
+    free(table);
+    io_unmap_file(&input);
+    return bResult;
+}
+
+/* ---------- Reader ---------- */
+
+/**
+ * @brief 메모리에 있는 (Flash 에 Map 된 등) 압축 파일을 엽니다. data 는 Reader 를 닫을 때까지 유지되어야 합니다.
+ *
+ * Footer 와 Offset Table 의 CRC32C 를 검증하며, Block 은 읽을 때 풉니다.
+ *
+ * @param data 압축 파일 내용
+ * @param size 압축 파일 크기
+ * @param cacheSize LRU Cache 에 둘 Block 수 (0 이면 SEEKABLE_DEFAULT_CACHE_SIZE)
+ * @return Reader (실패 시 NULL)
+ */
+SEEKABLE_Reader_t* seekable_reader_open_memory(const void* data, size_t size, DWORD cacheSize) {
+    if (size < SEEKABLE_FOOTER_SIZE) {
+        log_message("Seekable - invalid footer.");
+        return NULL;
+    }
+
+    const BYTE* const footer = (const BYTE*)data + size - SEEKABLE_FOOTER_SIZE;
+    if (read_le32(footer) != SEEKABLE_MAGIC || read_le32(footer + 4) != SEEKABLE_VERSION ||
+        read_le32(footer + 28) != crc32c(0, footer, 28)) {
+        log_message("Seekable - invalid footer.");
+        return NULL;
+    }
+
+    DWORD const blockSize = read_le32(footer + 8);
+    DWORD const blockCount = read_le32(footer + 12);
+    ULONGLONG const contentSize = read_le64(footer + 16);
+    size_t const tableSize = ((size_t)blockCount + 1) * sizeof(DWORD);
+    if (blockSize < SEEKABLE_MIN_BLOCK_SIZE || blockSize > SEEKABLE_MAX_BLOCK_SIZE ||
+        (contentSize + blockSize - 1) / blockSize != blockCount ||
+        size - SEEKABLE_FOOTER_SIZE < tableSize) {
+        log_message("Seekable - inconsistent footer.");
+        return NULL;
+    }
+
+    const BYTE* const table = footer - tableSize;
+    if (read_le32(footer + 24) != crc32c(0, table, tableSize) ||
+        read_le32(table + (size_t)blockCount * sizeof(DWORD)) != (DWORD)(table - (const BYTE*)data)) {
+        log_message("Seekable - offset table is corrupted.");
+        return NULL;
+    }
+
+    if (cacheSize == 0) {
+        cacheSize = SEEKABLE_DEFAULT_CACHE_SIZE;
+    }
+    SEEKABLE_Reader_t* const reader = (SEEKABLE_Reader_t*)calloc(1, sizeof(SEEKABLE_Reader_t));
+    if (reader == NULL) {
+        return NULL;
+    }
+    reader->mapping.hFile = INVALID_HANDLE_VALUE;
+    reader->data = (const BYTE*)data;
+    reader->size = size;
+    reader->table = table;
+    reader->blockSize = blockSize;
+    reader->blockCount = blockCount;
+    reader->contentSize = contentSize;
+    reader->cache = (SEEKABLE_CacheEntry_t*)calloc(cacheSize, sizeof(SEEKABLE_CacheEntry_t));
+    BYTE* const cacheData = (BYTE*)malloc((size_t)cacheSize * blockSize);
+    if (reader->cache == NULL || cacheData == NULL) {
+        log_message("Seekable - failed to allocate block cache.");
+        free(cacheData);
+        seekable_reader_close(reader);
+        return NULL;
+    }
+    reader->cacheSize = cacheSize;
+    for (DWORD i = 0; i < cacheSize; i++) {
+        reader->cache[i].block = MAXDWORD;
+        reader->cache[i].data = cacheData + (size_t)i * blockSize;
+    }
+    return reader;
+}
+
+/**
+ * @brief 압축 파일을 Map 하여 엽니다.
+ *
+ * @param filePath 압축 파일 경로
+ * @param cacheSize LRU Cache 에 둘 Block 수 (0 이면 SEEKABLE_DEFAULT_CACHE_SIZE)
+ * @return Reader (실패 시 NULL)
+ */
+SEEKABLE_Reader_t* seekable_reader_open(const TCHAR* filePath, DWORD cacheSize) {
+    IO_Mapping_t mapping;
+
+    if (!io_map_file(filePath, &mapping)) {
+        io_unmap_file(&mapping);
+        return NULL;
+    }
+    SEEKABLE_Reader_t* const reader = seekable_reader_open_memory(mapping.data, mapping.size, cacheSize);
+    if (reader == NULL) {
+        io_unmap_file(&mapping);
+        return NULL;
+    }
+    reader->mapping = mapping;
+    return reader;
+}
+
+/**
+ * @brief Block 하나를 dst 에 풉니다.
+ *
+ * @param dst 푼 내용을 쓸 버퍼 (blockSize 이상)
+ * @param pSize 푼 크기 (마지막 Block 은 blockSize 보다 작을 수 있음)
+ */
+static BOOL seekable_decode_block(SEEKABLE_Reader_t* reader, DWORD block, BYTE* dst, DWORD* pSize) {
+    DWORD const start = read_le32(reader->table + (size_t)block * sizeof(DWORD));
+    DWORD const end = read_le32(reader->table + ((size_t)block + 1) * sizeof(DWORD));
+    ULONGLONG const offset = (ULONGLONG)block * reader->blockSize;
+    DWORD const size = (DWORD)((reader->contentSize - offset < reader->blockSize) ?
+                               reader->contentSize - offset : reader->blockSize);
+
+    if (start > end || end > (DWORD)(reader->table - reader->data)) {
+        log_message("Seekable - invalid block offset.");
+        return FALSE;
+    }
+
+    reader->misses++;
+    if (end - start == size) {
+        memcpy(dst, reader->data + start, size); // 원본 그대로 저장한 Block
+    } else if (LZ4_decompress_safe((const char*)reader->data + start, (char*)dst, (int)(end - start), (int)size) !=
+               (int)size) {
+        log_message("Seekable - LZ4 block decompression failed.");
+        return FALSE;
+    }
+    *pSize = size;
+    return TRUE;
+}
+
+/**
+ * @brief Cache 에서 Block 을 찾습니다.
+ *
+ * @return Cache 칸 (없으면 NULL)
+ */
+static SEEKABLE_CacheEntry_t* seekable_cache_find(SEEKABLE_Reader_t* reader, DWORD block) {
+    for (DWORD i = 0; i < reader->cacheSize; i++) {
+        if (reader->cache[i].block == block) {
+            return &(reader->cache[i]);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Block 하나를 풀어 돌려줍니다. Cache 에 있으면 다시 풀지 않으며, 없으면 가장 오래 쓰지 않은 칸에 풉니다.
+ *
+ * @param reader Reader
+ * @param block Block 번호
+ * @param pSize 푼 크기
+ * @return 푼 내용 (다음 seekable_reader_block / seekable_reader_read 호출 전까지 유효, 실패 시 NULL)
+ */
+const BYTE* seekable_reader_block(SEEKABLE_Reader_t* reader, DWORD block, DWORD* pSize) {
+    if (block >= reader->blockCount) {
+        return NULL;
+    }
+
+    SEEKABLE_CacheEntry_t* entry = seekable_cache_find(reader, block);
+    if (entry != NULL) {
+        reader->hits++;
+    } else {
+        entry = &(reader->cache[0]);
+        for (DWORD i = 1; i < reader->cacheSize && entry->block != MAXDWORD; i++) {
+            if (reader->cache[i].block == MAXDWORD || reader->cache[i].lastUse < entry->lastUse) {
+                entry = &(reader->cache[i]);
+            }
+        }
+        entry->block = MAXDWORD;
+        if (!seekable_decode_block(reader, block, entry->data, &(entry->size))) {
+            return NULL;
+        }
+        entry->block = block;
+    }
+
+    entry->lastUse = ++(reader->useCounter);
+    *pSize = entry->size;
+    return entry->data;
+}
+
+/**
+ * @brief 원본의 지정한 위치부터 읽습니다.
+ *
+ * 필요한 Block 만 풀며, Block 전체를 읽는 부분은 Cache 를 거치지 않고 buffer 에 바로 풉니다.
+ * (순차로 크게 읽을 때 Cache 를 밀어내지 않음)
+ *
+ * @param reader Reader
+ * @param offset 원본에서의 위치
+ * @param buffer 읽은 내용을 쓸 버퍼
+ * @param size 읽을 크기
+ * @param pBytesRead 읽은 크기 (원본 끝을 넘으면 size 보다 작음)
+ * @return 성공 여부
+ */
+BOOL seekable_reader_read(
+    SEEKABLE_Reader_t* reader, ULONGLONG offset,
+    void* buffer, size_t size, size_t* pBytesRead
+) {
+    BYTE* dst = (BYTE*)buffer;
+
+    *pBytesRead = 0;
+    if (offset >= reader->contentSize) {
+        return TRUE;
+    }
+    if (size > reader->contentSize - offset) {
+        size = (size_t)(reader->contentSize - offset);
+    }
+
+    while (size > 0) {
+        DWORD const block = (DWORD)(offset / reader->blockSize);
+        DWORD const inBlock = (DWORD)(offset % reader->blockSize);
+        DWORD blockLength = 0;
+        size_t length;
+
+        if (inBlock == 0 && size >= reader->blockSize && seekable_cache_find(reader, block) == NULL) {
+            if (!seekable_decode_block(reader, block, dst, &blockLength)) {
+                return FALSE;
+            }
+            length = blockLength;
+        } else {
+            const BYTE* const data = seekable_reader_block(reader, block, &blockLength);
+            if (data == NULL) {
+                return FALSE;
+            }
+            length = blockLength - inBlock;
+            if (length > size) {
+                length = size;
+            }
+            memcpy(dst, data + inBlock, length);
+        }
+
+        dst += length;
+        offset += length;
+        size -= length;
+        *pBytesRead += length;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Reader 를 닫고 자원을 해제합니다.
+ */
+void seekable_reader_close(SEEKABLE_Reader_t* reader) {
+    if (reader == NULL) {
+        return;
+    }
+    if (reader->cache != NULL) {
+        free(reader->cache[0].data); // 모든 칸이 함께 할당한 버퍼를 나눠 씀
+        free(reader->cache);
+    }
+    io_unmap_file(&(reader->mapping));
+    free(reader);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SEEKABLE_H
+#define SEEKABLE_H
+
+#include <windows.h>
+
+#include "asyncio_win.h"
+
+/*
+ * 임의 위치 읽기용 Block Index LZ4 파일 구조 (모든 정수는 Little Endian)
+ *
+ *   [Block 0][Block 1]...[Block N-1]      원본 blockSize bytes 씩 독립적으로 압축한 LZ4 Block (Frame 아님)
+ *                                         압축해도 작아지지 않는 Block 은 원본 그대로 저장 (압축 크기 == 원본 크기)
+ *   [Offset 0]...[Offset N]               Block 시작 위치 (파일 처음 기준, 4 bytes), Offset N 은 Table 시작 위치
+ *   [Footer]                              SEEKABLE_FOOTER_SIZE bytes, 파일 끝에 고정
+ *
+ * compress_lz4 의 Frame 은 Block 이 이어져 있어 (LZ4F_blockLinked) 어느 위치든 처음부터 풀어야 하지만,
+ * 이 형식은 Offset Table 로 원하는 Block 하나만 O(1) 로 찾아 풀 수 있습니다. (Flash 의 Resource 를 조금씩 읽는 용도)
+ * Reader 는 최근에 푼 Block 을 LRU Cache 에 두어, 가까운 위치를 이어서 읽을 때 다시 풀지 않습니다.
+ * 압축 파일은 4 GB 보다 작아야 합니다.
+ */
+
+#define SEEKABLE_MAGIC               0x4B534E53  // "SNSK"
+#define SEEKABLE_VERSION             1
+#define SEEKABLE_FOOTER_SIZE         32
+#define SEEKABLE_DEFAULT_BLOCK_SIZE  (64 * 1024)       // 기본 Block 크기
+#define SEEKABLE_MIN_BLOCK_SIZE      512               // Block 크기 최소값
+#define SEEKABLE_MAX_BLOCK_SIZE      (4 * 1024 * 1024) // Block 크기 최대값
+#define SEEKABLE_DEFAULT_CACHE_SIZE  8                 // Reader 가 기본으로 Cache 에 두는 Block 수
+#define SEEKABLE_WRITE_BUFFER_SIZE   (1024 * 1024)     // Writer 가 모아서 쓰는 단위
+
+// 구조체 선언
+
+typedef struct SEEKABLE_Options_s SEEKABLE_Options_t;
+typedef struct SEEKABLE_CacheEntry_s SEEKABLE_CacheEntry_t;
+typedef struct SEEKABLE_Reader_s SEEKABLE_Reader_t;
+
+/*
+ * 압축 옵션. 0 으로 초기화하면 기본값을 사용합니다.
+ */
+struct SEEKABLE_Options_s {
+    DWORD blockSize;          // 원본 Block 크기 (0 이면 SEEKABLE_DEFAULT_BLOCK_SIZE)
+                              // 작을수록 임의 읽기가 빠르고 압축률은 낮아짐
+    int acceleration;         // LZ4_compress_fast 의 Acceleration (0 이면 1)
+};
+
+struct SEEKABLE_CacheEntry_s {
+    DWORD block;              // Cache 에 있는 Block 번호 (MAXDWORD 이면 빈 칸)
+    DWORD size;               // 푼 크기
+    ULONGLONG lastUse;        // 마지막으로 사용한 순번 (LRU)
+    BYTE* data;               // 푼 Block
+};
+
+struct SEEKABLE_Reader_s {
+    IO_Mapping_t mapping;     // seekable_reader_open 으로 연 경우 Map 한 파일
+    const BYTE* data;         // 압축 파일 내용
+    size_t size;              // 압축 파일 크기
+    const BYTE* table;        // Offset Table
+    DWORD blockSize;          // 원본 Block 크기
+    DWORD blockCount;         // Block 수
+    ULONGLONG contentSize;    // 원본 크기
+
+    SEEKABLE_CacheEntry_t* cache; // 푼 Block 의 LRU Cache
+    DWORD cacheSize;          // cache 의 칸 수
+    ULONGLONG useCounter;     // LRU 순번
+    ULONGLONG hits;           // Cache 적중 수
+    ULONGLONG misses;         // Block 을 푼 수 (Cache 를 거치지 않고 바로 푼 경우 포함)
+};
+
+// 함수 선언
+
+BOOL seekable_compress_file(const TCHAR* inputFilePath, const TCHAR* outputFilePath, const SEEKABLE_Options_t* options);
+
+SEEKABLE_Reader_t* seekable_reader_open(const TCHAR* filePath, DWORD cacheSize);
+SEEKABLE_Reader_t* seekable_reader_open_memory(const void* data, size_t size, DWORD cacheSize);
+const BYTE* seekable_reader_block(SEEKABLE_Reader_t* reader, DWORD block, DWORD* pSize);
+BOOL seekable_reader_read(
+    SEEKABLE_Reader_t* reader, ULONGLONG offset,
+    void* buffer, size_t size, size_t* pBytesRead
+);
+void seekable_reader_close(SEEKABLE_Reader_t* reader);
+
+#endif // SEEKABLE_H
@@ -0,0 +1,436 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define ZSTD_STATIC_LINKING_ONLY // ZSTD_createThreadPool
+#include "../include/zstd/zstd.h"
+
+#include "task_pool.h"
+#include "utility.h"
+
+// 우선순위별로 꺼내는 순서 (HIGH : NORMAL : LOW = 4 : 2 : 1, 해당 우선순위에 Task 가 없으면 다음 우선순위)
+static const TaskPriority kPickOrder[] = {
+    TASK_PRIORITY_HIGH, TASK_PRIORITY_NORMAL, TASK_PRIORITY_HIGH, TASK_PRIORITY_LOW,
+    TASK_PRIORITY_HIGH, TASK_PRIORITY_NORMAL, TASK_PRIORITY_HIGH
+};
+
+// 차례인 우선순위에 Task 가 없을 때 찾는 순서
+static const TaskPriority kPriorityOrder[TASK_PRIORITY_COUNT] = {
+    TASK_PRIORITY_HIGH, TASK_PRIORITY_NORMAL, TASK_PRIORITY_LOW
+};
+
+static TASK_Pool_t* volatile g_sharedPool = NULL; // task_pool_shared
+
+/**
+ * @brief 이 Worker 의 Deque 에 Task 를 넣습니다. (Worker 자신만 호출)
+ *
+ * @return Deque 가 가득 차면 FALSE
+ */
+static BOOL task_deque_push(TASK_Worker_t* worker, TASK_Item_t* item) {
+    AcquireSRWLockExclusive(&(worker->lock));
+    BOOL const bPushed = (worker->bottom - worker->top < TASK_DEQUE_SIZE);
+    if (bPushed) {
+        worker->deque[worker->bottom % TASK_DEQUE_SIZE] = item;
+        worker->bottom++;
+        InterlockedIncrement(&(worker->pool->dequeTasks));
+    }
+    ReleaseSRWLockExclusive(&(worker->lock));
+    return bPushed;
+}
+
+/**
+ * @brief Deque 에서 Task 를 꺼냅니다. 자신의 Deque 는 최근 Task 를, 다른 Worker 의 Deque 는 오래된 Task 를 꺼냅니다.
+ *
+ * @param worker Deque 를 가진 Worker
+ * @param bSteal 다른 Worker 가 가져가는지 여부
+ * @return 꺼낸 Task, 비어 있으면 NULL
+ */
+static TASK_Item_t* task_deque_pop(TASK_Worker_t* worker, BOOL bSteal) {
+    TASK_Item_t* item = NULL;
+
+    AcquireSRWLockExclusive(&(worker->lock));
+    if (worker->bottom != worker->top) {
+        if (bSteal) {
+            item = worker->deque[worker->top % TASK_DEQUE_SIZE];
+            worker->top++;
+        } else {
+            worker->bottom--;
+            item = worker->deque[worker->bottom % TASK_DEQUE_SIZE];
+        }
+        InterlockedDecrement(&(worker->pool->dequeTasks));
+    }
+    ReleaseSRWLockExclusive(&(worker->lock));
+    return item;
+}
+
+/**
+ * @brief Job 대기열에서 다음 Task 를 꺼냅니다. (pool->lock 을 잡은 상태에서 호출)
+ *
+ * 우선순위는 kPickOrder 비율을 따르고, 같은 우선순위의 Job 은 돌아가며 하나씩 꺼냅니다.
+ */
+static TASK_Item_t* task_pick_locked(TASK_Pool_t* pool) {
+    if (pool->queuedTasks == 0) {
+        return NULL;
+    }
+
+    TaskPriority const first = kPickOrder[pool->pickCount++ % (sizeof(kPickOrder) / sizeof(kPickOrder[0]))];
+    for (int n = -1; n < TASK_PRIORITY_COUNT; n++) {
+        TaskPriority const priority = (n < 0) ? first : kPriorityOrder[n];
+        TASK_Job_t* const job = pool->readyHead[priority];
+        if (job == NULL) {
+            continue;
+        }
+
+        // Job 의 첫 Task 를 꺼내고, Job 은 목록 끝으로 옮김 (남은 Task 가 없으면 목록에서 뺌)
+        TASK_Item_t* const item = job->head;
+        job->head = item->next;
+        if (job->head == NULL) {
+            job->tail = NULL;
+        }
+        pool->queuedTasks--;
+
+        pool->readyHead[priority] = job->nextReady;
+        if (pool->readyHead[priority] == NULL) {
+            pool->readyTail[priority] = NULL;
+        }
+        job->nextReady = NULL;
+        job->bReady = (job->head != NULL);
+        if (job->bReady) {
+            if (pool->readyTail[priority] != NULL) {
+                pool->readyTail[priority]->nextReady = job;
+            } else {
+                pool->readyHead[priority] = job;
+            }
+            pool->readyTail[priority] = job;
+        }
+        return item;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 실행할 Task 를 구합니다. 자신의 Deque, Job 대기열, 다른 Worker 의 Deque 순서로 찾습니다.
+ */
+static TASK_Item_t* task_take(TASK_Worker_t* self) {
+    TASK_Pool_t* const pool = self->pool;
+
+    TASK_Item_t* item = task_deque_pop(self, FALSE);
+    if (item != NULL) {
+        return item;
+    }
+
+    AcquireSRWLockExclusive(&(pool->lock));
+    item = task_pick_locked(pool);
+    ReleaseSRWLockExclusive(&(pool->lock));
+    if (item != NULL) {
+        return item;
+    }
+
+    for (DWORD n = 1; pool->dequeTasks > 0 && n < pool->workerCount; n++) {
+        item = task_deque_pop(&(pool->workers[(self->index + n) % pool->workerCount]), TRUE);
+        if (item != NULL) {
+            self->stolen++;
+            return item;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Task 완료를 알립니다. 이후 item 은 기다리던 쪽이 해제할 수 있으므로 참조하지 않습니다.
+ */
+static void task_complete(TASK_Item_t* item) {
+    TASK_Job_t* const job = item->job;
+
+    AcquireSRWLockExclusive(&(job->lock));
+    item->bDone = TRUE;
+    job->pending--;
+    WakeAllConditionVariable(&(job->done));
+    ReleaseSRWLockExclusive(&(job->lock));
+}
+
+/**
+ * @brief Worker Thread: Task 를 실행하고, 할 일이 없으면 새 Task 가 들어올 때까지 잠듭니다.
+ */
+static DWORD WINAPI task_worker_thread(LPVOID param) {
+    TASK_Worker_t* const self = (TASK_Worker_t*)param;
+    TASK_Pool_t* const pool = self->pool;
+
+    TlsSetValue(pool->tlsIndex, self);
+    for (;;) {
+        TASK_Item_t* const item = task_take(self);
+        if (item != NULL) {
+            item->function(item->param);
+            self->executed++;
+            task_complete(item);
+            continue;
+        }
+
+        // Deque 에 넣는 쪽도 pool->lock 을 잡고 깨우므로, 확인과 잠들기 사이에 들어온 Task 를 놓치지 않음
+        AcquireSRWLockExclusive(&(pool->lock));
+        while (!pool->bClosed && pool->queuedTasks == 0 && pool->dequeTasks == 0) {
+            SleepConditionVariableSRW(&(pool->wake), &(pool->lock), INFINITE, 0);
+        }
+        BOOL const bExit = pool->bClosed && pool->queuedTasks == 0 && pool->dequeTasks == 0;
+        ReleaseSRWLockExclusive(&(pool->lock));
+        if (bExit) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Thread Pool 을 만들고 Worker 를 시작합니다.
+ *
+ * Thread 수를 Task Worker 와 ZSTD_threadPool 이 반씩 나눠 가지므로 (Task Worker 가 하나 더 많음), LZ4 작업과
+ * ZSTD 작업이 함께 실행되어도 Pool 의 Thread 는 workerCount 를 넘지 않습니다.
+ *
+ * @param workerCount 전체 Thread 수 (0 이면 Processor 수, 최대 TASK_MAX_WORKERS)
+ * @return Pool, 실패 시 NULL
+ */
+TASK_Pool_t* task_pool_create(DWORD workerCount) {
+    if (workerCount == 0) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        workerCount = info.dwNumberOfProcessors;
+    }
+    if (workerCount > TASK_MAX_WORKERS) {
+        workerCount = TASK_MAX_WORKERS;
+    }
+    DWORD const zstdWorkerCount = workerCount / 2;
+    workerCount -= zstdWorkerCount;
+
+    TASK_Pool_t* const pool = (TASK_Pool_t*)calloc(1, sizeof(TASK_Pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+    InitializeSRWLock(&(pool->lock));
+    InitializeConditionVariable(&(pool->wake));
+    InitializeSRWLock(&(pool->zstdLock));
+    InitializeConditionVariable(&(pool->zstdProgress));
+    pool->tlsIndex = TlsAlloc();
+    pool->workers = (TASK_Worker_t*)calloc(workerCount, sizeof(TASK_Worker_t));
+    pool->zstdWorkerCount = zstdWorkerCount;
+    if (zstdWorkerCount > 0) {
+        pool->zstdPool = ZSTD_createThreadPool(zstdWorkerCount);
+    }
+    if (pool->tlsIndex == TLS_OUT_OF_INDEXES || pool->workers == NULL ||
+        (zstdWorkerCount > 0 && pool->zstdPool == NULL)) {
+        log_message("Failed to create task pool.");
+        task_pool_free(pool);
+        return NULL;
+    }
+
+    for (DWORD i = 0; i < workerCount; i++) {
+        TASK_Worker_t* const worker = &(pool->workers[i]);
+        worker->pool = pool;
+        worker->index = i;
+        InitializeSRWLock(&(worker->lock));
+        worker->hThread = CreateThread(NULL, 0, task_worker_thread, worker, 0, NULL);
+        if (worker->hThread == NULL) {
+            log_message("Failed to start task pool worker.");
+            task_pool_free(pool);
+            return NULL;
+        }
+        pool->workerCount = i + 1; // task_pool_free 가 시작한 Worker 만 기다리도록
+    }
+
+    return pool;
+}
+
+/**
+ * @brief 남은 Task 를 모두 실행한 뒤 Worker 를 멈추고 Pool 을 해제합니다.
+ *
+ * @param pool Pool (NULL 허용)
+ */
+void task_pool_free(TASK_Pool_t* pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    AcquireSRWLockExclusive(&(pool->lock));
+    pool->bClosed = TRUE;
+    WakeAllConditionVariable(&(pool->wake));
+    ReleaseSRWLockExclusive(&(pool->lock));
+
+    for (DWORD i = 0; i < pool->workerCount; i++) {
+        WaitForSingleObject(pool->workers[i].hThread, INFINITE);
+        CloseHandle(pool->workers[i].hThread);
+    }
+
+    if (pool->tlsIndex != TLS_OUT_OF_INDEXES) {
+        TlsFree(pool->tlsIndex);
+    }
+    ZSTD_freeThreadPool(pool->zstdPool);
+    free(pool->workers);
+    free(pool);
+}
+
+/**
+ * @brief Process 에 하나인 공용 Pool 을 구합니다. 처음 호출할 때 Processor 수만큼의 Thread 로 만들며, 해제하지 않습니다.
+ *
+ * @return 공용 Pool, 실패 시 NULL
+ */
+TASK_Pool_t* task_pool_shared(void) {
+    if (g_sharedPool != NULL) {
+        return g_sharedPool;
+    }
+
+    TASK_Pool_t* const pool = task_pool_create(0);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    // 동시에 만든 경우 먼저 등록된 Pool 을 사용
+    if (InterlockedCompareExchangePointer((void* volatile*)&g_sharedPool, pool, NULL) != NULL) {
+        task_pool_free(pool);
+    }
+    return g_sharedPool;
+}
+
+/**
+ * @brief Worker 들이 실행한 Task 수와 다른 Worker 에서 가져온 Task 수를 구합니다. (통계용, 대략적인 값)
+ */
+void task_pool_get_counts(TASK_Pool_t* pool, ULONGLONG* pExecuted, ULONGLONG* pStolen) {
+    *pExecuted = 0;
+    *pStolen = 0;
+    for (DWORD i = 0; i < pool->workerCount; i++) {
+        *pExecuted += pool->workers[i].executed;
+        *pStolen += pool->workers[i].stolen;
+    }
+}
+
+/**
+ * @brief ZSTD_threadPool 을 쓰는 작업이 진행했음 (압축 결과를 받았거나 압축을 끝냄) 을 알립니다.
+ *
+ * Job 을 마친 ZSTD Thread 가 비었을 수 있으므로, task_pool_zstd_wait 로 기다리는 작업을 깨웁니다.
+ */
+void task_pool_zstd_progress(TASK_Pool_t* pool) {
+    InterlockedIncrement(&(pool->zstdGeneration));
+    if (pool->zstdWaiters > 0) {
+        AcquireSRWLockExclusive(&(pool->zstdLock));
+        WakeAllConditionVariable(&(pool->zstdProgress));
+        ReleaseSRWLockExclusive(&(pool->zstdLock));
+    }
+}
+
+/**
+ * @brief 다른 작업이 task_pool_zstd_progress 로 진행을 알릴 때까지 기다립니다.
+ *
+ * @param pool Pool
+ * @param generation ZSTD 를 호출하기 전에 읽은 pool->zstdGeneration (그 사이에 알림이 있었으면 바로 반환)
+ * @param timeoutMillis 최대 대기 시간 (ms, 알리지 않고 Thread 를 비운 작업에 대비)
+ */
+void task_pool_zstd_wait(TASK_Pool_t* pool, LONG generation, DWORD timeoutMillis) {
+    AcquireSRWLockExclusive(&(pool->zstdLock));
+    InterlockedIncrement(&(pool->zstdWaiters)); // 알리는 쪽의 zstdGeneration 증가와 순서를 맞춤
+    if (pool->zstdGeneration == generation) {
+        SleepConditionVariableSRW(&(pool->zstdProgress), &(pool->zstdLock), timeoutMillis, 0);
+    }
+    InterlockedDecrement(&(pool->zstdWaiters));
+    ReleaseSRWLockExclusive(&(pool->zstdLock));
+}
+
+/**
+ * @brief Job 을 초기화합니다. Job 은 Task 가 모두 끝날 때까지 유지해야 합니다.
+ *
+ * @param job 초기화할 Job
+ * @param pool 사용할 Pool
+ * @param priority 우선순위
+ */
+void task_job_init(TASK_Job_t* job, TASK_Pool_t* pool, TaskPriority priority) {
+    memset(job, 0, sizeof(TASK_Job_t));
+    job->pool = pool;
+    job->priority = (priority < TASK_PRIORITY_COUNT) ? priority : TASK_PRIORITY_NORMAL;
+    InitializeSRWLock(&(job->lock));
+    InitializeConditionVariable(&(job->done));
+}
+
+/**
+ * @brief Task 를 넣습니다.
+ *
+ * Worker 가 실행 중인 Task 안에서 넣으면 그 Worker 의 Deque 에, 아니면 Job 대기열에 넣습니다.
+ *
+ * @param job 속한 Job
+ * @param item Task (완료될 때까지 유지)
+ * @param function 실행할 함수
+ * @param param 함수 인자
+ */
+void task_submit(TASK_Job_t* job, TASK_Item_t* item, TASK_Function function, void* param) {
+    TASK_Pool_t* const pool = job->pool;
+
+    item->function = function;
+    item->param = param;
+    item->job = job;
+    item->bDone = FALSE;
+    item->next = NULL;
+
+    AcquireSRWLockExclusive(&(job->lock));
+    job->pending++;
+    ReleaseSRWLockExclusive(&(job->lock));
+
+    TASK_Worker_t* const self = (TASK_Worker_t*)TlsGetValue(pool->tlsIndex);
+    BOOL const bLocal = (self != NULL) && task_deque_push(self, item);
+
+    AcquireSRWLockExclusive(&(pool->lock));
+    if (!bLocal) {
+        if (job->tail != NULL) {
+            job->tail->next = item;
+        } else {
+            job->head = item;
+        }
+        job->tail = item;
+        pool->queuedTasks++;
+
+        if (!job->bReady) {
+            job->bReady = TRUE;
+            if (pool->readyTail[job->priority] != NULL) {
+                pool->readyTail[job->priority]->nextReady = job;
+            } else {
+                pool->readyHead[job->priority] = job;
+            }
+            pool->readyTail[job->priority] = job;
+        }
+    }
+    WakeConditionVariable(&(pool->wake));
+    ReleaseSRWLockExclusive(&(pool->lock));
+}
+
+/**
+ * @brief Task 가 끝날 때까지 기다립니다. (Worker 가 실행하는 Task 안에서는 호출하지 않음)
+ */
+void task_wait(TASK_Item_t* item) {
+    TASK_Job_t* const job = item->job;
+
+    AcquireSRWLockExclusive(&(job->lock));
+    while (!item->bDone) {
+        SleepConditionVariableSRW(&(job->done), &(job->lock), INFINITE, 0);
+    }
+    ReleaseSRWLockExclusive(&(job->lock));
+}
+
+/**
+ * @brief Job 의 Task 가 모두 끝날 때까지 기다립니다. (Worker 가 실행하는 Task 안에서는 호출하지 않음)
+ */
+void task_job_wait(TASK_Job_t* job) {
+    AcquireSRWLockExclusive(&(job->lock));
+    while (job->pending > 0) {
+        SleepConditionVariableSRW(&(job->done), &(job->lock), INFINITE, 0);
+    }
+    ReleaseSRWLockExclusive(&(job->lock));
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <windows.h>
+
+/*
+ * 작업 공유 (Work-Stealing) Thread Pool
+ *
+ * 여러 압축 작업 (Job) 이 각자 Thread 를 만들지 않고, Process 에 하나인 Pool 의 Worker 에 Chunk 단위 Task 를 맡깁니다.
+ *
+ * - Job 밖에서 넣은 Task 는 Job 별 대기열에 쌓이고, Worker 는 우선순위별로 Job 을 돌아가며 (Round-Robin) 하나씩 꺼내므로
+ *   Task 를 많이 넣은 Job 이 다른 Job 을 밀어내지 않습니다. 우선순위 사이는 4:2:1 비율로 꺼내어 낮은 우선순위도 굶지 않습니다.
+ * - Task 안에서 넣은 Task 는 그 Worker 의 Deque 에 쌓여 먼저 처리하고 (LIFO), 할 일이 없는 Worker 는 다른 Worker 의
+ *   Deque 에서 오래된 Task 를 가져갑니다. (Stealing, FIFO)
+ * - ZSTD 는 Pool 의 ZSTD_threadPool 을 ZSTD_CCtx_refThreadPool 로 공유하므로,
+ *   동시에 압축하는 ZSTD 작업이 많아도 ZSTD Worker Thread 가 늘어나지 않습니다.
+ *   Thread 수는 task_pool_create 의 workerCount 를 Task Worker 와 ZSTD_threadPool 이 나눠 가지므로 합쳐서 넘지 않습니다.
+ *   (ZSTD Worker 가 하나 이하이면 ZSTD 는 나눠 압축해도 이득이 없으므로 호출한 Thread 에서 압축합니다.)
+ * - ZSTD_threadPool 이 모두 다른 작업의 Job 을 압축 중이면 ZSTD 는 진행 없이 반환하므로, 그 작업은
+ *   task_pool_zstd_wait 로 다른 작업이 진행을 알릴 (task_pool_zstd_progress) 때까지 잠듭니다.
+ *
+ * Task 안에서 task_wait 로 다른 Task 를 기다리면 안 됩니다. (모든 Worker 가 기다리면 멈춤)
+ */
+
+#define TASK_MAX_WORKERS 64  // Worker 최대 수
+#define TASK_DEQUE_SIZE  256 // Worker 별 Deque 크기 (가득 차면 Job 대기열에 넣음)
+
+// enum 선언
+
+typedef enum {
+    TASK_PRIORITY_NORMAL,  // 기본값
+    TASK_PRIORITY_HIGH,    // 먼저 처리 (대화형 작업 등)
+    TASK_PRIORITY_LOW,     // 나중에 처리 (Background 작업 등)
+    TASK_PRIORITY_COUNT    // 우선순위 수
+} TaskPriority;
+
+// 구조체 선언
+
+typedef struct TASK_Item_s TASK_Item_t;
+typedef struct TASK_Job_s TASK_Job_t;
+typedef struct TASK_Worker_s TASK_Worker_t;
+typedef struct TASK_Pool_s TASK_Pool_t;
+
+typedef void (*TASK_Function)(void* param);
+
+/*
+ * Task 하나. 호출한 쪽이 메모리를 가지며, 완료될 때까지 유지해야 합니다.
+ */
+struct TASK_Item_s {
+    TASK_Function function;   // 실행할 함수
+    void* param;              // 함수 인자
+    TASK_Job_t* job;          // 속한 Job
+    BOOL bDone;               // 완료 여부 (job->lock 보호)
+    TASK_Item_t* next;        // Job 대기열의 다음 Task
+};
+
+/*
+ * 같은 우선순위로 처리하는 Task 묶음 (압축 작업 하나)
+ */
+struct TASK_Job_s {
+    TASK_Pool_t* pool;        // 사용하는 Pool
+    TaskPriority priority;    // 우선순위
+    SRWLOCK lock;             // pending, 각 Task 의 bDone 보호
+    CONDITION_VARIABLE done;  // Task 완료
+    LONG pending;             // 넣었지만 끝나지 않은 Task 수
+
+    // 아래는 pool->lock 보호
+    TASK_Item_t* head;        // 아직 꺼내지 않은 Task (처음)
+    TASK_Item_t* tail;        // 아직 꺼내지 않은 Task (끝)
+    BOOL bReady;              // 우선순위별 Job 목록에 들어 있음
+    TASK_Job_t* nextReady;    // 우선순위별 Job 목록의 다음 Job
+};
+
+struct TASK_Worker_s {
+    TASK_Pool_t* pool;        // 속한 Pool
+    DWORD index;              // Worker 번호
+    HANDLE hThread;           // Worker Thread
+    SRWLOCK lock;             // Deque 보호
+    TASK_Item_t* deque[TASK_DEQUE_SIZE]; // Task 안에서 넣은 Task
+    LONG top;                 // 다른 Worker 가 가져가는 쪽 (오래된 Task)
+    LONG bottom;              // 이 Worker 가 넣고 꺼내는 쪽 (최근 Task)
+    ULONGLONG executed;       // 실행한 Task 수 (통계용)
+    ULONGLONG stolen;         // 다른 Worker 에서 가져온 Task 수 (통계용)
+};
+
+struct TASK_Pool_s {
+    DWORD workerCount;        // Task Worker 수
+    TASK_Worker_t* workers;   // Worker 목록
+    DWORD tlsIndex;           // 현재 Thread 의 TASK_Worker_t (Worker 가 아니면 NULL)
+    DWORD zstdWorkerCount;    // ZSTD_threadPool 의 Thread 수 (workerCount 와 합쳐 task_pool_create 의 workerCount)
+    struct POOL_ctx_s* zstdPool; // ZSTD_threadPool (zstd.h 실험적 API, zstdWorkerCount 가 0 이면 NULL)
+
+    SRWLOCK zstdLock;         // zstdProgress 대기 보호
+    CONDITION_VARIABLE zstdProgress; // ZSTD_threadPool 을 쓰는 작업이 진행함 (Thread 가 비었을 수 있음)
+    volatile LONG zstdGeneration; // 진행을 알린 횟수
+    volatile LONG zstdWaiters; // zstdProgress 를 기다리는 Thread 수
+
+    SRWLOCK lock;             // 아래 상태 보호
+    CONDITION_VARIABLE wake;  // 새 Task (또는 종료 요청)
+    TASK_Job_t* readyHead[TASK_PRIORITY_COUNT]; // 우선순위별로 꺼낼 Task 가 있는 Job (Round-Robin 순서)
+    TASK_Job_t* readyTail[TASK_PRIORITY_COUNT];
+    LONG queuedTasks;         // Job 대기열의 Task 수
+    volatile LONG dequeTasks; // 모든 Worker Deque 의 Task 수
+    DWORD pickCount;          // 우선순위 비율을 맞추기 위한 꺼낸 횟수
+    BOOL bClosed;             // 종료 요청
+};
+
+// 함수 선언
+
+TASK_Pool_t* task_pool_create(DWORD workerCount);
+void task_pool_free(TASK_Pool_t* pool);
+TASK_Pool_t* task_pool_shared(void);
+void task_pool_get_counts(TASK_Pool_t* pool, ULONGLONG* pExecuted, ULONGLONG* pStolen);
+void task_pool_zstd_progress(TASK_Pool_t* pool);
+void task_pool_zstd_wait(TASK_Pool_t* pool, LONG generation, DWORD timeoutMillis);
+
+void task_job_init(TASK_Job_t* job, TASK_Pool_t* pool, TaskPriority priority);
+void task_submit(TASK_Job_t* job, TASK_Item_t* item, TASK_Function function, void* param);
+void task_wait(TASK_Item_t* item);
+void task_job_wait(TASK_Job_t* job);
+
+#endif // TASK_POOL_H
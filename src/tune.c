@@ -0,0 +1,444 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/lz4/lz4frame.h"
+#include "../include/zstd/zstd.h"
+#include "tune.h"
+#include "asyncio_win.h"
+#include "utility.h"
+
+#define TUNE_CACHE_SIZE 32 // Process 안에서 기억하는 (Volume, Profile) 수
+
+// 보정 파일에서 찾은 값 하나 (없으면 chunkSize 0 으로 기억)
+typedef struct {
+    DWORD serial;             // Volume Serial Number
+    TCHAR key[32];            // Profile (tune_profile_key)
+    DWORD chunkSize;          // 저장된 Chunk 크기 (없거나 범위를 벗어나면 0)
+} TUNE_CacheEntry_t;
+
+static SRWLOCK g_cacheLock = SRWLOCK_INIT;
+static TUNE_CacheEntry_t g_cache[TUNE_CACHE_SIZE]; // g_cacheLock 보호
+static DWORD g_cacheCount = 0;                     // 채운 수 (가득 차면 오래된 것부터 덮어씀)
+
+/**
+ * @brief 기억해 둔 Chunk 크기를 찾습니다.
+ *
+ * @return 찾았으면 TRUE
+ */
+static BOOL tune_cache_find(DWORD serial, const TCHAR* key, DWORD* pChunkSize) {
+    BOOL bFound = FALSE;
+
+    AcquireSRWLockShared(&g_cacheLock);
+    DWORD const count = (g_cacheCount < TUNE_CACHE_SIZE) ? g_cacheCount : TUNE_CACHE_SIZE;
+    for (DWORD i = 0; i < count && !bFound; i++) {
+        if (g_cache[i].serial == serial && strcmp(g_cache[i].key, key) == 0) {
+            *pChunkSize = g_cache[i].chunkSize;
+            bFound = TRUE;
+        }
+    }
+    ReleaseSRWLockShared(&g_cacheLock);
+    return bFound;
+}
+
+/**
+ * @brief Chunk 크기를 기억합니다. 같은 (Volume, Profile) 이 있으면 바꿉니다.
+ */
+static void tune_cache_store(DWORD serial, const TCHAR* key, DWORD chunkSize) {
+    AcquireSRWLockExclusive(&g_cacheLock);
+    DWORD const count = (g_cacheCount < TUNE_CACHE_SIZE) ? g_cacheCount : TUNE_CACHE_SIZE;
+    DWORD index = g_cacheCount % TUNE_CACHE_SIZE;
+    BOOL bExisting = FALSE;
+    for (DWORD i = 0; i < count && !bExisting; i++) {
+        if (g_cache[i].serial == serial && strcmp(g_cache[i].key, key) == 0) {
+            index = i;
+            bExisting = TRUE;
+        }
+    }
+    g_cache[index].serial = serial;
+    snprintf(g_cache[index].key, sizeof(g_cache[index].key), "%s", key);
+    g_cache[index].chunkSize = chunkSize;
+    if (!bExisting) {
+        g_cacheCount++;
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+}
+
+/**
+ * @brief 보정 파일 경로 (실행 파일과 같은 폴더의 TUNE_PROFILE_FILE_NAME) 를 구합니다.
+ *
+ * @param path 경로를 저장할 버퍼
+ * @param pathSize 버퍼 크기 (TCHAR 수)
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL tune_profile_path(TCHAR* path, DWORD pathSize) {
+    DWORD const length = GetModuleFileName(NULL, path, pathSize);
+    if (length == 0 || length >= pathSize) {
+        return FALSE;
+    }
+
+    // 실행 파일 이름을 보정 파일 이름으로 바꿈
+    TCHAR* name = path;
+    for (TCHAR* p = path; *p != '\0'; p++) {
+        if (*p == '\\' || *p == '/') {
+            name = p + 1;
+        }
+    }
+    if ((size_t)(name - path) + sizeof(TUNE_PROFILE_FILE_NAME) > pathSize) {
+        return FALSE;
+    }
+    strcpy(name, TUNE_PROFILE_FILE_NAME);
+    return TRUE;
+}
+
+/**
+ * @brief 보정 파일의 Key 를 만듭니다. (예: "ZSTD", "ZSTD.pipeline.direct")
+ *
+ * 같은 장치라도 Pipeline 과 Direct I/O 여부에 따라 가장 좋은 Chunk 크기가 다르므로 따로 저장합니다.
+ */
+void tune_profile_key(CompressionAlgorithm algorithm, const CompressionOptions* options, TCHAR* key, size_t keySize) {
+    BOOL const bPipeline = (algorithm == ZSTD && options != NULL && options->bPipeline);
+    BOOL const bDirect = (options != NULL && options->cacheMode == IO_CACHE_DIRECT);
+
+    snprintf(key, keySize, "%s%s%s", (algorithm == LZ4) ? "LZ4" : "ZSTD",
+             bPipeline ? ".pipeline" : "", bDirect ? ".direct" : "");
+}
+
+/**
+ * @brief 파일이 있는 Volume 의 보정 파일 Section 이름을 만듭니다.
+ *
+ * @return 성공 시 TRUE, Volume 정보를 구할 수 없으면 FALSE
+ */
+static BOOL tune_volume_section(HANDLE hFile, TCHAR* section, size_t sectionSize, DWORD* pSerial) {
+    DWORD serial = 0;
+    if (!GetVolumeInformationByHandleW(hFile, NULL, 0, &serial, NULL, NULL, NULL, 0)) {
+        return FALSE;
+    }
+    snprintf(section, sectionSize, "volume-%08lX", (unsigned long)serial);
+    if (pSerial != NULL) {
+        *pSerial = serial;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 파일이 있는 Volume 과 Profile 에 저장된 Chunk 크기를 찾습니다.
+ *
+ * 보정 파일은 (Volume, Profile) 마다 Process 에서 한 번만 읽고 결과를 기억합니다. (작업마다 파일을 열고 해석하지 않음)
+ *
+ * @param hFile 입력 파일 핸들
+ * @param algorithm 압축 알고리듬
+ * @param options 작업별 옵션 (Profile 을 정함)
+ * @return 저장된 Chunk 크기, 없거나 범위를 벗어나면 0
+ */
+DWORD tune_lookup_chunk_size(HANDLE hFile, CompressionAlgorithm algorithm, const CompressionOptions* options) {
+    TCHAR path[MAX_PATH];
+    TCHAR section[32];
+    TCHAR key[32];
+    DWORD serial;
+    DWORD chunkSize = 0;
+
+    if (!tune_volume_section(hFile, section, sizeof(section), &serial)) {
+        return 0;
+    }
+    tune_profile_key(algorithm, options, key, sizeof(key));
+    if (tune_cache_find(serial, key, &chunkSize)) {
+        return chunkSize;
+    }
+
+    if (tune_profile_path(path, MAX_PATH)) {
+        UINT const value = GetPrivateProfileInt(section, key, 0, path);
+        if (value >= TUNE_MIN_CHUNK_SIZE && value <= TUNE_MAX_CHUNK_SIZE && value % TUNE_MIN_CHUNK_SIZE == 0) {
+            chunkSize = (DWORD)value;
+        }
+    }
+    tune_cache_store(serial, key, chunkSize);
+    return chunkSize;
+}
+
+/**
+ * @brief 예제 파일을 chunkSize 단위로 처음부터 끝까지 읽어, 처리량과 요청당 시간을 잽니다.
+ *
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL tune_measure_read(const TCHAR* samplePath, IoCacheMode cacheMode, DWORD chunkSize, TUNE_Measure_t* measure) {
+    OVERLAPPED overlap = { 0, };
+    ULONGLONG offset = 0;
+    DWORD requests = 0;
+    BOOL bResult = TRUE;
+
+    HANDLE const hFile = init_file_read_ex(samplePath, cacheMode);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return FALSE;
+    }
+    BYTE* const buffer = (BYTE*)async_alloc_aligned(chunkSize);
+    if (buffer == NULL) {
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    ULONGLONG const start = now_micros();
+    for (;;) {
+        DWORD dwBytesRead = 0;
+        async_set_offset(&overlap, offset);
+        if (!async_read(hFile, buffer, chunkSize, &dwBytesRead, &overlap, TRUE)) {
+            bResult = FALSE;
+            break;
+        }
+        requests++;
+        offset += dwBytesRead;
+        if (dwBytesRead < chunkSize) {
+            break;
+        }
+    }
+    ULONGLONG const micros = now_micros() - start + 1;
+
+    measure->readSpeed = (double)offset * 1000000.0 / (double)micros;
+    measure->readLatencyMicros = (double)micros / (double)requests;
+
+    async_free_aligned(buffer);
+    CloseHandle(hFile);
+    return bResult;
+}
+
+/**
+ * @brief 메모리에 있는 데이터를 chunkSize 단위로 Streaming 압축하여 처리량을 잽니다. (압축 옵션은 기본값)
+ *
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL tune_measure_compress(
+    const BYTE* data, size_t size, CompressionAlgorithm algorithm, DWORD chunkSize, TUNE_Measure_t* measure
+) {
+    BOOL bResult = TRUE;
+    ULONGLONG start = 0, micros = 0;
+
+    if (algorithm == LZ4) {
+        LZ4F_preferences_t prefs;
+        LZ4F_cctx* cctx = NULL;
+
+        memset(&prefs, 0, sizeof(prefs));
+        prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+        prefs.frameInfo.blockMode = LZ4F_blockLinked;
+
+        size_t const dstCapacity = LZ4F_compressBound(chunkSize, &prefs) + LZ4F_HEADER_SIZE_MAX;
+        BYTE* const dst = (BYTE*)malloc(dstCapacity);
+        if (dst == NULL || LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION))) {
+            free(dst);
+            return FALSE;
+        }
+
+        start = now_micros();
+        bResult = !LZ4F_isError(LZ4F_compressBegin(cctx, dst, dstCapacity, &prefs));
+        for (size_t pos = 0; bResult && pos < size; pos += chunkSize) {
+            size_t const n = (size - pos < chunkSize) ? size - pos : chunkSize;
+            bResult = !LZ4F_isError(LZ4F_compressUpdate(cctx, dst, dstCapacity, data + pos, n, NULL));
+        }
+        bResult = bResult && !LZ4F_isError(LZ4F_compressEnd(cctx, dst, dstCapacity, NULL));
+        micros = now_micros() - start + 1;
+
+        LZ4F_freeCompressionContext(cctx);
+        free(dst);
+    } else {
+        ZSTD_CCtx* const cctx = ZSTD_createCCtx();
+        size_t const dstCapacity = ZSTD_CStreamOutSize();
+        BYTE* const dst = (BYTE*)malloc(dstCapacity);
+        if (cctx == NULL || dst == NULL ||
+            ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, ZSTD_fast)) ||
+            ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1))) {
+            ZSTD_freeCCtx(cctx);
+            free(dst);
+            return FALSE;
+        }
+
+        start = now_micros();
+        for (size_t pos = 0; bResult && pos < size; pos += chunkSize) {
+            size_t const n = (size - pos < chunkSize) ? size - pos : chunkSize;
+            ZSTD_EndDirective const mode = (pos + n == size) ? ZSTD_e_end : ZSTD_e_continue;
+            ZSTD_inBuffer input = { data + pos, n, 0 };
+            BOOL bFinished;
+            do {
+                ZSTD_outBuffer output = { dst, dstCapacity, 0 };
+                size_t const remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+                bResult = !ZSTD_isError(remaining);
+                bFinished = (mode == ZSTD_e_end) ? (remaining == 0) : (input.pos == input.size);
+            } while (bResult && !bFinished);
+        }
+        micros = now_micros() - start + 1;
+
+        ZSTD_freeCCtx(cctx);
+        free(dst);
+    }
+
+    measure->compressSpeed = (double)size * 1000000.0 / (double)micros;
+    return bResult;
+}
+
+/**
+ * @brief 예제 파일을 chunkSize 로 실제 압축하여 처리량을 잽니다. (TUNE_RUNS 번의 중앙값)
+ *
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL tune_measure_file(
+    const TCHAR* samplePath, const TCHAR* outputPath, ULONGLONG sampleSize,
+    CompressionAlgorithm algorithm, const CompressionOptions* options, DWORD chunkSize, TUNE_Measure_t* measure
+) {
+    CompressionOptions runOptions = *options;
+    runOptions.chunkSize = chunkSize;
+    runOptions.verify = NULL;
+    runOptions.adaptStats = NULL;
+    runOptions.pipelineStats = NULL;
+
+    double speeds[TUNE_RUNS];
+    for (int run = 0; run < TUNE_RUNS; run++) {
+        ULONGLONG const start = now_micros();
+        BOOL const bResult = compress_file_ex(samplePath, outputPath, algorithm, &runOptions);
+        ULONGLONG const micros = now_micros() - start + 1;
+        DeleteFile(outputPath);
+        if (!bResult) {
+            return FALSE;
+        }
+        speeds[run] = (double)sampleSize * 1000000.0 / (double)micros;
+    }
+
+    qsort(speeds, TUNE_RUNS, sizeof(double), compare_double);
+    measure->fileSpeed = speeds[TUNE_RUNS / 2];
+    return TRUE;
+}
+
+/**
+ * @brief 예제 파일의 앞부분 (최대 TUNE_MAX_SAMPLE_SIZE) 을 메모리로 읽습니다.
+ *
+ * @return 읽은 데이터 (free 로 해제), 실패 시 NULL
+ */
+static BYTE* tune_load_sample(HANDLE hFile, ULONGLONG fileSize, size_t* pSize) {
+    OVERLAPPED overlap = { 0, };
+    size_t const size = (fileSize < TUNE_MAX_SAMPLE_SIZE) ? (size_t)fileSize : TUNE_MAX_SAMPLE_SIZE;
+    size_t total = 0;
+
+    BYTE* const data = (BYTE*)malloc(size);
+    if (data == NULL) {
+        return NULL;
+    }
+    while (total < size) {
+        DWORD dwBytesRead = 0;
+        async_set_offset(&overlap, total);
+        if (!async_read(hFile, data + total, (DWORD)(size - total), &dwBytesRead, &overlap, TRUE) || dwBytesRead == 0) {
+            free(data);
+            return NULL;
+        }
+        total += dwBytesRead;
+    }
+    *pSize = size;
+    return data;
+}
+
+/**
+ * @brief 대상 장치의 예제 파일로 Chunk 크기별 성능을 재고, 가장 좋은 크기를 보정 파일에 저장합니다.
+ *
+ * 압축 결과는 예제 파일 옆에 임시로 쓰고 지우므로, 같은 장치에 예제 파일 크기만큼의 여유 공간이 필요합니다.
+ * 예제 파일은 실제로 압축할 데이터와 비슷하고, File Cache 효과가 작도록 충분히 커야 합니다. (수십 MB 이상)
+ *
+ * @param samplePath 대상 장치에 있는 예제 파일 경로
+ * @param algorithm 압축 알고리듬
+ * @param options 실제 압축에 사용할 옵션 (NULL 이면 기본값, chunkSize 는 무시하며 Pipeline / Direct I/O 여부가 Profile)
+ * @param result 측정 결과를 저장할 곳
+ * @return 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL tune_calibrate(
+    const TCHAR* samplePath, CompressionAlgorithm algorithm,
+    const CompressionOptions* options, TUNE_Result_t* result
+) {
+    static const CompressionOptions kDefaultOptions = { 0, };
+    TCHAR outputPath[MAX_PATH];
+    TCHAR profilePath[MAX_PATH];
+    TCHAR section[32];
+    TCHAR value[16];
+    LARGE_INTEGER fileSize;
+    size_t dataSize = 0;
+    BOOL bResult = TRUE;
+
+    if (options == NULL) {
+        options = &kDefaultOptions;
+    }
+    memset(result, 0, sizeof(TUNE_Result_t));
+    tune_profile_key(algorithm, options, result->profile, sizeof(result->profile));
+    snprintf(outputPath, sizeof(outputPath), "%s.tune", samplePath);
+
+    // Volume 확인과 메모리 압축에 사용할 데이터 읽기
+    HANDLE const hFile = init_file_read(samplePath);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return FALSE;
+    }
+    if (!tune_volume_section(hFile, section, sizeof(section), &(result->volumeSerial)) ||
+        !GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+        log_message("Failed to identify calibration sample volume.");
+        CloseHandle(hFile);
+        return FALSE;
+    }
+    BYTE* const data = tune_load_sample(hFile, (ULONGLONG)fileSize.QuadPart, &dataSize);
+    CloseHandle(hFile);
+    if (data == NULL) {
+        log_message("Failed to read calibration sample.");
+        return FALSE;
+    }
+
+    // 첫 크기가 File Cache 를 채우는 비용을 떠안지 않도록 한 번 읽어 둠
+    TUNE_Measure_t warmup;
+    tune_measure_read(samplePath, options->cacheMode, TUNE_MAX_CHUNK_SIZE, &warmup);
+
+    for (DWORD chunkSize = TUNE_MIN_CHUNK_SIZE; bResult && chunkSize <= TUNE_MAX_CHUNK_SIZE; chunkSize *= 2) {
+        TUNE_Measure_t* const measure = &(result->measures[result->count]);
+        measure->chunkSize = chunkSize;
+
+        bResult = tune_measure_read(samplePath, options->cacheMode, chunkSize, measure) &&
+                  tune_measure_compress(data, dataSize, algorithm, chunkSize, measure) &&
+                  tune_measure_file(samplePath, outputPath, (ULONGLONG)fileSize.QuadPart, algorithm, options, chunkSize, measure);
+        if (!bResult) {
+            log_message("Calibration measurement failed.");
+            break;
+        }
+
+        result->count++;
+    }
+    free(data);
+
+    // 가장 빠른 크기에 가까운 (측정 오차 안) 가장 작은 크기
+    double bestSpeed = 0.0;
+    for (DWORD i = 0; i < result->count; i++) {
+        if (result->measures[i].fileSpeed > bestSpeed) {
+            bestSpeed = result->measures[i].fileSpeed;
+        }
+    }
+    for (DWORD i = 0; i < result->count && result->bestChunkSize == 0; i++) {
+        if (result->measures[i].fileSpeed >= bestSpeed * (1.0 - TUNE_TOLERANCE)) {
+            result->bestChunkSize = result->measures[i].chunkSize;
+        }
+    }
+
+    if (bResult) {
+        snprintf(value, sizeof(value), "%lu", (unsigned long)result->bestChunkSize);
+        bResult = tune_profile_path(profilePath, MAX_PATH) &&
+                  WritePrivateProfileString(section, result->profile, value, profilePath);
+        if (!bResult) {
+            log_message("Failed to save calibration profile.");
+        } else {
+            tune_cache_store(result->volumeSerial, result->profile, result->bestChunkSize); // 이후 작업이 바로 사용
+        }
+    }
+    return bResult;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TUNE_H
+#define TUNE_H
+
+#include <windows.h>
+
+#include "compressor.h"
+
+/*
+ * Chunk 크기 보정 (Calibration)
+ *
+ * 한 번에 읽어 압축하는 크기 (Chunk) 는 장치의 I/O 지연/처리량과 CPU Cache 크기에 따라 가장 좋은 값이 다릅니다.
+ * tune_calibrate 는 대상 장치에 있는 예제 파일로 TUNE_MIN_CHUNK_SIZE ~ TUNE_MAX_CHUNK_SIZE 의 크기마다
+ * 읽기 처리량과 지연, 메모리에서의 압축 처리량, 실제 파일 압축 처리량을 재고, 파일 압축이 가장 빠른 크기를
+ * 보정 파일 (실행 파일 옆의 TUNE_PROFILE_FILE_NAME) 에 저장합니다. 가장 빠른 크기와 차이가 TUNE_TOLERANCE 안인
+ * 더 작은 크기가 있으면 그 크기를 고릅니다. (버퍼 메모리와 요청 하나의 지연이 작음)
+ *
+ * 값은 Volume (Volume Serial Number) 과 Profile (알고리듬, Pipeline 사용 여부, Direct I/O 여부) 별로 저장하며,
+ * CompressionOptions.chunkSize 가 0 이면 입력 파일이 있는 Volume 의 값을 기본으로 사용합니다.
+ */
+
+#define TUNE_MIN_CHUNK_SIZE    (4 * 1024)        // 재는 가장 작은 Chunk 크기 (Chunk 크기의 정렬 단위)
+#define TUNE_MAX_CHUNK_SIZE    (4 * 1024 * 1024) // 재는 가장 큰 Chunk 크기
+#define TUNE_SIZE_COUNT        11                // 재는 크기 수 (4 KB 부터 2 배씩)
+#define TUNE_RUNS              3                 // 크기마다 파일 압축을 반복하는 수 (중앙값 사용)
+#define TUNE_TOLERANCE         0.05              // 가장 빠른 크기와 이 비율 안으로 차이나면 측정 오차로 보고 더 작은 크기를 고름
+#define TUNE_MAX_SAMPLE_SIZE   (64 * 1024 * 1024) // 메모리 압축 처리량을 잴 때 사용하는 예제 파일 앞부분 최대 크기
+#define TUNE_PROFILE_FILE_NAME "cesb_tune.ini"   // 보정 파일 이름
+
+// 구조체 선언
+
+typedef struct TUNE_Measure_s TUNE_Measure_t;
+typedef struct TUNE_Result_s TUNE_Result_t;
+
+/*
+ * Chunk 크기 하나의 측정 결과
+ */
+struct TUNE_Measure_s {
+    DWORD chunkSize;          // Chunk 크기
+    double readSpeed;         // 순차 읽기 처리량 (bytes/s)
+    double readLatencyMicros; // 읽기 요청 하나의 평균 시간 (us)
+    double compressSpeed;     // 메모리에서의 압축 처리량 (원본 기준 bytes/s)
+    double fileSpeed;         // compress_file_ex 처리량 (원본 기준 bytes/s, TUNE_RUNS 번의 중앙값)
+};
+
+struct TUNE_Result_s {
+    DWORD volumeSerial;       // 예제 파일이 있는 Volume 의 Serial Number
+    TCHAR profile[32];        // 보정 파일의 Key (알고리듬, Pipeline, Direct I/O)
+    DWORD bestChunkSize;      // 고른 Chunk 크기 (저장한 값)
+    DWORD count;              // measures 의 수
+    TUNE_Measure_t measures[TUNE_SIZE_COUNT]; // 크기별 측정 결과 (작은 것부터)
+};
+
+// 함수 선언
+
+BOOL tune_profile_path(TCHAR* path, DWORD pathSize);
+void tune_profile_key(CompressionAlgorithm algorithm, const CompressionOptions* options, TCHAR* key, size_t keySize);
+DWORD tune_lookup_chunk_size(HANDLE hFile, CompressionAlgorithm algorithm, const CompressionOptions* options);
+BOOL tune_calibrate(
+    const TCHAR* samplePath, CompressionAlgorithm algorithm,
+    const CompressionOptions* options, TUNE_Result_t* result
+);
+
+#endif // TUNE_H
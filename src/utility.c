@@ -75,4 +75,65 @@ TCHAR* get_output_file_name(const TCHAR* filename, CompressionAlgorithm algorith
     strcat(outSpace, filename);
     strcat(outSpace, get_extension(algorithm));
     return (TCHAR*)outSpace;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 현재 시각을 us 단위로 구합니다. (경과 시간, 기다린 시간 측정용)
+ */
+ULONGLONG now_micros(void) {
+    LARGE_INTEGER frequency, now;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (ULONGLONG)(now.QuadPart / frequency.QuadPart) * 1000000 +
+           (ULONGLONG)(now.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+}
+
+/**
+ * @brief qsort 용 double 비교 함수 (오름차순)
+ */
+int compare_double(const void* a, const void* b) {
+    double const x = *(const double*)a;
+    double const y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Little Endian 정수를 씁니다. (파일 형식의 Header/Index 직렬화용)
+ *
+ * @param p 쓸 위치
+ * @param v 값
+ */
+void write_le16(BYTE* p, WORD v) {
+    p[0] = (BYTE)v;
+    p[1] = (BYTE)(v >> 8);
+}
+
+void write_le32(BYTE* p, DWORD v) {
+    p[0] = (BYTE)v;
+    p[1] = (BYTE)(v >> 8);
+    p[2] = (BYTE)(v >> 16);
+    p[3] = (BYTE)(v >> 24);
+}
+
+void write_le64(BYTE* p, ULONGLONG v) {
+    write_le32(p, (DWORD)v);
+    write_le32(p + 4, (DWORD)(v >> 32));
+}
+
+/**
+ * @brief Little Endian 정수를 읽습니다. (정렬되지 않은 위치도 가능)
+ *
+ * @param p 읽을 위치
+ * @return 값
+ */
+WORD read_le16(const BYTE* p) {
+    return (WORD)(p[0] | (p[1] << 8));
+}
+
+DWORD read_le32(const BYTE* p) {
+    return (DWORD)p[0] | ((DWORD)p[1] << 8) | ((DWORD)p[2] << 16) | ((DWORD)p[3] << 24);
+}
+
+ULONGLONG read_le64(const BYTE* p) {
+    return (ULONGLONG)read_le32(p) | ((ULONGLONG)read_le32(p + 4) << 32);
+}
@@ -27,5 +27,14 @@ void log_message(const TCHAR* message);
 DWORD get_file_size(HANDLE hFile);
 const TCHAR* get_extension(CompressionAlgorithm algorithm);
 TCHAR* get_output_file_name(const TCHAR* filename, CompressionAlgorithm algorithm);
+ULONGLONG now_micros(void);
+int compare_double(const void* a, const void* b);
+
+void write_le16(BYTE* p, WORD v);
+void write_le32(BYTE* p, DWORD v);
+void write_le64(BYTE* p, ULONGLONG v);
+WORD read_le16(const BYTE* p);
+DWORD read_le32(const BYTE* p);
+ULONGLONG read_le64(const BYTE* p);
 
 #endif // UTILITY_H
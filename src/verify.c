@@ -0,0 +1,221 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "verify.h"
+#include "crc32c.h"
+#include "utility.h"
+
+/**
+ * @brief 대기열에서 조각을 하나 꺼냅니다. 대기열이 비어 있으면 조각이 들어오거나 닫힐 때까지 기다립니다.
+ *
+ * @return 꺼낸 조각, 대기열이 닫히고 비어 있으면 NULL
+ */
+static VERIFY_Piece_t* verify_pop(VERIFY_Context_t* verifier) {
+    AcquireSRWLockExclusive(&(verifier->lock));
+    while (verifier->head == NULL && !verifier->bClosed) {
+        SleepConditionVariableSRW(&(verifier->notEmpty), &(verifier->lock), INFINITE, 0);
+    }
+
+    VERIFY_Piece_t* const piece = verifier->head;
+    if (piece != NULL) {
+        verifier->head = piece->next;
+        if (verifier->head == NULL) {
+            verifier->tail = NULL;
+        }
+        verifier->queuedBytes -= piece->size;
+        WakeConditionVariable(&(verifier->notFull));
+    }
+    ReleaseSRWLockExclusive(&(verifier->lock));
+
+    return piece;
+}
+
+/**
+ * @brief 압축 데이터 조각 하나를 압축 해제하고, 결과를 Hash 에 이어 붙입니다.
+ */
+static BOOL verify_piece(VERIFY_Context_t* verifier, const BYTE* src, size_t size) {
+    size_t srcPos = 0;
+    BOOL bOutputFull = FALSE;
+
+    // 출력 버퍼를 가득 채운 경우 Decoder 내부에 남은 출력이 있을 수 있으므로 한 번 더 호출
+    while (srcPos < size || bOutputFull) {
+        size_t srcSize = size - srcPos;
+        size_t dstSize = VERIFY_OUTPUT_SIZE;
+
+        if (!decompress_stream(verifier->decomp, src + srcPos, &srcSize, verifier->outBuf, &dstSize)) {
+            return FALSE;
+        }
+        srcPos += srcSize;
+        bOutputFull = (dstSize == VERIFY_OUTPUT_SIZE);
+
+        verifier->result.outputHash = crc32c(verifier->result.outputHash, verifier->outBuf, dstSize);
+        verifier->result.outputBytes += dstSize;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 검증 Thread: 대기열이 닫힐 때까지 조각을 압축 해제합니다.
+ */
+static DWORD WINAPI verify_thread(LPVOID param) {
+    VERIFY_Context_t* const verifier = (VERIFY_Context_t*)param;
+    VERIFY_Piece_t* piece;
+
+    while ((piece = verify_pop(verifier)) != NULL) {
+        if (!verifier->bFailed && !verify_piece(verifier, (const BYTE*)(piece + 1), piece->size)) {
+            log_message("Verify - compressed output does not decompress.");
+            verifier->bFailed = TRUE; // 이후 조각은 대기열을 비우기 위해 꺼내기만 함
+        }
+        free(piece);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 검증 Thread 를 시작합니다.
+ *
+ * @param algorithm 압축 알고리듬
+ * @param options 압축 해제 옵션 (NULL 이면 기본값, 큰 ZSTD Window 로 압축하면 windowLogMax 지정)
+ * @return 검증 컨텍스트, 실패 시 NULL
+ */
+VERIFY_Context_t* verify_start(CompressionAlgorithm algorithm, const DecompressionOptions* options) {
+    VERIFY_Context_t* verifier = (VERIFY_Context_t*)calloc(1, sizeof(VERIFY_Context_t));
+    if (verifier == NULL) {
+        return NULL;
+    }
+
+    InitializeSRWLock(&(verifier->lock));
+    InitializeConditionVariable(&(verifier->notEmpty));
+    InitializeConditionVariable(&(verifier->notFull));
+    verifier->outBuf = (BYTE*)malloc(VERIFY_OUTPUT_SIZE);
+
+    if (verifier->outBuf != NULL && create_decompressor_ex(&(verifier->decomp), algorithm, options)) {
+        verifier->hThread = CreateThread(NULL, 0, verify_thread, verifier, 0, NULL);
+        if (verifier->hThread != NULL) {
+            return verifier;
+        }
+    }
+
+    log_message("Failed to start verifier.");
+    free_decompressor(verifier->decomp);
+    free(verifier->outBuf);
+    free(verifier);
+    return NULL;
+}
+
+/**
+ * @brief 압축할 원본을 Hash 에 이어 붙입니다. (압축하는 Thread 에서 읽은 직후 호출)
+ *
+ * @param verifier 검증 컨텍스트 (NULL 이면 아무것도 하지 않음)
+ * @param src 원본
+ * @param size 원본 크기
+ */
+void verify_input(VERIFY_Context_t* verifier, const void* src, size_t size) {
+    if (verifier == NULL) {
+        return;
+    }
+
+    verifier->result.inputHash = crc32c(verifier->result.inputHash, src, size);
+    verifier->result.inputBytes += size;
+}
+
+/**
+ * @brief 압축 데이터를 복사하여 검증 Thread 로 보냅니다. (출력 버퍼를 다시 사용하기 전에 호출)
+ *
+ * 대기열이 가득 차 있으면 공간이 생길 때까지 기다립니다.
+ *
+ * @param verifier 검증 컨텍스트 (NULL 이면 아무것도 하지 않음)
+ * @param compressed 압축 데이터
+ * @param size 압축 데이터 크기
+ * @return 성공 여부 (메모리 부족 시 FALSE)
+ */
+BOOL verify_output(VERIFY_Context_t* verifier, const void* compressed, size_t size) {
+    if (verifier == NULL || size == 0) {
+        return TRUE;
+    }
+
+    VERIFY_Piece_t* const piece = (VERIFY_Piece_t*)malloc(sizeof(VERIFY_Piece_t) + size);
+    if (piece == NULL) {
+        log_message("Verify - failed to allocate piece.");
+        return FALSE;
+    }
+    piece->size = size;
+    piece->next = NULL;
+    memcpy(piece + 1, compressed, size);
+
+    AcquireSRWLockExclusive(&(verifier->lock));
+    if (verifier->queuedBytes > 0 && verifier->queuedBytes + size > VERIFY_QUEUE_MAX_BYTES) {
+        ULONGLONG const start = GetTickCount64();
+        while (verifier->queuedBytes > 0 && verifier->queuedBytes + size > VERIFY_QUEUE_MAX_BYTES) {
+            SleepConditionVariableSRW(&(verifier->notFull), &(verifier->lock), INFINITE, 0);
+        }
+        verifier->result.stallMicros += (GetTickCount64() - start) * 1000;
+    }
+
+    if (verifier->tail != NULL) {
+        verifier->tail->next = piece;
+    } else {
+        verifier->head = piece;
+    }
+    verifier->tail = piece;
+    verifier->queuedBytes += size;
+    verifier->result.compressedBytes += size;
+    WakeConditionVariable(&(verifier->notEmpty));
+    ReleaseSRWLockExclusive(&(verifier->lock));
+
+    return TRUE;
+}
+
+/**
+ * @brief 남은 조각의 검증이 끝날 때까지 기다리고, 결과를 비교한 뒤 검증 컨텍스트를 해제합니다.
+ *
+ * @param verifier 검증 컨텍스트 (NULL 허용)
+ * @param result 검증 결과 (NULL 허용)
+ * @return 압축 해제 결과가 원본과 같으면 TRUE
+ */
+BOOL verify_finish(VERIFY_Context_t* verifier, VERIFY_Result_t* result) {
+    if (verifier == NULL) {
+        return FALSE;
+    }
+
+    AcquireSRWLockExclusive(&(verifier->lock));
+    verifier->bClosed = TRUE;
+    WakeAllConditionVariable(&(verifier->notEmpty));
+    ReleaseSRWLockExclusive(&(verifier->lock));
+
+    WaitForSingleObject(verifier->hThread, INFINITE);
+    CloseHandle(verifier->hThread);
+
+    // 마지막 Frame 까지 끝났고, 길이와 Hash 가 모두 같아야 함
+    verifier->result.bVerified = !verifier->bFailed && verifier->decomp->bFrameEnd &&
+        verifier->result.inputBytes == verifier->result.outputBytes &&
+        verifier->result.inputHash == verifier->result.outputHash;
+    if (!verifier->result.bVerified) {
+        log_message("Verify - decompressed output does not match the input.");
+    }
+
+    BOOL const bVerified = verifier->result.bVerified;
+    if (result != NULL) {
+        *result = verifier->result;
+    }
+
+    free_decompressor(verifier->decomp);
+    free(verifier->outBuf);
+    free(verifier);
+    return bVerified;
+}
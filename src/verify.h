@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025, SN7B2XV
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <windows.h>
+
+#include "compressor.h"
+#include "decompressor.h"
+
+/*
+ * 쓰기 후 검증 (Verify-After-Write)
+ *
+ * 압축 중에 만들어진 압축 데이터를 메모리에 있는 동안 복사하여 검증 Thread 로 보내고,
+ * 검증 Thread 는 이를 압축 해제하여 원본과 같은지 확인합니다.
+ * 원본은 압축하는 Thread 가 읽은 직후 CRC32C 로 이어서 Hash 하고, 검증 Thread 는 압축 해제 결과를
+ * 같은 방식으로 Hash 하여 마지막에 비교하므로, 입력/출력 파일을 다시 읽지 않습니다.
+ *
+ * 대기열에 쌓인 압축 데이터가 VERIFY_QUEUE_MAX_BYTES 를 넘으면 압축하는 Thread 가 잠시 기다립니다.
+ */
+
+#define VERIFY_QUEUE_MAX_BYTES (8 * 1024 * 1024) // 검증 대기열의 최대 압축 데이터 크기
+#define VERIFY_OUTPUT_SIZE     (256 * 1024)      // 검증 Thread 의 압축 해제 버퍼 크기
+
+// 구조체 선언
+
+typedef struct VERIFY_Piece_s VERIFY_Piece_t;
+typedef struct VERIFY_Context_s VERIFY_Context_t;
+
+struct VERIFY_Result_s { // VERIFY_Result_t (compressor.h 에서 선언)
+    BOOL bVerified;           // 압축 해제 결과가 원본과 같으면 TRUE
+    ULONGLONG inputBytes;     // Hash 한 원본 크기
+    ULONGLONG outputBytes;    // 검증 Thread 가 압축 해제한 크기
+    ULONGLONG compressedBytes;// 검증 Thread 로 보낸 압축 데이터 크기
+    DWORD inputHash;          // 원본의 CRC32C
+    DWORD outputHash;         // 압축 해제 결과의 CRC32C
+    ULONGLONG stallMicros;    // 대기열이 가득 차서 압축하는 Thread 가 기다린 시간 (us)
+};
+
+struct VERIFY_Piece_s {
+    size_t size;              // 압축 데이터 크기
+    VERIFY_Piece_t* next;     // 다음 조각
+    // 뒤에 압축 데이터가 이어짐
+};
+
+struct VERIFY_Context_s {
+    HANDLE hThread;                // 검증 Thread
+    SRWLOCK lock;                  // 대기열 보호
+    CONDITION_VARIABLE notEmpty;   // 대기열에 조각이 들어옴 (또는 종료 요청)
+    CONDITION_VARIABLE notFull;    // 대기열에 공간이 생김
+    VERIFY_Piece_t* head;          // 대기열 처음
+    VERIFY_Piece_t* tail;          // 대기열 끝
+    size_t queuedBytes;            // 대기열의 압축 데이터 크기
+    BOOL bClosed;                  // 더 이상 조각이 들어오지 않음
+    BOOL bFailed;                  // 압축 해제 실패 (이후 조각은 버림)
+
+    DECOMP_Context_t* decomp;      // 검증 Thread 의 압축 해제 컨텍스트
+    BYTE* outBuf;                  // 압축 해제 버퍼
+    VERIFY_Result_t result;        // 진행 중인 결과
+};
+
+// 함수 선언
+
+VERIFY_Context_t* verify_start(CompressionAlgorithm algorithm, const DecompressionOptions* options);
+void verify_input(VERIFY_Context_t* verifier, const void* src, size_t size);
+BOOL verify_output(VERIFY_Context_t* verifier, const void* compressed, size_t size);
+BOOL verify_finish(VERIFY_Context_t* verifier, VERIFY_Result_t* result);
+
+#endif // VERIFY_H
@@ -13,20 +13,163 @@
  * Portions of the code related to file I/O have been changed.
  */
 
+#define ZSTD_STATIC_LINKING_ONLY // ZSTD_CCtx_refThreadPool, ZSTD_c_srcSizeHint, ZSTD_estimate*
+
 #include <stdio.h>     // printf
 #include <stdlib.h>    // free
 #include <string.h>    // memset, strcat, strlen
 
 #include "zstd_nb.h"
 #include "asyncio_win.h"
+#include "pipeline.h"
 #include "utility.h"
 
-BOOL create_resources(resources_t** ress)
+#define ZSTD_STAGE_MIN_ROOM (4 * 1024) /* smallest output space handed to zstd from the stage */
+#define ZSTD_POOL_WAIT_MS 50           /* longest wait for another job on the shared pool to progress */
+#define ZSTD_ADAPT_JOB_SIZE (1024 * 1024) /* job size when the level adapts, so a new level applies soon */
+#define ZSTD_LONG_PARAM_COUNT 6            /* long-range parameters in CompressionOptions */
+#define ZSTD_LONG_DEFAULT_WINDOW_LOG 27    /* window zstd uses with long-distance matching (ZSTD_LDM_DEFAULT_WINDOW_LOG) */
+#define ZSTD_LDM_DEFAULT_HASH_RATE_LOG 7   /* zstd's LDM defaults for ZSTD_fast (zstd_ldm.c) */
+#define ZSTD_LDM_DEFAULT_MIN_MATCH 64
+#define ZSTD_LDM_DEFAULT_BUCKET_SIZE_LOG 4
+
+/* With workers on a shared pool, zstd only hands a job to the pool when a
+ * thread is free. While this context has jobs of its own in flight zstd
+ * blocks on them, so a call returns without progress only when other jobs
+ * hold every thread. Sleep until one of them reports progress (its thread
+ * may be free again) instead of calling again right away, and report our
+ * own progress to the others. The timeout covers a job that frees its
+ * threads without reporting, e.g. on an error. */
+static void ZSTD_NB_Backoff(resources_t* ress, LONG generation, size_t inputPosBefore,
+                            const ZSTD_inBuffer* input, const ZSTD_outBuffer* output)
+{
+    if (ress->sharedPool == NULL) {
+        return;
+    }
+    if (input->pos == inputPosBefore && output->pos == 0) {
+        task_pool_zstd_wait(ress->sharedPool, generation, ZSTD_POOL_WAIT_MS);
+    } else if (output->pos > 0) {
+        task_pool_zstd_progress(ress->sharedPool);
+    }
+}
+
+/* The shared pool's progress count before a call, for ZSTD_NB_Backoff. */
+static LONG ZSTD_NB_Generation(const resources_t* ress)
+{
+    return (ress->sharedPool != NULL) ? ress->sharedPool->zstdGeneration : 0;
+}
+
+/* The long-range parameters given in the options, as (parameter, value)
+ * pairs, so the same list configures a context and a memory estimate.
+ * Zero means the zstd default and is left out. */
+static int ZSTD_NB_LongRangeParams(const CompressionOptions* options, ZSTD_cParameter* params, int* values)
+{
+    int count = 0;
+    if (options->bZstdLongDistance) {
+        params[count] = ZSTD_c_enableLongDistanceMatching;
+        values[count++] = ZSTD_ps_enable;
+    }
+    if (options->zstdWindowLog != 0) {
+        params[count] = ZSTD_c_windowLog;
+        values[count++] = options->zstdWindowLog;
+    }
+    if (options->zstdLdmHashLog != 0) {
+        params[count] = ZSTD_c_ldmHashLog;
+        values[count++] = options->zstdLdmHashLog;
+    }
+    if (options->zstdLdmMinMatch != 0) {
+        params[count] = ZSTD_c_ldmMinMatch;
+        values[count++] = options->zstdLdmMinMatch;
+    }
+    if (options->zstdLdmBucketSizeLog != 0) {
+        params[count] = ZSTD_c_ldmBucketSizeLog;
+        values[count++] = options->zstdLdmBucketSizeLog;
+    }
+    if (options->zstdLdmHashRateLog != 0) {
+        params[count] = ZSTD_c_ldmHashRateLog;
+        values[count++] = options->zstdLdmHashRateLog;
+    }
+    return count;
+}
+
+/* Without a known size, a streaming context allocates the whole window.
+ * Hint the input size so zstd shrinks a long-range window to fit it (the
+ * hint only picks parameters, frames still end wherever we end them). */
+static int ZSTD_NB_SizeHint(ULONGLONG srcSize)
+{
+    return (srcSize > (ULONGLONG)ZSTD_SRCSIZEHINT_MAX) ? ZSTD_SRCSIZEHINT_MAX : (int)srcSize;
+}
+
+size_t zstd_estimate_memory(const CompressionOptions* options, ULONGLONG srcSize, size_t* pDecompressMemory)
+{
+    ZSTD_cParameter params[ZSTD_LONG_PARAM_COUNT];
+    int values[ZSTD_LONG_PARAM_COUNT];
+    int const count = ZSTD_NB_LongRangeParams(options, params, values);
+    size_t compressMemory = 0;
+
+    /* The window the encoder ends up with; the decoder needs the same. */
+    ZSTD_compressionParameters cParams = ZSTD_getCParams(ZSTD_fast, ZSTD_CONTENTSIZE_UNKNOWN, 0);
+    if (options->bZstdLongDistance) {
+        cParams.windowLog = ZSTD_LONG_DEFAULT_WINDOW_LOG;
+    }
+    if (options->zstdWindowLog != 0) {
+        cParams.windowLog = (unsigned)options->zstdWindowLog;
+    }
+    if (count != 0 && srcSize != 0) {
+        cParams = ZSTD_adjustCParams(cParams, (unsigned long long)ZSTD_NB_SizeHint(srcSize), 0);
+    }
+
+    /* One thread's context; each zstd worker adds about the same again. */
+    ZSTD_CCtx_params* const cctxParams = ZSTD_createCCtxParams();
+    if (cctxParams != NULL) {
+        size_t result = ZSTD_CCtxParams_setParameter(cctxParams, ZSTD_c_compressionLevel, ZSTD_fast);
+        for (int i = 0; i < count && !ZSTD_isError(result); i++) {
+            result = ZSTD_CCtxParams_setParameter(cctxParams, params[i], values[i]);
+        }
+        if (!ZSTD_isError(result) && count != 0 && srcSize != 0) {
+            result = ZSTD_CCtxParams_setParameter(cctxParams, ZSTD_c_srcSizeHint, ZSTD_NB_SizeHint(srcSize));
+        }
+
+        /* zstd derives unset LDM parameters only when it starts a frame, and
+         * its estimate divides by the unset minimum match, so fill in the
+         * same defaults (ZSTD_ldm_adjustParameters with ZSTD_fast). */
+        if (!ZSTD_isError(result) && options->bZstdLongDistance) {
+            int const windowLog = (int)cParams.windowLog;
+            int const hashRateLog = (options->zstdLdmHashRateLog != 0) ? options->zstdLdmHashRateLog :
+                (options->zstdLdmHashLog != 0 && windowLog > options->zstdLdmHashLog) ?
+                windowLog - options->zstdLdmHashLog : ZSTD_LDM_DEFAULT_HASH_RATE_LOG;
+            int hashLog = (options->zstdLdmHashLog != 0) ? options->zstdLdmHashLog : windowLog - hashRateLog;
+            hashLog = (hashLog < ZSTD_HASHLOG_MIN) ? ZSTD_HASHLOG_MIN : (hashLog > ZSTD_HASHLOG_MAX) ? ZSTD_HASHLOG_MAX : hashLog;
+
+            ZSTD_CCtxParams_setParameter(cctxParams, ZSTD_c_ldmHashRateLog, hashRateLog);
+            ZSTD_CCtxParams_setParameter(cctxParams, ZSTD_c_ldmHashLog, hashLog);
+            if (options->zstdLdmMinMatch == 0) {
+                ZSTD_CCtxParams_setParameter(cctxParams, ZSTD_c_ldmMinMatch, ZSTD_LDM_DEFAULT_MIN_MATCH);
+            }
+            if (options->zstdLdmBucketSizeLog == 0) {
+                ZSTD_CCtxParams_setParameter(cctxParams, ZSTD_c_ldmBucketSizeLog, ZSTD_LDM_DEFAULT_BUCKET_SIZE_LOG);
+            }
+        }
+        if (!ZSTD_isError(result)) {
+            compressMemory = ZSTD_estimateCStreamSize_usingCCtxParams(cctxParams);
+        }
+        ZSTD_freeCCtxParams(cctxParams);
+    }
+
+    if (pDecompressMemory != NULL) {
+        *pDecompressMemory = ZSTD_estimateDStreamSize((size_t)1 << cParams.windowLog);
+    }
+    return ZSTD_isError(compressMemory) ? 0 : compressMemory;
+}
+
+BOOL create_resources(resources_t** ress, const CompressionOptions* options)
 {
     *ress = (resources_t*)calloc(1, sizeof(resources_t));
-    (*ress)->srcBufMaxSize = ZSTD_CStreamInSize();   /* can always read one full block */
+    (*ress)->throttle = options->throttle;
+    (*ress)->options = *options;
+    (*ress)->srcBufMaxSize = (options->chunkSize != 0) ? options->chunkSize : ZSTD_CStreamInSize();
     (*ress)->dstBufMaxSize = ZSTD_CStreamOutSize();  /* can always flush a full block */
-    (*ress)->srcBuf = malloc((*ress)->srcBufMaxSize);
+    (*ress)->srcBuf = async_alloc_aligned((*ress)->srcBufMaxSize); /* aligned for direct I/O */
     (*ress)->dstBuf= malloc((*ress)->dstBufMaxSize);
 
     /* Create the context. */
@@ -34,13 +177,68 @@ BOOL create_resources(resources_t** ress)
 
     /* Set any compression parameters you want here.
      * They will persist for every compression operation.
-     * Here we set the compression level, and disable the checksum.
+     * Here we set the compression level, and enable the content checksum
+     * unless it was turned off. The zstd format has no per-block checksum,
+     * so CHECKSUM_BLOCK falls back to the content checksum.
      */
+    int const checksumFlag = (options->checksum != CHECKSUM_NONE);
     size_t const zstdSetLevelResult = ZSTD_CCtx_setParameter((*ress)->cctxPtr, ZSTD_c_compressionLevel, ZSTD_fast);
-    size_t const zstdSetCheckSumResult = ZSTD_CCtx_setParameter((*ress)->cctxPtr, ZSTD_c_checksumFlag, 1);
+    size_t const zstdSetCheckSumResult = ZSTD_CCtx_setParameter((*ress)->cctxPtr, ZSTD_c_checksumFlag, checksumFlag);
+
+    /* Long-distance matching and a larger window for repeats far apart. */
+    ZSTD_cParameter longParams[ZSTD_LONG_PARAM_COUNT];
+    int longValues[ZSTD_LONG_PARAM_COUNT];
+    int const longCount = ZSTD_NB_LongRangeParams(options, longParams, longValues);
+    size_t zstdLongResult = 0;
+    for (int i = 0; i < longCount && !ZSTD_isError(zstdLongResult) && (*ress)->cctxPtr != NULL; i++) {
+        zstdLongResult = ZSTD_CCtx_setParameter((*ress)->cctxPtr, longParams[i], longValues[i]);
+    }
+    if (ZSTD_isError(zstdLongResult)) {
+        log_message("error : Invalid ZSTD long-range parameter.");
+    }
     
+    /* With a shared pool, compress with as many zstd workers as the pool has
+     * zstd threads and run them there instead of spawning our own.
+     * A single zstd thread gains nothing from zstd's job splitting, and many
+     * jobs queueing on one worker cost several times the CPU of compressing
+     * in the calling thread, so that case (and a library built without
+     * multithreading) keeps compressing in this thread.
+     */
+    size_t zstdPoolResult = 0;
+    if (options->pool != NULL && options->pool->zstdWorkerCount > 1 && (*ress)->cctxPtr != NULL) {
+        size_t const workersResult = ZSTD_CCtx_setParameter(
+            (*ress)->cctxPtr, ZSTD_c_nbWorkers, (int)options->pool->zstdWorkerCount
+        );
+        if (ZSTD_isError(workersResult)) {
+            log_message("ZSTD multithreading is not supported; compressing in the calling thread.");
+        } else {
+            zstdPoolResult = ZSTD_CCtx_refThreadPool((*ress)->cctxPtr, options->pool->zstdPool);
+            (*ress)->bMultithreaded = TRUE;
+            (*ress)->sharedPool = options->pool;
+        }
+    }
+
+    /* A deadline changes the level while compressing. Single-threaded zstd
+     * only applies a new level at the next frame, while a worker applies it
+     * to the next job, so (like zstd --adapt) compress on one worker of our
+     * own unless the pool provides workers, and keep the jobs small.
+     * Without multithreading, the frame ends at each level change instead.
+     * Adapting to the output keeps compressing in this thread: the worker
+     * hand-off costs more than the occasional frame end.
+     */
+    if (options->deadlineMillis != 0 && (*ress)->cctxPtr != NULL) {
+        if (!(*ress)->bMultithreaded && options->pool == NULL) {
+            size_t const workersResult = ZSTD_CCtx_setParameter((*ress)->cctxPtr, ZSTD_c_nbWorkers, 1);
+            (*ress)->bMultithreaded = !ZSTD_isError(workersResult);
+        }
+        if ((*ress)->bMultithreaded) {
+            ZSTD_CCtx_setParameter((*ress)->cctxPtr, ZSTD_c_jobSize, ZSTD_ADAPT_JOB_SIZE);
+        }
+    }
+
     if ((*ress)->cctxPtr != NULL && (*ress)->srcBuf && (*ress)->dstBuf &&
-        !ZSTD_isError(zstdSetLevelResult) && !ZSTD_isError(zstdSetCheckSumResult)
+        !ZSTD_isError(zstdSetLevelResult) && !ZSTD_isError(zstdSetCheckSumResult) &&
+        !ZSTD_isError(zstdLongResult) && !ZSTD_isError(zstdPoolResult)
     ) { 
         return TRUE;
     }
@@ -57,16 +255,52 @@ void free_resources(resources_t* ress)
          return;
     }
 
-    ZSTD_freeCCtx(ress->cctxPtr);
-    free(ress->srcBuf);
+    if (ress->verifier != NULL) {
+        verify_finish(ress->verifier, NULL); /* stop the verifier thread */
+    }
+    io_stage_free(ress->stage);
+    adapt_free(ress->adapt);
+    ZSTD_freeCCtx(ress->cctxPtr); /* before the prefix it references goes away */
+    if (ress->sharedPool != NULL) {
+        task_pool_zstd_progress(ress->sharedPool); /* our pool threads are free now */
+    }
+    io_unmap_file(&(ress->reference));
+    async_free_aligned(ress->srcBuf);
     free(ress->dstBuf);
 }
 
+/* Reports a compressed chunk to the level controller and switches to the
+ * level it picks. Returns TRUE when the current frame has to end for the new
+ * level to take effect (single-threaded zstd applies it to the next frame). */
+static BOOL ZSTD_NB_Adapt(resources_t* ress, size_t bytes)
+{
+    /* Workers run behind the input zstd has taken in, so count what they
+     * have actually compressed. Progress restarts with every frame. */
+    if (ress->bMultithreaded && ress->adapt != NULL) {
+        ZSTD_frameProgression const progress = ZSTD_getFrameProgression(ress->cctxPtr);
+        if (progress.consumed < ress->adaptConsumed) {
+            ress->adaptConsumed = 0;
+        }
+        bytes = (size_t)(progress.consumed - ress->adaptConsumed);
+        ress->adaptConsumed = progress.consumed;
+    }
+
+    if (!adapt_update(ress->adapt, bytes)) {
+        return FALSE;
+    }
+
+    size_t const result = ZSTD_CCtx_setParameter(ress->cctxPtr, ZSTD_c_compressionLevel, adapt_level(ress->adapt));
+    if (ZSTD_isError(result)) {
+        log_message("ZSTD level change failed; keeping the current level.");
+        return FALSE;
+    }
+    return !ress->bMultithreaded;
+}
+
 BOOL ZSTD_NB_Process(resources_t* ress, HANDLE hInput, HANDLE hOutput)
 {
     BOOL bResult = TRUE;
-    BOOL bFirst = TRUE;
-    // int cnt = 0;
+    BOOL bWritePending = FALSE; // Write issued but not yet completed
 
     /* This loop read from the input file, compresses that entire chunk,
      * and writes all output produced to the output file.
@@ -75,10 +309,16 @@ BOOL ZSTD_NB_Process(resources_t* ress, HANDLE hInput, HANDLE hOutput)
     DWORD const toRead = ress->srcBufMaxSize;
     DWORD dwRead, dwBytesRead, dwBytesWritten;
     OVERLAPPED readOverlap = { 0, }, writeOverlap = { 0, }; // OVERLAPPED structure for asynchronous operations
+    ULONGLONG readOffset = 0, writeOffset = 0; // 64-bit file offsets (OVERLAPPED.Offset alone wraps at 4 GB)
+    ULONGLONG bytesSinceFlush = 0;             // Input compressed since the last flush point
+    ULONGLONG lastFlushTick = GetTickCount64(); // Time of the last flush point
+    BOOL bLevelChanged = FALSE;                 // A new level waits for the next frame
+    ULONGLONG writeWaitMicros = 0;              // Time spent waiting on the output since the last report
     for (;;) {
-        bAsyncResult = async_read(
+        async_set_offset(&readOverlap, readOffset);
+        bAsyncResult = async_read_ex(
             hInput, ress->srcBuf, toRead,
-            &dwBytesRead, &readOverlap, TRUE
+            &dwBytesRead, &readOverlap, TRUE, ress->throttle
         );
         if (bAsyncResult == FALSE) {
             log_message("async_read failed!");
@@ -93,10 +333,24 @@ BOOL ZSTD_NB_Process(resources_t* ress, HANDLE hInput, HANDLE hOutput)
          */
 
         dwRead = dwBytesRead;
-        readOverlap.Offset += dwBytesRead; // Update offset by amount read
+        readOffset += dwBytesRead; // Update offset by amount read
+        verify_input(ress->verifier, ress->srcBuf, dwRead);
+        io_stage_add_input(ress->stage, dwRead);
 
         int const lastChunk = (dwRead < toRead);
-        ZSTD_EndDirective const mode = lastChunk ? ZSTD_e_end : ZSTD_e_continue;
+        /* A flush point ends the current frame after this chunk. The next
+         * ZSTD_compressStream2() call starts a new frame with the same
+         * parameters, so every ended frame can be recovered on its own.
+         * A pending level change ends the frame the same way.
+         */
+        bytesSinceFlush += dwRead;
+        int const flushPoint = !lastChunk && (bLevelChanged ||
+            compress_flush_point_due(&(ress->options), bytesSinceFlush, lastFlushTick));
+        if (flushPoint) {
+            bytesSinceFlush = 0;
+            lastFlushTick = GetTickCount64();
+        }
+        ZSTD_EndDirective const mode = (lastChunk || flushPoint) ? ZSTD_e_end : ZSTD_e_continue;
         /* Set the input buffer to what we just read.
          * We compress until the input buffer is empty, each time flushing the
          * output.
@@ -107,66 +361,239 @@ BOOL ZSTD_NB_Process(resources_t* ress, HANDLE hInput, HANDLE hOutput)
             /* Compress into the output buffer and write all of the output to
              * the file so we can reuse the buffer next iteration.
              */
-            ZSTD_outBuffer output = { ress->dstBuf, ress->dstBufMaxSize, 0 };
-            size_t const remaining = ZSTD_compressStream2(ress->cctxPtr, &output, &input, mode);
-            if (ZSTD_isError(remaining)) {
-                log_message("ZSTD Compress Stream failed!");
+            /* The previous write still reads from dstBuf, so it must complete
+             * before zstd writes into the buffer again. It overlaps with the
+             * read above.
+             */
+            ULONGLONG waitStart = now_micros();
+            if (bWritePending) {
+                bWritePending = FALSE;
+                bResult = async_wait(hOutput, &writeOverlap, &dwBytesWritten, ress->throttle);
+                if (bResult == FALSE) {
+                    break; // Exit on error
+                }
+                writeOffset += dwBytesWritten; // Update offset by amount written
             }
 
-            if (!bFirst) {
-                // Check the result of the asynchronous operation
-                bResult = GetOverlappedResult(hOutput, &writeOverlap, &dwBytesWritten, TRUE);
-                writeOverlap.Offset += dwBytesWritten; // Update offset by amount written
+            /* With a stage, zstd compresses straight into whatever is left
+             * of the stage buffer, so every write is a full buffer. */
+            void* dst = ress->dstBuf;
+            size_t dstCapacity = ress->dstBufMaxSize;
+            if (ress->stage != NULL) {
+                dst = io_stage_reserve(ress->stage, ZSTD_STAGE_MIN_ROOM);
+                if (dst == NULL) {
+                    bResult = FALSE;
+                    break; // Exit on error
+                }
+                dstCapacity = io_stage_room(ress->stage);
             }
+            writeWaitMicros += now_micros() - waitStart;
 
-            bAsyncResult = async_write(
-                hOutput, ress->dstBuf, output.pos,
-                &dwBytesWritten, &writeOverlap, FALSE
-            );
-            if (bAsyncResult == FALSE) {
-                log_message("async_write failed!");
+            ZSTD_outBuffer output = { dst, dstCapacity, 0 };
+            size_t const inputPosBefore = input.pos;
+            LONG const generation = ZSTD_NB_Generation(ress);
+            size_t const remaining = ZSTD_compressStream2(ress->cctxPtr, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                log_message("ZSTD Compress Stream failed!");
                 bResult = FALSE;
                 break; // Exit on error
             }
-            /* If we're on the last chunk we're finished when zstd returns 0,
+            ZSTD_NB_Backoff(ress, generation, inputPosBefore, &input, &output);
+
+            waitStart = now_micros();
+            if (output.pos > 0 && ress->stage != NULL) {
+                /* Gather the output into large aligned writes. Copy it to
+                 * the verifier first: the commit may submit the buffer. */
+                if (!verify_output(ress->verifier, dst, output.pos) ||
+                    !io_stage_commit(ress->stage, output.pos)) {
+                    log_message("async_write failed!");
+                    bResult = FALSE;
+                    break; // Exit on error
+                }
+            } else if (output.pos > 0) {
+                async_set_offset(&writeOverlap, writeOffset);
+                bAsyncResult = async_write_ex(
+                    hOutput, ress->dstBuf, output.pos,
+                    &dwBytesWritten, &writeOverlap, FALSE, ress->throttle
+                );
+                if (bAsyncResult == FALSE) {
+                    log_message("async_write failed!");
+                    bResult = FALSE;
+                    break; // Exit on error
+                }
+                bWritePending = TRUE;
+
+                /* Copy the output to the verifier while the write reads the
+                 * same buffer. */
+                if (!verify_output(ress->verifier, ress->dstBuf, output.pos)) {
+                    bResult = FALSE;
+                    break; // Exit on error
+                }
+            }
+            writeWaitMicros += now_micros() - waitStart;
+            /* If we're ending a frame we're finished when zstd returns 0,
              * which means its consumed all the input AND finished the frame.
              * Otherwise, we're finished when we've consumed all the input.
              */
-            finished = lastChunk ? (remaining == 0) : (input.pos == input.size);
-            if (bFirst) {
-                bFirst = FALSE;
-            }
+            finished = (mode == ZSTD_e_end) ? (remaining == 0) : (input.pos == input.size);
         } while (!finished);
 
+        if (!bResult || lastChunk) {
+            break;
+        }
+        /* Tell the level controller how long the output held us up and
+         * whether the last write is still in flight. */
+        BOOL const bWriteInFlight = (ress->stage != NULL) ?
+            (ress->stage->bWritePending && !HasOverlappedIoCompleted(&(ress->stage->overlap))) :
+            (bWritePending && !HasOverlappedIoCompleted(&writeOverlap));
+        adapt_add_wait(ress->adapt, writeWaitMicros, bWriteInFlight ? 1 : 0, 1);
+        writeWaitMicros = 0;
+        bLevelChanged = ZSTD_NB_Adapt(ress, dwRead) || (bLevelChanged && !flushPoint);
+
         if (input.pos != input.size) {
             bResult = FALSE;
             log_message("Impossible: zstd only returns 0 when the input is completely consumed!");
             break;
         }
-        
-        if (!bResult || lastChunk) {
+    }
+
+    /* Wait for the last write so the OVERLAPPED structure and dstBuf outlive it. */
+    if (bWritePending && !async_wait(hOutput, &writeOverlap, &dwBytesWritten, ress->throttle)) {
+        bResult = FALSE;
+    }
+
+    /* Write what is left in the stage and trim the padded tail. */
+    if (bResult && ress->stage != NULL && !io_stage_finish(ress->stage)) {
+        bResult = FALSE;
+    }
+
+    return bResult;
+}
+
+/* Hands a filled output chunk to the writer thread and takes an empty one.
+ * The verifier gets its copy first because the writer reuses the chunk. */
+static PIPE_Chunk_t* ZSTD_NB_SubmitChunk(resources_t* ress, PIPE_Context_t* pipe, PIPE_Chunk_t* out)
+{
+    if (!verify_output(ress->verifier, out->data, out->size)) {
+        pipe_submit_output(pipe, out);
+        return NULL;
+    }
+    pipe_submit_output(pipe, out);
+    return pipe_get_output(pipe);
+}
+
+BOOL ZSTD_NB_ProcessPipelined(resources_t* ress, HANDLE hInput, HANDLE hOutput)
+{
+    BOOL bResult = TRUE;
+
+    /* The reader and writer threads own all file I/O (and the stage), so
+     * this thread only waits when there is no input chunk to compress or
+     * no empty output chunk to compress into.
+     */
+    PIPE_Context_t* const pipe = pipe_start(
+        hInput, hOutput, ress->options.chunkSize, PIPE_DEFAULT_CHUNK_SIZE,
+        ress->options.pipelineDepth, ress->stage, ress->throttle
+    );
+    if (pipe == NULL) {
+        return FALSE;
+    }
+
+    ULONGLONG bytesSinceFlush = 0;             // Input compressed since the last flush point
+    ULONGLONG lastFlushTick = GetTickCount64(); // Time of the last flush point
+    BOOL bLevelChanged = FALSE;                 // A new level waits for the next frame
+    ULONGLONG outputStallReported = 0;          // Output stall already reported to the level controller
+    PIPE_Chunk_t* out = pipe_get_output(pipe);
+    while (out != NULL) {
+        PIPE_Chunk_t* const in = pipe_next_input(pipe);
+        if (in == NULL) {
+            bResult = FALSE;
+            break; // Read or write failed
+        }
+        verify_input(ress->verifier, in->data, in->size);
+        out->inputBytes += in->size;
+
+        int const lastChunk = in->bLast;
+        bytesSinceFlush += in->size;
+        int const flushPoint = !lastChunk && (bLevelChanged ||
+            compress_flush_point_due(&(ress->options), bytesSinceFlush, lastFlushTick));
+        if (flushPoint) {
+            bytesSinceFlush = 0;
+            lastFlushTick = GetTickCount64();
+        }
+        ZSTD_EndDirective const mode = (lastChunk || flushPoint) ? ZSTD_e_end : ZSTD_e_continue;
+
+        ZSTD_inBuffer input = { in->data, in->size, 0 };
+        int finished;
+        do {
+            /* Hand the chunk over once zstd could no longer make progress in it. */
+            if (out->capacity - out->size < ZSTD_STAGE_MIN_ROOM) {
+                out = ZSTD_NB_SubmitChunk(ress, pipe, out);
+                if (out == NULL) {
+                    bResult = FALSE;
+                    break; // Exit on error
+                }
+            }
+
+            ZSTD_outBuffer output = { out->data + out->size, out->capacity - out->size, 0 };
+            size_t const inputPosBefore = input.pos;
+            LONG const generation = ZSTD_NB_Generation(ress);
+            size_t const remaining = ZSTD_compressStream2(ress->cctxPtr, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                log_message("ZSTD Compress Stream failed!");
+                bResult = FALSE;
+                break; // Exit on error
+            }
+            ZSTD_NB_Backoff(ress, generation, inputPosBefore, &input, &output);
+            out->size += output.pos;
+
+            finished = (mode == ZSTD_e_end) ? (remaining == 0) : (input.pos == input.size);
+        } while (!finished);
+
+        /* zstd has consumed (buffered) the whole chunk, so the reader may refill it. */
+        size_t const chunkSize = in->size;
+        pipe_release_input(pipe, in);
+        if (!bResult) {
             break;
         }
+        /* The writer is behind when we wait for empty output chunks or the
+         * filled ones queue up. */
+        adapt_add_wait(ress->adapt, pipe->stats.outputStallMicros - outputStallReported,
+                       pipe_pending_output(pipe), pipe->depth);
+        outputStallReported = pipe->stats.outputStallMicros;
+        bLevelChanged = ZSTD_NB_Adapt(ress, chunkSize) || (bLevelChanged && !flushPoint);
 
-        // Preventing Kernel Resource Saturation
-        // if ((cnt % 16) == 15) {
-        //     Sleep(10);
-        // }
-        // cnt++;
+        if (lastChunk) {
+            out->bLast = TRUE;
+            if (!verify_output(ress->verifier, out->data, out->size)) {
+                bResult = FALSE;
+                break;
+            }
+            pipe_submit_output(pipe, out);
+            break;
+        }
+
+        /* A finished frame goes to the writer right away so it can be recovered. */
+        if (flushPoint && out->size > 0) {
+            out = ZSTD_NB_SubmitChunk(ress, pipe, out);
+        }
+    }
+    if (out == NULL) {
+        bResult = FALSE;
     }
 
-    return bResult;
+    /* After the last chunk the writer finishes the stage before it exits. */
+    return pipe_finish(pipe, !bResult, ress->options.pipelineStats) && bResult;
 }
 
-BOOL compress_zstd(const TCHAR* fname, const TCHAR* outName)
+BOOL compress_zstd(const TCHAR* fname, const TCHAR* outName, const CompressionOptions* options)
 {
     // log_message("Starting compression of %s with level 1, using 1 threads", fname);
 
     BOOL bResult = TRUE; // Compression success status
 
     /* Open the input and output files. */
-    HANDLE hInput = init_file_read(fname); // File to read
-    HANDLE hOutput = init_file_write(outName); // File to write
+    HANDLE hInput = init_file_read_ex(fname, options->cacheMode); // File to read
+    HANDLE hOutput = init_file_write_ex(outName, options->cacheMode); // File to write
 
     resources_t* ress;
 
@@ -180,16 +607,109 @@ BOOL compress_zstd(const TCHAR* fname, const TCHAR* outName)
         return FALSE;
     }
 
-    if (create_resources(&ress)) {
-        bResult = ZSTD_NB_Process(ress, hInput, hOutput);
+    /* Read in the requested or calibrated chunk size (tune.h), else one
+     * full zstd block, or a pipeline chunk when pipelined. */
+    CompressionOptions resolved = *options;
+    resolved.chunkSize = compress_chunk_size(
+        options, ZSTD, hInput, options->bPipeline ? PIPE_DEFAULT_CHUNK_SIZE : (DWORD)ZSTD_CStreamInSize()
+    );
+
+    /* Delta mode (like zstd --patch-from): map the reference and let the
+     * window reach back over the reference from the end of the input. zstd
+     * attaches a prefix to one frame only, so the file stays a single frame
+     * (no flush points, no level changes), and long-distance matching finds
+     * the matches a ZSTD_fast hash table would lose over such a window. */
+    IO_Mapping_t reference = { INVALID_HANDLE_VALUE, NULL, NULL, 0 };
+    LARGE_INTEGER inputSize;
+    BOOL bReferenced = TRUE;
+    if (options->referencePath != NULL) {
+        bReferenced = io_map_file(options->referencePath, &reference) && GetFileSizeEx(hInput, &inputSize);
+        if (bReferenced) {
+            ULONGLONG const span = reference.size + (ULONGLONG)inputSize.QuadPart;
+            int windowLog = ZSTD_WINDOWLOG_MIN;
+            while (windowLog < ZSTD_WINDOWLOG_MAX && ((ULONGLONG)1 << windowLog) < span) {
+                windowLog++;
+            }
+            if (resolved.zstdWindowLog < windowLog) {
+                resolved.zstdWindowLog = windowLog;
+            }
+            resolved.bZstdLongDistance = TRUE;
+            resolved.flushPointBytes = 0;
+            resolved.flushPointMillis = 0;
+            resolved.deadlineMillis = 0;
+            resolved.bAdaptToOutput = FALSE;
+        }
+    }
+
+    ress = NULL;
+    if (bReferenced && create_resources(&ress, &resolved)) {
+        /* Gather the output through a stage into large aligned writes. */
+        BOOL bReady = compress_create_stage(
+            options, hInput, hOutput, resolved.chunkSize, ZSTD_STAGE_MIN_ROOM, &(ress->stage)
+        );
+
+        /* Fit a long-range window to the input. */
+        if (bReady && (resolved.bZstdLongDistance || resolved.zstdWindowLog != 0) &&
+            GetFileSizeEx(hInput, &inputSize) && inputSize.QuadPart > 0) {
+            bReady = !ZSTD_isError(ZSTD_CCtx_setParameter(
+                ress->cctxPtr, ZSTD_c_srcSizeHint, ZSTD_NB_SizeHint((ULONGLONG)inputSize.QuadPart)
+            ));
+        }
+
+        /* Attach the reference; the resources own the mapping from here. */
+        ress->reference = reference;
+        reference.hFile = INVALID_HANDLE_VALUE;
+        reference.hMapping = NULL;
+        reference.data = NULL;
+        if (bReady && ress->reference.data != NULL) {
+            bReady = !ZSTD_isError(ZSTD_CCtx_refPrefix(ress->cctxPtr, ress->reference.data, ress->reference.size));
+        }
+
+        /* Start the verify-after-write thread if requested. */
+        if (bReady && options->verify != NULL) {
+            DecompressionOptions verifyOptions = { 0, };
+            verifyOptions.windowLogMax = ZSTD_WINDOWLOG_MAX; /* accept whatever window this frame uses */
+            verifyOptions.referencePath = options->referencePath;
+            ress->verifier = verify_start(ZSTD, &verifyOptions);
+            bReady = (ress->verifier != NULL);
+        }
+
+        /* Start adapting the level: to the deadline if one is set, else to
+         * the output speed if asked. */
+        if (bReady && (resolved.deadlineMillis != 0 || resolved.bAdaptToOutput)) {
+            AdaptMode const mode = (resolved.deadlineMillis != 0) ? ADAPT_MODE_DEADLINE : ADAPT_MODE_OUTPUT;
+            ress->adapt = GetFileSizeEx(hInput, &inputSize) ?
+                adapt_create(ZSTD, mode, (ULONGLONG)inputSize.QuadPart, resolved.deadlineMillis) : NULL;
+            bReady = (ress->adapt != NULL);
+        }
+        if (bReady && options->bPipeline) {
+            bResult = ZSTD_NB_ProcessPipelined(ress, hInput, hOutput);
+        } else if (bReady) {
+            bResult = ZSTD_NB_Process(ress, hInput, hOutput);
+        } else {
+            bResult = FALSE;
+        }
+        adapt_finish(ress->adapt, options->adaptStats);
+        if (ress->verifier != NULL) {
+            BOOL const bVerified = verify_finish(ress->verifier, options->verify);
+            ress->verifier = NULL;
+            bResult = bResult && bVerified;
+        }
     } else {
         log_message("error : ZSTD resource allocation failed.");
+        bResult = FALSE;
     }
+    io_unmap_file(&reference);
 
-    // Cleanup resources
+    /* Report the memory the context used, workers and long-range tables included. */
+    if (ress != NULL && options->zstdMemoryUsage != NULL) {
+        *(options->zstdMemoryUsage) = ZSTD_sizeof_CCtx(ress->cctxPtr);
+    }
+
+    // Cleanup resources (a pending stage write must finish before the handles close)
+    free_resources(ress);
     CloseHandle(hInput);
     CloseHandle(hOutput);
-    free_resources(ress);
 
     return bResult;
 }
@@ -21,6 +21,11 @@
 
 #include <windows.h>
 
+#include "adapt.h"
+#include "compressor.h"
+#include "io_stage.h"
+#include "verify.h"
+
 // 구조체 선언
 
 typedef struct resources_s resources_t;
@@ -32,13 +37,24 @@ struct resources_s {
     size_t dstBufMaxSize;
     ZSTD_CCtx* cctxPtr;
     BOOL bWait;
+    IO_Throttle_t* throttle;   // I/O 제한 (NULL 이면 제한 없음)
+    CompressionOptions options; // 작업별 옵션 (복사본)
+    VERIFY_Context_t* verifier; // 쓰기 후 검증 (NULL 이면 사용 안 함)
+    IO_Stage_t* stage;         // 출력 Staging (압축 결과를 모아 정렬된 큰 쓰기로 씀, NULL 이면 바로 씀)
+    ADAPT_Context_t* adapt;    // 마감 시간에 맞춘 Level 조절 (NULL 이면 Level 고정)
+    BOOL bMultithreaded;       // zstd Worker 가 압축 (바꾼 Level 이 Frame 중간의 다음 Job 부터 적용됨)
+    TASK_Pool_t* sharedPool;   // ZSTD_threadPool 을 빌려 쓰는 Pool (NULL 이면 자체 Worker 이거나 호출한 Thread 에서 압축)
+    ULONGLONG adaptConsumed;   // Worker 가 압축을 마친 원본 크기 (Level 조절의 진행률, bMultithreaded 일 때)
+    IO_Mapping_t reference;    // Delta 압축의 기준 파일 (Frame 의 Prefix, CompressionOptions.referencePath)
 };
 
 // 함수 선언
 
-BOOL create_resources(resources_t** ress);
+size_t zstd_estimate_memory(const CompressionOptions* options, ULONGLONG srcSize, size_t* pDecompressMemory);
+BOOL create_resources(resources_t** ress, const CompressionOptions* options);
 void free_resources(resources_t* ress);
 BOOL ZSTD_NB_Process(resources_t* ress, HANDLE hInput, HANDLE hOutput);
-BOOL compress_zstd(const TCHAR* fname, const TCHAR* outName);
+BOOL ZSTD_NB_ProcessPipelined(resources_t* ress, HANDLE hInput, HANDLE hOutput);
+BOOL compress_zstd(const TCHAR* fname, const TCHAR* outName, const CompressionOptions* options);
 
 #endif // ZSTD_NB_H